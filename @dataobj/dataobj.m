@@ -6,7 +6,17 @@ function dobj = dataobj(varargin)
 %    wildcards ('*').
 %
 % DATAOBJ(FILENAME,'tint',tint)
-%       tint         - limit dataobj to time interval
+%       tint         - limit dataobj to time interval, ISDAT epoch [start stop]
+%                      or GenericTimeArray
+%
+% DATAOBJ(FILENAME,...,'vars',varNames)
+%       varNames     - read only these variables (string or cell array of
+%                      strings) and the variables they refer to through
+%                      their attributes (DEPEND_0, LABL_PTR_1 ...)
+%
+%    With tint and the MEX file irf_cdfread_mx only the records within
+%    tint are read from CDF files with TT2000 time, see irf_cdfread_mx.c.
+%    Other files are read whole with spdfcdfread.
 
 % ----------------------------------------------------------------------------
 % "THE BEER-WARE LICENSE" (Revision 42):
@@ -21,6 +31,8 @@ if isempty(usingNasaPatchCdf), % check only once if using NASA cdf
 end
 shouldReadAllData = true;  % default read all data
 isDataReturned    = true; % default expects data to be returned
+varsToRead = {}; % default all variables
+tintTT2000 = [];
 if     nargin==0, action='create_default_object';
 elseif nargin==1, action='read_data_from_file';
 else
@@ -31,14 +43,25 @@ else
       irf.log('warning','KeepTT2000 is deprecated (always TRUE)')
     end
   end
-  if nargin >=3
-    if ischar(varargin{2}) && strcmp(varargin{2},'tint') && ...
-        isnumeric(varargin{3}) && (length(varargin{3})==2),
-      tint=varargin{3};
+  args = varargin(2:end);
+  if rem(length(args),2), args(end) = []; end % KeepTT2000
+  while ~isempty(args)
+    if ischar(args{1}) && strcmp(args{1},'tint') && ...
+        isnumeric(args{2}) && (length(args{2})==2),
+      tint=args{2};
       shouldReadAllData=false;
+    elseif ischar(args{1}) && strcmp(args{1},'tint') && ...
+        isa(args{2},'GenericTimeArray') && (length(args{2})==2),
+      tintTT2000 = args{2}.ttns;
+      tint = args{2}.epochUnix;
+      shouldReadAllData=false;
+    elseif ischar(args{1}) && strcmp(args{1},'vars') && ...
+        (ischar(args{2}) || iscellstr(args{2})),
+      varsToRead = cellstr(args{2});
     else
       error('IRF:dataobj:dataobj:invalidInput','invalid input params');
     end
+    args(1:2) = [];
   end
 end
 
@@ -86,7 +109,9 @@ switch action
       %% read in file
       irf.log('notice',['Reading: ' cdf_file]);
       % initialize data object
-      if usingNasaPatchCdf
+      if usingNasaPatchCdf && ~shouldReadAllData && read_records_in_tint
+        % only the records within tint were read, see irf_cdfread_mx.c
+      elseif usingNasaPatchCdf
         timeVariable = [];
         [data,info] = spdfcdfread(cdf_file,'CombineRecords',true,'KeepEpochAsIs',true);
 
@@ -161,6 +186,12 @@ switch action
 
         fix_order_of_array_dimensions;
 
+        if ~isempty(varsToRead)
+          isSelected = select_variables;
+          data = data(isSelected);
+          info.Variables = info.Variables(isSelected,:);
+        end
+
         if ~shouldReadAllData
           nVariables = size(info.Variables,1);
           records = cell(nVariables,1); recsTmp = {};
@@ -177,8 +208,7 @@ switch action
             iTimeVar = get_var_idx(timeVarName);
             timeline = data{iTimeVar};
             if strcmpi(info.Variables(iTimeVar,4),'tt2000')
-              tintTmp(1) = spdfparsett2000(epoch2iso(tint(1)));
-              tintTmp(2) = spdfparsett2000(epoch2iso(tint(2)));
+              tintTmp = get_tint_tt2000;
             else tintTmp = tint;
             end
             records{i} = (timeline >= tintTmp(1)) & (timeline < tintTmp(2));
@@ -314,6 +344,99 @@ switch action
 end % Main function
 
 %% Help functions
+  function res = read_records_in_tint
+    % Read only the records within tint of the record varying variables
+    % with irf_cdfread_mx, the non record varying ones with spdfcdfread.
+    % Returns false if this cannot be done (no MEX file, time other than
+    % TT2000, unsupported CDF), then the whole file is to be read.
+    res = false;
+    if exist('irf_cdfread_mx','file')~=3, return, end
+    try
+      info = spdfcdfinfo(cdf_file);
+      if ~isempty(varsToRead)
+        info.Variables = info.Variables(select_variables,:);
+      end
+      if any(ismember(lower(info.Variables(:,4)),{'epoch','epoch16'})), return, end
+      nVariables = size(info.Variables,1);
+      data = cell(1,nVariables); records = cell(nVariables,1);
+      isFixed = cellfun(@(x) strcmpi(x(1),'F'), info.Variables(:,5));
+      for iVar = find(strcmpi(info.Variables(:,4),'tt2000'))'
+        if is_virtual(iVar), return, end
+      end
+      if any(isFixed)
+        dataFixed = spdfcdfread(cdf_file,'Variables',info.Variables(isFixed,1)',...
+          'CombineRecords',true,'KeepEpochAsIs',true);
+        if sum(isFixed)==1, dataFixed = {dataFixed}; end
+        data(isFixed) = dataFixed;
+        fix_order_of_array_dimensions;
+      end
+      % Record ranges [first count] of the time variables, which also apply
+      % to the variables depending on them and to their DELTA_PLUS/MINUS
+      first = zeros(nVariables,1); count = zeros(nVariables,1);
+      recsTmp = {};
+      for iVar = find(~isFixed)'
+        timeVarName = get_key('DEPEND_0',iVar);
+        if isempty(timeVarName), continue, end
+        timeVarName = timeVarName{:};
+        iTimeVar = get_var_idx(timeVarName);
+        if ~strcmpi(info.Variables(iTimeVar,4),'tt2000')
+          error('IRF:dataobj:dataobj:notTT2000','%s is not TT2000',timeVarName);
+        end
+        idx = [];
+        if ~isempty(recsTmp), idx = find(strcmpi(recsTmp(:,1),timeVarName)); end
+        if isempty(idx)
+          [firstTmp,countTmp] = irf_cdfread_mx('range',cdf_file,timeVarName,...
+            get_tint_tt2000);
+          recsTmp = [recsTmp; {timeVarName,firstTmp,countTmp}]; %#ok<AGROW>
+          idx = size(recsTmp,1);
+          iRange = iTimeVar;
+          for deltaParam={'DELTA_PLUS','DELTA_MINUS'}
+            deltaVar = get_key(deltaParam{:},iTimeVar);
+            if isempty(deltaVar) || ~ischar(deltaVar{:}), continue, end
+            iRange = [iRange get_var_idx(deltaVar{:})]; %#ok<AGROW>
+          end
+          first(iRange) = firstTmp; count(iRange) = countTmp;
+        end
+        first(iVar) = recsTmp{idx,2}; count(iVar) = recsTmp{idx,3};
+      end
+      for iVar = find(~isFixed)'
+        data{iVar} = irf_cdfread_mx('read',cdf_file,info.Variables{iVar,1},...
+          first(iVar),count(iVar));
+        records{iVar} = true(count(iVar),1);
+      end
+      irf_cdfread_mx('close');
+      res = true;
+    catch err
+      irf_cdfread_mx('close');
+      irf.log('notice',['Reading the whole file, irf_cdfread_mx: ' err.message]);
+    end
+  end
+
+  function tintTmp = get_tint_tt2000
+    if isempty(tintTT2000) % int64
+      tintTT2000 = [spdfparsett2000(epoch2iso(tint(1))) ...
+        spdfparsett2000(epoch2iso(tint(2)))];
+    end
+    tintTmp = tintTT2000;
+  end
+
+  function isSelected = select_variables
+    % varsToRead and the variables they refer to, recursively
+    varNames = info.Variables(:,1);
+    isSelected = ismember(varNames,varsToRead);
+    isNew = isSelected; attrNames = fieldnames(info.VariableAttributes);
+    while any(isNew)
+      newNames = varNames(isNew); isNew(:) = false;
+      for iAttr = 1:length(attrNames)
+        attr = info.VariableAttributes.(attrNames{iAttr});
+        isRef = ismember(attr(:,1),newNames) & cellfun(@ischar,attr(:,2));
+        isNew = isNew | ismember(varNames,attr(isRef,2));
+      end
+      isNew = isNew & ~isSelected;
+      isSelected = isSelected | isNew;
+    end
+  end
+
   function idx = get_var_idx(varName)
     isVarArray=cellfun(@(x) strcmpi(x,varName), info.Variables(:,1));
     idx = find(isVarArray==1);
@@ -398,7 +398,21 @@ classdef (Abstract) GenericTimeArray
 		end
 		function utc = ttns2utc(ttns,format)
       % Convert TT nanoseconds to UTC
+      persistent leaps
       if nargin<2 || isempty(format), format = 2; end
+      if isnumeric(format) && isscalar(format) && any(format==[0 1 2]) ...
+          && exist('irf_isotime_mx','file') == 3
+        % Fast path, same output as spdfencodett2000 below
+        if isempty(leaps)
+          leaps = {};
+          if exist('CDFLeapSeconds.txt','file')
+            leaps = {GenericTimeArray.leap_seconds()};
+          end
+        end
+        digits = [6 3 9];
+        utc = irf_isotime_mx(int64(ttns(:)),'ttns',digits(format+1),leaps{:});
+        return
+      end
 			utc =  char(spdfencodett2000(int64(ttns)));
 			if isnumeric(format)
 				switch format
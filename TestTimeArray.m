@@ -34,4 +34,63 @@ classdef TestTimeArray < matlab.unittest.TestCase
       testCase.verifyEqual(t.epoch, ttns)
     end
   end
-end
\ No newline at end of file
+  
+  methods (Test)
+    function testIsotimeMxTtns(testCase)
+      % irf_isotime_mx against spdfencodett2000, the path of ttns2utc
+      % without it: truncation at 59.999..., leap seconds, times before
+      % 2000 and before 1972, when TAI-UTC drifts, and before 1960
+      testCase.assumeEqual(exist('irf_isotime_mx','file'),3,...
+        'irf_isotime_mx is not compiled');
+      rng(42);
+      ns = int64([0 1 499999999 999999999 1e9 1e9+1 1999999999 2e9]);
+      days = {'1972-06-30','1998-12-31','2008-12-31','2016-12-31',... % leap
+        '1999-12-31','2015-02-28','1971-12-31','1965-08-31','1961-07-31',...
+        '1960-12-31','1959-12-31','1958-01-01','1900-06-15'};
+      t0 = spdfparsett2000(strcat(days(:),'T23:59:59.000000000'));
+      ttns = [reshape(bsxfun(@plus,t0,ns)',[],1)
+        int64(-1); int64(0); int64(1)
+        int64(rand(2000,1)*4e18-2.5e18)
+        intmin('int64'); intmin('int64')+1];  % fill and pad values
+      utc = char(spdfencodett2000(ttns));
+      for digits = [0 3 6 9]
+        s = irf_isotime_mx(ttns,'ttns',digits);
+        testCase.verifyEqual(s,[utc(:,1:19+(digits>0)*(digits+1)) ...
+          repmat('Z',length(ttns),1)],sprintf('digits %d',digits))
+      end
+    end
+    function testIsotimeMxEpoch(testCase)
+      % irf_isotime_mx against the MATLAB path of epoch2iso: rounding
+      % carry of 59.999...96 into the next minute, day and year, days
+      % ending in a leap second and negative epochs
+      testCase.assumeEqual(exist('irf_isotime_mx','file'),3,...
+        'irf_isotime_mx is not compiled');
+      rng(42);
+      t = [0; 59.9999996; 59.9999994; 59.9996; 59.9994; 86399.9999996
+        946684799.9999996; 946684799.9995    % 1999-12-31
+        78796799.9999996; 78796799.5         % 1972-06-30, leap
+        1483228799.9999996; 1483228799.9999  % 2016-12-31, leap
+        -4e-7; -6e-7; -0.0004; -0.0006; -60.0000004; -86400.9999996
+        -1e9+0.9999996; -2208988800.0000004  % 1938, 1900-01-01
+        -1e9*rand(500,1); 2e9*rand(500,1)];
+      for fmt = [0 1]
+        testCase.verifyEqual(irf_isotime_mx(t,'epoch',6-3*fmt),...
+          epoch2iso_matlab(t,fmt),sprintf('fmt %d',fmt))
+      end
+    end
+  end
+end
+
+function out = epoch2iso_matlab(t,fmt)
+% EPOCH2ISO without irf_isotime_mx, as for unsorted times
+dt_res = 5*10^(-7+3*fmt);
+d = fromepoch(t);
+switch fmt
+  case 0, out = num2str(d,'%04d-%02d-%02dT%02d:%02d:%09.6fZ');
+  case 1, out = num2str(d,'%04d-%02d-%02dT%02d:%02d:%06.3fZ');
+end
+ii = find(out(:,18)=='6'); % rounded to 60.000 seconds
+if any(ii)
+  out(ii,:) = epoch2iso_matlab(t(ii)+dt_res,fmt);
+end
+end
@@ -2,35 +2,71 @@
 %	Initialisation of CEFLIB library
 %	--------------------------------
 %
-if not (libisloaded ('libcef'))
-	loadlibrary (['libcef_' lower(computer)], @libcef_mfile,'alias','libcef')
-end
+if exist ('cef_mx', 'file') == 3
+	% in-tree reader, see cef_mx.cpp
+	cef_read	= @(file)	cef_mx ('read', file);
 
+	cef_read_interval = @(file,t1,t2) cef_mx ('read_interval', file, t1, t2);
 
-cef_read	= @(file)	calllib ('libcef', 'cef_read', file);
+	cef_read_header	= @(file)	cef_mx ('read_header', file);
 
-cef_close	= @()		calllib	('libcef', 'cef_close');
+	cef_close	= @()		cef_mx ('close');
 
-cef_verbosity	= @(level)	calllib ('libcef', 'cef_verbosity', level);
+	cef_verbosity	= @(level)	cef_mx ('verbosity', level);
 
-cef_metanames	= @()		calllib ('libcef', 'cef_metanames');
+	cef_cache	= @(varargin)	cef_mx ('cache', varargin{:});
 
-cef_meta	= @(meta)	calllib ('libcef', 'cef_meta', meta);
+	cef_metanames	= @()		cef_mx ('metanames');
 
-cef_gattributes	= @()		calllib ('libcef', 'cef_gattributes');
+	cef_meta	= @(meta)	cef_mx ('meta', meta);
 
-cef_vattributes	= @(var)	calllib ('libcef', 'cef_vattributes', var);
+	cef_gattributes	= @()		cef_mx ('gattributes');
 
-cef_gattr	= @(key)	calllib ('libcef', 'cef_gattr', key);
+	cef_vattributes	= @(var)	cef_mx ('vattributes', var);
 
-cef_vattr	= @(var,key)	calllib ('libcef', 'cef_vattr', var, key);
+	cef_gattr	= @(key)	cef_mx ('gattr', key);
 
-cef_varnames	= @()		calllib ('libcef', 'cef_varnames');
+	cef_vattr	= @(var,key)	cef_mx ('vattr', var, key);
 
-cef_var		= @(var) 	calllib ('libcef', 'cef_var', var);
+	cef_varnames	= @()		cef_mx ('varnames');
 
-cef_depends	= @(var)	calllib ('libcef', 'cef_depends', var);
+	cef_var		= @(var) 	cef_mx ('var', var);
 
-cef_date 	= @(d)		d / 86400000.0 + 715146.0;
+	cef_depends	= @(var)	cef_mx ('depends', var);
+
+	milli_to_isotime = @(var,n)	cef_mx ('milli_to_isotime', var, n);
+else
+	if not (libisloaded ('libcef'))
+		loadlibrary (['libcef_' lower(computer)], @libcef_mfile,'alias','libcef')
+	end
+
+	cef_read	= @(file)	calllib ('libcef', 'cef_read', file);
+
+	cef_read_header	= cef_read;
+
+	cef_close	= @()		calllib	('libcef', 'cef_close');
+
+	cef_verbosity	= @(level)	calllib ('libcef', 'cef_verbosity', level);
+
+	cef_metanames	= @()		calllib ('libcef', 'cef_metanames');
+
+	cef_meta	= @(meta)	calllib ('libcef', 'cef_meta', meta);
+
+	cef_gattributes	= @()		calllib ('libcef', 'cef_gattributes');
 
-milli_to_isotime = @(var,n)	calllib ('libcef', 'milli_to_isotime', var, n);
+	cef_vattributes	= @(var)	calllib ('libcef', 'cef_vattributes', var);
+
+	cef_gattr	= @(key)	calllib ('libcef', 'cef_gattr', key);
+
+	cef_vattr	= @(var,key)	calllib ('libcef', 'cef_vattr', var, key);
+
+	cef_varnames	= @()		calllib ('libcef', 'cef_varnames');
+
+	cef_var		= @(var) 	calllib ('libcef', 'cef_var', var);
+
+	cef_depends	= @(var)	calllib ('libcef', 'cef_depends', var);
+
+	milli_to_isotime = @(var,n)	calllib ('libcef', 'milli_to_isotime', var, n);
+end
+
+cef_date 	= @(d)		d / 86400000.0 + 715146.0;
@@ -0,0 +1,2207 @@
+//
+// cef_mx.cpp  In-tree reader for CEF (Cluster Exchange Format) files
+//
+// Implements the API of the CESR CEFLIB (see libcef.h) natively:
+//
+//   cef_read, cef_close, cef_verbosity, cef_metanames, cef_meta,
+//   cef_gattributes, cef_vattributes, cef_gattr, cef_vattr, cef_var,
+//   cef_varnames, cef_depends, milli_to_isotime
+//
+// The functions are exported with the libcef.h signatures and are also
+// reachable through the MEX gateway, which is what cef_init.m uses when
+// this file has been compiled:
+//
+//   STATUS = cef_mx('read',FILENAME)
+//   STATUS = cef_mx('read_interval',FILENAME,TSTART,TSTOP)
+//   STATUS = cef_mx('read_header',FILENAME)   metadata only
+//   OUT    = cef_mx('var',VARNAME)   ... one command per libcef function
+//   cef_mx('threads',N)              number of parser threads, 0 = auto
+//   cef_mx('cache',DIR,MAXBYTES)     keep parsed columns in DIR, '' = off
+//
+// Uncompressed files are memory mapped, .gz files (also multi-member gzip
+// as written by cefprint_mx) are inflated as a stream into one buffer.
+// cef_read only reads the header and indexes the records, scanning for
+// delimiters 16 bytes at a time (SSE2). A variable is parsed the first
+// time cef_var asks for it: in every record the fields in front of it are
+// skipped by counting delimiters and only its own fields are converted.
+// The records are split between threads which write straight into a
+// preallocated array. The text stays mapped (or inflated) until cef_close.
+//
+// cef_read_header stops at DATA_UNTIL (reading INCLUDE files as usual), so
+// metadata queries never touch the data section; the records are indexed
+// only if cef_var later asks for a varying variable. Parsed headers are
+// kept in memory for the last 512 files and reused while neither the file
+// nor its INCLUDE files change.
+//
+// Returned values follow CEFLIB: ISO_TIME as double milliseconds since
+// 1958-01-01, FLOAT as single, DOUBLE as double, INT as int32, BYTE as
+// uint8, CHAR as cell, ISO_TIME_RANGE as struct with fields start/stop.
+// A variable with SIZES = n1,n2 has size [n2 n1 NRECORDS]. Variable names
+// are truncated before "__<dataset>" and are case insensitive.
+//
+// Compile with:
+//   mex -v -largeArrayDims cef_mx.cpp CXXFLAGS='$CXXFLAGS -O2 -std=c++11 -pthread' -lz
+//
+
+#include "mex.h"
+
+#include <zlib.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <dirent.h>
+#include <limits.h>
+#include <unistd.h>
+#include <strings.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// libcef.h has no C++ guards, the API keeps C linkage
+extern "C" {
+#include "libcef.h"
+
+int		cef_read_interval (char * filename, double tstart, double tstop);
+int		cef_read_header (char * filename);
+
+void		cef_cache (char * dir, double max_bytes);
+}
+
+namespace {
+
+// Error codes returned by cef_read, CEFLIB uses values > 100 for errors
+enum {
+	CEF_OK = 0,
+	CEF_ERR_OPEN = 101,
+	CEF_ERR_HEADER = 102
+};
+
+enum ValueType { VT_CHAR, VT_FLOAT, VT_DOUBLE, VT_INT, VT_BYTE, VT_ISO_TIME, VT_ISO_TIME_RANGE };
+
+const double MILLI_PER_DAY = 86400000.0;
+
+int verbosity = 1;
+int nthreads_opt = 0;	// 0 means one per CPU
+
+struct Attr {
+	std::string name;
+	std::vector<std::string> values;
+};
+
+struct Meta {
+	std::string name;
+	std::vector<std::string> entries;
+};
+
+struct Variable {
+	std::string name;	// truncated before "__"
+	std::string fullname;
+	std::vector<Attr> attrs;
+	ValueType type;
+	std::vector<size_t> sizes;
+	size_t nelem;	// values per record
+	bool varying;	// false when values are given by the DATA attribute
+	bool parsed;
+	size_t col;	// first field of the variable in a record
+
+	// parsed values, only the vector matching type is used
+	std::vector<double> d;	// ISO_TIME, DOUBLE, ISO_TIME_RANGE (start,stop)
+	std::vector<float> f;
+	std::vector<int32_t> i;
+	std::vector<uint8_t> b;
+	std::vector<std::string> s;
+};
+
+// Text of a CEF file, either mapped or inflated into memory
+struct Source {
+	const char *data = nullptr;
+	size_t size = 0;
+	void *map = nullptr;
+	size_t map_size = 0;
+	std::vector<char> owned;
+
+	Source() = default;
+	Source(const Source &) = delete;
+	Source &operator=(const Source &) = delete;
+	~Source() { release(); }
+	void release()
+	{
+		if ( map )
+			munmap(map, map_size);
+		map = nullptr;
+		data = nullptr;
+		size = 0;
+		std::vector<char>().swap(owned);
+	}
+	void swap(Source &o)
+	{
+		std::swap(data, o.data);
+		std::swap(size, o.size);
+		std::swap(map, o.map);
+		std::swap(map_size, o.map_size);
+		owned.swap(o.owned);
+	}
+	void take(std::vector<char> &text)
+	{
+		release();
+		owned.swap(text);
+		data = owned.data();
+		size = owned.size();
+	}
+};
+
+struct CefFile {
+	std::string filename;
+	std::vector<Attr> gattrs;
+	std::vector<Meta> metas;
+	std::vector<Variable> vars;
+	size_t nrec = 0;
+	size_t nfields = 0;	// values per record
+	char marker = 0;	// END_OF_RECORD_MARKER, 0 for end of line
+	std::string data_until;
+	size_t data_start = 0;
+	std::vector<size_t> rec_begin, rec_end;
+	bool indexed = true;	// false while the records come from the cache
+	std::string cache_entry;	// column cache directory, empty when not cached
+	std::vector<std::string> includes;	// INCLUDE files read by the header
+	Source src;
+};
+
+CefFile *cur = nullptr;
+
+//
+// Small string helpers
+//
+
+bool ci_equal(const std::string &a, const std::string &b)
+{
+	return a.size() == b.size() && strncasecmp(a.c_str(), b.c_str(), a.size()) == 0;
+}
+
+std::string truncate_name(const std::string &name)
+{
+	size_t p = name.find("__");
+	return p == std::string::npos || p == 0 ? name : name.substr(0, p);
+}
+
+inline bool is_blank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+std::string trim(const char *b, const char *e)
+{
+	while ( b < e && is_blank(*b) ) b++;
+	while ( e > b && is_blank(e[-1]) ) e--;
+	return std::string(b, e);
+}
+
+const Attr *find_attr(const std::vector<Attr> &attrs, const std::string &name)
+{
+	for ( const Attr &a : attrs )
+		if ( ci_equal(a.name, name) )
+			return &a;
+	return nullptr;
+}
+
+Variable *find_var(CefFile *cf, const char *name)
+{
+	std::string n(name);
+	for ( Variable &v : cf->vars )
+		if ( ci_equal(v.name, n) || ci_equal(v.fullname, n) )
+			return &v;
+	return nullptr;
+}
+
+//
+// Reading the file
+//
+
+bool map_file(const char *filename, Source &src)
+{
+	int fd = open(filename, O_RDONLY);
+	if ( fd < 0 )
+		return false;
+	struct stat st;
+	if ( fstat(fd, &st) != 0 ) {
+		close(fd);
+		return false;
+	}
+	src.map_size = st.st_size;
+	if ( src.map_size > 0 ) {
+		src.map = mmap(nullptr, src.map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if ( src.map == MAP_FAILED ) {
+			src.map = nullptr;
+			close(fd);
+			return false;
+		}
+		madvise(src.map, src.map_size, MADV_SEQUENTIAL);
+	}
+	close(fd);
+	src.data = static_cast<const char *>(src.map);
+	src.size = src.map_size;
+	return true;
+}
+
+// Inflate the gzip members of IN into OUT, stopping after LIMIT bytes
+bool inflate_all(const unsigned char *in, size_t len, std::vector<char> &out,
+		size_t limit = SIZE_MAX)
+{
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	if ( inflateInit2(&zs, 15 + 32) != Z_OK )
+		return false;
+
+	out.resize(std::min(limit, len * 8 + (1 << 16)));
+	size_t have = 0;
+	zs.next_in = const_cast<Bytef *>(in);
+	zs.avail_in = len;
+	while ( have < limit ) {
+		if ( have == out.size() )
+			out.resize(std::min(limit, out.size() * 2));
+		size_t avail = std::min<size_t>(out.size() - have, 1 << 30);
+		zs.next_out = reinterpret_cast<Bytef *>(&out[have]);
+		zs.avail_out = avail;
+		int ret = inflate(&zs, Z_NO_FLUSH);
+		have += avail - zs.avail_out;
+		if ( ret == Z_STREAM_END ) {
+			// concatenated members, skip trailing zero padding
+			while ( zs.avail_in > 0 && *zs.next_in == 0 ) {
+				zs.next_in++;
+				zs.avail_in--;
+			}
+			if ( zs.avail_in == 0 )
+				break;
+			inflateReset(&zs);
+		} else if ( ret != Z_OK && !(ret == Z_BUF_ERROR && zs.avail_out == 0) ) {
+			inflateEnd(&zs);
+			return false;
+		}
+	}
+	inflateEnd(&zs);
+	out.resize(have);
+	return true;
+}
+
+inline bool is_gzip(const Source &src)
+{
+	return src.size >= 2 && (unsigned char)src.data[0] == 0x1f &&
+		(unsigned char)src.data[1] == 0x8b;
+}
+
+bool load_source(const char *filename, Source &src)
+{
+	if ( !map_file(filename, src) )
+		return false;
+	if ( is_gzip(src) ) {
+		std::vector<char> text;
+		bool ok = inflate_all(reinterpret_cast<const unsigned char *>(src.data),
+				src.size, text);
+		if ( !ok )
+			return false;
+		src.take(text);
+	}
+	return true;
+}
+
+//
+// Header
+//
+
+// Split a value list on commas outside quotes and strip the quotes
+std::vector<std::string> split_values(const char *b, const char *e)
+{
+	std::vector<std::string> out;
+	const char *p = b;
+	while ( p <= e ) {
+		while ( p < e && is_blank(*p) ) p++;
+		if ( p < e && (*p == '"' || *p == '\'') ) {
+			char q = *p++;
+			const char *s = p;
+			while ( p < e && *p != q ) p++;
+			out.push_back(std::string(s, p));
+			if ( p < e ) p++;
+			while ( p < e && *p != ',' ) p++;
+		} else {
+			const char *s = p;
+			while ( p < e && *p != ',' ) p++;
+			out.push_back(trim(s, p));
+		}
+		if ( p >= e )
+			break;
+		p++;	// ','
+	}
+	return out;
+}
+
+// Position of '!' starting a comment, or e
+const char *comment_start(const char *b, const char *e)
+{
+	char q = 0;
+	for ( const char *p = b; p < e; p++ ) {
+		if ( q ) {
+			if ( *p == q ) q = 0;
+		} else if ( *p == '"' || *p == '\'' )
+			q = *p;
+		else if ( *p == '!' )
+			return p;
+	}
+	return e;
+}
+
+bool parse_header(CefFile *cf, const char *text, size_t size, const std::string &dir,
+		bool include, int depth);
+
+std::string dirname_of(const std::string &path)
+{
+	size_t p = path.rfind('/');
+	return p == std::string::npos ? std::string(".") : path.substr(0, p);
+}
+
+// INCLUDE files are looked up in the directory of the file and in CEFPATH
+bool read_include(CefFile *cf, const std::string &name, const std::string &dir, int depth)
+{
+	std::vector<std::string> dirs(1, dir);
+	if ( const char *env = getenv("CEFPATH") ) {
+		std::string s(env);
+		size_t p = 0, q;
+		while ( (q = s.find(':', p)) != std::string::npos ) {
+			dirs.push_back(s.substr(p, q - p));
+			p = q + 1;
+		}
+		dirs.push_back(s.substr(p));
+	}
+	for ( const std::string &d : dirs ) {
+		std::string path = d + "/" + name;
+		if ( access(path.c_str(), R_OK) != 0 )
+			continue;
+		Source inc;
+		if ( !load_source(path.c_str(), inc) )
+			return false;
+		cf->includes.push_back(path);
+		return parse_header(cf, inc.data, inc.size, dirname_of(path), true, depth + 1);
+	}
+	if ( verbosity > 0 )
+		mexPrintf("cef_mx: include file %s not found\n", name.c_str());
+	return false;
+}
+
+ValueType value_type(const std::string &s)
+{
+	if ( ci_equal(s, "FLOAT") ) return VT_FLOAT;
+	if ( ci_equal(s, "DOUBLE") ) return VT_DOUBLE;
+	if ( ci_equal(s, "INT") ) return VT_INT;
+	if ( ci_equal(s, "BYTE") ) return VT_BYTE;
+	if ( ci_equal(s, "ISO_TIME") ) return VT_ISO_TIME;
+	if ( ci_equal(s, "ISO_TIME_RANGE") ) return VT_ISO_TIME_RANGE;
+	return VT_CHAR;
+}
+
+// Parse header lines, sets cf->data_start when DATA_UNTIL is found
+bool parse_header(CefFile *cf, const char *text, size_t size, const std::string &dir,
+		bool include, int depth)
+{
+	if ( depth > 8 )
+		return false;
+
+	const char *p = text, *end = text + size;
+	Meta *meta = nullptr;
+	Variable *var = nullptr;
+	std::string line;
+
+	while ( p < end ) {
+		const char *nl = static_cast<const char *>(memchr(p, '\n', end - p));
+		const char *le = nl ? nl : end;
+		const char *next = nl ? nl + 1 : end;
+
+		const char *ce = comment_start(p, le);
+		std::string part = trim(p, ce);
+		p = next;
+
+		// continuation lines end with '\'
+		if ( !part.empty() && part.back() == '\\' ) {
+			part.pop_back();
+			line += part;
+			continue;
+		}
+		line += part;
+		if ( line.empty() )
+			continue;
+
+		size_t eq = line.find('=');
+		if ( eq == std::string::npos ) {
+			if ( verbosity > 1 )
+				mexPrintf("cef_mx: ignoring header line '%s'\n", line.c_str());
+			line.clear();
+			continue;
+		}
+		std::string key = trim(line.data(), line.data() + eq);
+		std::vector<std::string> values = split_values(line.data() + eq + 1,
+				line.data() + line.size());
+		std::string value = values.empty() ? std::string() : values[0];
+		line.clear();
+
+		if ( ci_equal(key, "START_META") ) {
+			cf->metas.push_back(Meta());
+			meta = &cf->metas.back();
+			meta->name = value;
+		} else if ( ci_equal(key, "END_META") ) {
+			meta = nullptr;
+		} else if ( ci_equal(key, "START_VARIABLE") ) {
+			cf->vars.push_back(Variable());
+			var = &cf->vars.back();
+			var->fullname = value;
+			var->name = truncate_name(value);
+		} else if ( ci_equal(key, "END_VARIABLE") ) {
+			var = nullptr;
+		} else if ( meta ) {
+			if ( ci_equal(key, "ENTRY") )
+				meta->entries.insert(meta->entries.end(), values.begin(), values.end());
+		} else if ( var ) {
+			Attr a;
+			a.name = key;
+			a.values = values;
+			var->attrs.push_back(a);
+		} else if ( ci_equal(key, "INCLUDE") ) {
+			if ( !read_include(cf, value, dir, depth) )
+				return false;
+			meta = nullptr;
+			var = nullptr;
+		} else {
+			Attr a;
+			a.name = key;
+			a.values = values;
+			cf->gattrs.push_back(a);
+			if ( ci_equal(key, "END_OF_RECORD_MARKER") )
+				cf->marker = value.empty() ? 0 : value[0];
+			else if ( ci_equal(key, "DATA_UNTIL") && !include ) {
+				cf->data_until = value;
+				cf->data_start = p - text;
+				return true;
+			}
+		}
+	}
+	return include;
+}
+
+// Variable layout and CEFLIB conventions for attribute values
+bool setup_variables(CefFile *cf)
+{
+	size_t col = 0;
+	for ( Variable &v : cf->vars ) {
+		const Attr *a = find_attr(v.attrs, "VALUE_TYPE");
+		v.type = a && !a->values.empty() ? value_type(a->values[0]) : VT_CHAR;
+
+		v.sizes.clear();
+		if ( (a = find_attr(v.attrs, "SIZES")) != nullptr )
+			for ( const std::string &s : a->values )
+				v.sizes.push_back(strtoul(s.c_str(), nullptr, 10));
+		if ( v.sizes.empty() )
+			v.sizes.push_back(1);
+		v.nelem = 1;
+		for ( size_t n : v.sizes )
+			v.nelem *= n;
+
+		v.varying = find_attr(v.attrs, "DATA") == nullptr;
+		v.parsed = !v.varying;
+		v.col = col;
+		if ( v.varying )
+			col += v.nelem;
+	}
+	cf->nfields = col;
+
+	// references to other variables use the truncated names
+	for ( Variable &v : cf->vars )
+		for ( Attr &a : v.attrs )
+			for ( std::string &s : a.values )
+				for ( const Variable &w : cf->vars )
+					if ( s == w.fullname ) {
+						s = w.name;
+						break;
+					}
+	return true;
+}
+
+//
+// Record scanning
+//
+
+// First of '\n', MARKER, quotes or '!' in [p,end)
+inline const char *scan_special(const char *p, const char *end, char marker)
+{
+#if defined(__SSE2__)
+	const __m128i vn = _mm_set1_epi8('\n');
+	const __m128i vm = _mm_set1_epi8(marker ? marker : '\n');
+	const __m128i vq = _mm_set1_epi8('"');
+	const __m128i va = _mm_set1_epi8('\'');
+	const __m128i vx = _mm_set1_epi8('!');
+	while ( p + 16 <= end ) {
+		__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+		__m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(c, vn), _mm_cmpeq_epi8(c, vm)),
+				_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(c, vq), _mm_cmpeq_epi8(c, va)),
+					_mm_cmpeq_epi8(c, vx)));
+		int mask = _mm_movemask_epi8(m);
+		if ( mask )
+			return p + __builtin_ctz(mask);
+		p += 16;
+	}
+#endif
+	for ( ; p < end; p++ )
+		if ( *p == '\n' || *p == marker || *p == '"' || *p == '\'' || *p == '!' )
+			return p;
+	return end;
+}
+
+inline const char *skip_line(const char *p, const char *end)
+{
+	const char *nl = static_cast<const char *>(memchr(p, '\n', end - p));
+	return nl ? nl + 1 : end;
+}
+
+double parse_iso_time(const char *b, const char *e);
+
+// Time of a record whose first field is an ISO_TIME, NaN if it is not
+double record_time(const char *p, const char *end, char marker)
+{
+	while ( p < end && (*p == ' ' || *p == '\t') ) p++;
+	const char *e = p;
+	while ( e < end && *e != ',' && *e != '\n' && *e != marker ) e++;
+	if ( e >= end )
+		return NAN;
+	while ( e > p && is_blank(e[-1]) ) e--;
+	return parse_iso_time(p, e);
+}
+
+// Find [begin,end) of the data records starting at offset FROM. With a
+// time interval only records with TSTART <= time < TSTOP are kept and the
+// scan stops at the first record past TSTOP; the first field must then be
+// the time tag.
+void index_records(CefFile *cf, size_t from, double tstart = -INFINITY,
+		double tstop = INFINITY)
+{
+	const char *base = cf->src.data;
+	const char *p = base + from, *end = base + cf->src.size;
+	const std::string &until = cf->data_until;
+	bool interval = tstart > -INFINITY || tstop < INFINITY;
+
+	cf->rec_begin.clear();
+	cf->rec_end.clear();
+
+	while ( p < end ) {
+		// outside a record: blank lines, comments or the end of data
+		while ( p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') )
+			p++;
+		if ( p >= end )
+			break;
+		if ( *p == '!' ) {
+			p = skip_line(p, end);
+			continue;
+		}
+		if ( !until.empty() && (size_t)(end - p) >= until.size() &&
+				memcmp(p, until.data(), until.size()) == 0 )
+			break;
+
+		const char *rb = p, *re;
+		for (;;) {
+			p = scan_special(p, end, cf->marker);
+			if ( p >= end ) {
+				re = end;
+				break;
+			}
+			char c = *p;
+			if ( c == '\n' || (cf->marker && c == cf->marker) ) {
+				if ( c == cf->marker || !cf->marker ) {
+					re = p++;
+					break;
+				}
+				p++;
+			} else if ( c == '!' ) {
+				p = skip_line(p, end);
+				if ( p >= end ) {	// comment without a final newline
+					re = end;
+					break;
+				}
+				p--;	// keep the '\n' for marker-less files
+			} else {
+				const char *q = static_cast<const char *>(memchr(p + 1, c, end - p - 1));
+				p = q ? q + 1 : end;
+			}
+		}
+		if ( interval ) {
+			double t = record_time(rb, re + 1 < end ? re + 1 : end, cf->marker);
+			if ( t >= tstop )
+				return;
+			if ( t < tstart )
+				continue;
+		}
+		cf->rec_begin.push_back(rb - base);
+		cf->rec_end.push_back(re - base);
+	}
+}
+
+//
+// Field parsing
+//
+
+const double pow10tab[23] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+// Parse a decimal number. Short inputs are converted exactly with one
+// rounding (Clinger's fast path), anything else is handed to strtod.
+double parse_double(const char *b, const char *e)
+{
+	const char *p = b;
+	bool neg = false;
+	uint64_t mant = 0;
+	int ndig = 0, exp10 = 0;
+
+	if ( p < e && (*p == '-' || *p == '+') )
+		neg = *p++ == '-';
+	const char *digits = p;
+	for ( ; p < e && *p >= '0' && *p <= '9'; p++ )
+		if ( mant || *p != '0' ) {
+			mant = mant*10 + (*p - '0');
+			ndig++;
+		}
+	if ( p < e && *p == '.' ) {
+		for ( p++; p < e && *p >= '0' && *p <= '9'; p++ ) {
+			if ( mant || *p != '0' ) {
+				mant = mant*10 + (*p - '0');
+				ndig++;
+			}
+			exp10--;
+		}
+	}
+	if ( p == digits )
+		goto slow;
+	if ( p < e && (*p == 'e' || *p == 'E') ) {
+		bool eneg = false;
+		int ex = 0;
+		p++;
+		if ( p < e && (*p == '-' || *p == '+') )
+			eneg = *p++ == '-';
+		if ( p >= e || *p < '0' || *p > '9' )
+			goto slow;
+		for ( ; p < e && *p >= '0' && *p <= '9'; p++ )
+			if ( ex < 10000 )
+				ex = ex*10 + (*p - '0');
+		exp10 += eneg ? -ex : ex;
+	}
+	if ( p != e || ndig > 15 || exp10 < -22 || exp10 > 22 )
+		goto slow;
+	{
+		double v = (double)mant;
+		v = exp10 >= 0 ? v * pow10tab[exp10] : v / pow10tab[-exp10];
+		return neg ? -v : v;
+	}
+
+slow:
+	char buf[128];
+	size_t n = std::min<size_t>(e - b, sizeof(buf) - 1);
+	memcpy(buf, b, n);
+	buf[n] = '\0';
+	char *ep;
+	double v = strtod(buf, &ep);
+	return ep == buf ? NAN : v;
+}
+
+int32_t parse_int(const char *b, const char *e)
+{
+	const char *p = b;
+	bool neg = false;
+	int64_t v = 0;
+
+	if ( p < e && (*p == '-' || *p == '+') )
+		neg = *p++ == '-';
+	if ( p == e )
+		return 0;
+	for ( ; p < e && *p >= '0' && *p <= '9'; p++ )
+		v = v*10 + (*p - '0');
+	if ( p != e )	// 7.0, 1e3 ...
+		return (int32_t)lrint(parse_double(b, e));
+	return (int32_t)(neg ? -v : v);
+}
+
+inline int64_t days_from_civil(int64_t y, unsigned m, unsigned d)
+{
+	y -= m <= 2;
+	const int64_t era = (y >= 0 ? y : y - 399) / 400;
+	const unsigned yoe = (unsigned)(y - era * 400);
+	const unsigned doy = (153*(m + (m > 2 ? -3 : 9)) + 2)/5 + d - 1;
+	const unsigned doe = yoe * 365 + yoe/4 - yoe/100 + doy;
+	return era * 146097 + (int64_t)doe - 719468;
+}
+
+const int64_t DAYS_1958 = days_from_civil(1958, 1, 1);
+
+inline bool get_digits(const char *&p, const char *e, int n, int &v)
+{
+	v = 0;
+	for ( int k = 0; k < n; k++, p++ ) {
+		if ( p >= e || *p < '0' || *p > '9' )
+			return false;
+		v = v*10 + (*p - '0');
+	}
+	return true;
+}
+
+// ISO time "YYYY-MM-DDThh:mm:ss.ffffffZ" to milliseconds since 1958
+double parse_iso_time(const char *b, const char *e)
+{
+	const char *p = b;
+	int y, mo, d, h = 0, mi = 0, s = 0;
+
+	if ( !get_digits(p, e, 4, y) || p >= e || *p++ != '-' ||
+			!get_digits(p, e, 2, mo) || p >= e || *p++ != '-' ||
+			!get_digits(p, e, 2, d) )
+		return NAN;
+	if ( p < e && (*p == 'T' || *p == ' ') ) {
+		p++;
+		if ( !get_digits(p, e, 2, h) )
+			return NAN;
+		if ( p < e && *p == ':' ) {
+			p++;
+			if ( !get_digits(p, e, 2, mi) )
+				return NAN;
+			if ( p < e && *p == ':' ) {
+				p++;
+				if ( !get_digits(p, e, 2, s) )
+					return NAN;
+			}
+		}
+	}
+	double frac = 0;
+	if ( p < e && *p == '.' ) {
+		int64_t f = 0, scale = 1;
+		for ( p++; p < e && *p >= '0' && *p <= '9'; p++ )
+			if ( scale < 1000000000000LL ) {
+				f = f*10 + (*p - '0');
+				scale *= 10;
+			}
+		frac = (double)f * 1000.0 / (double)scale;
+	}
+	if ( p < e && *p == 'Z' )
+		p++;
+	if ( p != e )
+		return NAN;
+
+	int64_t days = days_from_civil(y, mo, d) - DAYS_1958;
+	return (double)((days*86400 + h*3600 + mi*60 + s) * 1000) + frac;
+}
+
+// Store one field of variable V at value index K
+inline void store_field(Variable &v, size_t k, const char *b, const char *e)
+{
+	switch ( v.type ) {
+	case VT_FLOAT:
+		v.f[k] = b == e ? NAN : (float)parse_double(b, e);
+		break;
+	case VT_DOUBLE:
+		v.d[k] = b == e ? NAN : parse_double(b, e);
+		break;
+	case VT_INT:
+		v.i[k] = parse_int(b, e);
+		break;
+	case VT_BYTE:
+		v.b[k] = (uint8_t)parse_int(b, e);
+		break;
+	case VT_ISO_TIME:
+		v.d[k] = parse_iso_time(b, e);
+		break;
+	case VT_ISO_TIME_RANGE: {
+		const char *sl = static_cast<const char *>(memchr(b, '/', e - b));
+		v.d[2*k] = parse_iso_time(b, sl ? sl : e);
+		v.d[2*k + 1] = sl ? parse_iso_time(sl + 1, e) : NAN;
+		break;
+	}
+	default:
+		v.s[k].assign(b, e);
+	}
+}
+
+void allocate_values(Variable &v, size_t n)
+{
+	switch ( v.type ) {
+	case VT_FLOAT: v.f.assign(n, NAN); break;
+	case VT_INT: v.i.assign(n, 0); break;
+	case VT_BYTE: v.b.assign(n, 0); break;
+	case VT_ISO_TIME_RANGE: v.d.assign(2*n, NAN); break;
+	case VT_CHAR: v.s.assign(n, std::string()); break;
+	default: v.d.assign(n, NAN);
+	}
+}
+
+// Next field of a record, returns false at the end of the record
+inline bool next_field(const char *&p, const char *e, const char *&fb, const char *&fe)
+{
+	for (;;) {
+		while ( p < e && is_blank(*p) ) p++;
+		if ( p < e && *p == '!' ) {
+			const char *nl = static_cast<const char *>(memchr(p, '\n', e - p));
+			p = nl ? nl : e;
+			continue;
+		}
+		break;
+	}
+	if ( p >= e )
+		return false;
+	if ( *p == '"' || *p == '\'' ) {
+		char q = *p++;
+		fb = p;
+		const char *qe = static_cast<const char *>(memchr(p, q, e - p));
+		fe = qe ? qe : e;
+		p = qe ? qe + 1 : e;
+		while ( p < e && *p != ',' ) p++;
+	} else {
+		fb = p;
+		const char *c = static_cast<const char *>(memchr(p, ',', e - p));
+		p = c ? c : e;
+		fe = p;
+		while ( fe > fb && is_blank(fe[-1]) ) fe--;
+	}
+	if ( p < e )
+		p++;	// ','
+	return true;
+}
+
+// First of ',', quotes or '!' in [p,end)
+inline const char *scan_delim(const char *p, const char *end)
+{
+#if defined(__SSE2__)
+	const __m128i vc = _mm_set1_epi8(',');
+	const __m128i vq = _mm_set1_epi8('"');
+	const __m128i va = _mm_set1_epi8('\'');
+	const __m128i vx = _mm_set1_epi8('!');
+	while ( p + 16 <= end ) {
+		__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+		__m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(c, vc), _mm_cmpeq_epi8(c, vq)),
+				_mm_or_si128(_mm_cmpeq_epi8(c, va), _mm_cmpeq_epi8(c, vx)));
+		int mask = _mm_movemask_epi8(m);
+		if ( mask )
+			return p + __builtin_ctz(mask);
+		p += 16;
+	}
+#endif
+	for ( ; p < end; p++ )
+		if ( *p == ',' || *p == '"' || *p == '\'' || *p == '!' )
+			return p;
+	return end;
+}
+
+// Skip N fields by counting delimiters, false if the record is shorter
+inline bool skip_fields(const char *&p, const char *e, size_t n)
+{
+	while ( n > 0 ) {
+		p = scan_delim(p, e);
+		if ( p >= e )
+			return false;
+		char c = *p++;
+		if ( c == ',' )
+			n--;
+		else if ( c == '!' ) {
+			const char *nl = static_cast<const char *>(memchr(p, '\n', e - p));
+			p = nl ? nl : e;
+		} else {
+			const char *q = static_cast<const char *>(memchr(p, c, e - p));
+			p = q ? q + 1 : e;
+		}
+	}
+	return true;
+}
+
+// Parse the fields of variable V in records [r0,r1), the fields before
+// it are skipped without being tokenised
+void parse_var_range(const CefFile *cf, Variable *v, size_t r0, size_t r1,
+		std::atomic<size_t> *nbad)
+{
+	const char *base = cf->src.data;
+	size_t bad = 0;
+
+	for ( size_t r = r0; r < r1; r++ ) {
+		const char *p = base + cf->rec_begin[r], *e = base + cf->rec_end[r];
+		const char *fb, *fe;
+		size_t k = 0;
+		if ( skip_fields(p, e, v->col) )
+			for ( ; k < v->nelem; k++ ) {
+				if ( !next_field(p, e, fb, fe) )
+					break;
+				store_field(*v, r*v->nelem + k, fb, fe);
+			}
+		if ( k < v->nelem )
+			bad++;
+	}
+	*nbad += bad;
+}
+
+int thread_count(size_t nrec)
+{
+	int n = nthreads_opt > 0 ? nthreads_opt : (int)std::thread::hardware_concurrency();
+	size_t max_by_size = nrec / 4096 + 1;	// not worth a thread for few records
+	if ( n < 1 )
+		n = 1;
+	if ( (size_t)n > max_by_size )
+		n = (int)max_by_size;
+	return n;
+}
+
+// Parse a record-varying variable on first use, records are split
+// between threads
+size_t parse_variable(CefFile *cf, Variable &v)
+{
+	allocate_values(v, cf->nrec * v.nelem);
+
+	std::atomic<size_t> nbad(0);
+	int nt = thread_count(cf->nrec);
+	if ( nt == 1 )
+		parse_var_range(cf, &v, 0, cf->nrec, &nbad);
+	else {
+		std::vector<std::thread> th;
+		size_t chunk = (cf->nrec + nt - 1) / nt;
+		for ( int t = 0; t < nt; t++ ) {
+			size_t r0 = std::min(cf->nrec, t*chunk), r1 = std::min(cf->nrec, r0 + chunk);
+			th.push_back(std::thread(parse_var_range, cf, &v, r0, r1, &nbad));
+		}
+		for ( std::thread &t : th )
+			t.join();
+	}
+	v.parsed = true;
+	if ( nbad && verbosity > 0 )
+		mexPrintf("WARNING : %lu records with missing values for %s\n",
+				(unsigned long)nbad, v.name.c_str());
+	return nbad;
+}
+
+// Values of variables given by the DATA attribute
+void parse_constants(CefFile *cf)
+{
+	for ( Variable &v : cf->vars ) {
+		if ( v.varying )
+			continue;
+		const Attr *a = find_attr(v.attrs, "DATA");
+		allocate_values(v, v.nelem);
+		for ( size_t k = 0; k < v.nelem && k < a->values.size(); k++ ) {
+			const std::string &s = a->values[k];
+			store_field(v, k, s.data(), s.data() + s.size());
+		}
+	}
+}
+
+//
+// Time intervals
+//
+
+const size_t GZ_SPAN = 4 << 20;	// uncompressed bytes between checkpoints
+const size_t GZ_WINDOW = 32768;	// deflate dictionary
+const size_t GZ_CHUNK = 1 << 20;
+const size_t GZ_CACHE = 8;	// files for which checkpoints are kept
+
+// Restart point in a gzip file (as in zran.c from the zlib examples)
+struct GzPoint {
+	size_t in;	// compressed offset
+	int bits;	// bits of the byte before IN which belong to the block
+	size_t out;	// uncompressed offset
+	bool member;	// start of a gzip member, no dictionary needed
+	double t;	// time of the first record after OUT, NaN while unknown
+	std::vector<unsigned char> window;
+};
+
+struct GzIndex {
+	std::string path;
+	off_t size;
+	time_t mtime;
+	size_t covered;	// checkpoints are complete up to this offset
+	std::vector<GzPoint> points;
+	unsigned long used;
+};
+
+std::vector<GzIndex> gz_cache;
+unsigned long gz_clock = 0;
+
+// Checkpoints of a file, kept while the file is unchanged
+GzIndex &gz_index(const char *path, const struct stat &st)
+{
+	for ( GzIndex &ix : gz_cache )
+		if ( ix.path == path && ix.size == st.st_size && ix.mtime == st.st_mtime ) {
+			ix.used = ++gz_clock;
+			return ix;
+		}
+	if ( gz_cache.size() >= GZ_CACHE ) {
+		size_t old = 0;
+		for ( size_t k = 1; k < gz_cache.size(); k++ )
+			if ( gz_cache[k].used < gz_cache[old].used )
+				old = k;
+		gz_cache.erase(gz_cache.begin() + old);
+	}
+	GzIndex ix;
+	ix.path = path;
+	ix.size = st.st_size;
+	ix.mtime = st.st_mtime;
+	ix.covered = 0;
+	ix.used = ++gz_clock;
+	ix.points.push_back(GzPoint{0, 0, 0, true, -INFINITY, std::vector<unsigned char>()});
+	gz_cache.push_back(ix);
+	return gz_cache.back();
+}
+
+// True when the line at POS starts a record: the previous non-blank
+// character ends a record and the first field is a time tag (in *T)
+bool record_start_at(const CefFile *cf, const char *text, size_t size, size_t pos, double *t)
+{
+	if ( cf->marker ) {
+		size_t q = pos;
+		while ( q > 0 && is_blank(text[q - 1]) ) q--;
+		if ( q == 0 || text[q - 1] != cf->marker )
+			return false;
+	}
+	*t = record_time(text + pos, text + size, cf->marker);
+	return !std::isnan(*t);
+}
+
+// First record starting on a line at or after POS and before LIMIT
+size_t next_record_start(const CefFile *cf, const char *text, size_t size, size_t pos,
+		size_t limit, double *t)
+{
+	if ( pos > 0 && text[pos - 1] != '\n' )
+		pos = skip_line(text + pos, text + size) - text;
+	for ( ; pos < limit; pos = skip_line(text + pos, text + size) - text )
+		if ( record_start_at(cf, text, size, pos, t) )
+			return pos;
+	*t = NAN;
+	return limit;
+}
+
+// Bisect line starts in [lo,hi) for a record before TSTART, LO must be a
+// record start
+size_t locate_time(const CefFile *cf, size_t lo, size_t hi, double tstart)
+{
+	const char *text = cf->src.data;
+	double t;
+	while ( hi - lo > 65536 ) {
+		size_t mid = lo + (hi - lo) / 2;
+		size_t r = next_record_start(cf, text, cf->src.size, mid, hi, &t);
+		if ( r < hi && t < tstart )
+			lo = r;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+// Inflate from checkpoint PI until a record at or after TSTOP is complete
+// or the file ends. Checkpoints are added past ix.covered on the way.
+bool gz_inflate_from(const CefFile *cf, const unsigned char *in, size_t len, GzIndex &ix,
+		size_t pi, double tstop, std::vector<char> &out, size_t &win_off)
+{
+	const GzPoint p0 = ix.points[pi];
+	bool raw = !p0.member, ok = true;
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	if ( inflateInit2(&zs, raw ? -15 : 15 + 16) != Z_OK )
+		return false;
+	if ( raw ) {
+		if ( p0.bits )
+			inflatePrime(&zs, p0.bits, in[p0.in - 1] >> (8 - p0.bits));
+		inflateSetDictionary(&zs, p0.window.data(), p0.window.size());
+	}
+	zs.next_in = const_cast<Bytef *>(in + p0.in);
+	zs.avail_in = len - p0.in;
+
+	win_off = p0.out;
+	out.clear();
+	size_t have = 0, checked = 0;
+	for (;;) {
+		if ( out.size() < have + GZ_CHUNK )
+			out.resize(std::max(2*out.size(), have + GZ_CHUNK));
+		zs.next_out = reinterpret_cast<Bytef *>(&out[have]);
+		zs.avail_out = GZ_CHUNK;
+		int ret = inflate(&zs, Z_BLOCK);
+		have += GZ_CHUNK - zs.avail_out;
+		size_t pos = win_off + have;
+		bool add = pos > ix.covered && pos >= ix.points.back().out + GZ_SPAN;
+
+		if ( ret == Z_STREAM_END ) {
+			// next member, the raw stream leaves the gzip trailer
+			size_t next = zs.next_in - in + (raw ? 8 : 0);
+			while ( next < len && in[next] == 0 )
+				next++;
+			if ( next >= len )
+				break;
+			inflateReset2(&zs, 15 + 16);
+			raw = false;
+			zs.next_in = const_cast<Bytef *>(in + next);
+			zs.avail_in = len - next;
+			if ( add )
+				ix.points.push_back(GzPoint{next, 0, pos, true, NAN,
+						std::vector<unsigned char>()});
+		} else if ( ret == Z_BUF_ERROR && zs.avail_in == 0 )
+			break;	// truncated file
+		else if ( ret != Z_OK ) {
+			ok = false;
+			break;
+		} else if ( add && (zs.data_type & 128) && !(zs.data_type & 64) && have >= GZ_WINDOW ) {
+			const unsigned char *w = reinterpret_cast<unsigned char *>(&out[have - GZ_WINDOW]);
+			ix.points.push_back(GzPoint{(size_t)(zs.next_in - in), zs.data_type & 7, pos,
+					false, NAN, std::vector<unsigned char>(w, w + GZ_WINDOW)});
+		}
+
+		// records are sorted, stop at the first one past TSTOP
+		if ( have >= checked + GZ_CHUNK ) {
+			double t;
+			size_t r = next_record_start(cf, out.data(), have, checked, have, &t);
+			if ( r < have && t >= tstop )
+				break;
+			checked = have;
+		}
+	}
+	inflateEnd(&zs);
+	out.resize(have);
+	if ( win_off + have > ix.covered )
+		ix.covered = win_off + have;
+
+	for ( GzPoint &p : ix.points )
+		if ( std::isnan(p.t) && p.out >= win_off && p.out < win_off + have ) {
+			double t;
+			if ( next_record_start(cf, out.data(), have, p.out - win_off, have, &t) < have )
+				p.t = t;
+		}
+	return ok;
+}
+
+// Header of a gzip file, inflating more of it until DATA_UNTIL is found
+bool gz_read_header(CefFile *cf, const unsigned char *in, size_t len, const char *filename)
+{
+	std::vector<char> text;
+	for ( size_t limit = 1 << 18; ; limit *= 4 ) {
+		if ( !inflate_all(in, len, text, limit) )
+			return false;
+		cf->gattrs.clear();
+		cf->metas.clear();
+		cf->vars.clear();
+		cf->includes.clear();
+		bool ok = parse_header(cf, text.data(), text.size(), dirname_of(filename), false, 0);
+		if ( ok && (cf->data_start < text.size() || text.size() < limit) )
+			return true;
+		if ( text.size() < limit )
+			return false;
+	}
+}
+
+// Interval selection needs the time tags in the first field
+bool time_first(const CefFile *cf)
+{
+	for ( const Variable &v : cf->vars )
+		if ( v.varying )
+			return v.col == 0 && v.nelem == 1 && v.type == VT_ISO_TIME;
+	return false;
+}
+
+//
+// Header cache
+//
+// Parsed headers are kept in memory, so that scanning many files for
+// metadata or reopening a file does not read and parse the header text
+// again. An entry is used while the file and its INCLUDE files keep their
+// device, inode, size and modification time.
+//
+
+const size_t HEADER_CACHE = 512;
+
+struct FileId {
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	time_t mtime;
+
+	bool operator==(const FileId &o) const
+	{
+		return dev == o.dev && ino == o.ino && size == o.size && mtime == o.mtime;
+	}
+};
+
+bool file_id(const char *path, FileId &id)
+{
+	struct stat st;
+	if ( stat(path, &st) != 0 )
+		return false;
+	id = FileId{st.st_dev, st.st_ino, st.st_size, st.st_mtime};
+	return true;
+}
+
+struct HeaderEntry {
+	FileId id;
+	std::vector<std::pair<std::string, FileId>> includes;
+	std::vector<Attr> gattrs;
+	std::vector<Meta> metas;
+	std::vector<Variable> vars;	// after setup_variables and parse_constants
+	size_t nfields;
+	char marker;
+	std::string data_until;
+	size_t data_start;
+	unsigned long used;
+};
+
+std::vector<HeaderEntry> header_cache;
+unsigned long header_clock = 0;
+
+bool header_lookup(CefFile *cf, const FileId &id)
+{
+	for ( HeaderEntry &h : header_cache ) {
+		if ( !(h.id == id) )
+			continue;
+		bool same = true;
+		for ( const auto &inc : h.includes ) {
+			FileId iid;
+			if ( !file_id(inc.first.c_str(), iid) || !(iid == inc.second) ) {
+				same = false;
+				break;
+			}
+		}
+		if ( !same )
+			return false;
+		h.used = ++header_clock;
+		cf->gattrs = h.gattrs;
+		cf->metas = h.metas;
+		cf->vars = h.vars;
+		cf->nfields = h.nfields;
+		cf->marker = h.marker;
+		cf->data_until = h.data_until;
+		cf->data_start = h.data_start;
+		for ( const auto &inc : h.includes )
+			cf->includes.push_back(inc.first);
+		return true;
+	}
+	return false;
+}
+
+void header_store(const CefFile *cf, const FileId &id)
+{
+	HeaderEntry h;
+	h.id = id;
+	for ( const std::string &path : cf->includes ) {
+		FileId iid;
+		if ( !file_id(path.c_str(), iid) )
+			return;
+		h.includes.push_back(std::make_pair(path, iid));
+	}
+	h.gattrs = cf->gattrs;
+	h.metas = cf->metas;
+	h.vars = cf->vars;
+	h.nfields = cf->nfields;
+	h.marker = cf->marker;
+	h.data_until = cf->data_until;
+	h.data_start = cf->data_start;
+	h.used = ++header_clock;
+
+	for ( HeaderEntry &old : header_cache )
+		if ( old.id == id ) {
+			old = std::move(h);
+			return;
+		}
+	if ( header_cache.size() >= HEADER_CACHE ) {
+		size_t old = 0;
+		for ( size_t k = 1; k < header_cache.size(); k++ )
+			if ( header_cache[k].used < header_cache[old].used )
+				old = k;
+		header_cache.erase(header_cache.begin() + old);
+	}
+	header_cache.push_back(std::move(h));
+}
+
+// Header of FILENAME from the cache or from FILE, which is mapped here
+// when the caller has not opened it
+int read_header(CefFile *cf, const char *filename, Source &file)
+{
+	FileId id;
+	bool have_id = file_id(filename, id);
+	if ( have_id && header_lookup(cf, id) )
+		return CEF_OK;
+
+	if ( file.data == nullptr && !map_file(filename, file) )
+		return CEF_ERR_OPEN;
+	bool ok;
+	if ( is_gzip(file) )
+		ok = gz_read_header(cf, reinterpret_cast<const unsigned char *>(file.data),
+				file.size, filename);
+	else
+		ok = parse_header(cf, file.data, file.size, dirname_of(filename), false, 0);
+	if ( !ok )
+		return CEF_ERR_HEADER;
+	setup_variables(cf);
+	parse_constants(cf);
+	if ( have_id )
+		header_store(cf, id);
+	return CEF_OK;
+}
+
+//
+// Column cache
+//
+
+// Opt-in cache of parsed variables. Every source file gets a directory
+// below cache.dir named after a hash of its path, size and mtime, with a
+// manifest and one column file per parsed variable: a 64 byte header
+// followed by the values as stored in memory (ISO_TIME as the double
+// milliseconds returned by cef_var). The manifest mtime is the LRU clock
+// and the least recently used entries are removed beyond cache.max_bytes.
+// cache.used counts the bytes of the directory as of the last scan plus
+// those written since, so that only a store beyond the limit scans the
+// directory again; trimming goes 1/8 below the limit so the next stores
+// do not scan at once.
+
+struct CacheConfig {
+	std::string dir;
+	uint64_t max_bytes = (uint64_t)2 << 30;
+	uint64_t used = 0;
+} cache;
+
+const char CACHE_MAGIC[8] = { 'C', 'E', 'F', 'C', 'O', 'L', '1', '\0' };
+
+struct ColumnHeader {
+	char magic[8];
+	uint32_t type;
+	uint32_t elem_size;
+	uint64_t nrec;
+	uint64_t nelem;
+	char pad[32];
+};
+
+struct CacheKey {
+	std::string path;
+	uint64_t size;
+	int64_t mtime;
+};
+
+bool cache_key(const char *filename, CacheKey &key)
+{
+	char real[PATH_MAX];
+	struct stat st;
+	if ( realpath(filename, real) == nullptr || stat(real, &st) != 0 )
+		return false;
+	key.path = real;
+	key.size = st.st_size;
+	key.mtime = st.st_mtime;
+	return true;
+}
+
+std::string cache_entry_dir(const CacheKey &key)
+{
+	// FNV-1a
+	uint64_t h = 14695981039346656037ULL;
+	std::string id = key.path + '\0' + std::to_string(key.size) + '\0' +
+		std::to_string(key.mtime);
+	for ( unsigned char c : id ) {
+		h ^= c;
+		h *= 1099511628211ULL;
+	}
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", (unsigned long long)h);
+	return cache.dir + "/" + name;
+}
+
+// Number of records of a cached file, false if there is no valid entry
+bool cache_lookup(const std::string &entry, const CacheKey &key, size_t *nrec)
+{
+	std::string manifest = entry + "/manifest";
+	FILE *fp = fopen(manifest.c_str(), "r");
+	if ( fp == nullptr )
+		return false;
+	char path[PATH_MAX + 16];
+	unsigned long long size, n;
+	long long mtime;
+	bool ok = fgets(path, sizeof(path), fp) != nullptr &&
+		fscanf(fp, "%llu %lld %llu", &size, &mtime, &n) == 3;
+	fclose(fp);
+	if ( !ok )
+		return false;
+	path[strcspn(path, "\n")] = '\0';
+	if ( key.path != path || key.size != size || key.mtime != mtime )
+		return false;
+	utimes(manifest.c_str(), nullptr);	// LRU
+	*nrec = n;
+	return true;
+}
+
+// Write FILE through a temporary name so that readers never see it partial
+bool cache_write(const std::string &file, const void *head, size_t head_len,
+		const void *data, size_t len)
+{
+	std::string tmp = file + ".tmp" + std::to_string(getpid());
+	FILE *fp = fopen(tmp.c_str(), "wb");
+	if ( fp == nullptr )
+		return false;
+	bool ok = fwrite(head, 1, head_len, fp) == head_len &&
+		(len == 0 || fwrite(data, 1, len, fp) == len);
+	ok = fclose(fp) == 0 && ok;
+	if ( ok )
+		ok = rename(tmp.c_str(), file.c_str()) == 0;
+	if ( !ok )
+		unlink(tmp.c_str());
+	return ok;
+}
+
+bool cache_create(const std::string &entry, const CacheKey &key, size_t nrec)
+{
+	mkdir(cache.dir.c_str(), 0777);
+	if ( mkdir(entry.c_str(), 0777) != 0 && errno != EEXIST )
+		return false;
+	std::string text = key.path + "\n" + std::to_string(key.size) + " " +
+		std::to_string(key.mtime) + " " + std::to_string(nrec) + "\n";
+	if ( !cache_write(entry + "/manifest", text.data(), text.size(), nullptr, 0) )
+		return false;
+	cache.used += text.size();
+	return true;
+}
+
+std::string column_file(const CefFile *cf, const Variable &v)
+{
+	return cf->cache_entry + "/" + std::to_string(&v - cf->vars.data()) + ".col";
+}
+
+// Storage of a parsed variable, null for CHAR which is not cached
+const void *column_data(const Variable &v, size_t *elem_size)
+{
+	switch ( v.type ) {
+	case VT_FLOAT: *elem_size = sizeof(float); return v.f.data();
+	case VT_INT: *elem_size = sizeof(int32_t); return v.i.data();
+	case VT_BYTE: *elem_size = 1; return v.b.data();
+	case VT_ISO_TIME_RANGE: *elem_size = 2*sizeof(double); return v.d.data();
+	case VT_CHAR: return nullptr;
+	default: *elem_size = sizeof(double); return v.d.data();
+	}
+}
+
+// Values of V in its column file, which is mapped into COL. They are
+// copied from the mapping straight into the MATLAB array; null if V is
+// not cached.
+const void *cache_map(const CefFile *cf, const Variable &v, Source &col)
+{
+	if ( cf->cache_entry.empty() || v.type == VT_CHAR )
+		return nullptr;
+	size_t esz = 0;
+	column_data(v, &esz);
+	if ( !map_file(column_file(cf, v).c_str(), col) || col.size < sizeof(ColumnHeader) )
+		return nullptr;
+	ColumnHeader h;
+	memcpy(&h, col.data, sizeof(h));
+	if ( memcmp(h.magic, CACHE_MAGIC, 8) != 0 || h.type != (uint32_t)v.type ||
+			h.elem_size != esz || h.nrec != cf->nrec || h.nelem != v.nelem ||
+			col.size != sizeof(h) + h.nrec * h.nelem * h.elem_size )
+		return nullptr;
+	return col.data + sizeof(h);
+}
+
+uint64_t dir_size(const std::string &dir)
+{
+	uint64_t total = 0;
+	DIR *d = opendir(dir.c_str());
+	if ( d == nullptr )
+		return 0;
+	while ( struct dirent *e = readdir(d) ) {
+		struct stat st;
+		if ( e->d_name[0] != '.' && stat((dir + "/" + e->d_name).c_str(), &st) == 0 )
+			total += st.st_size;
+	}
+	closedir(d);
+	return total;
+}
+
+void remove_dir(const std::string &dir)
+{
+	DIR *d = opendir(dir.c_str());
+	if ( d == nullptr )
+		return;
+	while ( struct dirent *e = readdir(d) )
+		if ( e->d_name[0] != '.' )
+			unlink((dir + "/" + e->d_name).c_str());
+	closedir(d);
+	rmdir(dir.c_str());
+}
+
+// Remove least recently used entries until the cache fits, KEEP is spared
+void cache_trim(const std::string &keep)
+{
+	struct Entry {
+		std::string dir;
+		time_t used;
+		uint64_t size;
+	};
+	std::vector<Entry> entries;
+	uint64_t total = 0;
+
+	DIR *d = opendir(cache.dir.c_str());
+	if ( d == nullptr )
+		return;
+	while ( struct dirent *e = readdir(d) ) {
+		if ( e->d_name[0] == '.' )
+			continue;
+		std::string dir = cache.dir + "/" + e->d_name;
+		struct stat st;
+		if ( stat((dir + "/manifest").c_str(), &st) != 0 )
+			continue;
+		entries.push_back(Entry{dir, st.st_mtime, dir_size(dir)});
+		total += entries.back().size;
+	}
+	closedir(d);
+	cache.used = total;
+	if ( total <= cache.max_bytes )
+		return;
+
+	uint64_t target = cache.max_bytes - cache.max_bytes / 8;
+	std::sort(entries.begin(), entries.end(),
+			[](const Entry &a, const Entry &b) { return a.used < b.used; });
+	for ( const Entry &e : entries ) {
+		if ( total <= target )
+			break;
+		if ( e.dir == keep )
+			continue;
+		remove_dir(e.dir);
+		total -= e.size;
+		if ( verbosity > 1 )
+			mexPrintf("cef_mx: removed %s from the cache\n", e.dir.c_str());
+	}
+	cache.used = total;
+}
+
+void cache_store(CefFile *cf, const Variable &v)
+{
+	size_t esz = 0;
+	const void *data = column_data(v, &esz);
+	if ( data == nullptr || cf->cache_entry.empty() )
+		return;
+	ColumnHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, CACHE_MAGIC, 8);
+	h.type = v.type;
+	h.elem_size = esz;
+	h.nrec = cf->nrec;
+	h.nelem = v.nelem;
+	size_t len = cf->nrec * v.nelem * esz;
+	if ( !cache_write(column_file(cf, v), &h, sizeof(h), data, len) ) {
+		if ( verbosity > 0 )
+			mexPrintf("WARNING : cannot write %s to the cache\n", v.name.c_str());
+		return;
+	}
+	cache.used += sizeof(h) + len;
+	if ( cache.used > cache.max_bytes )
+		cache_trim(cf->cache_entry);
+}
+
+// Records of a file opened from the cache or by cef_read_header are only
+// indexed when a variable has to be parsed
+bool ensure_indexed(CefFile *cf)
+{
+	if ( cf->indexed )
+		return true;
+	if ( cf->src.data == nullptr || is_gzip(cf->src) ) {
+		cf->src.release();
+		if ( !load_source(cf->filename.c_str(), cf->src) )
+			return false;
+	}
+	index_records(cf, cf->data_start);
+	cf->indexed = true;
+	if ( cf->rec_begin.size() != cf->nrec ) {
+		cf->nrec = cf->rec_begin.size();
+		for ( Variable &v : cf->vars )
+			if ( v.varying )
+				v.parsed = false;
+		if ( !cf->cache_entry.empty() ) {
+			mexPrintf("WARNING : %s changed, cache entry dropped\n", cf->filename.c_str());
+			remove_dir(cf->cache_entry);
+			cf->cache_entry.clear();
+		}
+	}
+	return true;
+}
+
+//
+// MATLAB output
+//
+
+mxArray *string_list(const std::vector<std::string> &list)
+{
+	mxArray *out = mxCreateCellMatrix(list.size(), 1);
+	for ( size_t k = 0; k < list.size(); k++ )
+		mxSetCell(out, k, mxCreateString(list[k].c_str()));
+	return out;
+}
+
+mxArray *attr_value(const Attr *a)
+{
+	if ( a->values.size() == 1 )
+		return mxCreateString(a->values[0].c_str());
+	return string_list(a->values);
+}
+
+// N records of V, VALUES as returned by column_data
+mxArray *variable_array(const Variable &v, size_t n, const void *values)
+{
+	std::vector<mwSize> dims(v.sizes.rbegin(), v.sizes.rend());
+	dims.push_back(n);
+	size_t count = v.nelem * n;
+	mxArray *out;
+
+	switch ( v.type ) {
+	case VT_FLOAT:
+		out = mxCreateNumericArray(dims.size(), dims.data(), mxSINGLE_CLASS, mxREAL);
+		if ( count )
+			memcpy(mxGetData(out), values, count * sizeof(float));
+		break;
+	case VT_INT:
+		out = mxCreateNumericArray(dims.size(), dims.data(), mxINT32_CLASS, mxREAL);
+		if ( count )
+			memcpy(mxGetData(out), values, count * sizeof(int32_t));
+		break;
+	case VT_BYTE:
+		out = mxCreateNumericArray(dims.size(), dims.data(), mxUINT8_CLASS, mxREAL);
+		if ( count )
+			memcpy(mxGetData(out), values, count);
+		break;
+	case VT_ISO_TIME_RANGE: {
+		const char *fields[] = { "start", "stop" };
+		const double *d = static_cast<const double *>(values);
+		out = mxCreateStructArray(dims.size(), dims.data(), 2, fields);
+		for ( size_t k = 0; k < count; k++ ) {
+			mxSetFieldByNumber(out, k, 0, mxCreateDoubleScalar(d[2*k]));
+			mxSetFieldByNumber(out, k, 1, mxCreateDoubleScalar(d[2*k + 1]));
+		}
+		break;
+	}
+	case VT_CHAR:
+		out = mxCreateCellArray(dims.size(), dims.data());
+		for ( size_t k = 0; k < count; k++ )
+			mxSetCell(out, k, mxCreateString(v.s[k].c_str()));
+		break;
+	default:
+		out = mxCreateNumericArray(dims.size(), dims.data(), mxDOUBLE_CLASS, mxREAL);
+		if ( count )
+			memcpy(mxGetData(out), values, count * sizeof(double));
+	}
+	return out;
+}
+
+// Milliseconds since 1958 to ISO string with DIGITS fractional digits.
+// As in CEFLIB whole seconds are truncated and fractions are rounded,
+// but a rounded fraction carries into the seconds (CEFLIB prints :60).
+void milli_to_iso(double ms, int digits, char *out)
+{
+	if ( !std::isfinite(ms) ) {
+		strcpy(out, "NaN");
+		return;
+	}
+	int64_t scale = 1;
+	for ( int k = 0; k < digits; k++ )
+		scale *= 10;
+	// seconds within the minute are rounded the way printf does it
+	double minute = std::floor(ms / 60000.0);
+	double isec = std::floor(ms / 1000.0);
+	double x = (isec - minute * 60.0) + (ms - isec * 1000.0) / 1000.0;
+	int64_t sub;
+	if ( digits ) {
+		char buf[32];
+		snprintf(buf, sizeof(buf), "%.*f", digits, x);
+		char *dot = strchr(buf, '.');
+		sub = strtoll(buf, nullptr, 10) * scale + strtoll(dot + 1, nullptr, 10);
+	} else
+		sub = (int64_t)std::floor(x);
+	sub += (int64_t)minute * 60 * scale;
+	int64_t sec = sub / scale, frac = sub % scale;
+	if ( frac < 0 ) {
+		frac += scale;
+		sec--;
+	}
+	int64_t days = sec / 86400, sod = sec % 86400;
+	if ( sod < 0 ) {
+		sod += 86400;
+		days--;
+	}
+
+	// civil_from_days
+	int64_t z = days + DAYS_1958 + 719468;
+	const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+	const unsigned doe = (unsigned)(z - era * 146097);
+	const unsigned yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+	const unsigned doy = doe - (365*yoe + yoe/4 - yoe/100);
+	const unsigned mp = (5*doy + 2)/153;
+	const unsigned d = doy - (153*mp + 2)/5 + 1;
+	const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+	const int64_t y = (int64_t)yoe + era * 400 + (m <= 2);
+
+	int n = sprintf(out, "%04d-%02u-%02uT%02d:%02d:%02d", (int)y, m, d,
+			(int)(sod/3600), (int)(sod/60%60), (int)(sod%60));
+	if ( digits > 0 )
+		n += sprintf(out + n, ".%0*lld", digits, (long long)frac);
+	strcpy(out + n, "Z");
+}
+
+bool no_file()
+{
+	if ( cur )
+		return false;
+	mexPrintf("ERROR : no CEF file loaded\n");
+	return true;
+}
+
+} // namespace
+
+//
+// libcef.h API
+//
+
+int cef_read(char *filename)
+{
+	cef_close();
+
+	CefFile *cf = new CefFile();
+	cf->filename = filename;
+	if ( verbosity > 0 )
+		mexPrintf("Reading file %s, please wait...\n", filename);
+
+	CacheKey key;
+	std::string entry;
+	size_t cached_nrec = 0;
+	bool hit = false;
+	if ( !cache.dir.empty() && cache_key(filename, key) ) {
+		entry = cache_entry_dir(key);
+		hit = cache_lookup(entry, key, &cached_nrec);
+	}
+
+	// a cached file only needs its header
+	bool ok = hit ? map_file(filename, cf->src) : load_source(filename, cf->src);
+	if ( !ok ) {
+		if ( verbosity > 0 )
+			mexPrintf("ERROR : cannot read %s\n", filename);
+		delete cf;
+		return CEF_ERR_OPEN;
+	}
+	if ( read_header(cf, filename, cf->src) != CEF_OK ) {
+		if ( verbosity > 0 )
+			mexPrintf("ERROR : no DATA_UNTIL in %s\n", filename);
+		delete cf;
+		return CEF_ERR_HEADER;
+	}
+	if ( is_gzip(cf->src) )
+		cf->src.release();
+
+	if ( hit ) {
+		cf->nrec = cached_nrec;
+		cf->indexed = false;
+		cf->cache_entry = entry;
+	} else {
+		index_records(cf, cf->data_start);
+		cf->nrec = cf->rec_begin.size();
+		if ( !entry.empty() && cache_create(entry, key, cf->nrec) )
+			cf->cache_entry = entry;
+	}
+
+	// values are parsed by cef_var, the text stays mapped until cef_close
+	cur = cf;
+	if ( verbosity > 0 )
+		mexPrintf("%lu variables and %lu records read\n",
+				(unsigned long)cf->vars.size(), (unsigned long)cf->nrec);
+	return CEF_OK;
+}
+
+int cef_read_interval(char *filename, double tstart, double tstop)
+{
+	cef_close();
+
+	CefFile *cf = new CefFile();
+	cf->filename = filename;
+	if ( verbosity > 0 )
+		mexPrintf("Reading file %s, please wait...\n", filename);
+
+	Source file;
+	struct stat st;
+	if ( stat(filename, &st) != 0 || !map_file(filename, file) ) {
+		if ( verbosity > 0 )
+			mexPrintf("ERROR : cannot read %s\n", filename);
+		delete cf;
+		return CEF_ERR_OPEN;
+	}
+	const unsigned char *in = reinterpret_cast<const unsigned char *>(file.data);
+	bool gz = is_gzip(file);
+	if ( read_header(cf, filename, file) != CEF_OK ) {
+		if ( verbosity > 0 )
+			mexPrintf("ERROR : no DATA_UNTIL in %s\n", filename);
+		delete cf;
+		return CEF_ERR_HEADER;
+	}
+
+	if ( !time_first(cf) ) {
+		if ( verbosity > 0 )
+			mexPrintf("WARNING : no time tags in the first field, reading all records\n");
+		tstart = -INFINITY;
+		tstop = INFINITY;
+	}
+
+	size_t begin = cf->data_start;
+	if ( !gz )
+		cf->src.swap(file);
+	else {
+		// inflate from the last checkpoint before TSTART
+		GzIndex &ix = gz_index(filename, st);
+		size_t pi = 0, win_off;
+		for ( size_t k = 1; k < ix.points.size() && ix.points[k].t < tstart; k++ )
+			pi = k;
+		std::vector<char> text;
+		if ( !gz_inflate_from(cf, in, file.size, ix, pi, tstop, text, win_off) ) {
+			if ( verbosity > 0 )
+				mexPrintf("ERROR : cannot inflate %s\n", filename);
+			delete cf;
+			return CEF_ERR_OPEN;
+		}
+		cf->src.take(text);
+		if ( win_off > 0 ) {
+			double t;
+			begin = next_record_start(cf, cf->src.data, cf->src.size, 0, cf->src.size, &t);
+		}
+	}
+	if ( tstart > -INFINITY )
+		begin = locate_time(cf, begin, cf->src.size, tstart);
+	index_records(cf, begin, tstart, tstop);
+	cf->nrec = cf->rec_begin.size();
+
+	cur = cf;
+	if ( verbosity > 0 )
+		mexPrintf("%lu variables and %lu records read\n",
+				(unsigned long)cf->vars.size(), (unsigned long)cf->nrec);
+	return CEF_OK;
+}
+
+int cef_read_header(char *filename)
+{
+	cef_close();
+
+	CefFile *cf = new CefFile();
+	cf->filename = filename;
+	cf->indexed = false;
+
+	Source file;
+	int status = read_header(cf, filename, file);
+	if ( status != CEF_OK ) {
+		if ( verbosity > 0 ) {
+			if ( status == CEF_ERR_OPEN )
+				mexPrintf("ERROR : cannot read %s\n", filename);
+			else
+				mexPrintf("ERROR : no DATA_UNTIL in %s\n", filename);
+		}
+		delete cf;
+		return status;
+	}
+
+	// the records are only read if cef_var asks for a varying variable
+	cur = cf;
+	if ( verbosity > 1 )
+		mexPrintf("%lu variables in header of %s\n",
+				(unsigned long)cf->vars.size(), filename);
+	return CEF_OK;
+}
+
+int cef_close(void)
+{
+	delete cur;
+	cur = nullptr;
+	return 0;
+}
+
+void cef_verbosity(int level)
+{
+	verbosity = level;
+}
+
+void cef_cache(char *dir, double max_bytes)
+{
+	cache.dir = dir ? dir : "";
+	while ( cache.dir.size() > 1 && cache.dir.back() == '/' )
+		cache.dir.pop_back();
+	if ( max_bytes > 0 )
+		cache.max_bytes = (uint64_t)max_bytes;
+	if ( !cache.dir.empty() )
+		cache_trim("");
+}
+
+mxArray *cef_metanames(void)
+{
+	if ( no_file() )
+		return nullptr;
+	std::vector<std::string> names;
+	for ( const Meta &m : cur->metas )
+		names.push_back(m.name);
+	return string_list(names);
+}
+
+mxArray *cef_meta(char *meta)
+{
+	if ( no_file() )
+		return nullptr;
+	for ( const Meta &m : cur->metas )
+		if ( ci_equal(m.name, meta) )
+			return string_list(m.entries);
+	mexPrintf("Unknown %s metadata section\n", meta);
+	return nullptr;
+}
+
+mxArray *cef_gattributes(void)
+{
+	if ( no_file() )
+		return nullptr;
+	std::vector<std::string> names;
+	for ( const Attr &a : cur->gattrs )
+		names.push_back(a.name);
+	return string_list(names);
+}
+
+mxArray *cef_vattributes(char *varname)
+{
+	if ( no_file() )
+		return nullptr;
+	Variable *v = find_var(cur, varname);
+	if ( !v ) {
+		mexPrintf("ERROR : variable %s not found\n", varname);
+		return nullptr;
+	}
+	std::vector<std::string> names;
+	for ( const Attr &a : v->attrs )
+		names.push_back(a.name);
+	return string_list(names);
+}
+
+mxArray *cef_gattr(char *attribute)
+{
+	if ( no_file() )
+		return nullptr;
+	const Attr *a = find_attr(cur->gattrs, attribute);
+	if ( !a ) {
+		mexPrintf("ERROR : global attribute %s not found\n", attribute);
+		return nullptr;
+	}
+	return attr_value(a);
+}
+
+mxArray *cef_vattr(char *varname, char *attribute)
+{
+	if ( no_file() )
+		return nullptr;
+	Variable *v = find_var(cur, varname);
+	const Attr *a = v ? find_attr(v->attrs, attribute) : nullptr;
+	if ( !a ) {
+		mexPrintf("ERROR : attribute %s of variable %s not found\n", attribute, varname);
+		return nullptr;
+	}
+	return attr_value(a);
+}
+
+mxArray *cef_var(char *varname)
+{
+	if ( no_file() )
+		return nullptr;
+	Variable *v = find_var(cur, varname);
+	if ( !v ) {
+		mexPrintf("ERROR : variable %s not found\n", varname);
+		return nullptr;
+	}
+	Source col;
+	size_t esz;
+	const void *values = v->parsed ? nullptr : cache_map(cur, *v, col);
+	if ( !v->parsed && values == nullptr ) {
+		if ( !ensure_indexed(cur) ) {
+			mexPrintf("ERROR : cannot read %s\n", cur->filename.c_str());
+			return nullptr;
+		}
+		parse_variable(cur, *v);
+		cache_store(cur, *v);
+	}
+	if ( values == nullptr )
+		values = column_data(*v, &esz);
+	return variable_array(*v, v->varying ? cur->nrec : 1, values);
+}
+
+mxArray *cef_varnames(void)
+{
+	if ( no_file() )
+		return nullptr;
+	std::vector<std::string> names;
+	for ( const Variable &v : cur->vars )
+		names.push_back(v.name);
+	return string_list(names);
+}
+
+mxArray *cef_depends(char *varname)
+{
+	if ( no_file() )
+		return nullptr;
+	Variable *v = find_var(cur, varname);
+	if ( !v ) {
+		mexPrintf("ERROR : variable %s not found\n", varname);
+		return nullptr;
+	}
+	std::vector<std::string> deps(v->sizes.size() + 1);
+	for ( size_t k = 0; k < deps.size(); k++ ) {
+		const Attr *a = find_attr(v->attrs, "DEPEND_" + std::to_string(k));
+		if ( a && !a->values.empty() )
+			deps[k] = a->values[0];
+	}
+	return string_list(deps);
+}
+
+mxArray *milli_to_isotime(mxArray *var, int digits)
+{
+	if ( var == nullptr )
+		return nullptr;
+	if ( digits < 0 ) digits = 0;
+	if ( digits > 9 ) digits = 9;
+
+	size_t n = mxGetNumberOfElements(var);
+	mxArray *out = mxCreateCellArray(mxGetNumberOfDimensions(var), mxGetDimensions(var));
+	char buf[128];
+
+	if ( mxIsStruct(var) ) {
+		for ( size_t k = 0; k < n; k++ ) {
+			mxArray *a = mxGetFieldByNumber(var, k, 0), *b = mxGetFieldByNumber(var, k, 1);
+			milli_to_iso(a ? mxGetScalar(a) : NAN, digits, buf);
+			size_t len = strlen(buf);
+			buf[len++] = '/';
+			milli_to_iso(b ? mxGetScalar(b) : NAN, digits, buf + len);
+			mxSetCell(out, k, mxCreateString(buf));
+		}
+	} else if ( mxIsDouble(var) ) {
+		const double *ms = mxGetPr(var);
+		for ( size_t k = 0; k < n; k++ ) {
+			milli_to_iso(ms[k], digits, buf);
+			mxSetCell(out, k, mxCreateString(buf));
+		}
+	} else {
+		mxDestroyArray(out);
+		mexPrintf("ERROR : milli_to_isotime expects ISO_TIME or ISO_TIME_RANGE values\n");
+		return nullptr;
+	}
+	return out;
+}
+
+//
+// MEX gateway
+//
+
+namespace {
+
+std::string arg_string(int nrhs, const mxArray *prhs[], int k, const char *cmd)
+{
+	if ( nrhs <= k || !mxIsChar(prhs[k]) )
+		mexErrMsgIdAndTxt("cef_mx:input", "cef_mx('%s',...) expects a string argument", cmd);
+	char *s = mxArrayToString(prhs[k]);
+	std::string out(s);
+	mxFree(s);
+	return out;
+}
+
+double arg_scalar(int nrhs, const mxArray *prhs[], int k, const char *cmd)
+{
+	if ( nrhs <= k || !mxIsNumeric(prhs[k]) || mxGetNumberOfElements(prhs[k]) != 1 )
+		mexErrMsgIdAndTxt("cef_mx:input", "cef_mx('%s',...) expects a scalar argument", cmd);
+	return mxGetScalar(prhs[k]);
+}
+
+// Time as milliseconds since 1958 or an ISO string
+double arg_time(int nrhs, const mxArray *prhs[], int k, const char *cmd)
+{
+	if ( nrhs > k && mxIsChar(prhs[k]) ) {
+		std::string s = arg_string(nrhs, prhs, k, cmd);
+		double t = parse_iso_time(s.data(), s.data() + s.size());
+		if ( std::isnan(t) )
+			mexErrMsgIdAndTxt("cef_mx:input", "cannot parse time '%s'", s.c_str());
+		return t;
+	}
+	return arg_scalar(nrhs, prhs, k, cmd);
+}
+
+void close_at_exit()
+{
+	cef_close();
+}
+
+} // namespace
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	static bool first = true;
+	if ( first ) {
+		mexAtExit(close_at_exit);
+		first = false;
+	}
+	if ( nrhs < 1 || !mxIsChar(prhs[0]) )
+		mexErrMsgIdAndTxt("cef_mx:input", "First input must be a command string");
+
+	std::string cmd = arg_string(nrhs, prhs, 0, "");
+	const char *c = cmd.c_str();
+	std::string a1, a2;
+	mxArray *out = nullptr;
+
+	if ( cmd == "read" ) {
+		a1 = arg_string(nrhs, prhs, 1, c);
+		out = mxCreateDoubleScalar(cef_read(&a1[0]));
+	} else if ( cmd == "read_header" ) {
+		a1 = arg_string(nrhs, prhs, 1, c);
+		out = mxCreateDoubleScalar(cef_read_header(&a1[0]));
+	} else if ( cmd == "read_interval" ) {
+		a1 = arg_string(nrhs, prhs, 1, c);
+		double tstart = arg_time(nrhs, prhs, 2, c), tstop = arg_time(nrhs, prhs, 3, c);
+		out = mxCreateDoubleScalar(cef_read_interval(&a1[0], tstart, tstop));
+	} else if ( cmd == "close" )
+		out = mxCreateDoubleScalar(cef_close());
+	else if ( cmd == "verbosity" )
+		cef_verbosity((int)arg_scalar(nrhs, prhs, 1, c));
+	else if ( cmd == "cache" ) {
+		a1 = arg_string(nrhs, prhs, 1, c);
+		cef_cache(&a1[0], nrhs > 2 ? arg_scalar(nrhs, prhs, 2, c) : 0);
+	} else if ( cmd == "threads" )
+		nthreads_opt = (int)arg_scalar(nrhs, prhs, 1, c);
+	else if ( cmd == "metanames" )
+		out = cef_metanames();
+	else if ( cmd == "meta" ) {
+		a1 = arg_string(nrhs, prhs, 1, c);
+		out = cef_meta(&a1[0]);
+	} else if ( cmd == "gattributes" )
+		out = cef_gattributes();
+	else if ( cmd == "vattributes" ) {
+		a1 = arg_string(nrhs, prhs, 1, c);
+		out = cef_vattributes(&a1[0]);
+	} else if ( cmd == "gattr" ) {
+		a1 = arg_string(nrhs, prhs, 1, c);
+		out = cef_gattr(&a1[0]);
+	} else if ( cmd == "vattr" ) {
+		a1 = arg_string(nrhs, prhs, 1, c);
+		a2 = arg_string(nrhs, prhs, 2, c);
+		out = cef_vattr(&a1[0], &a2[0]);
+	} else if ( cmd == "var" ) {
+		a1 = arg_string(nrhs, prhs, 1, c);
+		out = cef_var(&a1[0]);
+	} else if ( cmd == "varnames" )
+		out = cef_varnames();
+	else if ( cmd == "depends" ) {
+		a1 = arg_string(nrhs, prhs, 1, c);
+		out = cef_depends(&a1[0]);
+	} else if ( cmd == "milli_to_isotime" ) {
+		if ( nrhs < 3 )
+			mexErrMsgIdAndTxt("cef_mx:input", "Usage: cef_mx('milli_to_isotime',VAR,DIGITS)");
+		out = milli_to_isotime(const_cast<mxArray *>(prhs[1]), (int)arg_scalar(nrhs, prhs, 2, c));
+	} else
+		mexErrMsgIdAndTxt("cef_mx:input", "Unknown command '%s'", c);
+
+	if ( nlhs > 0 || out )
+		plhs[0] = out ? out : mxCreateDoubleMatrix(0, 0, mxREAL);
+}
@@ -66,7 +66,10 @@ end
 
 matlabd = datenum(matlabd);
 
-onera_desp_lib_load;
+native = exist('onera_desp_lib_mx','file') == 3; % see onera_desp_lib_mx.c
+if ~native,
+    onera_desp_lib_load;
+end
 
 kext = onera_desp_lib_kext(kext);
 in_options = options;
@@ -88,6 +91,19 @@ maginput = onera_desp_lib_maginputs(maginput); % NaN to baddata
 
 Nbounce = 1000; % maximum size of bounce array
 Naz = 48; % number of azimuths
+if native,
+    [iyear,idoy,UT] = onera_desp_lib_matlabd2yds(matlabd);
+    [Lm,Lstar,Blocalar,Bmin,J,POSITarray,NPOSIT] = onera_desp_lib_mx('drift_shell',...
+        kext,options,sysaxes,iyear,idoy,UT,x1,x2,x3,maginput');
+    POSIT = cell(Naz,1);
+    Blocal = cell(Naz,1);
+    for i = 1:Naz,
+        n = NPOSIT(i);
+        POSIT{i} = squeeze(POSITarray(:,1:n,i))';
+        Blocal{i} = Blocalar(1:n,i);
+    end
+    return
+end
 Lm = nan;
 Lstar = Lm;
 Blocalar = repmat(nan,Nbounce,Naz);
@@ -82,7 +82,10 @@ end
 
 matlabd = datenum(matlabd);
 
-onera_desp_lib_load;
+native = exist('onera_desp_lib_mx','file') == 3; % see onera_desp_lib_mx.c
+if ~native,
+    onera_desp_lib_load;
+end
 
 ntime = length(x1);
 kext = onera_desp_lib_kext(kext);
@@ -105,6 +108,10 @@ maginput = onera_desp_lib_maginputs(maginput); % NaN to baddata
 
 
 [iyear,idoy,UT] = onera_desp_lib_matlabd2yds(matlabd);
+if native,
+    [Xfoot,Bfoot,BfootMag] = onera_desp_lib_mx('find_foot_point',...
+        kext,options,sysaxes,iyear,idoy,UT,x1,x2,x3,stop_alt,hemi_flag,maginput');
+else
 Xfoot = repmat(nan,ntime,3);
 Bfoot = repmat(nan,ntime,3);
 BfootMag = repmat(nan,ntime,1);
@@ -119,6 +126,7 @@ for i = 1:ntime,
     Bfoot(i,:) = get(BfootPtr,'value');
     BfootMag(i) = get(BfootMagPtr,'value');
 end
+end
 
 % the flag value is actually -1d31
 % BfootMag<=0 also indicates error
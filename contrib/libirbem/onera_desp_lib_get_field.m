@@ -61,7 +61,10 @@ end
 
 matlabd = datenum(matlabd);
 
-onera_desp_lib_load;
+native = exist('onera_desp_lib_mx','file') == 3; % see onera_desp_lib_mx.c
+if ~native,
+    onera_desp_lib_load;
+end
 
 ntime = length(x1);
 kext = onera_desp_lib_kext(kext);
@@ -82,6 +85,15 @@ end
 
 maginput = onera_desp_lib_maginputs(maginput); % NaN to baddata
 
+if native,
+    [iyear,idoy,UT] = onera_desp_lib_matlabd2yds(matlabd);
+    [Bgeo,B] = onera_desp_lib_mx('get_field',kext,options,sysaxes,iyear,idoy,UT,x1,x2,x3,maginput');
+    ibad = B>1e5; % artifact of baddata not being handled correctly
+    B(ibad) = nan;
+    Bgeo(ibad,:) = nan;
+    return
+end
+
 Nmax = onera_desp_lib_ntime_max; % maximum array size in fortran library
 if ntime > Nmax, % break up into multiple calls
     Bgeo = nan(ntime,3);
@@ -0,0 +1,72 @@
+function table = onera_desp_lib_lstar_table_load(filename)
+%***************************************************************************************************
+%
+% This file is part of IRBEM-LIB.
+%
+%    IRBEM-LIB is free software: you can redistribute it and/or modify
+%    it under the terms of the GNU Lesser General Public License as published by
+%    the Free Software Foundation, either version 3 of the License, or
+%    (at your option) any later version.
+%
+%    IRBEM-LIB is distributed in the hope that it will be useful,
+%    but WITHOUT ANY WARRANTY; without even the implied warranty of
+%    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+%    GNU Lesser General Public License for more details.
+%
+%    You should have received a copy of the GNU Lesser General Public License
+%    along with IRBEM-LIB.  If not, see <http://www.gnu.org/licenses/>.
+%
+%***************************************************************************************************
+%
+% function table = onera_desp_lib_lstar_table_load(filename)
+% opens an L* table written by onera_desp_lib_lstar_table_make
+% the grid and the inputs the table was computed with are read into the
+% fields filename, kext, options, sysaxes, matlabd, iact, maginput, x1,
+% x2, x3, act, alpha and n (grid size), the Lm, Lstar and Bmin arrays
+% are memory mapped (field data, see memmapfile), only the parts
+% onera_desp_lib_lstar_table_lookup interpolates in are read from disk
+% the fields offset.Lm, offset.Lstar and offset.Bmin are the positions
+% of the arrays in data.Data (in doubles, zero based)
+
+fid = fopen(filename,'r','ieee-le');
+if fid < 0,
+    error('%s: cannot open %s',mfilename,filename);
+end
+magic = fread(fid,[1 8],'*char');
+header = fread(fid,[1 63],'double');
+fclose(fid);
+if ~strcmp(magic,'IRBEMLUT') || (length(header) < 63),
+    error('%s: %s is not an L* table',mfilename,filename);
+end
+if header(1) ~= 1,
+    error('%s: %s has unsupported version %g',mfilename,filename,header(1));
+end
+
+table.filename = filename;
+table.n = header(2:6);
+table.kext = header(7);
+table.options = header(8:12);
+table.sysaxes = header(13);
+table.matlabd = header(14);
+table.iact = header(15);
+table.maginput = header(16:40);
+
+n = table.n;
+nv = sum(n); % grid vectors
+ngrid = prod(n);
+d = dir(filename);
+if d.bytes ~= 512+8*(nv+2*ngrid+prod(n(1:4))),
+    error('%s: %s is truncated',mfilename,filename);
+end
+table.data = memmapfile(filename,'Offset',512,'Format','double');
+
+v = table.data.Data(1:nv);
+names = {'x1','x2','x3','act','alpha'};
+i0 = 0;
+for i = 1:length(names),
+    table.(names{i}) = v(i0+(1:n(i)));
+    i0 = i0+n(i);
+end
+table.offset.Lm = nv;
+table.offset.Lstar = nv+ngrid;
+table.offset.Bmin = nv+2*ngrid;
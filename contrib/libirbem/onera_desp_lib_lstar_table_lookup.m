@@ -0,0 +1,152 @@
+function [Lm,Lstar,Bmin,err] = onera_desp_lib_lstar_table_lookup(table,matlabd,x1,x2,x3,alpha,maginput,tol)
+%***************************************************************************************************
+%
+% This file is part of IRBEM-LIB.
+%
+%    IRBEM-LIB is free software: you can redistribute it and/or modify
+%    it under the terms of the GNU Lesser General Public License as published by
+%    the Free Software Foundation, either version 3 of the License, or
+%    (at your option) any later version.
+%
+%    IRBEM-LIB is distributed in the hope that it will be useful,
+%    but WITHOUT ANY WARRANTY; without even the implied warranty of
+%    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+%    GNU Lesser General Public License for more details.
+%
+%    You should have received a copy of the GNU Lesser General Public License
+%    along with IRBEM-LIB.  If not, see <http://www.gnu.org/licenses/>.
+%
+%***************************************************************************************************
+%
+% function [Lm,Lstar,Bmin,err] = onera_desp_lib_lstar_table_lookup(table,matlabd,x1,x2,x3,alpha,maginput,tol)
+% interpolates Lm, Lstar and Bmin in a table made by
+% onera_desp_lib_lstar_table_make, for the table's field model and options
+% table - a table from onera_desp_lib_lstar_table_load, or its file name
+% matlabd - Matlab date numbers, only used for the points computed exactly
+% x1, x2, x3 - positions in the table's coordinates (table.sysaxes, GSM or SM)
+% alpha - vector of local pitch angles (degrees)
+% maginput - [length(x1) x 25] as for onera_desp_lib_make_lstar_shell_splitting,
+%   only element table.iact (e.g. Kp) is interpolated in, the other
+%   elements are assumed to be those of the table
+% tol - largest acceptable error estimate of Lstar (default inf)
+%
+% Lm, Lstar are length(x1) x length(alpha), Bmin is length(x1) x 1, as
+% from onera_desp_lib_make_lstar_shell_splitting
+% err.Lm, err.Lstar and err.Bmin are estimates of the interpolation errors
+% err.exact is true for the points computed with
+% onera_desp_lib_make_lstar_shell_splitting instead
+%
+% Values are interpolated multilinearly in position, activity and pitch
+% angle. The error of linear interpolation between two grid points is
+% about t*(1-t)/2 times the second difference of the grid values, t being
+% the fractional position between them; err sums this over the grid
+% dimensions, with the second differences taken at the nearest grid
+% point. It is an estimate for grids of about equal spacing, not a bound.
+% Points outside the grid, next to a grid point where L* is undefined
+% (NaN, e.g. open drift shells or inside the Earth), or with err.Lstar >
+% tol are computed exactly, i.e. with the table's kext, options and
+% sysaxes, the given matlabd and the full maginput.
+
+if ischar(table),
+    table = onera_desp_lib_lstar_table_load(table);
+end
+if nargin < 8 || isempty(tol),
+    tol = inf;
+end
+
+ntime = length(x1);
+nipa = length(alpha);
+if isempty(maginput),
+    maginput = nan(ntime,25);
+end
+if (size(maginput,1)==25) && (size(maginput,2)~=25), % 25xN
+    maginput = maginput'; % Nx25
+end
+if size(maginput,1) ~= ntime,
+    maginput = repmat(maginput,ntime,1);
+end
+matlabd = datenum(matlabd);
+if length(matlabd)==1,
+    matlabd = repmat(matlabd,ntime,1);
+end
+
+% one query per point and pitch angle, point index varying fastest
+q = [repmat([x1(:) x2(:) x3(:) maginput(:,table.iact)],nipa,1) ...
+    reshape(repmat(alpha(:)',ntime,1),ntime*nipa,1)];
+grids = {table.x1,table.x2,table.x3,table.act,table.alpha};
+n = table.n;
+nq = size(q,1);
+i0 = ones(nq,5); % lower grid point
+t = zeros(nq,5); % fraction to the next
+inear = ones(nq,5);
+out = false(nq,1);
+for d = 1:5,
+    if n(d) == 1,
+        out = out | (q(:,d) ~= grids{d});
+        continue
+    end
+    u = interp1(grids{d},(1:n(d))',q(:,d)); % NaN outside
+    out = out | isnan(u);
+    u(isnan(u)) = 1;
+    i0(:,d) = min(floor(u),n(d)-1);
+    t(:,d) = u-i0(:,d);
+    inear(:,d) = round(u);
+end
+
+[Lm,err.Lm] = interp_table(table,table.offset.Lm,n,i0,t,inear);
+[Lstar,err.Lstar] = interp_table(table,table.offset.Lstar,n,i0,t,inear);
+% Bmin does not depend on the pitch angle, the first alpha will do
+[Bmin,err.Bmin] = interp_table(table,table.offset.Bmin,n(1:4),i0(1:ntime,1:4),t(1:ntime,1:4),inear(1:ntime,1:4));
+
+Lm = reshape(Lm,ntime,nipa);
+Lstar = reshape(Lstar,ntime,nipa);
+err.Lm = reshape(err.Lm,ntime,nipa);
+err.Lstar = reshape(err.Lstar,ntime,nipa);
+
+bad = reshape(out | isnan(Lstar(:)) | ~(err.Lstar(:) <= tol),ntime,nipa);
+err.exact = any(bad,2);
+if any(err.exact),
+    i = find(err.exact);
+    [Lm(i,:),Lstar(i,:),Bmirror,Bmin(i)] = onera_desp_lib_make_lstar_shell_splitting(table.kext,table.options,table.sysaxes,...
+        matlabd(i),x1(i),x2(i),x3(i),alpha,maginput(i,:));
+    err.Lm(i,:) = 0;
+    err.Lstar(i,:) = 0;
+    err.Bmin(i) = 0;
+end
+
+function [v,e] = interp_table(table,offset,n,i0,t,inear)
+% multilinear interpolation in the array at offset in table.data, and
+% the error estimate
+D = length(n);
+stride = cumprod([1 n(1:end-1)]);
+base = offset+1+(i0-1)*stride'; % lower corner, one-based index into Data
+v = zeros(size(i0,1),1);
+for c = 0:2^D-1,
+    corner = bitget(c,1:D);
+    if any(corner & (n==1)),
+        continue
+    end
+    w = ones(size(v));
+    for d = 1:D,
+        if corner(d),
+            w = w.*t(:,d);
+        else
+            w = w.*(1-t(:,d));
+        end
+    end
+    f = table.data.Data(base+corner*stride');
+    f(w==0) = 0; % a NaN in a corner with no weight does not matter
+    v = v+w.*f;
+end
+
+e = zeros(size(v));
+near = offset+1+(inear-1)*stride';
+for d = 1:D,
+    if n(d) < 3,
+        continue
+    end
+    j = min(max(inear(:,d),2),n(d)-1);
+    mid = near+(j-inear(:,d))*stride(d);
+    d2 = table.data.Data(mid-stride(d))-2*table.data.Data(mid)+table.data.Data(mid+stride(d));
+    e = e+t(:,d).*(1-t(:,d))/2.*abs(d2);
+end
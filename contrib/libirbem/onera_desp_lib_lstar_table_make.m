@@ -0,0 +1,120 @@
+function table = onera_desp_lib_lstar_table_make(filename,kext,options,sysaxes,matlabd,grid)
+%***************************************************************************************************
+%
+% This file is part of IRBEM-LIB.
+%
+%    IRBEM-LIB is free software: you can redistribute it and/or modify
+%    it under the terms of the GNU Lesser General Public License as published by
+%    the Free Software Foundation, either version 3 of the License, or
+%    (at your option) any later version.
+%
+%    IRBEM-LIB is distributed in the hope that it will be useful,
+%    but WITHOUT ANY WARRANTY; without even the implied warranty of
+%    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+%    GNU Lesser General Public License for more details.
+%
+%    You should have received a copy of the GNU Lesser General Public License
+%    along with IRBEM-LIB.  If not, see <http://www.gnu.org/licenses/>.
+%
+%***************************************************************************************************
+%
+% function table = onera_desp_lib_lstar_table_make(filename,kext,options,sysaxes,matlabd,grid)
+% computes Lm, Lstar and Bmin on a grid of positions, one magnetic
+% activity input and local pitch angles with
+% onera_desp_lib_make_lstar_shell_splitting, writes them to the file
+% filename and returns the table as onera_desp_lib_lstar_table_load does
+% kext, options - as for onera_desp_lib_make_lstar
+% sysaxes - 'GSM' or 'SM' (2 or 4), the coordinates of the grid
+% matlabd - the date the table is computed for (Matlab date number).
+%   The dipole tilt, IGRF and the external field change with it, the table
+%   is only as good as the positions in sysaxes are for other dates.
+% grid - structure with fields
+%   x1,x2,x3 - increasing vectors of positions in sysaxes, RE
+%   act - increasing vector of values of the activity input, in maginput
+%       units (e.g. Kp*10 as in OMNI2 files)
+%   iact - the maginput element act applies to (default 1 = Kp, 2 = Dst)
+%   maginput - 1x25, the other maginput elements (default NaN, i.e.
+%       baddata; element iact is ignored)
+%   alpha - increasing vector of local pitch angles, degrees (1 to 25 values)
+%
+% grid points inside the Earth (radius < 1) are not computed and are NaN
+% the table is used with onera_desp_lib_lstar_table_lookup
+%
+% The file is a 512 byte header followed by the grid vectors and the
+% Lm, Lstar (x1 x x2 x x3 x act x alpha) and Bmin (x1 x x2 x x3 x act)
+% arrays, as little endian doubles in Matlab order, so that it can be
+% memory mapped (see onera_desp_lib_lstar_table_load).
+
+if nargin < 6,
+    error('Usage: table = %s(filename,kext,options,sysaxes,matlabd,grid)',mfilename);
+end
+
+kext = onera_desp_lib_kext(kext);
+options = onera_desp_lib_options(options);
+sysaxes = onera_desp_lib_sysaxes(sysaxes);
+if ~ismember(sysaxes,[2 4]),
+    error('%s: sysaxes must be GSM or SM',mfilename);
+end
+if options(1) == 0,
+    error('%s: options must compute L*',mfilename);
+end
+matlabd = datenum(matlabd);
+
+if ~isfield(grid,'iact') || isempty(grid.iact),
+    grid.iact = 1;
+end
+if ~isfield(grid,'maginput') || isempty(grid.maginput),
+    grid.maginput = nan(1,25);
+end
+names = {'x1','x2','x3','act','alpha'};
+for i = 1:length(names),
+    v = grid.(names{i});
+    if isempty(v) || any(diff(v(:))<=0),
+        error('%s: grid.%s must be an increasing vector',mfilename,names{i});
+    end
+    grid.(names{i}) = v(:);
+end
+if length(grid.alpha) > 25,
+    error('%s: at most 25 pitch angles',mfilename);
+end
+
+n = [length(grid.x1) length(grid.x2) length(grid.x3) length(grid.act) length(grid.alpha)];
+[X1,X2,X3] = ndgrid(grid.x1,grid.x2,grid.x3);
+inside = sqrt(X1(:).^2+X2(:).^2+X3(:).^2) >= 1;
+npos = prod(n(1:3));
+
+Lm = nan([npos n(4) n(5)]);
+Lstar = Lm;
+Bmin = nan(npos,n(4));
+for iact = 1:n(4),
+    maginput = repmat(grid.maginput(:)',sum(inside),1);
+    maginput(:,grid.iact) = grid.act(iact);
+    [lm,lstar,bmirror,bmin] = onera_desp_lib_make_lstar_shell_splitting(kext,options,sysaxes,matlabd,...
+        X1(inside),X2(inside),X3(inside),grid.alpha,maginput);
+    Lm(inside,iact,:) = reshape(lm,[sum(inside) 1 n(5)]);
+    Lstar(inside,iact,:) = reshape(lstar,[sum(inside) 1 n(5)]);
+    Bmin(inside,iact) = bmin;
+end
+
+fid = fopen(filename,'w','ieee-le');
+if fid < 0,
+    error('%s: cannot open %s',mfilename,filename);
+end
+header = zeros(1,63); % 8 + 504 bytes
+header(1) = 1; % version
+header(2:6) = n;
+header(7) = kext;
+header(8:12) = options;
+header(13) = sysaxes;
+header(14) = matlabd;
+header(15) = grid.iact;
+header(16:40) = grid.maginput(:)';
+fwrite(fid,'IRBEMLUT','char');
+fwrite(fid,header,'double');
+fwrite(fid,[grid.x1; grid.x2; grid.x3; grid.act; grid.alpha],'double');
+fwrite(fid,Lm,'double');
+fwrite(fid,Lstar,'double');
+fwrite(fid,Bmin,'double');
+fclose(fid);
+
+table = onera_desp_lib_lstar_table_load(filename);
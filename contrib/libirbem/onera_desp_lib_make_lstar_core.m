@@ -61,7 +61,10 @@ end
 
 matlabd = datenum(matlabd);
 
-onera_desp_lib_load;
+native = exist('onera_desp_lib_mx','file') == 3; % see onera_desp_lib_mx.c
+if ~native,
+    onera_desp_lib_load;
+end
 
 ntime = length(x1);
 nipa = length(alpha);
@@ -82,6 +85,18 @@ if length(matlabd)==1,
 end
 maginput = onera_desp_lib_maginputs(maginput); % NaN to baddata
 
+if native && (nipa<=Nmaxpa),
+    % the gateway passes the arrays to the library directly, in blocks of ntime_max
+    [iyear,idoy,UT] = onera_desp_lib_matlabd2yds(matlabd);
+    cmd = strrep(lower(func_name),'onera_desp_lib_','');
+    if splitting,
+        [Lm,Lstar,Bmirror,Bmin,J,MLT] = onera_desp_lib_mx(cmd,kext,options,sysaxes,iyear,idoy,UT,x1,x2,x3,alpha,maginput');
+    else
+        [Lm,Lstar,Bmirror,Bmin,J,MLT] = onera_desp_lib_mx(cmd,kext,options,sysaxes,iyear,idoy,UT,x1,x2,x3,maginput');
+    end
+    return
+end
+
 Lm = repmat(nan,ntime,nipa);
 Lstar = repmat(nan,ntime,nipa);
 Bmirror = repmat(nan,ntime,nipa);
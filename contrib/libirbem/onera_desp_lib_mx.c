@@ -0,0 +1,906 @@
+/*
+ * onera_desp_lib_mx.c  MEX gateway to the IRBEM library (onera_desp_lib.h)
+ *
+ * Calls the Fortran routines with the MATLAB arrays themselves, without
+ * loadlibrary, thunk files or libpointer objects. The onera_desp_lib_*.m
+ * wrappers use it when it has been compiled and fall back to calllib
+ * otherwise.
+ *
+ *   N = onera_desp_lib_mx('ntime_max')
+ *
+ *   N = onera_desp_lib_mx('workers')
+ *   onera_desp_lib_mx('workers',N)
+ *   get/set the number of processes of make_lstar and its variants:
+ *   0 (default) one per processor, 1 no worker processes
+ *
+ *   [Lm,Lstar,Blocal,Bmin,J,MLT] = onera_desp_lib_mx('make_lstar',
+ *         KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,MAGINPUT)
+ *   same for 'landi2lstar'
+ *
+ *   [Lm,Lstar,Blocal,Bmin,J,MLT] = onera_desp_lib_mx('make_lstar_shell_splitting',
+ *         KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,ALPHA,MAGINPUT)
+ *   same for 'landi2lstar_shell_splitting'
+ *
+ *   [Lm,Lstar,Blocal,Bmin,J,POSIT,NPOSIT] = onera_desp_lib_mx('drift_shell',
+ *         KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,MAGINPUT)
+ *
+ *   [Lm,Blocal,Bmin,J,POSIT] = onera_desp_lib_mx('trace_field_line',
+ *         KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,MAGINPUT,R0)
+ *
+ *   POSIT = onera_desp_lib_mx('trace_field_line_towards_earth',
+ *         KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,MAGINPUT,DS)
+ *
+ *   [Bgeo,B] = onera_desp_lib_mx('get_field',
+ *         KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,MAGINPUT)
+ *
+ *   [Xfoot,Bfoot,BfootMag] = onera_desp_lib_mx('find_foot_point',
+ *         KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,STOP_ALT,HEMI_FLAG,MAGINPUT)
+ *
+ *   [Xfoot,Bfoot,BfootMag,Lm,Bmin,J,NPOSIT,POSIT,Blocal] = onera_desp_lib_mx('trace_batch',
+ *         KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,MAGINPUT,STOP_ALT,HEMI_FLAG,R0)
+ *   find_foot_point1_ for N points and, with more than three outputs,
+ *   trace_field_line2_1_ as well. The field lines are packed one after
+ *   the other into POSIT (sum(NPOSIT)x3) and Blocal (sum(NPOSIT)x1), and
+ *   only returned when asked for.
+ *
+ * KEXT, OPTIONS (5 elements) and SYSAXES are the numeric values returned by
+ * onera_desp_lib_kext/_options/_sysaxes. IYEAR, IDOY, UT, X1, X2 and X3 have
+ * N elements each (N = 1 for drift_shell and trace_*), IYEAR and IDOY double
+ * or int32. MAGINPUT is 25xN as the library stores it, i.e. the transpose of
+ * what onera_desp_lib_maginputs returns. ALPHA has up to 25 pitch angles.
+ *
+ * Outputs are Nx1 (Nx3, NxNALPHA) as returned by the .m wrappers, with the
+ * library's bad data value -1e31 replaced by NaN. drift_shell returns the
+ * raw 1000x48 Blocal, 3x1000x48 POSIT and 48x1 NPOSIT arrays, the traced
+ * field lines of trace_* are trimmed to their length.
+ *
+ * make_lstar, get_field and the splitting variants take any N and call the
+ * library in blocks of ntime_max points. Routines with one-dimensional
+ * ntime_max arrays write straight into the outputs; the splitting variants
+ * have NTIME_MAX x NALPHA arrays and go through one scratch block.
+ *
+ * make_lstar and its variants spread the blocks over worker processes
+ * (Unix), since the Fortran keeps its state in common blocks and cannot
+ * run in threads. Workers are forked for each call, write into memory
+ * shared with MATLAB and claim blocks from a shared counter; MATLAB's
+ * process works on blocks as well. Blocks a worker did not finish (it
+ * crashed, or could not be forked) are computed again serially at the
+ * end. Workers are copies of MATLAB and do not call the MATLAB API.
+ *
+ * trace_batch spreads its points over the workers the same way, in
+ * rounds of TRACE_ROUND points so that the field lines of a round fit
+ * into shared memory.
+ *
+ * The L* of make_lstar1_ and landi2lstar1_ depends on the points before
+ * it in the same call, so these keep the blocks of ntime_max of the
+ * serial case and give the same results; there is parallelism only
+ * beyond ntime_max points. The splitting variants compute every point
+ * on its own and use smaller blocks, a few per worker.
+ *
+ * Compile with (Linux, library in the same directory):
+ *   mex -v onera_desp_lib_mx.c onera_desp_lib_glnxa64.so CFLAGS='$CFLAGS -O2' LDFLAGS='$LDFLAGS -Wl,-rpath,\$ORIGIN'
+ *
+ * $Id$
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+#include "onera_desp_lib.h"
+
+#ifndef _WIN32
+#define HAVE_FORK
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS	MAP_ANON
+#endif
+#endif
+
+/*
+ * This typedef is needed for MATLAB < 7.3
+ */
+#ifndef MWSIZE_MAX
+typedef int mwSize;
+#endif
+
+#define BAD_LIMIT	(-1e30)		/* the library flags bad data with -1e31 */
+#define NMAXPA		25		/* pitch angles of the splitting routines */
+#define NMAGINPUT	25
+#define NBOUNCE_DRIFT	1000		/* drift_shell1_ points per field line */
+#define NAZ		48		/* drift_shell1_ field lines */
+#define NBOUNCE_TRACE	3000		/* trace_field_line*_ points */
+#define MAX_WORKERS	64
+#define POOL_MIN_POINTS	8		/* fewer points run serially */
+#define POOL_BLOCKS	4		/* blocks per worker */
+#define TRACE_ROUND	256		/* trace_batch points per round */
+#define MAX_OUTPUTS	9
+
+typedef struct {
+	int kext, options[5], sysaxes;
+	mwSize n;		/* points */
+	int *iyear, *idoy;
+	double *ut, *x1, *x2, *x3;
+	int *tmp_iyear, *tmp_idoy;	/* converted from double, or NULL */
+} irbem_args;
+
+typedef void (*block_fn)(void *ctx, mwSize block, void *scratch);
+
+static int ntime_max = 0;
+static int nworkers = 0;		/* 0: one per processor */
+
+static int get_ntime_max(void)
+{
+	if ( ntime_max <= 0 )
+		get_irbem_ntime_max1_(&ntime_max);
+	if ( ntime_max <= 0 )
+		mexErrMsgTxt("onera_desp_lib_mx: bad ntime_max from the library.");
+	return ntime_max;
+}
+
+static int get_int(const mxArray *a, const char *name)
+{
+	char msg[128];
+
+	if ( !mxIsNumeric(a) || mxGetNumberOfElements(a) != 1 ) {
+		snprintf(msg, sizeof(msg), "%s must be a numeric scalar.", name);
+		mexErrMsgTxt(msg);
+	}
+	return (int)mxGetScalar(a);
+}
+
+static double get_double(const mxArray *a, const char *name)
+{
+	char msg[128];
+
+	if ( !mxIsNumeric(a) || mxGetNumberOfElements(a) != 1 ) {
+		snprintf(msg, sizeof(msg), "%s must be a numeric scalar.", name);
+		mexErrMsgTxt(msg);
+	}
+	return mxGetScalar(a);
+}
+
+/*
+ * N doubles, used in place
+ */
+static double *get_doubles(const mxArray *a, mwSize n, const char *name)
+{
+	char msg[128];
+
+	if ( !mxIsDouble(a) || mxIsComplex(a) || mxGetNumberOfElements(a) != n ) {
+		snprintf(msg, sizeof(msg), "%s must be a real double array "
+			"with %lu elements.", name, (unsigned long)n);
+		mexErrMsgTxt(msg);
+	}
+	return mxGetPr(a);
+}
+
+/*
+ * N integers, used in place if int32, else converted into *tmp
+ */
+static int *get_ints(const mxArray *a, mwSize n, const char *name, int **tmp)
+{
+	char msg[128];
+	const double *d;
+	mwSize i;
+
+	if ( mxGetNumberOfElements(a) != n || mxIsComplex(a) ||
+	     !(mxIsInt32(a) || mxIsDouble(a)) ) {
+		snprintf(msg, sizeof(msg), "%s must be a real double or int32 "
+			"array with %lu elements.", name, (unsigned long)n);
+		mexErrMsgTxt(msg);
+	}
+	if ( mxIsInt32(a) )
+		return (int *)mxGetData(a);
+
+	d = mxGetPr(a);
+	*tmp = (int *)mxMalloc((n ? n : 1) * sizeof(int));
+	for ( i = 0; i < n; i++ )
+		(*tmp)[i] = (int)d[i];
+	return *tmp;
+}
+
+/*
+ * KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3 starting at prhs[0]
+ */
+static void get_args(irbem_args *r, const mxArray *prhs[])
+{
+	const mxArray *opt = prhs[1];
+	mwSize i;
+
+	memset(r, 0, sizeof(*r));
+	r->kext = get_int(prhs[0], "KEXT");
+	if ( !mxIsNumeric(opt) || mxGetNumberOfElements(opt) != 5 )
+		mexErrMsgTxt("OPTIONS must have 5 elements.");
+	for ( i = 0; i < 5; i++ )
+		r->options[i] = mxIsInt32(opt) ? ((int *)mxGetData(opt))[i]
+					       : (int)mxGetPr(opt)[i];
+	r->sysaxes = get_int(prhs[2], "SYSAXES");
+
+	r->n = mxGetNumberOfElements(prhs[6]);
+	r->iyear = get_ints(prhs[3], r->n, "IYEAR", &r->tmp_iyear);
+	r->idoy = get_ints(prhs[4], r->n, "IDOY", &r->tmp_idoy);
+	r->ut = get_doubles(prhs[5], r->n, "UT");
+	r->x1 = get_doubles(prhs[6], r->n, "X1");
+	r->x2 = get_doubles(prhs[7], r->n, "X2");
+	r->x3 = get_doubles(prhs[8], r->n, "X3");
+}
+
+static void free_args(irbem_args *r)
+{
+	if ( r->tmp_iyear )
+		mxFree(r->tmp_iyear);
+	if ( r->tmp_idoy )
+		mxFree(r->tmp_idoy);
+}
+
+static double *get_maginput(const mxArray *a, mwSize n)
+{
+	if ( !mxIsDouble(a) || mxIsComplex(a) || mxGetM(a) != NMAGINPUT ||
+	     mxGetNumberOfElements(a) != NMAGINPUT * n )
+		mexErrMsgTxt("MAGINPUT must be a real 25xN double array.");
+	return mxGetPr(a);
+}
+
+static void check_single(const irbem_args *r)
+{
+	if ( r->n != 1 )
+		mexErrMsgTxt("This routine takes a single point.");
+}
+
+static mxArray *new_double(mwSize m, mwSize n)
+{
+	return mxCreateDoubleMatrix(m, n, mxREAL);
+}
+
+static void flags_to_nan(double *x, mwSize n)
+{
+	mwSize i;
+
+	for ( i = 0; i < n; i++ )
+		if ( x[i] < BAD_LIMIT )
+			x[i] = mxGetNaN();
+}
+
+/*
+ * 3xN (library) to Nx3 (MATLAB), flags to NaN
+ */
+static void transpose3(double *out, const double *in, mwSize n)
+{
+	mwSize i;
+	int k;
+
+	for ( i = 0; i < n; i++ )
+		for ( k = 0; k < 3; k++ )
+			out[i + k * n] = in[3 * i + k] < BAD_LIMIT ? mxGetNaN()
+								   : in[3 * i + k];
+}
+
+/*
+ * Processes to use, 1 without fork()
+ */
+static int pool_size(void)
+{
+#ifdef HAVE_FORK
+	long n = nworkers;
+
+	if ( n <= 0 )
+		n = sysconf(_SC_NPROCESSORS_ONLN);
+	if ( n < 1 )
+		n = 1;
+	return n > MAX_WORKERS ? MAX_WORKERS : (int)n;
+#else
+	return 1;
+#endif
+}
+
+/*
+ * Memory the workers write into, NULL if it cannot be had
+ */
+static void *shared_alloc(size_t size)
+{
+#ifdef HAVE_FORK
+	void *p = mmap(NULL, size ? size : 1, PROT_READ | PROT_WRITE,
+		       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+	return p == MAP_FAILED ? NULL : p;
+#else
+	return NULL;
+#endif
+}
+
+static void shared_free(void *p, size_t size)
+{
+#ifdef HAVE_FORK
+	if ( p )
+		munmap(p, size ? size : 1);
+#endif
+}
+
+#ifdef HAVE_FORK
+typedef struct {
+	volatile long next;		/* next block to claim */
+	volatile char done[1];		/* nblocks flags */
+} pool_state;
+
+static void work_blocks(pool_state *st, mwSize nblocks, block_fn fn,
+			void *ctx, void *scratch)
+{
+	mwSize b;
+
+	while ( (b = (mwSize)__sync_fetch_and_add(&st->next, 1)) < nblocks ) {
+		fn(ctx, b, scratch);
+		st->done[b] = 1;
+	}
+}
+#endif
+
+/*
+ * Calls fn for blocks 0..NBLOCKS-1 in up to NPROC processes. fn must
+ * write its results into shared_alloc() memory when NPROC > 1. SCRATCH
+ * bytes are allocated once here, the workers get private copies of it.
+ */
+static void run_blocks(mwSize nblocks, int nproc, block_fn fn, void *ctx,
+		       size_t scratch_size)
+{
+	void *scratch = scratch_size ? mxMalloc(scratch_size) : NULL;
+	mwSize b;
+#ifdef HAVE_FORK
+	pool_state *st = NULL;
+	size_t st_size = sizeof(pool_state) + nblocks;
+	pid_t pids[MAX_WORKERS];
+	int np = 0, i;
+
+	if ( (mwSize)nproc > nblocks )
+		nproc = (int)nblocks;
+	if ( nproc > 1 )
+		st = (pool_state *)shared_alloc(st_size);
+	if ( st ) {
+		st->next = 0;
+		memset((char *)st->done, 0, nblocks);
+		fflush(stdout);
+		for ( i = 1; i < nproc; i++ ) {
+			pid_t pid = fork();
+
+			if ( pid == 0 ) {
+				work_blocks(st, nblocks, fn, ctx, scratch);
+				_exit(0);
+			}
+			if ( pid < 0 )
+				break;
+			pids[np++] = pid;
+		}
+		work_blocks(st, nblocks, fn, ctx, scratch);
+		for ( i = 0; i < np; i++ )
+			while ( waitpid(pids[i], NULL, 0) < 0 && errno == EINTR )
+				;
+	}
+#endif
+
+	for ( b = 0; b < nblocks; b++ ) {
+#ifdef HAVE_FORK
+		if ( st && st->done[b] )
+			continue;
+#endif
+		fn(ctx, b, scratch);
+	}
+
+#ifdef HAVE_FORK
+	shared_free(st, st_size);
+#endif
+	if ( scratch )
+		mxFree(scratch);
+}
+
+typedef struct {
+	irbem_args *r;
+	int landi, splitting, nipa, nmax;
+	mwSize bsize;			/* points per block */
+	double *alpha, *maginput;
+	double *out[6];			/* NxNALPHA, Bmin and MLT Nx1 */
+} lstar_job;
+
+static void lstar_block(void *ctx, mwSize b, void *scratch)
+{
+	static const int split_out[4] = { 0, 1, 2, 4 };	/* NTIME_MAX x NALPHA outputs */
+	const lstar_job *job = (const lstar_job *)ctx;
+	irbem_args *r = job->r;
+	mwSize i0 = b * job->bsize, i, j;
+	double *const *out = job->out, *s[4];
+	int ntime, nipa = job->nipa, k;
+
+	ntime = (int)(r->n - i0 < job->bsize ? r->n - i0 : job->bsize);
+
+	if ( !job->splitting ) {
+		(job->landi ? landi2lstar1_ : make_lstar1_)(&ntime, &r->kext,
+			r->options, &r->sysaxes, r->iyear + i0,
+			r->idoy + i0, r->ut + i0, r->x1 + i0, r->x2 + i0, r->x3 + i0,
+			job->maginput + NMAGINPUT * i0, out[0] + i0, out[1] + i0,
+			out[2] + i0, out[3] + i0, out[4] + i0, out[5] + i0);
+		return;
+	}
+
+	for ( k = 0; k < 4; k++ )
+		s[k] = (double *)scratch + (size_t)k * job->nmax * nipa;
+	(job->landi ? landi2lstar_shell_splitting1_ : make_lstar_shell_splitting1_)(
+		&ntime, &nipa, &r->kext, r->options,
+		&r->sysaxes, r->iyear + i0, r->idoy + i0, r->ut + i0,
+		r->x1 + i0, r->x2 + i0, r->x3 + i0, job->alpha,
+		job->maginput + NMAGINPUT * i0, s[0], s[1], s[2], out[3] + i0,
+		s[3], out[5] + i0);
+
+	for ( k = 0; k < 4; k++ )
+		for ( j = 0; j < (mwSize)nipa; j++ )
+			for ( i = 0; i < (mwSize)ntime; i++ )
+				out[split_out[k]][i0 + i + j * r->n] =
+					s[k][i + j * job->nmax];
+}
+
+/*
+ * make_lstar1_, landi2lstar1_ and the shell splitting variants
+ */
+static void make_lstar(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[],
+		       int landi, int splitting)
+{
+	irbem_args r;
+	lstar_job job;
+	double *shared = NULL;
+	size_t shared_size = 0, len[6], off;
+	int nproc = pool_size(), k;
+	mwSize nblocks;
+
+	if ( nrhs != 10 + splitting )
+		mexErrMsgTxt(splitting ?
+			"Usage: [Lm,Lstar,Blocal,Bmin,J,MLT] = onera_desp_lib_mx(CMD,KEXT,"
+			"OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,ALPHA,MAGINPUT)" :
+			"Usage: [Lm,Lstar,Blocal,Bmin,J,MLT] = onera_desp_lib_mx(CMD,KEXT,"
+			"OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,MAGINPUT)");
+	if ( nlhs > 6 )
+		mexErrMsgTxt("Too many output arguments.");
+
+	memset(&job, 0, sizeof(job));
+	job.r = &r;
+	job.landi = landi;
+	job.splitting = splitting;
+	job.nipa = 1;
+	job.nmax = get_ntime_max();
+
+	get_args(&r, prhs);
+	if ( splitting ) {
+		job.nipa = (int)mxGetNumberOfElements(prhs[9]);
+		if ( job.nipa < 1 || job.nipa > NMAXPA )
+			mexErrMsgTxt("ALPHA must have 1 to 25 pitch angles.");
+		job.alpha = get_doubles(prhs[9], job.nipa, "ALPHA");
+	}
+	job.maginput = get_maginput(prhs[9 + splitting], r.n);
+
+	for ( k = 0; k < 6; k++ ) {
+		plhs[k] = new_double(r.n, (k == 3 || k == 5) ? 1 : job.nipa);
+		job.out[k] = mxGetPr(plhs[k]);
+		len[k] = mxGetNumberOfElements(plhs[k]);
+		shared_size += len[k] * sizeof(double);
+	}
+
+	/*
+	 * Blocks of ntime_max, the splitting variants a few per worker.
+	 * make_lstar1_ carries state from one point to the next within a
+	 * call, its L* changes with the block boundaries.
+	 */
+	job.bsize = job.nmax;
+	if ( splitting && nproc > 1 && r.n >= POOL_MIN_POINTS ) {
+		mwSize bsize = (r.n + (mwSize)nproc * POOL_BLOCKS - 1) /
+			       ((mwSize)nproc * POOL_BLOCKS);
+
+		if ( bsize < job.bsize )
+			job.bsize = bsize;
+	}
+	nblocks = (r.n + job.bsize - 1) / job.bsize;
+	if ( nproc > 1 && nblocks > 1 )
+		shared = (double *)shared_alloc(shared_size);
+	if ( shared )
+		for ( k = 0, off = 0; k < 6; off += len[k], k++ )
+			job.out[k] = shared + off;
+	else
+		nproc = 1;
+
+	run_blocks(nblocks, nproc, lstar_block, &job, splitting ?
+		   4 * (size_t)job.nmax * job.nipa * sizeof(double) : 0);
+
+	for ( k = 0; k < 6; k++ ) {
+		if ( shared )
+			memcpy(mxGetPr(plhs[k]), job.out[k], len[k] * sizeof(double));
+		flags_to_nan(mxGetPr(plhs[k]), len[k]);
+	}
+	shared_free(shared, shared_size);
+	free_args(&r);
+}
+
+static void drift_shell(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	irbem_args r;
+	double *maginput, *out[6];
+	int ind[NAZ], k;
+	mwSize dims[3] = { 3, NBOUNCE_DRIFT, NAZ };
+
+	if ( nrhs != 10 )
+		mexErrMsgTxt("Usage: [Lm,Lstar,Blocal,Bmin,J,POSIT,NPOSIT] = onera_desp_lib_mx("
+			"'drift_shell',KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,MAGINPUT)");
+	if ( nlhs > 7 )
+		mexErrMsgTxt("Too many output arguments.");
+
+	get_args(&r, prhs);
+	check_single(&r);
+	maginput = get_maginput(prhs[9], 1);
+
+	plhs[0] = new_double(1, 1);
+	plhs[1] = new_double(1, 1);
+	plhs[2] = new_double(NBOUNCE_DRIFT, NAZ);
+	plhs[3] = new_double(1, 1);
+	plhs[4] = new_double(1, 1);
+	plhs[5] = mxCreateNumericArray(3, dims, mxDOUBLE_CLASS, mxREAL);
+	for ( k = 0; k < 6; k++ )
+		out[k] = mxGetPr(plhs[k]);
+
+	drift_shell1_(&r.kext, r.options, &r.sysaxes, r.iyear, r.idoy, r.ut,
+		r.x1, r.x2, r.x3, maginput, out[0], out[1], out[2], out[3],
+		out[4], out[5], ind);
+
+	for ( k = 0; k < 6; k++ )
+		flags_to_nan(out[k], mxGetNumberOfElements(plhs[k]));
+	plhs[6] = new_double(NAZ, 1);
+	for ( k = 0; k < NAZ; k++ )
+		mxGetPr(plhs[6])[k] = ind[k];
+	free_args(&r);
+}
+
+/*
+ * trace_field_line2_1_ and trace_field_line_towards_earth1_
+ */
+static void trace_field_line(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[],
+			     int towards_earth)
+{
+	irbem_args r;
+	double *maginput, arg, Lm, Bmin, J, *blocal, *posit;
+	int ind = 0;
+
+	if ( nrhs != 11 )
+		mexErrMsgTxt(towards_earth ?
+			"Usage: POSIT = onera_desp_lib_mx('trace_field_line_towards_earth',"
+			"KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,MAGINPUT,DS)" :
+			"Usage: [Lm,Blocal,Bmin,J,POSIT] = onera_desp_lib_mx('trace_field_line',"
+			"KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,MAGINPUT,R0)");
+	if ( nlhs > (towards_earth ? 1 : 5) )
+		mexErrMsgTxt("Too many output arguments.");
+
+	get_args(&r, prhs);
+	check_single(&r);
+	maginput = get_maginput(prhs[9], 1);
+	arg = get_double(prhs[10], towards_earth ? "DS" : "R0");
+
+	blocal = (double *)mxMalloc(NBOUNCE_TRACE * sizeof(double));
+	posit = (double *)mxMalloc(3 * NBOUNCE_TRACE * sizeof(double));
+
+	if ( towards_earth )
+		trace_field_line_towards_earth1_(&r.kext, r.options, &r.sysaxes,
+			r.iyear, r.idoy, r.ut, r.x1, r.x2, r.x3, maginput, &arg,
+			posit, &ind);
+	else
+		trace_field_line2_1_(&r.kext, r.options, &r.sysaxes, r.iyear,
+			r.idoy, r.ut, r.x1, r.x2, r.x3, maginput, &arg, &Lm,
+			blocal, &Bmin, &J, posit, &ind);
+
+	if ( ind < 0 )
+		ind = 0;
+	if ( ind > NBOUNCE_TRACE )
+		ind = NBOUNCE_TRACE;
+
+	if ( towards_earth ) {
+		plhs[0] = new_double(ind, 3);
+		transpose3(mxGetPr(plhs[0]), posit, ind);
+	} else {
+		plhs[0] = mxCreateDoubleScalar(Lm < BAD_LIMIT ? mxGetNaN() : Lm);
+		plhs[1] = new_double(ind, 1);
+		memcpy(mxGetPr(plhs[1]), blocal, ind * sizeof(double));
+		flags_to_nan(mxGetPr(plhs[1]), ind);
+		plhs[2] = mxCreateDoubleScalar(Bmin < BAD_LIMIT ? mxGetNaN() : Bmin);
+		plhs[3] = mxCreateDoubleScalar(J < BAD_LIMIT ? mxGetNaN() : J);
+		plhs[4] = new_double(ind, 3);
+		transpose3(mxGetPr(plhs[4]), posit, ind);
+	}
+
+	mxFree(blocal);
+	mxFree(posit);
+	free_args(&r);
+}
+
+static void get_field(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	irbem_args r;
+	double *maginput, *bgeo, *b;
+	int nmax = get_ntime_max(), ntime;
+	mwSize i0;
+
+	if ( nrhs != 10 )
+		mexErrMsgTxt("Usage: [Bgeo,B] = onera_desp_lib_mx('get_field',"
+			"KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,MAGINPUT)");
+	if ( nlhs > 2 )
+		mexErrMsgTxt("Too many output arguments.");
+
+	get_args(&r, prhs);
+	maginput = get_maginput(prhs[9], r.n);
+
+	bgeo = (double *)mxMalloc((r.n ? 3 * r.n : 1) * sizeof(double));
+	plhs[1] = new_double(r.n, 1);
+	b = mxGetPr(plhs[1]);
+
+	for ( i0 = 0; i0 < r.n; i0 += nmax ) {
+		ntime = (int)(r.n - i0 < (mwSize)nmax ? r.n - i0 : (mwSize)nmax);
+		get_field_multi_(&ntime, &r.kext, r.options, &r.sysaxes,
+			r.iyear + i0, r.idoy + i0, r.ut + i0, r.x1 + i0, r.x2 + i0,
+			r.x3 + i0, maginput + NMAGINPUT * i0, bgeo + 3 * i0, b + i0);
+	}
+
+	plhs[0] = new_double(r.n, 3);
+	transpose3(mxGetPr(plhs[0]), bgeo, r.n);
+	flags_to_nan(b, r.n);
+	mxFree(bgeo);
+	free_args(&r);
+}
+
+static void find_foot_point(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	irbem_args r;
+	double *maginput, stop_alt, *xf, *bf, *bm, xfoot[3], bfoot[3];
+	int hemi_flag, k;
+	mwSize i;
+
+	if ( nrhs != 12 )
+		mexErrMsgTxt("Usage: [Xfoot,Bfoot,BfootMag] = onera_desp_lib_mx('find_foot_point',"
+			"KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,X1,X2,X3,STOP_ALT,HEMI_FLAG,MAGINPUT)");
+	if ( nlhs > 3 )
+		mexErrMsgTxt("Too many output arguments.");
+
+	get_args(&r, prhs);
+	stop_alt = get_double(prhs[9], "STOP_ALT");
+	hemi_flag = get_int(prhs[10], "HEMI_FLAG");
+	maginput = get_maginput(prhs[11], r.n);
+
+	plhs[0] = new_double(r.n, 3);
+	plhs[1] = new_double(r.n, 3);
+	plhs[2] = new_double(r.n, 1);
+	xf = mxGetPr(plhs[0]);
+	bf = mxGetPr(plhs[1]);
+	bm = mxGetPr(plhs[2]);
+
+	for ( i = 0; i < r.n; i++ ) {
+		find_foot_point1_(&r.kext, r.options, &r.sysaxes, r.iyear + i,
+			r.idoy + i, r.ut + i, r.x1 + i, r.x2 + i, r.x3 + i,
+			&stop_alt, &hemi_flag, maginput + NMAGINPUT * i,
+			xfoot, bfoot, bm + i);
+		for ( k = 0; k < 3; k++ ) {
+			xf[i + k * r.n] = xfoot[k] < BAD_LIMIT ? mxGetNaN() : xfoot[k];
+			bf[i + k * r.n] = bfoot[k] < BAD_LIMIT ? mxGetNaN() : bfoot[k];
+		}
+	}
+
+	flags_to_nan(bm, r.n);
+	free_args(&r);
+}
+
+typedef struct {
+	irbem_args *r;
+	double *maginput, stop_alt, r0;
+	int hemi_flag, trace, paths;
+	mwSize i0, n, bsize;		/* points of the round, per block */
+	double *res;			/* TRACE_NRES per point */
+	double *posit, *blocal;		/* NBOUNCE_TRACE per point, or NULL */
+} trace_job;
+
+/* trace_job.res: Xfoot(3), Bfoot(3), BfootMag, Lm, Bmin, J, NPOSIT */
+#define TRACE_NRES	11
+
+static void trace_block(void *ctx, mwSize b, void *scratch)
+{
+	const trace_job *job = (const trace_job *)ctx;
+	irbem_args *r = job->r;
+	double stop_alt = job->stop_alt, r0 = job->r0, *blocal, *posit, *res;
+	int hemi_flag = job->hemi_flag, ind;
+	mwSize k, i;
+
+	for ( k = b * job->bsize; k < (b + 1) * job->bsize && k < job->n; k++ ) {
+		i = job->i0 + k;
+		res = job->res + TRACE_NRES * k;
+		find_foot_point1_(&r->kext, r->options, &r->sysaxes, r->iyear + i,
+			r->idoy + i, r->ut + i, r->x1 + i, r->x2 + i, r->x3 + i,
+			&stop_alt, &hemi_flag, job->maginput + NMAGINPUT * i,
+			res, res + 3, res + 6);
+		if ( !job->trace )
+			continue;
+
+		blocal = job->paths ? job->blocal + NBOUNCE_TRACE * k : (double *)scratch;
+		posit = job->paths ? job->posit + 3 * NBOUNCE_TRACE * k
+				   : (double *)scratch + NBOUNCE_TRACE;
+		ind = 0;
+		trace_field_line2_1_(&r->kext, r->options, &r->sysaxes,
+			r->iyear + i, r->idoy + i, r->ut + i, r->x1 + i, r->x2 + i,
+			r->x3 + i, job->maginput + NMAGINPUT * i, &r0, res + 7,
+			blocal, res + 8, res + 9, posit, &ind);
+		res[10] = ind < 0 ? 0 : ind > NBOUNCE_TRACE ? NBOUNCE_TRACE : ind;
+	}
+}
+
+/*
+ * find_foot_point1_ and trace_field_line2_1_ for N points
+ */
+static void trace_batch(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	irbem_args r;
+	trace_job job;
+	double *out[7], *posit = NULL, *blocal = NULL, *res;
+	size_t res_size, path_size = 0, npath = 0, maxpath = 0;
+	int nproc = pool_size(), shared = 0, k;
+	mwSize nblocks, i, j;
+
+	if ( nrhs != 13 )
+		mexErrMsgTxt("Usage: [Xfoot,Bfoot,BfootMag,Lm,Bmin,J,NPOSIT,POSIT,Blocal] = "
+			"onera_desp_lib_mx('trace_batch',KEXT,OPTIONS,SYSAXES,IYEAR,IDOY,UT,"
+			"X1,X2,X3,MAGINPUT,STOP_ALT,HEMI_FLAG,R0)");
+	if ( nlhs > 9 )
+		mexErrMsgTxt("Too many output arguments.");
+
+	memset(&job, 0, sizeof(job));
+	job.r = &r;
+	get_args(&r, prhs);
+	job.maginput = get_maginput(prhs[9], r.n);
+	job.stop_alt = get_double(prhs[10], "STOP_ALT");
+	job.hemi_flag = get_int(prhs[11], "HEMI_FLAG");
+	job.r0 = get_double(prhs[12], "R0");
+	job.trace = nlhs > 3;
+	job.paths = nlhs > 7;
+
+	plhs[0] = new_double(r.n, 3);
+	plhs[1] = new_double(r.n, 3);
+	plhs[2] = new_double(r.n, 1);
+	for ( k = 3; k < 7; k++ )
+		plhs[k] = new_double(job.trace ? r.n : 0, 1);
+	for ( k = 0; k < 7; k++ )
+		out[k] = mxGetPr(plhs[k]);
+
+	/* one round's results and field lines, shared with the workers */
+	res_size = TRACE_ROUND * TRACE_NRES * sizeof(double);
+	if ( job.paths )
+		path_size = TRACE_ROUND * 4 * NBOUNCE_TRACE * sizeof(double);
+	if ( nproc > 1 && r.n >= POOL_MIN_POINTS ) {
+		job.res = (double *)shared_alloc(res_size + path_size);
+		shared = job.res != NULL;
+	}
+	if ( !shared ) {
+		nproc = 1;
+		job.res = (double *)mxMalloc(res_size + path_size);
+	}
+	if ( job.paths ) {
+		job.blocal = job.res + TRACE_ROUND * TRACE_NRES;
+		job.posit = job.blocal + TRACE_ROUND * NBOUNCE_TRACE;
+	}
+
+	for ( job.i0 = 0; job.i0 < r.n; job.i0 += TRACE_ROUND ) {
+		job.n = r.n - job.i0 < TRACE_ROUND ? r.n - job.i0 : TRACE_ROUND;
+		job.bsize = (job.n + (mwSize)nproc * POOL_BLOCKS - 1) /
+			    ((mwSize)nproc * POOL_BLOCKS);
+		nblocks = (job.n + job.bsize - 1) / job.bsize;
+		run_blocks(nblocks, nproc, trace_block, &job, job.trace && !job.paths ?
+			   4 * NBOUNCE_TRACE * sizeof(double) : 0);
+
+		for ( j = 0; j < job.n; j++ ) {
+			i = job.i0 + j;
+			res = job.res + TRACE_NRES * j;
+			for ( k = 0; k < 3; k++ ) {
+				out[0][i + k * r.n] = res[k];
+				out[1][i + k * r.n] = res[3 + k];
+			}
+			out[2][i] = res[6];
+			if ( !job.trace )
+				continue;
+			for ( k = 3; k < 7; k++ )
+				out[k][i] = res[4 + k];
+			if ( !job.paths )
+				continue;
+
+			/* append the field line */
+			if ( npath + (size_t)res[10] > maxpath ) {
+				maxpath = 2 * maxpath + NBOUNCE_TRACE;
+				posit = (double *)mxRealloc(posit, 3 * maxpath * sizeof(double));
+				blocal = (double *)mxRealloc(blocal, maxpath * sizeof(double));
+			}
+			memcpy(posit + 3 * npath, job.posit + 3 * NBOUNCE_TRACE * j,
+			       3 * (size_t)res[10] * sizeof(double));
+			memcpy(blocal + npath, job.blocal + NBOUNCE_TRACE * j,
+			       (size_t)res[10] * sizeof(double));
+			npath += (size_t)res[10];
+		}
+	}
+
+	for ( k = 0; k < 6; k++ )
+		flags_to_nan(out[k], mxGetNumberOfElements(plhs[k]));
+	if ( job.paths ) {
+		plhs[7] = new_double(npath, 3);
+		transpose3(mxGetPr(plhs[7]), posit, npath);
+		plhs[8] = new_double(npath, 1);
+		if ( npath )
+			memcpy(mxGetPr(plhs[8]), blocal, npath * sizeof(double));
+		flags_to_nan(mxGetPr(plhs[8]), npath);
+		mxFree(posit);
+		mxFree(blocal);
+	}
+	if ( shared )
+		shared_free(job.res, res_size + path_size);
+	else
+		mxFree(job.res);
+	free_args(&r);
+}
+
+static void dispatch(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	char cmd[64];
+
+	if ( nrhs < 1 || !mxIsChar(prhs[0]) || mxGetString(prhs[0], cmd, sizeof(cmd)) )
+		mexErrMsgTxt("Usage: onera_desp_lib_mx(CMD,...)");
+
+	if ( strcmp(cmd, "ntime_max") == 0 ) {
+		plhs[0] = mxCreateDoubleScalar(get_ntime_max());
+	} else if ( strcmp(cmd, "workers") == 0 ) {
+		if ( nrhs > 2 )
+			mexErrMsgTxt("Usage: N = onera_desp_lib_mx('workers' [,N])");
+		plhs[0] = mxCreateDoubleScalar(pool_size());
+		if ( nrhs == 2 ) {
+			nworkers = get_int(prhs[1], "N");
+			if ( nworkers < 0 )
+				nworkers = 0;
+		}
+	} else if ( strcmp(cmd, "make_lstar") == 0 ) {
+		make_lstar(nlhs, plhs, nrhs - 1, prhs + 1, 0, 0);
+	} else if ( strcmp(cmd, "landi2lstar") == 0 ) {
+		make_lstar(nlhs, plhs, nrhs - 1, prhs + 1, 1, 0);
+	} else if ( strcmp(cmd, "make_lstar_shell_splitting") == 0 ) {
+		make_lstar(nlhs, plhs, nrhs - 1, prhs + 1, 0, 1);
+	} else if ( strcmp(cmd, "landi2lstar_shell_splitting") == 0 ) {
+		make_lstar(nlhs, plhs, nrhs - 1, prhs + 1, 1, 1);
+	} else if ( strcmp(cmd, "drift_shell") == 0 ) {
+		drift_shell(nlhs, plhs, nrhs - 1, prhs + 1);
+	} else if ( strcmp(cmd, "trace_field_line") == 0 ) {
+		trace_field_line(nlhs, plhs, nrhs - 1, prhs + 1, 0);
+	} else if ( strcmp(cmd, "trace_field_line_towards_earth") == 0 ) {
+		trace_field_line(nlhs, plhs, nrhs - 1, prhs + 1, 1);
+	} else if ( strcmp(cmd, "get_field") == 0 ) {
+		get_field(nlhs, plhs, nrhs - 1, prhs + 1);
+	} else if ( strcmp(cmd, "find_foot_point") == 0 ) {
+		find_foot_point(nlhs, plhs, nrhs - 1, prhs + 1);
+	} else if ( strcmp(cmd, "trace_batch") == 0 ) {
+		trace_batch(nlhs, plhs, nrhs - 1, prhs + 1);
+	} else {
+		mexErrMsgTxt("onera_desp_lib_mx: unknown command.");
+	}
+}
+
+/*
+ * The commands create all their outputs, MATLAB only has room for nlhs
+ */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	mxArray *out[MAX_OUTPUTS];
+	int k;
+
+	for ( k = 0; k < MAX_OUTPUTS; k++ )
+		out[k] = NULL;
+	dispatch(nlhs, out, nrhs, prhs);
+	for ( k = 0; k < MAX_OUTPUTS; k++ )
+		if ( k < (nlhs > 1 ? nlhs : 1) )
+			plhs[k] = out[k];
+		else if ( out[k] )
+			mxDestroyArray(out[k]);
+}
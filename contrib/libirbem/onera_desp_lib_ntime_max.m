@@ -21,6 +21,11 @@ function ntime_max = onera_desp_lib_ntime_max()
 % ntime_max = onera_desp_lib_ntime_max()
 % size of ntime dimension in fortran arrays
 
+if exist('onera_desp_lib_mx','file') == 3, % native gateway, see onera_desp_lib_mx.c
+    ntime_max = onera_desp_lib_mx('ntime_max');
+    return
+end
+
 onera_desp_lib_load;
 
 nPtr = libpointer('int32Ptr',-1);
@@ -0,0 +1,121 @@
+function [Xfoot,Bfoot,BfootMag,Lm,Bmin,J,NPOSIT,POSIT,Blocal] = onera_desp_lib_trace_batch(kext,options,sysaxes,matlabd,x1,x2,x3,stop_alt,hemi_flag,maginput,R0)
+%***************************************************************************************************
+%
+% This file is part of IRBEM-LIB.
+%
+%    IRBEM-LIB is free software: you can redistribute it and/or modify
+%    it under the terms of the GNU Lesser General Public License as published by
+%    the Free Software Foundation, either version 3 of the License, or
+%    (at your option) any later version.
+%
+%    IRBEM-LIB is distributed in the hope that it will be useful,
+%    but WITHOUT ANY WARRANTY; without even the implied warranty of
+%    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+%    GNU Lesser General Public License for more details.
+%
+%    You should have received a copy of the GNU Lesser General Public License
+%    along with IRBEM-LIB.  If not, see <http://www.gnu.org/licenses/>.
+%
+%***************************************************************************************************
+%
+% function [Xfoot,Bfoot,BfootMag,Lm,Bmin,J,NPOSIT,POSIT,Blocal] = onera_desp_lib_trace_batch(kext,options,sysaxes,matlabd,x1,x2,x3,stop_alt,hemi_flag,maginput,R0)
+% foot points and field lines of length(x1) points in one call
+% Xfoot, Bfoot, BfootMag (length(x1) x 3, x 3, x 1) as from
+% onera_desp_lib_find_foot_point for stop_alt and hemi_flag
+% Lm, Bmin, J (length(x1) x 1) as from onera_desp_lib_trace_field_line
+% with R0 (default 1)
+% NPOSIT (length(x1) x 1) is the number of points of each traced field line
+% POSIT (sum(NPOSIT) x 3, GEO) and Blocal (sum(NPOSIT) x 1) are the field
+% lines one after the other, e.g. mat2cell(POSIT,NPOSIT,3) splits them
+% The field lines are only traced when Lm or later outputs are asked
+% for, and only returned when POSIT is.
+% kext, options, sysaxes, matlabd, x1, x2, x3 and maginput are as for
+% onera_desp_lib_trace_field_line, stop_alt and hemi_flag as for
+% onera_desp_lib_find_foot_point
+%
+% With the mex gateway onera_desp_lib_mx the points are computed in one
+% call, in several processes (see onera_desp_lib_mx.c), otherwise this
+% calls onera_desp_lib_find_foot_point and onera_desp_lib_trace_field_line.
+
+if nargin < 10,
+    maginput = [];
+end
+if nargin < 11,
+    R0 = 1;
+end
+
+if ischar(hemi_flag),
+    switch(upper(hemi_flag))
+        case {'','SAME'}, hemi_flag = 0;
+        case {'N','NORTH'}, hemi_flag = +1;
+        case {'S','SOUTH'}, hemi_flag = -1;
+        case {'O','OPPOSITE'}, hemi_flag = 2;
+        otherwise
+            error('Unknown hemi_flag "%s"',hemi_flag);
+    end
+end
+
+matlabd = datenum(matlabd);
+
+ntime = length(x1);
+kext = onera_desp_lib_kext(kext);
+options = onera_desp_lib_options(options);
+sysaxes = onera_desp_lib_sysaxes(sysaxes);
+if isempty(maginput),
+    maginput = nan(ntime,25);
+end
+if (size(maginput,1)==25) && (size(maginput,2)~=25), % 25xN
+    maginput = maginput'; % Nx25
+end
+if size(maginput,1) ~= ntime,
+    maginput = repmat(maginput,ntime,1);
+end
+if length(matlabd)==1,
+    matlabd = repmat(matlabd,ntime,1);
+end
+
+if exist('onera_desp_lib_mx','file') == 3, % see onera_desp_lib_mx.c
+    maginput = onera_desp_lib_maginputs(maginput); % NaN to baddata
+    [iyear,idoy,UT] = onera_desp_lib_matlabd2yds(matlabd);
+    % the gateway computes the outputs in blocks of 3, 7 and 9
+    if nargout > 7,
+        out = cell(1,9);
+    elseif nargout > 3,
+        out = cell(1,7);
+    else
+        out = cell(1,3);
+    end
+    [out{:}] = onera_desp_lib_mx('trace_batch',kext,options,sysaxes,iyear,idoy,UT,...
+        x1,x2,x3,maginput',stop_alt,hemi_flag,R0);
+    [Xfoot,Bfoot,BfootMag] = deal(out{1:3});
+    if length(out) > 3,
+        [Lm,Bmin,J,NPOSIT] = deal(out{4:7});
+    end
+    if length(out) > 7,
+        [POSIT,Blocal] = deal(out{8:9});
+    end
+    % the flag value is actually -1d31
+    % BfootMag<=0 also indicates error
+    Xfoot(BfootMag<=0,:) = nan; % discard debug info
+    Bfoot(BfootMag<=0,:) = nan; % discard debug info
+    BfootMag(BfootMag<=0) = nan;
+    return
+end
+
+[Xfoot,Bfoot,BfootMag] = onera_desp_lib_find_foot_point(kext,options,sysaxes,matlabd,x1,x2,x3,stop_alt,hemi_flag,maginput);
+if nargout <= 3,
+    return
+end
+Lm = nan(ntime,1);
+Bmin = nan(ntime,1);
+J = nan(ntime,1);
+NPOSIT = zeros(ntime,1);
+paths = cell(ntime,1);
+blocals = cell(ntime,1);
+for i = 1:ntime,
+    [Lm(i),blocals{i},Bmin(i),J(i),paths{i}] = onera_desp_lib_trace_field_line(kext,options,sysaxes,matlabd(i),...
+        x1(i),x2(i),x3(i),maginput(i,:),R0);
+    NPOSIT(i) = size(paths{i},1);
+end
+POSIT = vertcat(zeros(0,3),paths{:});
+Blocal = vertcat(zeros(0,1),blocals{:});
@@ -70,7 +70,10 @@ end
 
 matlabd = datenum(matlabd);
 
-onera_desp_lib_load;
+native = exist('onera_desp_lib_mx','file') == 3; % see onera_desp_lib_mx.c
+if ~native,
+    onera_desp_lib_load;
+end
 
 kext = onera_desp_lib_kext(kext);
 options = onera_desp_lib_options(options);
@@ -85,6 +88,13 @@ end
 maginput = onera_desp_lib_maginputs(maginput); % NaN to baddata
 
 
+if native,
+    [iyear,idoy,UT] = onera_desp_lib_matlabd2yds(matlabd);
+    [Lm,Blocal,Bmin,J,POSIT] = onera_desp_lib_mx('trace_field_line',...
+        kext,options,sysaxes,iyear,idoy,UT,x1,x2,x3,maginput',R0);
+    return
+end
+
 Nbounce = 20*150; % maximum size of bounce array
 Lm = nan;
 Blocal = repmat(nan,Nbounce,1);
@@ -63,7 +63,10 @@ end
 
 matlabd = datenum(matlabd);
 
-onera_desp_lib_load;
+native = exist('onera_desp_lib_mx','file') == 3; % see onera_desp_lib_mx.c
+if ~native,
+    onera_desp_lib_load;
+end
 
 kext = onera_desp_lib_kext(kext);
 options = onera_desp_lib_options(options);
@@ -79,6 +82,13 @@ end
 maginput = onera_desp_lib_maginputs(maginput); % NaN to baddata
 
 
+if native,
+    [iyear,idoy,UT] = onera_desp_lib_matlabd2yds(matlabd);
+    POSIT = onera_desp_lib_mx('trace_field_line_towards_earth',...
+        kext,options,sysaxes,iyear,idoy,UT,x1,x2,x3,maginput',ds);
+    return
+end
+
 Nbounce = 20*150; % maximum size of bounce array
 [iyear,idoy,UT] = onera_desp_lib_matlabd2yds(matlabd);
 POSIT = repmat(nan,[3 Nbounce]);
@@ -0,0 +1,156 @@
+classdef test_onera_desp_lib < matlab.unittest.TestCase
+	%TEST_ONERA_DESP_LIB tests of the batch and table functions of libirbem
+	%
+	% The tests calling the field models need the mex gateway
+	% onera_desp_lib_mx (see onera_desp_lib_mx.c) and are skipped without
+	% it.
+
+	properties
+		kext = 'T89';
+		options = [0 0 0 0 0];
+		sysaxes = 'GSM';
+		matlabd = datenum(2015,3,17,12,0,0);
+		maginput = [20 nan(1,24)]; % Kp = 2
+	end
+
+	methods
+		function need_mex(testCase)
+			testCase.assumeEqual(exist('onera_desp_lib_mx','file'),3,...
+				'onera_desp_lib_mx is not compiled');
+		end
+	end
+
+	methods (Test)
+		function test_trace_batch_nargout(testCase)
+			% every number of outputs gives the outputs of the full call
+			testCase.need_mex;
+			x1 = [-5; -6.6; 4]; x2 = [0; 1; -2]; x3 = [0.5; 0; 1];
+			args = {testCase.kext,testCase.options,testCase.sysaxes,...
+				testCase.matlabd,x1,x2,x3,100,'same',testCase.maginput};
+			full = cell(1,9);
+			[full{:}] = onera_desp_lib_trace_batch(args{:});
+			testCase.verifySize(full{1},[3 3]);
+			testCase.verifySize(full{4},[3 1]);
+			testCase.verifySize(full{8},[sum(full{7}) 3]);
+			for n = 1:8
+				out = cell(1,n);
+				[out{:}] = onera_desp_lib_trace_batch(args{:});
+				testCase.verifyEqual(out,full(1:n),sprintf('nargout %d',n));
+			end
+		end
+		function test_lstar_table_interpolation(testCase)
+			% a table of known values, no field model needed: grid points
+			% come back exactly, linear data is interpolated exactly and the
+			% error estimate is the error for quadratic data
+			grid.x1 = [-8 -7 -6 -5]'; grid.x2 = [-1 0 1]'; grid.x3 = [-0.5 0.5]';
+			grid.act = [10 20 30]'; grid.alpha = [30 60 90]';
+			lin = @(x1,x2,x3,a,p) 3+0.5*x1-0.25*x2+2*x3+0.01*a+0.001*p;
+			quad = @(x1,x2,x3,a,p) 1+x1.^2;
+			fileName = [tempname '.lut'];
+			cleanup = onCleanup(@() delete(fileName)); %#ok<NASGU>
+			write_table(fileName,grid,lin,quad);
+			table = onera_desp_lib_lstar_table_load(fileName);
+			testCase.verifyEqual(table.n,[4 3 2 3 3]);
+
+			% every grid point
+			[X1,X2,X3,A] = ndgrid(grid.x1,grid.x2,grid.x3,grid.act);
+			maginput = [A(:) nan(numel(A),24)];
+			[Lm,Lstar,Bmin,err] = onera_desp_lib_lstar_table_lookup(table,...
+				testCase.matlabd,X1(:),X2(:),X3(:),grid.alpha,maginput);
+			P = repmat(grid.alpha',numel(A),1);
+			testCase.verifyEqual(Lm,lin(X1(:),X2(:),X3(:),A(:),P));
+			testCase.verifyEqual(Lstar,quad(X1(:),X2(:),X3(:),A(:),P));
+			testCase.verifyEqual(Bmin,lin(X1(:),X2(:),X3(:),A(:),grid.alpha(1)));
+			testCase.verifyFalse(any(err.exact));
+			testCase.verifyEqual(err.Lstar,zeros(size(Lstar)));
+
+			% between the grid points
+			x1 = [-7.6; -6.5; -5.2]; x2 = [-0.3; 0.4; 0.9]; x3 = [0.1; -0.2; 0.5];
+			a = [12; 25; 30]; alpha = [45 80];
+			[Lm,Lstar,~,err] = onera_desp_lib_lstar_table_lookup(table,...
+				testCase.matlabd,x1,x2,x3,alpha,[a nan(3,24)]);
+			P = repmat(alpha,3,1);
+			testCase.verifyEqual(Lm,lin(repmat(x1,1,2),repmat(x2,1,2),...
+				repmat(x3,1,2),repmat(a,1,2),P),'AbsTol',1e-12);
+			testCase.verifyEqual(err.Lm,zeros(3,2),'AbsTol',1e-12);
+			truth = quad(repmat(x1,1,2));
+			testCase.verifyEqual(err.Lstar,abs(Lstar-truth),'AbsTol',1e-12);
+			testCase.verifyFalse(any(err.exact));
+		end
+		function test_lstar_table_make_and_fallback(testCase)
+			% make, load and lookup with the field model: grid points come
+			% back as computed, points outside the grid and above tol are
+			% computed exactly
+			testCase.need_mex;
+			grid.x1 = [-7 -6 -5]'; grid.x2 = [-1 0 1]'; grid.x3 = 0;
+			grid.act = [10 20]'; grid.alpha = [40 90]';
+			opt = [0 0 0 0 0]; opt(1) = 1; % L*
+			fileName = [tempname '.lut'];
+			cleanup = onCleanup(@() delete(fileName)); %#ok<NASGU>
+			onera_desp_lib_lstar_table_make(fileName,testCase.kext,opt,...
+				testCase.sysaxes,testCase.matlabd,grid);
+			table = onera_desp_lib_lstar_table_load(fileName);
+			exact = @(x1,x2,x3,act) lstar_exact(testCase,opt,x1,x2,x3,grid.alpha,act);
+
+			% grid points
+			[X1,X2] = ndgrid(grid.x1,grid.x2);
+			act = repmat(grid.act(2),numel(X1),1);
+			[Lm,Lstar,Bmin,err] = onera_desp_lib_lstar_table_lookup(table,...
+				testCase.matlabd,X1(:),X2(:),zeros(numel(X1),1),grid.alpha,...
+				[act nan(numel(X1),24)]);
+			[Lm0,Lstar0,Bmin0] = exact(X1(:),X2(:),zeros(numel(X1),1),act);
+			testCase.verifyEqual(Lm,Lm0);
+			testCase.verifyEqual(Lstar,Lstar0);
+			testCase.verifyEqual(Bmin,Bmin0);
+			testCase.verifyFalse(any(err.exact));
+
+			% outside the grid, and inside it with tol = 0
+			x1 = [-8; -6.5]; x2 = [0; 0.5]; x3 = [0; 0]; act = [15; 15];
+			[Lm,Lstar,Bmin,err] = onera_desp_lib_lstar_table_lookup(table,...
+				testCase.matlabd,x1,x2,x3,grid.alpha,[act nan(2,24)]);
+			testCase.verifyEqual(err.exact,[true; false]);
+			[Lm0,Lstar0,Bmin0] = exact(x1,x2,x3,act);
+			testCase.verifyEqual(Lm(1,:),Lm0(1,:));
+			testCase.verifyEqual(Lstar(1,:),Lstar0(1,:));
+			testCase.verifyEqual(Bmin(1),Bmin0(1));
+			testCase.verifyGreaterThan(err.Lstar(2,:),0);
+			[Lm,Lstar,Bmin,err] = onera_desp_lib_lstar_table_lookup(table,...
+				testCase.matlabd,x1,x2,x3,grid.alpha,[act nan(2,24)],0);
+			testCase.verifyEqual(err.exact,[true; true]);
+			testCase.verifyEqual(Lm,Lm0);
+			testCase.verifyEqual(Lstar,Lstar0);
+			testCase.verifyEqual(Bmin,Bmin0);
+		end
+	end
+end
+
+function [Lm,Lstar,Bmin] = lstar_exact(testCase,opt,x1,x2,x3,alpha,act)
+% onera_desp_lib_make_lstar_shell_splitting as the table is made
+[Lm,Lstar,~,Bmin] = onera_desp_lib_make_lstar_shell_splitting(testCase.kext,...
+	opt,testCase.sysaxes,testCase.matlabd,x1,x2,x3,alpha,[act nan(length(x1),24)]);
+end
+
+function write_table(fileName,grid,fLm,fLstar)
+% an L* table file as onera_desp_lib_lstar_table_make writes it, with
+% Lm = fLm, Lstar = fLstar and Bmin = fLm at the first pitch angle
+n = [length(grid.x1) length(grid.x2) length(grid.x3) length(grid.act) length(grid.alpha)];
+[X1,X2,X3,A,P] = ndgrid(grid.x1,grid.x2,grid.x3,grid.act,grid.alpha);
+header = zeros(1,63);
+header(1) = 1;
+header(2:6) = n;
+header(7) = 4; % T89
+header(8:12) = [1 0 0 0 0];
+header(13) = 2; % GSM
+header(14) = datenum(2015,3,17);
+header(15) = 1;
+header(16:40) = nan;
+fid = fopen(fileName,'w','ieee-le');
+fwrite(fid,'IRBEMLUT','char');
+fwrite(fid,header,'double');
+fwrite(fid,[grid.x1; grid.x2; grid.x3; grid.act; grid.alpha],'double');
+fwrite(fid,fLm(X1,X2,X3,A,P),'double');
+fwrite(fid,fLstar(X1,X2,X3,A,P),'double');
+Bmin = fLm(X1,X2,X3,A,P);
+fwrite(fid,Bmin(:,:,:,:,1),'double');
+fclose(fid);
+end
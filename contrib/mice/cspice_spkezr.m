@@ -51,6 +51,9 @@
 %
 %                [1,1] = size(target); cell = class(target)
 %
+%                Several targets may be given as a KxM character array
+%                or a Kx1 cell array of names, one target per row.
+%
 %      et        the scalar or 1XN-vector of double precision ephemeris epochs,
 %                expressed as seconds past J2000 TDB, at which the state of the
 %                target body relative to the observer is to be computed,
@@ -222,6 +225,9 @@
 %
 %              [1,N] = size(lt), double = class(lt)
 %
+%              For K targets 'state' has size [6,N,K] and 'lt' size [1,N,K],
+%              the values for target k in state(:,:,k) and lt(:,:,k).
+%
 %-Examples
 %
 %   Any numerical results shown for this example may differ between
@@ -818,6 +824,12 @@
 %
 %-Version
 %
+%   -Mice Version 1.0.3, 18-OCT-2026
+%
+%       Calls the 'spkezr_m' interface, which writes the states and light
+%       times straight into arrays instead of a structure array.
+%       Added support for several targets in one call.
+%
 %-  -Mice Version 1.0.2, 03-JUL-2014 (NJB) (BVS) (EDW)
 %
 %        Discussion of light time corrections was updated. Assertions
@@ -866,14 +878,31 @@ function [state, lt] = cspice_spkezr(targ, et, ref, abcorr, obs)
    end
 
    %
-   % Call the MEX library. The "_s" suffix indicates a structure type
-   % return argument.
+   % Call the MEX library. The "_m" interface returns the states as a
+   % 6xNxK array and the light times as a 1xNxK array, N the
+   % number of epochs and K the number of targets.
+   %
+   % A MEX library built before 'spkezr_m' existed knows only the "_s"
+   % (structure) interface; call that one target at a time instead.
    %
    try
-      [starg] = mice('spkezr_s',targ,et,ref,abcorr,obs);
-      state   = reshape( [starg.state], 6, [] );
-      lt      = reshape( [starg.lt   ], 1, [] );
+      [state, lt] = mice('spkezr_m',targ,et,ref,abcorr,obs);
    catch
-      rethrow(lasterror)
+      err = lasterror;
+      if isempty( strfind( err.message, 'MICE(UNKNOWNCALL)' ) )
+         rethrow(err)
+      end
+      try
+         K     = size(targ, 1);
+         state = zeros( 6, numel(et), K );
+         lt    = zeros( 1, numel(et), K );
+         for k = 1:K
+            [starg]      = mice('spkezr_s',deblank(targ(k,:)),et,ref,abcorr,obs);
+            state(:,:,k) = reshape( [starg.state], 6, [] );
+            lt   (:,:,k) = reshape( [starg.lt   ], 1, [] );
+         end
+      catch
+         rethrow(lasterror)
+      end
    end
 
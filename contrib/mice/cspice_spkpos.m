@@ -50,6 +50,9 @@
 %
 %                [1,1] = size(target); cell = class(target)
 %
+%                Several targets may be given as a KxM character array
+%                or a Kx1 cell array of names, one target per row.
+%
 %      et        the scalar or 1XN-vector of double precision ephemeris
 %                time, expressed as seconds past J2000 TDB, at which
 %                position of the target body relative to the observer
@@ -214,6 +217,9 @@
 %
 %            [1,N] = size(lt), double = class(lt)
 %
+%            For K targets 'pos' has size [3,N,K] and 'lt' size [1,N,K],
+%            the values for target k in pos(:,:,k) and lt(:,:,k).
+%
 %            'pos' and 'lt' return with the same vectorization
 %            measure (N) as 'et'.
 %
@@ -794,6 +800,12 @@
 %
 %-Version
 %
+%   -Mice Version 1.0.3, 18-OCT-2026
+%
+%       Calls the 'spkpos_m' interface, which writes the positions and light
+%       times straight into arrays instead of a structure array.
+%       Added support for several targets in one call.
+%
 %-  -Mice Version 1.0.2, 03-JUL-2014 (NJB) (BVS) (EDW)
 %
 %      Discussion of light time corrections was updated. Assertions
@@ -843,15 +855,32 @@ function [pos, lt] = cspice_spkpos(targ, et, ref, abcorr, obs)
    end
 
    %
-   % Call the MEX library. The "_s" suffix indicates a structure type
-   % return argument.
+   % Call the MEX library. The "_m" interface returns the positions as a
+   % 3xNxK array and the light times as a 1xNxK array, N the
+   % number of epochs and K the number of targets.
+   %
+   % A MEX library built before 'spkpos_m' existed knows only the "_s"
+   % (structure) interface; call that one target at a time instead.
    %
    try
-      [ptarg] = mice('spkpos_s', targ, et,ref, abcorr, obs);
-      pos     = reshape( [ptarg.pos], 3, [] );
-      lt      = reshape( [ptarg.lt],  1, [] );
+      [pos, lt] = mice('spkpos_m', targ, et, ref, abcorr, obs);
    catch
-      rethrow(lasterror)
+      err = lasterror;
+      if isempty( strfind( err.message, 'MICE(UNKNOWNCALL)' ) )
+         rethrow(err)
+      end
+      try
+         K   = size(targ, 1);
+         pos = zeros( 3, numel(et), K );
+         lt  = zeros( 1, numel(et), K );
+         for k = 1:K
+            [ptarg]    = mice('spkpos_s', deblank(targ(k,:)), et, ref, abcorr, obs);
+            pos(:,:,k) = reshape( [ptarg.pos], 3, [] );
+            lt (:,:,k) = reshape( [ptarg.lt],  1, [] );
+         end
+      catch
+         rethrow(lasterror)
+      end
    end
 
 
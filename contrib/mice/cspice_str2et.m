@@ -117,7 +117,11 @@
 %
 %-Particulars
 %
-%   None.
+%   A character array of ISO-8601 UTC times, "YYYY-MM-DDThh:mm:ss.fff"
+%   with a 'T' or blank between date and time, any number of fraction
+%   digits and an optional trailing 'Z', converts in a batch without
+%   the general time string parser. The results are those of str2et_c;
+%   rows in other formats convert as before.
 %
 %-Required Reading
 %
@@ -129,6 +133,10 @@
 %
 %-Version
 %
+%   -Mice Version 1.1.0, 18-OCT-2026
+%
+%      Batched conversion of ISO-8601 UTC character arrays.
+%
 %   -Mice Version 1.0.0, 22-NOV-2005, EDW (JPL)
 %
 %-Index_Entries
@@ -50,6 +50,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <math.h>
 #include "mex.h"
 #include "SpiceUsr.h"
 #include "SpiceZmc.h"
@@ -416,6 +417,7 @@ struct bucket
    {
    char           * key;
    void           (*binding)(int, mxArray*[], int, const mxArray*[]);
+   SpiceInt         slot;
    struct bucket  * next;
    };
 
@@ -446,9 +448,9 @@ void hashtable_destroy()
 
 
 /*
--Procedure  hashtable_lookup
+-Procedure  hashtable_bucket
 */
-void ( *hashtable_lookup(char *key) )(int, mxArray*[], int, const mxArray*[])
+struct bucket * hashtable_bucket(char *key)
    {
    int index =  zzhash2_(key, &m2, strlen(key));
    struct bucket  * b;
@@ -457,7 +459,7 @@ void ( *hashtable_lookup(char *key) )(int, mxArray*[], int, const mxArray*[])
       {
       if (0==strcmp(b->key,key))
          {
-         return b->binding;
+         return b;
          }
       }
 
@@ -467,11 +469,25 @@ void ( *hashtable_lookup(char *key) )(int, mxArray*[], int, const mxArray*[])
 
 
 
+/*
+-Procedure  hashtable_lookup
+*/
+void ( *hashtable_lookup(char *key) )(int, mxArray*[], int, const mxArray*[])
+   {
+   struct bucket  * b = hashtable_bucket(key);
+
+   return b ? b->binding : NULL;
+   }
+
+
+
+
 /*
 -Procedure Bucket
 */
 struct bucket *Bucket( char *key,
                        void (*binding)(int, mxArray*[], int, const mxArray*[]),
+                       SpiceInt slot,
                        struct bucket *next )
    {
    struct bucket *b = malloc(sizeof(struct bucket));
@@ -484,6 +500,7 @@ struct bucket *Bucket( char *key,
 
    b->key      = key;
    b->binding  = binding;
+   b->slot     = slot;
    b->next     = next;
    return b;
    }
@@ -495,10 +512,11 @@ struct bucket *Bucket( char *key,
 -Procedure hashtable_insert
 */
 void hashtable_insert(char *key,
-                      void (*binding)(int, mxArray*[], int, const mxArray*[]))
+                      void (*binding)(int, mxArray*[], int, const mxArray*[]),
+                      SpiceInt slot)
    {
    int index    = zzhash2_(key, &m2, strlen(key));
-   table[index] = Bucket(key, binding, table[index]);
+   table[index] = Bucket(key, binding, slot, table[index]);
    }
 
 
@@ -1721,552 +1739,883 @@ void cspice_ckgpav(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              ckobj_c ( ConstSpiceChar    * ck,
-                               SpiceCell         * ids );
-
+   Attitude from a quaternion cache.
+
+   [q, found] = mice('ckgp_q', inst, et, ref, tol, form) returns the
+   attitude of 'inst' relative to 'ref' at the ephemeris times 'et', as
+   cspice_ckgp returns it for the encoded SCLK times of 'et', but from
+   quaternions cached at adaptively spaced knots. form 'QUAT' returns the
+   4xN quaternions of the C-matrices, form 'SPIN' the 1xN spin phases:
+   the angle, counterclockwise about +Z of 'ref', from the +X axis of
+   'ref' to the projection of the +X axis of 'inst' on the X-Y plane of
+   'ref', in [0, 2pi). Epochs without pointing have NaN and found false.
+
+   tol = [ticks angle] gives the SCLK tolerance passed to ckgp_c and the
+   bound on the interpolation error in radians. A knot interval is
+   interpolated by quaternion SLERP if the interpolation agrees with
+   ckgp_c at the interval midpoint within the bound and the knots are
+   less than CKQ_MAXANG apart, otherwise it is halved. The angle limit
+   keeps the midpoint test meaningful for spinning spacecraft: a SLERP
+   over a full spin period would agree at the midpoint, and everywhere
+   else be wrong. Intervals that do not interpolate down to CKQ_HMIN
+   seconds, those with the pointing found at one end only, and those
+   in coverage gaps are flagged, epochs in them go to ckgp_c. Epochs
+   more than CKQ_EDGE seconds outside the coverage of 'inst' in the
+   loaded CK files, as ckcov_c gives it, have no pointing without a
+   call.
+
+   The knots persist between calls for the same instrument, frame and
+   tolerance, queries in a covered interval are a binary search and a
+   SLERP. Beyond CKQ_MAX_KNOTS knots the spans not used by the current
+   call are dropped. NaN and infinite epochs have no pointing.
+   mice('ckgp_q') frees the knots, which also happens when kernels are
+   loaded or unloaded.
 */
-void cspice_ckobj(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
-   {
-   SpiceChar           ck[DEFAULT_STR_LENGTH+1];
-   mxChar            * mx_ck;
 
-   SpiceInt            i;
-   SpiceInt            j;
-   int                 sizearray[2];
+#define  CKQ_H0          0.25
+#define  CKQ_HMIN        1.0e-3
+#define  CKQ_HMAX        3600.0
+#define  CKQ_MAXANG      0.7853981633974483
+#define  CKQ_GAP         600.0
+#define  CKQ_EDGE        1.0e-3
+#define  CKQ_MAX_KNOTS   4000000
+#define  CKQ_MAX_COVER   100000
 
-   SpiceInt            card = 0;
-   SpiceInt            size;
-   SpiceInt          * ids_f;
-   SpiceInt          * ids;
+#define  CKQ_FOUND       1
+#define  CKQ_INTERP      2
 
-   struct extra_dims * extra;
-   struct argcheck ArgCheck[] =
-      {
-      { "ck",   MiceChar,   0, {0}, 1},
-      { "size", MiceInt,    0, {0}, 0},
-      { "ids",  MiceIgnore, 0, {0}, 0},
-      };
+struct ckq_span
+   {
+   SpiceInt             n;
+   SpiceDouble        * et;
+   SpiceDouble        * q;
+   unsigned char      * flag;
+   SpiceInt             call;
+   };
 
-   check_arg_num( nrhs, nlhs, 2, 1 );
+struct ckq_cache
+   {
+   SpiceChar            key[DEFAULT_STR_LENGTH+96];
+   SpiceInt             nspan;
+   struct ckq_span    * span;
+   SpiceInt             ncover;
+   SpiceDouble        * cover;
+   struct ckq_cache   * next;
+   };
 
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+static struct ckq_cache * ckq_caches = NULL;
+static SpiceInt           ckq_nknots = 0;
+static SpiceInt           ckq_call   = 0;
 
-   size = S_INT_ARGV(2);
-   ids  = (SpiceInt*)mxMalloc( (size + SPICE_CELL_CTRLSZ)*sizeof(SpiceInt)  );
+static SpiceDouble pxv_angle( ConstSpiceDouble * a, ConstSpiceDouble * b );
+static void        pxv_slerp( ConstSpiceDouble * q0,
+                              ConstSpiceDouble * q1,
+                              SpiceDouble        u,
+                              SpiceDouble      * q );
+static int         eph_compare( const void * a, const void * b );
 
-   ssizei_( ( integer * ) &size, ( integer * ) ids   );
-   scardi_( ( integer * ) &card, ( integer * ) ids   );
 
-   if (extra->count>1)
+static void ckq_free( struct ckq_cache * c )
+   {
+   SpiceInt             i;
+
+   for ( i=0; i<c->nspan; i++ )
       {
+      free( c->span[i].et   );
+      free( c->span[i].q    );
+      free( c->span[i].flag );
+      ckq_nknots -= c->span[i].n;
+      }
 
-      mx_ck = (mxChar *)mxGetChars(prhs[1]);
+   free( c->span );
+   c->span  = NULL;
+   c->nspan = 0;
+   }
 
-      for ( i=0; i<extra->count; i++)
-         {
 
-         /*
-         Extract the string data, character by character, into
-         CSPICE strings. The mx_str array stores the data in a column
-         major format, we need to extract the data by rows.
-         */
-         for ( j=0; j<extra->offset[0]; j++)
-            {
-            ck[j] = (char)mx_ck[i + (extra->count*j)];
-            }
+static void ckq_clear( void )
+   {
+   struct ckq_cache   * c;
 
-         ck[extra->offset[0]] = '\0';
+   while ( (c = ckq_caches) != NULL )
+      {
+      ckq_caches = c->next;
+      ckq_free( c );
+      free( c->cover );
+      free( c );
+      }
 
-         ckobj_(  ( char        * ) ck,
-                   ( integer    * ) (ids),
-                   ( ftnlen       ) strlen(ck)   );
+   ckq_nknots = 0;
+   }
 
-         /*
-         Check for a failure signal. Free the memory assigned to 'ids'
-         before signaling a Matlab error.
-         */
-         if ( failed_c())
-            {
-            mxFree( ids );
 
-            /*
-            The mice_fail call creates the error string then returns control
-            to the MATLAB interpreter.
-            */
-            mice_fail(i);
-            }
+/*
+Drop the knots of the other instruments and the spans of 'c' not used
+by the current call.
+*/
+static void ckq_evict( struct ckq_cache * c )
+   {
+   struct ckq_cache   * p;
+   SpiceInt             k;
+   SpiceInt             m = 0;
 
+   for ( p=ckq_caches; p; p=p->next )
+      {
+      if ( p != c )
+         {
+         ckq_free( p );
          }
-
       }
-   else
-      {
-      mxGetString(prhs[1], ck, DEFAULT_STR_LENGTH);
-
-      ckobj_(  ( char        * ) ck,
-                ( integer    * ) (ids),
-                ( ftnlen       ) strlen(ck)   );
 
-      /*
-      Check for a failure signal. Free the memory assigned to 'ids'
-      before signaling a Matlab error.
-      */
-      if ( failed_c())
+   for ( k=0; k<c->nspan; k++ )
+      {
+      if ( c->span[k].call == ckq_call )
          {
-         mxFree( ids );
-
-         /*
-         The mice_fail call creates the error string then returns control
-         to the MATLAB interpreter.
-         */
-         mice_fail(SCALAR);
+         c->span[m++] = c->span[k];
+         }
+      else
+         {
+         free( c->span[k].et   );
+         free( c->span[k].q    );
+         free( c->span[k].flag );
+         ckq_nknots -= c->span[k].n;
          }
-
       }
 
+   c->nspan = m;
+   }
+
+
+/*
+Pointing of 'inst' at 'et' as a quaternion, SPICEFALSE if none.
+*/
+static SpiceBoolean ckq_eval( SpiceInt         inst,
+                              SpiceDouble      et,
+                              SpiceDouble      tol,
+                              ConstSpiceChar * ref,
+                              SpiceDouble      q[4] )
+   {
+   SpiceDouble          sclkdp;
+   SpiceDouble          clkout;
+   SpiceDouble          cmat[3][3];
+   SpiceInt             sclkid;
+   SpiceBoolean         found;
+
    /*
-   Array element 6, index 5, contains the cell cardinality. Create an output
-   array CARDx1.
+   The clock of the CK frame, as CK_<inst>_SCLK maps it or else the
+   spacecraft of the instrument ID.
    */
-   sizearray[0] = ids[5];
-   sizearray[1] = 1;
+   ckmeta_c( inst, "SCLK", &sclkid );
+   sce2c_c ( sclkid, et, &sclkdp );
+   ckgp_c ( inst, sclkdp, tol, ref, cmat, &clkout, &found );
+   CHECK_CALL_FAILURE(SCALAR);
 
-   plhs[0] = mxCreateNumericArray( 2, sizearray, mxINT32_CLASS, mxREAL);
-   ids_f   = A_INT_RET_ARGV(0);
+   if ( found )
+      {
+      m2q_c( cmat, q );
+      }
 
-   MOVEI( ids + SPICE_CELL_CTRLSZ, ids[5], ids_f );
-   mxFree( ids );
+   return found;
    }
 
 
-
-
 /*
-   void              ckopn_c  ( ConstSpiceChar    * name,
-                                ConstSpiceChar    * ifname,
-                                SpiceInt            ncomch,
-                                SpiceInt          * handle  )
+Coverage of 'inst' in the loaded CK files as ET intervals, ncover -1
+if it cannot be determined.
 */
-void cspice_ckopn(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+static void ckq_coverage( struct ckq_cache * c,
+                          SpiceInt           inst,
+                          SpiceDouble        tol )
    {
+   SpiceChar            file  [DEFAULT_STR_LENGTH+1];
+   SpiceChar            filtyp[DEFAULT_STR_LENGTH+1];
+   SpiceChar            source[DEFAULT_STR_LENGTH+1];
+   SpiceDouble        * cover;
+   SpiceInt             size = 2*CKQ_MAX_COVER;
+   SpiceInt             card = 0;
+   SpiceInt             count;
+   SpiceInt             handle;
+   SpiceInt             i;
+   SpiceBoolean         found;
 
-   SpiceChar            fname [DEFAULT_STR_LENGTH+1];
-   SpiceChar            ifname[DEFAULT_STR_LENGTH+1];
-   SpiceInt             ncomch;
-   SpiceInt           * handle;
+   SpiceCell            cover_cell = { SPICE_DP,
+                                       0,
+                                       0,
+                                       0,
+                                       SPICETRUE,
+                                       SPICEFALSE,
+                                       SPICEFALSE,
+                                       NULL,
+                                       NULL };
 
-   struct extra_dims  * extra;
-   struct argcheck ArgCheck[] =
+   c->ncover = -1;
+   c->cover  = NULL;
+
+   cover = (SpiceDouble*)malloc( (size + SPICE_CELL_CTRLSZ)
+                                 * sizeof(SpiceDouble) );
+
+   if ( cover == NULL )
       {
-      { "fname",  MiceChar, 0, {0}, 0},
-      { "ifname", MiceChar, 0, {0}, 0},
-      { "ncomch", MiceInt,  0, {0}, 0},
-      { "handle", MiceInt,  0, {0}, 0},
-      };
+      return;
+      }
 
-   check_arg_num( nrhs, nlhs, 3, 1);
+   ssized_( ( integer * ) &size, ( double * ) cover );
+   scardd_( ( integer * ) &card, ( double * ) cover );
 
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+   cover_cell.size = size;
+   cover_cell.base = cover;
+   cover_cell.data = &cover[SPICE_CELL_CTRLSZ];
 
-   mxGetString(prhs[1], fname,  DEFAULT_STR_LENGTH);
-   mxGetString(prhs[2], ifname, DEFAULT_STR_LENGTH);
+   ktotal_c( "CK", &count );
 
-   ncomch = S_INT_ARGV(3);
-   handle = A_INT_RET_ARGV(0);
+   for ( i=0; i<count && !failed_c(); i++ )
+      {
+      kdata_c( i, "CK", DEFAULT_STR_LENGTH, DEFAULT_STR_LENGTH,
+               DEFAULT_STR_LENGTH, file, filtyp, source, &handle, &found );
 
-   ckopn_c( fname, ifname, ncomch, handle );
-   CHECK_CALL_FAILURE(SCALAR);
+      ckcov_c( file, inst, SPICEFALSE, "INTERVAL", tol, "TDB", &cover_cell );
+      }
 
-   }
+   /*
+   A coverage too fragmented for the cell only costs the shortcut.
+   */
+   if ( failed_c() )
+      {
+      reset_c();
+      free( cover );
+      return;
+      }
 
+   c->ncover = card_c( &cover_cell );
+   c->cover  = cover;
 
+   memmove( cover, cover + SPICE_CELL_CTRLSZ,
+            c->ncover * sizeof(SpiceDouble) );
+   }
 
 
 /*
-   void              ckw01_c  ( SpiceInt            handle,
-                                SpiceDouble         begtime,
-                                SpiceDouble         endtime,
-                                SpiceInt            inst,
-                                ConstSpiceChar    * ref,
-                                SpiceBoolean        avflag,
-                                ConstSpiceChar    * segid,
-                                SpiceInt            nrec,
-                                ConstSpiceDouble    sclkdp [],
-                                ConstSpiceDouble    quats  [][4],
-                                ConstSpiceDouble    avvs   [][3]  );
-
+SPICETRUE if 't' is well outside the coverage of 'c'.
 */
-void cspice_ckw01(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+static SpiceBoolean ckq_gap( const struct ckq_cache * c, SpiceDouble t )
    {
+   SpiceInt             lo = 0;
+   SpiceInt             hi;
+   SpiceInt             mid;
 
-   SpiceInt             handle;
-   SpiceDouble          begtime;
-   SpiceDouble          endtime;
-   SpiceInt             inst;
-   SpiceChar            ref   [DEFAULT_STR_LENGTH+1];
-   SpiceBoolean         avflag;
-   SpiceChar            segid [DEFAULT_STR_LENGTH+1];
-   SpiceInt             sclkdp_size;
+   if ( c->ncover < 0 )
+      {
+      return SPICEFALSE;
+      }
 
-   ConstSpiceDouble   * sclkdp;
-   ConstSpiceDouble   * quats;
-   ConstSpiceDouble   * avvs;
+   /*
+   The first interval end at or after t - CKQ_EDGE.
+   */
+   hi = c->ncover;
 
-   struct extra_dims  * extra;
-   struct argcheck ArgCheck[] =
+   while ( lo < hi )
       {
-      { "handle",  MiceInt,     0, { 0 },    0},
-      { "begtime", MiceDouble,  0, { 0 },    0},
-      { "endtime", MiceDouble,  0, { 0 },    0},
-      { "inst",    MiceInt,     0, { 0 },    0},
-      { "ref",     MiceChar,    0, { 0 },    0},
-      { "avflag",  MiceInt, 0, { 0 },    0},
-      { "segid",   MiceChar,    0, { 0 },    0},
-      { "sclkdp",  MiceDouble,  1, { 0 },    0},
-      { "quats",   MiceDouble,  2, { 4, 0 }, 0},
-      { "avvs",    MiceDouble,  2, { 3, 0 }, 0},
-      };
+      mid = (lo + hi) / 2;
 
-   check_arg_num( nrhs, nlhs, 10, 0);
+      if ( c->cover[mid] < t - CKQ_EDGE )
+         {
+         lo = mid + 1;
+         }
+      else
+         {
+         hi = mid;
+         }
+      }
 
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+   /*
+   An odd index is the end of an interval containing t - CKQ_EDGE, an
+   even one the start of the next interval.
+   */
+   return ( lo == c->ncover )
+       || ( lo % 2 == 0 && c->cover[lo] > t + CKQ_EDGE );
+   }
 
-   sclkdp_size = mxGetNumberOfElements( prhs[8] );
 
-   if( 4*sclkdp_size !=  (SpiceInt)mxGetNumberOfElements( prhs[9] ) )
-      {
-      mexErrMsgTxt( "MICE(INVALIDSIZE): Matrix `quats` must have the same "
-                            "measure of vectorization as `sclkdp`" );
-      }
+/*
+Append a knot to 'span', growing the arrays with mxRealloc.
+*/
+static void ckq_push( struct ckq_span  * span,
+                      SpiceInt         * size,
+                      SpiceDouble        t,
+                      ConstSpiceDouble * q,
+                      SpiceBoolean       found )
+   {
 
-   if( 3*sclkdp_size != (SpiceInt)mxGetNumberOfElements( prhs[10] ) )
+   if ( span->n == *size )
       {
-      mexErrMsgTxt( "MICE(INVALIDSIZE): Matrix `aavs` must have the same "
-                            "measure of vectorization as `sclkdp`" );
+      *size     *= 2;
+      span->et   = (SpiceDouble*)mxRealloc( span->et,
+                                      *size   * sizeof(SpiceDouble) );
+      span->q    = (SpiceDouble*)mxRealloc( span->q,
+                                      4**size * sizeof(SpiceDouble) );
+      span->flag = (unsigned char*)mxRealloc( span->flag, *size );
       }
 
-   handle  = S_INT_ARGV(1);
-   begtime = S_DBL_ARGV(2);
-   endtime = S_DBL_ARGV(3);
-   inst    = S_INT_ARGV(4);
+   span->et  [span->n] = t;
+   span->flag[span->n] = found ? CKQ_FOUND : 0;
+   MOVED( q, 4, span->q + 4*span->n );
+   span->n++;
+   }
 
-   mxGetString(prhs[5], ref, DEFAULT_STR_LENGTH);
 
-   avflag  = *(SpiceBoolean*)mxGetData(prhs[6]);
+/*
+Knots covering [a, b].
+*/
+static void ckq_build( SpiceInt          inst,
+                       ConstSpiceChar  * ref,
+                       SpiceDouble       tol,
+                       SpiceDouble       atol,
+                       SpiceDouble       a,
+                       SpiceDouble       b,
+                       struct ckq_span * span )
+   {
+   SpiceDouble          t;
+   SpiceDouble          t1;
+   SpiceDouble          tm = 0.0;
+   SpiceDouble          h = CKQ_H0;
+   SpiceDouble          q0[4] = { 1.0, 0.0, 0.0, 0.0 };
+   SpiceDouble          q1[4] = { 1.0, 0.0, 0.0, 0.0 };
+   SpiceDouble          qm[4] = { 1.0, 0.0, 0.0, 0.0 };
+   SpiceDouble          qi[4];
+   SpiceDouble          err = 0.0;
+   SpiceDouble          ang = 0.0;
+   SpiceBoolean         f0;
+   SpiceBoolean         f1;
+   SpiceBoolean         fm = SPICEFALSE;
+   SpiceBoolean         interp;
+   SpiceInt             size = 1024;
+
+   span->n    = 0;
+   span->et   = (SpiceDouble*)mxMalloc( size   * sizeof(SpiceDouble) );
+   span->q    = (SpiceDouble*)mxMalloc( 4*size * sizeof(SpiceDouble) );
+   span->flag = (unsigned char*)mxMalloc( size );
+
+   t  = a;
+   f0 = ckq_eval( inst, t, tol, ref, q0 );
+   ckq_push( span, &size, t, q0, f0 );
+
+   while ( t < b )
+      {
+
+      h  = MinVal( h, b - t );
+      t1 = t + h;
+      f1 = ckq_eval( inst, t1, tol, ref, q1 );
+
+      for (;;)
+         {
+         interp = SPICEFALSE;
 
-   mxGetString(prhs[7], segid, DEFAULT_STR_LENGTH);
+         if ( f0 && f1 )
+            {
+            tm  = t + 0.5*h;
+            fm  = ckq_eval( inst, tm, tol, ref, qm );
+            ang = pxv_angle( q0, q1 );
+
+            if ( fm )
+               {
+               pxv_slerp( q0, q1, 0.5, qi );
+               err    = pxv_angle( qi, qm );
+               interp = ( err <= atol && ang <= CKQ_MAXANG );
+               }
+            }
 
-   sclkdp  = (ConstSpiceDouble*)mxGetData(prhs[8]);
-   quats   = (ConstSpiceDouble*)mxGetData(prhs[9]);
-   avvs    = (ConstSpiceDouble*)mxGetData(prhs[10]);
+         /*
+         No pointing at either end is a coverage gap, epochs in it go
+         to ckgp_c.
+         */
+         if ( interp || (!f0 && !f1) || h <= CKQ_HMIN )
+            {
+            break;
+            }
 
-   ckw01_c( handle,
-            begtime,
-            endtime,
-            inst,
-            ref,
-            avflag,
-            segid,
-            sclkdp_size,
-            sclkdp,
-            (Nx4)quats,
-            (Nx3)avvs);
+         /*
+         Halve the interval, the midpoint becomes the new end.
+         */
+         h  = 0.5*h;
+         t1 = t + h;
 
-   CHECK_CALL_FAILURE( SCALAR );
+         if ( f0 && f1 )
+            {
+            MOVED( qm, 4, q1 );
+            f1 = fm;
+            }
+         else
+            {
+            f1 = ckq_eval( inst, t1, tol, ref, q1 );
+            }
+         }
 
-   }
+      if ( interp )
+         {
+         span->flag[span->n-1] |= CKQ_INTERP;
+         ckq_push( span, &size, tm, qm, SPICETRUE );
+         span->flag[span->n-1] |= CKQ_INTERP;
+
+         /*
+         The SLERP error grows with h^2, doubling is safe well below the
+         bound. The angle limit keeps a doubled interval under half a
+         turn, where the midpoint test cannot alias.
+         */
+         if ( err < atol/8.0 && ang < 0.5*CKQ_MAXANG )
+            {
+            h = MinVal( 2.0*h, CKQ_HMAX );
+            }
+         }
+      else if ( !f0 && !f1 )
+         {
+         h = MinVal( 2.0*h, CKQ_HMAX );
+         }
+      else
+         {
+         /*
+         A jump or the edge of the coverage, start again with the
+         initial interval.
+         */
+         h = CKQ_H0;
+         }
+
+      ckq_push( span, &size, t1, q1, f1 );
 
+      t  = t1;
+      f0 = f1;
+      MOVED( q1, 4, q0 );
+      }
 
+   }
 
 
 /*
-   void              ckw02_c  ( SpiceInt            handle,
-                                SpiceDouble         begtim,
-                                SpiceDouble         endtim,
-                                SpiceInt            inst,
-                                ConstSpiceChar    * ref,
-                                ConstSpiceChar    * segid,
-                                SpiceInt            nrec,
-                                ConstSpiceDouble    start  [],
-                                ConstSpiceDouble    stop   [],
-                                ConstSpiceDouble    quats  [][4],
-                                ConstSpiceDouble    avvs   [][3],
-                                ConstSpiceDouble    rates  []    )
+Index of the span of 'c' covering 't', -1 if none.
 */
-void cspice_ckw02(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+static SpiceInt ckq_find( const struct ckq_cache * c, SpiceDouble t )
    {
+   SpiceInt             lo = 0;
+   SpiceInt             hi = c->nspan;
+   SpiceInt             mid;
 
-   SpiceInt             handle;
-   SpiceDouble          begtime;
-   SpiceDouble          endtime;
-   SpiceInt             inst;
-   SpiceChar            ref   [DEFAULT_STR_LENGTH+1];
-   SpiceChar            segid [DEFAULT_STR_LENGTH+1];
-   SpiceInt             start_size;
+   while ( lo < hi )
+      {
+      mid = (lo + hi) / 2;
 
-   ConstSpiceDouble   * start;
-   ConstSpiceDouble   * stop;
-   ConstSpiceDouble   * quats;
-   ConstSpiceDouble   * avvs;
-   ConstSpiceDouble   * rates;
+      if ( c->span[mid].et[0] <= t )
+         {
+         lo = mid + 1;
+         }
+      else
+         {
+         hi = mid;
+         }
+      }
 
-   struct extra_dims  * extra;
-   struct argcheck ArgCheck[] =
+   if ( lo > 0 && t <= c->span[lo-1].et[c->span[lo-1].n - 1] )
       {
-      { "handle",  MiceInt,     0, { 0 },    0},
-      { "begtime", MiceDouble,  0, { 0 },    0},
-      { "endtime", MiceDouble,  0, { 0 },    0},
-      { "inst",    MiceInt,     0, { 0 },    0},
-      { "ref",     MiceChar,    0, { 0 },    0},
-      { "segid",   MiceChar,    0, { 0 },    0},
-      { "start",   MiceDouble,  1, { 0 },    0},
-      { "stop",    MiceDouble,  1, { 0 },    0},
-      { "quats",   MiceDouble,  2, { 4, 0 }, 0},
-      { "avvs",    MiceDouble,  2, { 3, 0 }, 0},
-      { "rates",   MiceDouble,  1, { 0 },    0},
-      };
+      return lo - 1;
+      }
 
-   check_arg_num( nrhs, nlhs, 11, 0);
+   return -1;
+   }
 
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   start_size = mxGetNumberOfElements( prhs[7] );
+/*
+Move a built span to persistent memory and insert it in 'c', keeping the
+spans sorted.
+*/
+static void ckq_insert( struct ckq_cache * c, const struct ckq_span * s )
+   {
+   struct ckq_span      p;
+   struct ckq_span    * spans;
+   SpiceInt             k;
 
-   if( start_size !=  (SpiceInt)mxGetNumberOfElements( prhs[8] ) )
+   p.n    = s->n;
+   p.et   = (SpiceDouble*)malloc(   s->n * sizeof(SpiceDouble) );
+   p.q    = (SpiceDouble*)malloc( 4*s->n * sizeof(SpiceDouble) );
+   p.flag = (unsigned char*)malloc( s->n );
+   spans  = (struct ckq_span*)realloc( c->span,
+                                 (c->nspan + 1) * sizeof(struct ckq_span) );
+
+   if ( p.et == NULL || p.q == NULL || p.flag == NULL || spans == NULL )
       {
-      mexErrMsgTxt( "MICE(INVALIDSIZE): Array `stop` must have the same "
-                            "measure of vectorization as `start`" );
+      free( p.et );
+      free( p.q );
+      free( p.flag );
+
+      if ( spans != NULL )
+         {
+         c->span = spans;
+         }
+
+      mexErrMsgTxt( "MICE(MALLOCFAILED): Cannot store attitude knots." );
       }
 
-   if( 4*start_size !=  (SpiceInt)mxGetNumberOfElements( prhs[9] ) )
+   memcpy( p.et,   s->et,     s->n * sizeof(SpiceDouble) );
+   memcpy( p.q,    s->q,    4*s->n * sizeof(SpiceDouble) );
+   memcpy( p.flag, s->flag,   s->n );
+   c->span = spans;
+
+   for ( k=c->nspan; k>0 && c->span[k-1].et[0] > p.et[0]; k-- )
       {
-      mexErrMsgTxt( "MICE(INVALIDSIZE): Matrix `quats` must have the same "
-                            "measure of vectorization as `start`" );
+      c->span[k] = c->span[k-1];
       }
 
-   if( 3*start_size !=  (SpiceInt)mxGetNumberOfElements( prhs[10] ) )
+   p.call     = ckq_call;
+   c->span[k] = p;
+   c->nspan++;
+   ckq_nknots += p.n;
+   }
+
+
+/*
+Quaternion at 't' in span 's' of 'c', from the knots or from ckgp_c.
+*/
+static SpiceBoolean ckq_lookup( const struct ckq_cache * c,
+                                const struct ckq_span  * s,
+                                SpiceInt                 inst,
+                                SpiceDouble              t,
+                                SpiceDouble              tol,
+                                ConstSpiceChar         * ref,
+                                SpiceDouble              q[4] )
+   {
+   SpiceInt             lo = 0;
+   SpiceInt             hi = s->n - 1;
+   SpiceInt             mid;
+
+   while ( hi - lo > 1 )
       {
-      mexErrMsgTxt( "MICE(INVALIDSIZE): Matrix `aavs` must have the same "
-                            "measure of vectorization as `start`" );
+      mid = (lo + hi) / 2;
+
+      if ( s->et[mid] <= t )
+         {
+         lo = mid;
+         }
+      else
+         {
+         hi = mid;
+         }
       }
 
-   if( start_size !=  (SpiceInt)mxGetNumberOfElements( prhs[11] ) )
+   if ( t == s->et[lo] )
       {
-      mexErrMsgTxt( "MICE(INVALIDSIZE): Array `rates` must have the same "
-                            "measure of vectorization as `start`" );
+      MOVED( s->q + 4*lo, 4, q );
+      return ( s->flag[lo] & CKQ_FOUND ) != 0;
       }
 
-   handle  = S_INT_ARGV(1);
-   begtime = S_DBL_ARGV(2);
-   endtime = S_DBL_ARGV(3);
-   inst    = S_INT_ARGV(4);
-
-   mxGetString(prhs[5], ref,   DEFAULT_STR_LENGTH);
-   mxGetString(prhs[6], segid, DEFAULT_STR_LENGTH);
-
-   start   = (ConstSpiceDouble*)mxGetData(prhs[7]);
-   stop    = (ConstSpiceDouble*)mxGetData(prhs[8]);
-   quats   = (ConstSpiceDouble*)mxGetData(prhs[9]);
-   avvs    = (ConstSpiceDouble*)mxGetData(prhs[10]);
-   rates   = (ConstSpiceDouble*)mxGetData(prhs[11]);
+   if ( t == s->et[hi] )
+      {
+      MOVED( s->q + 4*hi, 4, q );
+      return ( s->flag[hi] & CKQ_FOUND ) != 0;
+      }
 
-   ckw02_c( handle,
-            begtime,
-            endtime,
-            inst,
-            ref,
-            segid,
-            start_size,
-            start,
-            stop,
-            (Nx4)quats,
-            (Nx3)avvs,
-            rates);
+   if ( s->flag[lo] & CKQ_INTERP )
+      {
+      pxv_slerp( s->q + 4*lo, s->q + 4*hi,
+                 (t - s->et[lo]) / (s->et[hi] - s->et[lo]), q );
+      return SPICETRUE;
+      }
 
-   CHECK_CALL_FAILURE( SCALAR );
+   if ( ckq_gap( c, t ) )
+      {
+      return SPICEFALSE;
+      }
 
+   return ckq_eval( inst, t, tol, ref, q );
    }
 
 
-
-
-/*
-   void              ckw03_c  ( SpiceInt            handle,
-                                SpiceDouble         begtim,
-                                SpiceDouble         endtim,
-                                SpiceInt            inst,
-                                ConstSpiceChar    * ref,
-                                SpiceBoolean        avflag,
-                                ConstSpiceChar    * segid,
-                                SpiceInt            nrec,
-                                ConstSpiceDouble    sclkdp [],
-                                ConstSpiceDouble    quats  [][4],
-                                ConstSpiceDouble    avvs   [][3],
-                                SpiceInt            nints,
-                                ConstSpiceDouble    starts []     );
-*/
-void cspice_ckw03(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void mice_ckgp_q(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceInt             handle;
-   SpiceDouble          begtime;
-   SpiceDouble          endtime;
+   SpiceDouble        * vec_et;
+   SpiceDouble        * vec_out;
+   SpiceDouble        * vec_tol;
+   SpiceDouble        * todo;
+   mxLogical          * vec_found;
+   SpiceChar            ref [DEFAULT_STR_LENGTH+1];
+   SpiceChar            form[DEFAULT_STR_LENGTH+1];
+   SpiceChar            key [DEFAULT_STR_LENGTH+96];
+   SpiceDouble          tol;
+   SpiceDouble          atol;
+   SpiceDouble          q[4];
+   SpiceDouble          m[3][3];
+   SpiceDouble          phase;
+   SpiceBoolean         spin;
+   SpiceBoolean         found;
    SpiceInt             inst;
-   SpiceChar            ref   [DEFAULT_STR_LENGTH+1];
-   SpiceBoolean         avflag;
-   SpiceChar            segid [DEFAULT_STR_LENGTH+1];
-   SpiceInt             sclkdp_size;
-   SpiceInt             nints;
+   struct ckq_cache   * c;
+   struct ckq_span      span;
 
-   ConstSpiceDouble   * sclkdp;
-   ConstSpiceDouble   * quats;
-   ConstSpiceDouble   * avvs;
-   ConstSpiceDouble   * starts;
+   SpiceInt             n;
+   SpiceInt             nq;
+   SpiceInt             ntodo;
+   SpiceInt             first;
+   SpiceInt             i;
+   SpiceInt             k;
+   SpiceInt             last = -1;
 
-   struct extra_dims  * extra;
-   struct argcheck ArgCheck[] =
+   if ( nrhs == 1 )
       {
-      { "handle",  MiceInt,     0, { 0 },    0},
-      { "begtime", MiceDouble,  0, { 0 },    0},
-      { "endtime", MiceDouble,  0, { 0 },    0},
-      { "inst",    MiceInt,     0, { 0 },    0},
-      { "ref",     MiceChar,    0, { 0 },    0},
-      { "avflag",  MiceInt, 0, { 0 },    0},
-      { "segid",   MiceChar,    0, { 0 },    0},
-      { "sclkdp",  MiceDouble,  1, { 0 },    0},
-      { "quats",   MiceDouble,  2, { 4, 0 }, 0},
-      { "avvs",    MiceDouble,  2, { 3, 0 }, 0},
-      { "starts",  MiceDouble,  1, { 0 },    0},
-      };
+      check_arg_num( nrhs, nlhs, 0, 0 );
+      ckq_clear();
+      return;
+      }
 
-   check_arg_num( nrhs, nlhs, 11, 0);
+   check_arg_num( nrhs, nlhs, 5, 2 );
 
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+   if ( !mxIsNumeric(prhs[1]) || mxGetNumberOfElements(prhs[1]) != 1 )
+      {
+      mexErrMsgTxt( "MICE(BADARG): Input argument (`inst') must be a "
+                    "numeric scalar." );
+      }
 
-   sclkdp_size = mxGetNumberOfElements( prhs[8] );
-   nints       = mxGetNumberOfElements( prhs[11]);
+   if ( !mxIsDouble(prhs[2]) || mxIsComplex(prhs[2]) )
+      {
+      mexErrMsgTxt( "MICE(BADVAL): All elements of input argument (`et') "
+                    "must have type double." );
+      }
 
-   if( 4*sclkdp_size !=  (SpiceInt)mxGetNumberOfElements( prhs[9] ) )
+   if ( !mxIsChar(prhs[3]) || !mxIsChar(prhs[5]) )
       {
-      mexErrMsgTxt( "MICE(INVALIDSIZE): Matrix `quats` must have the same "
-                            "measure of vectorization as `sclkdp`" );
+      mexErrMsgTxt( "MICE(BADARG): Input arguments (`ref', `form') "
+                    "must be alphabetic." );
       }
 
-   if( 3*sclkdp_size != (SpiceInt)mxGetNumberOfElements( prhs[10] ) )
+   if ( !mxIsDouble(prhs[4]) || mxGetNumberOfElements(prhs[4]) != 2 )
       {
-      mexErrMsgTxt( "MICE(INVALIDSIZE): Matrix `aavs` must have the same "
-                            "measure of vectorization as `sclkdp`" );
+      mexErrMsgTxt( "MICE(BADARG): Input argument (`tol') must be a "
+                    "2-vector [ticks angle]." );
       }
 
+   inst    = (SpiceInt)mxGetScalar(prhs[1]);
+   vec_tol = A_DBL_ARGV(4);
+   tol     = vec_tol[0];
+   atol    = vec_tol[1];
 
-   handle  = S_INT_ARGV(1);
-   begtime = S_DBL_ARGV(2);
-   endtime = S_DBL_ARGV(3);
-   inst    = S_INT_ARGV(4);
+   if ( !(tol >= 0.0) || !(atol > 0.0) )
+      {
+      mexErrMsgTxt( "MICE(BADARG): The SCLK tolerance must be "
+                    "non-negative, the angle tolerance positive." );
+      }
 
-   mxGetString(prhs[5], ref, DEFAULT_STR_LENGTH);
+   mxGetString(prhs[3], ref,  DEFAULT_STR_LENGTH);
+   mxGetString(prhs[5], form, DEFAULT_STR_LENGTH);
 
-   avflag  = *(SpiceBoolean*)mxGetData(prhs[6]);
+   if ( eqstr_c( form, "SPIN" ) )
+      {
+      spin = SPICETRUE;
+      }
+   else if ( eqstr_c( form, "QUAT" ) )
+      {
+      spin = SPICEFALSE;
+      }
+   else
+      {
+      mexErrMsgTxt( "MICE(BADARG): Input argument (`form') must be "
+                    "'QUAT' or 'SPIN'." );
+      }
 
-   mxGetString(prhs[7], segid, DEFAULT_STR_LENGTH);
+   sprintf( key, "%ld|%s|%.17g|%.17g", (long)inst, ref, tol, atol );
 
-   sclkdp  = (ConstSpiceDouble*)mxGetData(prhs[8]);
-   quats   = (ConstSpiceDouble*)mxGetData(prhs[9]);
-   avvs    = (ConstSpiceDouble*)mxGetData(prhs[10]);
-   starts  = (ConstSpiceDouble*)mxGetData(prhs[11]);
+   for ( c=ckq_caches; c; c=c->next )
+      {
+      if ( strcmp( c->key, key ) == 0 )
+         {
+         break;
+         }
+      }
 
-   ckw03_c( handle,
-            begtime,
-            endtime,
-            inst,
-            ref,
-            avflag,
-            segid,
-            sclkdp_size,
-            sclkdp,
-            (Nx4)quats,
-            (Nx3)avvs,
-            nints,
-            starts);
+   if ( c == NULL )
+      {
+      c = (struct ckq_cache*)calloc( 1, sizeof(struct ckq_cache) );
 
-   CHECK_CALL_FAILURE( SCALAR );
+      if ( c == NULL )
+         {
+         mexErrMsgTxt( "MICE(MALLOCFAILED): Cannot store attitude knots." );
+         }
 
-   }
+      strcpy( c->key, key );
+      ckq_coverage( c, inst, tol );
+      c->next    = ckq_caches;
+      ckq_caches = c;
+      }
 
+   n         = (SpiceInt)mxGetNumberOfElements(prhs[2]);
+   nq        = spin ? 1 : 4;
+   vec_et    = A_DBL_ARGV(2);
+   plhs[0]   = mxCreateDoubleMatrix( nq, n, mxREAL );
+   plhs[1]   = mxCreateLogicalMatrix( 1, n );
+   vec_out   = A_DBL_RET_ARGV(0);
+   vec_found = mxGetLogicals( plhs[1] );
 
+   /*
+   Epochs not covered by the knots so far, in spans as for spkezr_h.
+   */
+   todo  = (SpiceDouble*)mxMalloc( (n+1) * sizeof(SpiceDouble) );
+   ntodo = 0;
+   ckq_call++;
 
+   for ( i=0; i<n; i++ )
+      {
+      if ( !isfinite( vec_et[i] ) )
+         {
+         continue;
+         }
 
-/*
-   SpiceDouble              clight_c( void )
-*/
-void cspice_clight(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
-   {
+      if ( last < 0 || vec_et[i] < c->span[last].et[0] ||
+           vec_et[i] > c->span[last].et[c->span[last].n - 1] )
+         {
+         last = ckq_find( c, vec_et[i] );
+         }
 
-   check_arg_num( nrhs, nlhs, 0, 1 );
+      if ( last < 0 )
+         {
+         todo[ntodo++] = vec_et[i];
+         }
+      else
+         {
+         c->span[last].call = ckq_call;
+         }
+      }
 
-   /*
-   Directly return the scalar value. This simple case needs no
-   error checks.
-   */
-   plhs[0] = mxCreateDoubleScalar( clight_c() );
-   }
+   if ( ntodo > 0 )
+      {
 
+      qsort( todo, ntodo, sizeof(SpiceDouble), eph_compare );
 
+      first = 0;
 
+      for ( i=1; i<=ntodo; i++ )
+         {
 
-/*
-   void              clpool_c( void )
-*/
-void cspice_clpool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
-   {
+         if ( i < ntodo && todo[i] - todo[i-1] < CKQ_GAP )
+            {
+            for ( k=0; k<c->nspan; k++ )
+               {
+               if ( c->span[k].et[0] > todo[i-1] && c->span[k].et[0] < todo[i] )
+                  {
+                  break;
+                  }
+               }
+
+            if ( k == c->nspan )
+               {
+               continue;
+               }
+            }
 
-   check_arg_num( nrhs, nlhs, 0, 0 );
+         ckq_build( inst, ref, tol, atol, todo[first], todo[i-1], &span );
+
+         if ( ckq_nknots + span.n > CKQ_MAX_KNOTS )
+            {
+            ckq_evict( c );
+            }
+
+         ckq_insert( c, &span );
+         mxFree( span.et   );
+         mxFree( span.q    );
+         mxFree( span.flag );
+
+         first = i;
+         }
+
+      }
+
+   mxFree( todo );
+
+   last = -1;
+
+   for ( i=0; i<n; i++ )
+      {
+      if ( last < 0 || vec_et[i] < c->span[last].et[0] ||
+           vec_et[i] > c->span[last].et[c->span[last].n - 1] )
+         {
+         last = ckq_find( c, vec_et[i] );
+         }
+
+      found        = SPICEFALSE;
+
+      if ( last >= 0 && isfinite( vec_et[i] ) )
+         {
+         found = ckq_lookup( c, c->span + last, inst, vec_et[i],
+                             tol, ref, q );
+         }
+
+      vec_found[i] = found ? true : false;
+
+      if ( !found )
+         {
+         for ( k=0; k<nq; k++ )
+            {
+            vec_out[nq*i + k] = mxGetNaN();
+            }
+         }
+      else if ( spin )
+         {
+         /*
+         Row 0 of the C-matrix is the instrument +X axis in 'ref'.
+         */
+         q2m_c( q, m );
+         phase = atan2( m[0][1], m[0][0] );
+
+         vec_out[i] = ( phase < 0.0 ) ? phase + twopi_c() : phase;
+         }
+      else
+         {
+         MOVED( q, 4, vec_out + 4*i );
+         }
+      }
 
-   /*
-   Not much to do, make the call.
-   */
-   clpool_c();
    }
 
 
 
 
 /*
-   void              cnmfrm_c ( ConstSpiceChar    * cname,
-                                SpiceInt            lenout,
-                                SpiceInt          * frcode,
-                                SpiceChar         * frname,
-                                SpiceBoolean      * found   );
+   void              ckobj_c ( ConstSpiceChar    * ck,
+                               SpiceCell         * ids );
+
 */
-void mice_cnmfrm(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_ckobj(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
+   SpiceChar           ck[DEFAULT_STR_LENGTH+1];
+   mxChar            * mx_ck;
 
-   SpiceChar            cname[DEFAULT_STR_LENGTH+1];
-   SpiceChar            frname[DEFAULT_STR_LENGTH+1];
-   mxChar             * mx_cname;
-   SpiceInt             frcode;
-   SpiceBoolean         found;
+   SpiceInt            i;
+   SpiceInt            j;
+   int                 sizearray[2];
 
-   SpiceInt             i;
-   SpiceInt             j;
+   SpiceInt            card = 0;
+   SpiceInt            size;
+   SpiceInt          * ids_f;
+   SpiceInt          * ids;
 
-   struct extra_dims  * extra;
+   struct extra_dims * extra;
    struct argcheck ArgCheck[] =
       {
-      { "cname",  MiceChar,   0, {0}, 1},
-      { "cnmfrm", MiceNameID, 0, {0}, 1},
+      { "ck",   MiceChar,   0, {0}, 1},
+      { "size", MiceInt,    0, {0}, 0},
+      { "ids",  MiceIgnore, 0, {0}, 0},
       };
 
-   check_arg_num( nrhs, nlhs, 1, 1 );
+   check_arg_num( nrhs, nlhs, 2, 1 );
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
+   size = S_INT_ARGV(2);
+   ids  = (SpiceInt*)mxMalloc( (size + SPICE_CELL_CTRLSZ)*sizeof(SpiceInt)  );
+
+   ssizei_( ( integer * ) &size, ( integer * ) ids   );
+   scardi_( ( integer * ) &card, ( integer * ) ids   );
 
    if (extra->count>1)
       {
-      mx_cname = (mxChar *)mxGetChars(prhs[1]);
 
-      for (i=0;i<extra->count;i++)
+      mx_ck = (mxChar *)mxGetChars(prhs[1]);
+
+      for ( i=0; i<extra->count; i++)
          {
 
          /*
@@ -2276,131 +2625,110 @@ void mice_cnmfrm(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
          */
          for ( j=0; j<extra->offset[0]; j++)
             {
-            cname[j] = (SpiceChar)mx_cname[i + (extra->count*j)];
+            ck[j] = (char)mx_ck[i + (extra->count*j)];
             }
 
-         cname[extra->offset[0]] = '\0';
+         ck[extra->offset[0]] = '\0';
 
-         cnmfrm_c ( cname,
-                    DEFAULT_STR_LENGTH,
-                    &frcode,
-                    frname,
-                    &found   );
-         CHECK_CALL_FAILURE(i);
+         ckobj_(  ( char        * ) ck,
+                   ( integer    * ) (ids),
+                   ( ftnlen       ) strlen(ck)   );
 
-          mxDestroyArray( mxGetField( plhs[0], i, "frname" ) );
-          if ( found )
-             {
-             mxSetField( plhs[0], i, "name", mxCreateString(frname) );
-             }
-          else
-             {
-             mxSetField( plhs[0], i, "name", mxCreateString("\0") );
-             frcode = 0;
-             }
+         /*
+         Check for a failure signal. Free the memory assigned to 'ids'
+         before signaling a Matlab error.
+         */
+         if ( failed_c())
+            {
+            mxFree( ids );
 
-          mxDestroyArray( mxGetField( plhs[0], i,"code" ) );
-          mxSetField( plhs[0], i,"code", zzmice_CreateIntScalar(frcode) );
+            /*
+            The mice_fail call creates the error string then returns control
+            to the MATLAB interpreter.
+            */
+            mice_fail(i);
+            }
 
-          mxDestroyArray( mxGetField( plhs[0], i, "found" ) );
-          mxSetField( plhs[0], i, "found",
-                          mxCreateLogicalScalar(found ? true: false));
          }
 
       }
    else
       {
-      mxGetString(prhs[1], cname, DEFAULT_STR_LENGTH);
+      mxGetString(prhs[1], ck, DEFAULT_STR_LENGTH);
 
-      cnmfrm_c ( cname,
-                 DEFAULT_STR_LENGTH,
-                 &frcode,
-                 frname,
-                 &found   );
-      CHECK_CALL_FAILURE(SCALAR);
+      ckobj_(  ( char        * ) ck,
+                ( integer    * ) (ids),
+                ( ftnlen       ) strlen(ck)   );
 
-      mxDestroyArray( mxGetField( plhs[0], 0, "name" ) );
-      if ( found )
-         {
-         mxSetField(plhs[0], 0, "name", mxCreateString(frname)   );
-         }
-      else
+      /*
+      Check for a failure signal. Free the memory assigned to 'ids'
+      before signaling a Matlab error.
+      */
+      if ( failed_c())
          {
-         mxSetField( plhs[0], 0, "name",  mxCreateString("\0") );
-         frcode = 0;
-         }
+         mxFree( ids );
 
-      mxDestroyArray( mxGetField( plhs[0], 0,"code" ) );
-      mxSetField( plhs[0], 0,"code", zzmice_CreateIntScalar(frcode));
+         /*
+         The mice_fail call creates the error string then returns control
+         to the MATLAB interpreter.
+         */
+         mice_fail(SCALAR);
+         }
 
-      mxDestroyArray( mxGetField( plhs[0], 0, "found" ) );
-      mxSetField( plhs[0], 0, "found",
-                  mxCreateLogicalScalar(found ? true: false));
       }
 
+   /*
+   Array element 6, index 5, contains the cell cardinality. Create an output
+   array CARDx1.
+   */
+   sizearray[0] = ids[5];
+   sizearray[1] = 1;
+
+   plhs[0] = mxCreateNumericArray( 2, sizearray, mxINT32_CLASS, mxREAL);
+   ids_f   = A_INT_RET_ARGV(0);
+
+   MOVEI( ids + SPICE_CELL_CTRLSZ, ids[5], ids_f );
+   mxFree( ids );
    }
 
 
 
 
 /*
-   void              conics_c( ConstSpiceDouble  elts[8],
-                                SpiceDouble       et,
-                                SpiceDouble       state[6] )
+   void              ckopn_c  ( ConstSpiceChar    * name,
+                                ConstSpiceChar    * ifname,
+                                SpiceInt            ncomch,
+                                SpiceInt          * handle  )
 */
-void cspice_conics(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_ckopn(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_elts;
-   SpiceDouble        * vec_et;
-   SpiceDouble        * vec_state;
-   SpiceDouble        * elts;
-   SpiceDouble          et;
-   SpiceDouble        * state;
-
-   SpiceInt             i;
+   SpiceChar            fname [DEFAULT_STR_LENGTH+1];
+   SpiceChar            ifname[DEFAULT_STR_LENGTH+1];
+   SpiceInt             ncomch;
+   SpiceInt           * handle;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "elts",  MiceDouble, 1, {8}, 1},
-      { "et",    MiceDouble, 0, {0}, 1},
-      { "state", MiceDouble, 1, {6}, 1},
+      { "fname",  MiceChar, 0, {0}, 0},
+      { "ifname", MiceChar, 0, {0}, 0},
+      { "ncomch", MiceInt,  0, {0}, 0},
+      { "handle", MiceInt,  0, {0}, 0},
       };
 
-   check_arg_num( nrhs, nlhs, 2, 1 );
+   check_arg_num( nrhs, nlhs, 3, 1);
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_elts  = A_DBL_ARGV(1);
-   vec_et    = A_DBL_ARGV(2);
-   vec_state = A_DBL_RET_ARGV(0);
-
-   if (extra->count>1)
-      {
-
-      for (i=0;i<extra->count;i++)
-         {
-
-         elts  =  (vec_elts  + i*extra->offset[0]);
-         et    = *(vec_et    + i*extra->offset[1]);
-         state =  (vec_state + i*extra->offset[2]);
-
-         conics_c(elts, et, state);
-         CHECK_CALL_FAILURE(i);
-         }
-
-      }
-   else
-      {
+   mxGetString(prhs[1], fname,  DEFAULT_STR_LENGTH);
+   mxGetString(prhs[2], ifname, DEFAULT_STR_LENGTH);
 
-      elts  =  vec_elts;
-      et    = *vec_et;
-      state =  vec_state;
+   ncomch = S_INT_ARGV(3);
+   handle = A_INT_RET_ARGV(0);
 
-      conics_c(elts, et, state);
-      CHECK_CALL_FAILURE(SCALAR);
-      }
+   ckopn_c( fname, ifname, ncomch, handle );
+   CHECK_CALL_FAILURE(SCALAR);
 
    }
 
@@ -2408,67 +2736,96 @@ void cspice_conics(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              convrt_c ( SpiceDouble         x,
-                                ConstSpiceChar    * in,
-                                ConstSpiceChar    * out,
-                                SpiceDouble       * y    );
+   void              ckw01_c  ( SpiceInt            handle,
+                                SpiceDouble         begtime,
+                                SpiceDouble         endtime,
+                                SpiceInt            inst,
+                                ConstSpiceChar    * ref,
+                                SpiceBoolean        avflag,
+                                ConstSpiceChar    * segid,
+                                SpiceInt            nrec,
+                                ConstSpiceDouble    sclkdp [],
+                                ConstSpiceDouble    quats  [][4],
+                                ConstSpiceDouble    avvs   [][3]  );
+
 */
-void cspice_convrt(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_ckw01(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceChar           in[DEFAULT_STR_LENGTH+1];
-   SpiceChar           out[DEFAULT_STR_LENGTH+1];
-   SpiceDouble         x;
-   SpiceDouble       * vec_x;
-   SpiceDouble       * y;
-   SpiceDouble       * vec_y;
+   SpiceInt             handle;
+   SpiceDouble          begtime;
+   SpiceDouble          endtime;
+   SpiceInt             inst;
+   SpiceChar            ref   [DEFAULT_STR_LENGTH+1];
+   SpiceBoolean         avflag;
+   SpiceChar            segid [DEFAULT_STR_LENGTH+1];
+   SpiceInt             sclkdp_size;
 
-   SpiceInt            i;
+   ConstSpiceDouble   * sclkdp;
+   ConstSpiceDouble   * quats;
+   ConstSpiceDouble   * avvs;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "x",   MiceDouble, 0, {0}, 1},
-      { "in",  MiceChar,   0, {0}, 0},
-      { "out", MiceChar,   0, {0}, 0},
-      { "y",   MiceDouble, 0, {0}, 1},
+      { "handle",  MiceInt,     0, { 0 },    0},
+      { "begtime", MiceDouble,  0, { 0 },    0},
+      { "endtime", MiceDouble,  0, { 0 },    0},
+      { "inst",    MiceInt,     0, { 0 },    0},
+      { "ref",     MiceChar,    0, { 0 },    0},
+      { "avflag",  MiceInt, 0, { 0 },    0},
+      { "segid",   MiceChar,    0, { 0 },    0},
+      { "sclkdp",  MiceDouble,  1, { 0 },    0},
+      { "quats",   MiceDouble,  2, { 4, 0 }, 0},
+      { "avvs",    MiceDouble,  2, { 3, 0 }, 0},
       };
 
-   check_arg_num( nrhs, nlhs, 3, 1 );
-
-   extra  = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+   check_arg_num( nrhs, nlhs, 10, 0);
 
-   vec_x = A_DBL_ARGV(1);
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   mxGetString(prhs[2], in,  DEFAULT_STR_LENGTH);
-   mxGetString(prhs[3], out, DEFAULT_STR_LENGTH);
+   sclkdp_size = mxGetNumberOfElements( prhs[8] );
 
-   vec_y = A_DBL_RET_ARGV(0);
+   if( 4*sclkdp_size !=  (SpiceInt)mxGetNumberOfElements( prhs[9] ) )
+      {
+      mexErrMsgTxt( "MICE(INVALIDSIZE): Matrix `quats` must have the same "
+                            "measure of vectorization as `sclkdp`" );
+      }
 
-   if (extra->count>1)
+   if( 3*sclkdp_size != (SpiceInt)mxGetNumberOfElements( prhs[10] ) )
       {
+      mexErrMsgTxt( "MICE(INVALIDSIZE): Matrix `aavs` must have the same "
+                            "measure of vectorization as `sclkdp`" );
+      }
 
-      for (i=0;i<extra->count;i++)
-         {
+   handle  = S_INT_ARGV(1);
+   begtime = S_DBL_ARGV(2);
+   endtime = S_DBL_ARGV(3);
+   inst    = S_INT_ARGV(4);
 
-         x = *(vec_x + i*extra->offset[0]);
-         y =  (vec_y + i*extra->offset[3]);
+   mxGetString(prhs[5], ref, DEFAULT_STR_LENGTH);
 
-         convrt_c( x, in, out, y);
-         CHECK_CALL_FAILURE(i);
-         }
+   avflag  = *(SpiceBoolean*)mxGetData(prhs[6]);
 
+   mxGetString(prhs[7], segid, DEFAULT_STR_LENGTH);
 
-      }
-   else
-      {
-      x = *vec_x;
-      y =  vec_y;
+   sclkdp  = (ConstSpiceDouble*)mxGetData(prhs[8]);
+   quats   = (ConstSpiceDouble*)mxGetData(prhs[9]);
+   avvs    = (ConstSpiceDouble*)mxGetData(prhs[10]);
 
-      convrt_c( x, in, out, y);
-      CHECK_CALL_FAILURE(SCALAR);
+   ckw01_c( handle,
+            begtime,
+            endtime,
+            inst,
+            ref,
+            avflag,
+            segid,
+            sclkdp_size,
+            sclkdp,
+            (Nx4)quats,
+            (Nx3)avvs);
 
-      }
+   CHECK_CALL_FAILURE( SCALAR );
 
    }
 
@@ -2476,152 +2833,216 @@ void cspice_convrt(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              cyllat_c( SpiceDouble    r,
-                                SpiceDouble    lonc,
-                                SpiceDouble    z,
-                                SpiceDouble *  radius,
-                                SpiceDouble *  lon,
-                                SpiceDouble *  lat )
+   void              ckw02_c  ( SpiceInt            handle,
+                                SpiceDouble         begtim,
+                                SpiceDouble         endtim,
+                                SpiceInt            inst,
+                                ConstSpiceChar    * ref,
+                                ConstSpiceChar    * segid,
+                                SpiceInt            nrec,
+                                ConstSpiceDouble    start  [],
+                                ConstSpiceDouble    stop   [],
+                                ConstSpiceDouble    quats  [][4],
+                                ConstSpiceDouble    avvs   [][3],
+                                ConstSpiceDouble    rates  []    )
 */
-void cspice_cyllat(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_ckw02(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_r;
-   SpiceDouble        * vec_lonc;
-   SpiceDouble        * vec_z;
-   SpiceDouble        * vec_radius;
-   SpiceDouble        * vec_lon;
-   SpiceDouble        * vec_lat;
-   SpiceDouble          r;
-   SpiceDouble          lonc;
-   SpiceDouble          z;
-   SpiceDouble        * radius;
-   SpiceDouble        * lon;
-   SpiceDouble        * lat;
+   SpiceInt             handle;
+   SpiceDouble          begtime;
+   SpiceDouble          endtime;
+   SpiceInt             inst;
+   SpiceChar            ref   [DEFAULT_STR_LENGTH+1];
+   SpiceChar            segid [DEFAULT_STR_LENGTH+1];
+   SpiceInt             start_size;
 
-   SpiceInt             i;
+   ConstSpiceDouble   * start;
+   ConstSpiceDouble   * stop;
+   ConstSpiceDouble   * quats;
+   ConstSpiceDouble   * avvs;
+   ConstSpiceDouble   * rates;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "r",      MiceDouble, 0, {0}, 1},
-      { "lonc",   MiceDouble, 0, {0}, 1},
-      { "z",      MiceDouble, 0, {0}, 1},
-      { "radius", MiceDouble, 0, {0}, 1},
-      { "lon",    MiceDouble, 0, {0}, 1},
-      { "lat",    MiceDouble, 0, {0}, 1},
+      { "handle",  MiceInt,     0, { 0 },    0},
+      { "begtime", MiceDouble,  0, { 0 },    0},
+      { "endtime", MiceDouble,  0, { 0 },    0},
+      { "inst",    MiceInt,     0, { 0 },    0},
+      { "ref",     MiceChar,    0, { 0 },    0},
+      { "segid",   MiceChar,    0, { 0 },    0},
+      { "start",   MiceDouble,  1, { 0 },    0},
+      { "stop",    MiceDouble,  1, { 0 },    0},
+      { "quats",   MiceDouble,  2, { 4, 0 }, 0},
+      { "avvs",    MiceDouble,  2, { 3, 0 }, 0},
+      { "rates",   MiceDouble,  1, { 0 },    0},
       };
 
-   check_arg_num( nrhs, nlhs, 3, 3 );
+   check_arg_num( nrhs, nlhs, 11, 0);
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_r      = A_DBL_ARGV(1);
-   vec_lonc   = A_DBL_ARGV(2);
-   vec_z      = A_DBL_ARGV(3);
-   vec_radius = A_DBL_RET_ARGV(0);
-   vec_lon    = A_DBL_RET_ARGV(1);
-   vec_lat    = A_DBL_RET_ARGV(2);
-   r          = *vec_r;
-   lonc       = *vec_lonc;
-   z          = *vec_z;
-   radius     =  vec_radius;
-   lon        =  vec_lon;
-   lat        =  vec_lat;
+   start_size = mxGetNumberOfElements( prhs[7] );
 
-   if (extra->count>1)
+   if( start_size !=  (SpiceInt)mxGetNumberOfElements( prhs[8] ) )
       {
-
-      for (i=0;i<extra->count;i++)
-         {
-         r      = *(vec_r      + i*extra->offset[0]);
-         lonc   = *(vec_lonc   + i*extra->offset[1]);
-         z      = *(vec_z      + i*extra->offset[2]);
-         radius =  (vec_radius + i*extra->offset[3]);
-         lon    =  (vec_lon    + i*extra->offset[4]);
-         lat    =  (vec_lat    + i*extra->offset[5]);
-
-         cyllat_c(r, lonc, z, radius, lon, lat);
-         CHECK_CALL_FAILURE(i);
-         }
-
+      mexErrMsgTxt( "MICE(INVALIDSIZE): Array `stop` must have the same "
+                            "measure of vectorization as `start`" );
       }
-   else
-      {
 
-      cyllat_c(r, lonc, z, radius, lon, lat);
-      CHECK_CALL_FAILURE(SCALAR); ;
+   if( 4*start_size !=  (SpiceInt)mxGetNumberOfElements( prhs[9] ) )
+      {
+      mexErrMsgTxt( "MICE(INVALIDSIZE): Matrix `quats` must have the same "
+                            "measure of vectorization as `start`" );
       }
 
-   }
-
-
+   if( 3*start_size !=  (SpiceInt)mxGetNumberOfElements( prhs[10] ) )
+      {
+      mexErrMsgTxt( "MICE(INVALIDSIZE): Matrix `aavs` must have the same "
+                            "measure of vectorization as `start`" );
+      }
+
+   if( start_size !=  (SpiceInt)mxGetNumberOfElements( prhs[11] ) )
+      {
+      mexErrMsgTxt( "MICE(INVALIDSIZE): Array `rates` must have the same "
+                            "measure of vectorization as `start`" );
+      }
+
+   handle  = S_INT_ARGV(1);
+   begtime = S_DBL_ARGV(2);
+   endtime = S_DBL_ARGV(3);
+   inst    = S_INT_ARGV(4);
+
+   mxGetString(prhs[5], ref,   DEFAULT_STR_LENGTH);
+   mxGetString(prhs[6], segid, DEFAULT_STR_LENGTH);
+
+   start   = (ConstSpiceDouble*)mxGetData(prhs[7]);
+   stop    = (ConstSpiceDouble*)mxGetData(prhs[8]);
+   quats   = (ConstSpiceDouble*)mxGetData(prhs[9]);
+   avvs    = (ConstSpiceDouble*)mxGetData(prhs[10]);
+   rates   = (ConstSpiceDouble*)mxGetData(prhs[11]);
+
+   ckw02_c( handle,
+            begtime,
+            endtime,
+            inst,
+            ref,
+            segid,
+            start_size,
+            start,
+            stop,
+            (Nx4)quats,
+            (Nx3)avvs,
+            rates);
+
+   CHECK_CALL_FAILURE( SCALAR );
+
+   }
+
+
 
 
 /*
-   void              cylrec_c( SpiceDouble r,
-                               SpiceDouble lon,
-                               SpiceDouble z,
-                               SpiceDouble rectan[3] )
+   void              ckw03_c  ( SpiceInt            handle,
+                                SpiceDouble         begtim,
+                                SpiceDouble         endtim,
+                                SpiceInt            inst,
+                                ConstSpiceChar    * ref,
+                                SpiceBoolean        avflag,
+                                ConstSpiceChar    * segid,
+                                SpiceInt            nrec,
+                                ConstSpiceDouble    sclkdp [],
+                                ConstSpiceDouble    quats  [][4],
+                                ConstSpiceDouble    avvs   [][3],
+                                SpiceInt            nints,
+                                ConstSpiceDouble    starts []     );
 */
-void cspice_cylrec(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_ckw03(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_r;
-   SpiceDouble        * vec_lon;
-   SpiceDouble        * vec_z;
-   SpiceDouble        * vec_rectan;
-   SpiceDouble          r;
-   SpiceDouble          lon;
-   SpiceDouble          z;
-   SpiceDouble        * rectan;
+   SpiceInt             handle;
+   SpiceDouble          begtime;
+   SpiceDouble          endtime;
+   SpiceInt             inst;
+   SpiceChar            ref   [DEFAULT_STR_LENGTH+1];
+   SpiceBoolean         avflag;
+   SpiceChar            segid [DEFAULT_STR_LENGTH+1];
+   SpiceInt             sclkdp_size;
+   SpiceInt             nints;
 
-   SpiceInt             i;
+   ConstSpiceDouble   * sclkdp;
+   ConstSpiceDouble   * quats;
+   ConstSpiceDouble   * avvs;
+   ConstSpiceDouble   * starts;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "r",      MiceDouble, 0, {0}, 1},
-      { "lon",    MiceDouble, 0, {0}, 1},
-      { "z",      MiceDouble, 0, {0}, 1},
-      { "rectan", MiceDouble, 1, {3}, 1},
+      { "handle",  MiceInt,     0, { 0 },    0},
+      { "begtime", MiceDouble,  0, { 0 },    0},
+      { "endtime", MiceDouble,  0, { 0 },    0},
+      { "inst",    MiceInt,     0, { 0 },    0},
+      { "ref",     MiceChar,    0, { 0 },    0},
+      { "avflag",  MiceInt, 0, { 0 },    0},
+      { "segid",   MiceChar,    0, { 0 },    0},
+      { "sclkdp",  MiceDouble,  1, { 0 },    0},
+      { "quats",   MiceDouble,  2, { 4, 0 }, 0},
+      { "avvs",    MiceDouble,  2, { 3, 0 }, 0},
+      { "starts",  MiceDouble,  1, { 0 },    0},
       };
 
-   check_arg_num( nrhs, nlhs, 3, 1 );
+   check_arg_num( nrhs, nlhs, 11, 0);
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_r      = A_DBL_ARGV(1);
-   vec_lon    = A_DBL_ARGV(2);
-   vec_z      = A_DBL_ARGV(3);
-   vec_rectan = A_DBL_RET_ARGV(0);
+   sclkdp_size = mxGetNumberOfElements( prhs[8] );
+   nints       = mxGetNumberOfElements( prhs[11]);
 
-   r          = *(vec_r);
-   lon        = *(vec_lon);
-   z          = *(vec_z);
-   rectan     =  (vec_rectan);
+   if( 4*sclkdp_size !=  (SpiceInt)mxGetNumberOfElements( prhs[9] ) )
+      {
+      mexErrMsgTxt( "MICE(INVALIDSIZE): Matrix `quats` must have the same "
+                            "measure of vectorization as `sclkdp`" );
+      }
 
-   if (extra->count>1)
+   if( 3*sclkdp_size != (SpiceInt)mxGetNumberOfElements( prhs[10] ) )
       {
+      mexErrMsgTxt( "MICE(INVALIDSIZE): Matrix `aavs` must have the same "
+                            "measure of vectorization as `sclkdp`" );
+      }
 
-      for (i=0;i<extra->count;i++)
-         {
-         r      = *(vec_r      + i*extra->offset[0]);
-         lon    = *(vec_lon    + i*extra->offset[1]);
-         z      = *(vec_z      + i*extra->offset[2]);
-         rectan =  (vec_rectan + i*extra->offset[3]);
 
-         cylrec_c(r, lon, z, rectan);
-         CHECK_CALL_FAILURE(i);
-         }
+   handle  = S_INT_ARGV(1);
+   begtime = S_DBL_ARGV(2);
+   endtime = S_DBL_ARGV(3);
+   inst    = S_INT_ARGV(4);
 
-      }
-   else
-      {
+   mxGetString(prhs[5], ref, DEFAULT_STR_LENGTH);
 
-      cylrec_c(r, lon, z, rectan);
-      CHECK_CALL_FAILURE(SCALAR); ;
-      }
+   avflag  = *(SpiceBoolean*)mxGetData(prhs[6]);
+
+   mxGetString(prhs[7], segid, DEFAULT_STR_LENGTH);
+
+   sclkdp  = (ConstSpiceDouble*)mxGetData(prhs[8]);
+   quats   = (ConstSpiceDouble*)mxGetData(prhs[9]);
+   avvs    = (ConstSpiceDouble*)mxGetData(prhs[10]);
+   starts  = (ConstSpiceDouble*)mxGetData(prhs[11]);
+
+   ckw03_c( handle,
+            begtime,
+            endtime,
+            inst,
+            ref,
+            avflag,
+            segid,
+            sclkdp_size,
+            sclkdp,
+            (Nx4)quats,
+            (Nx3)avvs,
+            nints,
+            starts);
+
+   CHECK_CALL_FAILURE( SCALAR );
 
    }
 
@@ -2629,82 +3050,146 @@ void cspice_cylrec(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              cylsph_c( SpiceDouble    r,
-                               SpiceDouble    lonc,
-                               SpiceDouble    z,
-                               SpiceDouble *  radius,
-                               SpiceDouble *  colat,
-                               SpiceDouble *  lon )
+   SpiceDouble              clight_c( void )
 */
-void cspice_cylsph(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_clight(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_r;
-   SpiceDouble        * vec_lonc;
-   SpiceDouble        * vec_z;
-   SpiceDouble        * vec_radius;
-   SpiceDouble        * vec_colat;
-   SpiceDouble        * vec_lon;
-   SpiceDouble          r;
-   SpiceDouble          lonc;
-   SpiceDouble          z;
-   SpiceDouble        * radius;
-   SpiceDouble        * colat;
-   SpiceDouble        * lon;
+   check_arg_num( nrhs, nlhs, 0, 1 );
+
+   /*
+   Directly return the scalar value. This simple case needs no
+   error checks.
+   */
+   plhs[0] = mxCreateDoubleScalar( clight_c() );
+   }
+
+
+
+
+/*
+   void              clpool_c( void )
+*/
+void cspice_clpool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   check_arg_num( nrhs, nlhs, 0, 0 );
+
+   /*
+   Not much to do, make the call.
+   */
+   clpool_c();
+   zzmice_pool_reset();
+   }
+
+
+
+
+/*
+   void              cnmfrm_c ( ConstSpiceChar    * cname,
+                                SpiceInt            lenout,
+                                SpiceInt          * frcode,
+                                SpiceChar         * frname,
+                                SpiceBoolean      * found   );
+*/
+void mice_cnmfrm(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceChar            cname[DEFAULT_STR_LENGTH+1];
+   SpiceChar            frname[DEFAULT_STR_LENGTH+1];
+   mxChar             * mx_cname;
+   SpiceInt             frcode;
+   SpiceBoolean         found;
 
    SpiceInt             i;
+   SpiceInt             j;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "r",      MiceDouble, 0, {0}, 1},
-      { "lonc",   MiceDouble, 0, {0}, 1},
-      { "z",      MiceDouble, 0, {0}, 1},
-      { "radius", MiceDouble, 0, {0}, 1},
-      { "colat",  MiceDouble, 0, {0}, 1},
-      { "lon",    MiceDouble, 0, {0}, 1},
+      { "cname",  MiceChar,   0, {0}, 1},
+      { "cnmfrm", MiceNameID, 0, {0}, 1},
       };
 
-   check_arg_num( nrhs, nlhs, 3, 3 );
+   check_arg_num( nrhs, nlhs, 1, 1 );
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_r      = A_DBL_ARGV(1);
-   vec_lonc   = A_DBL_ARGV(2);
-   vec_z      = A_DBL_ARGV(3);
-   vec_radius = A_DBL_RET_ARGV(0);
-   vec_colat  = A_DBL_RET_ARGV(1);
-   vec_lon    = A_DBL_RET_ARGV(2);
-   r          = *vec_r;
-   lonc       = *vec_lonc;
-   z          = *vec_z;
-   radius     = vec_radius;
-   colat      = vec_colat;
-   lon        = vec_lon;
 
    if (extra->count>1)
       {
+      mx_cname = (mxChar *)mxGetChars(prhs[1]);
 
       for (i=0;i<extra->count;i++)
          {
 
-         r      = *(vec_r      + i*extra->offset[0]);
-         lonc   = *(vec_lonc   + i*extra->offset[1]);
-         z      = *(vec_z      + i*extra->offset[2]);
-         radius =  (vec_radius + i*extra->offset[3]);
-         colat  =  (vec_colat  + i*extra->offset[4]);
-         lon    =  (vec_lon    + i*extra->offset[5]);
+         /*
+         Extract the string data, character by character, into
+         CSPICE strings. The mx_str array stores the data in a column
+         major format, we need to extract the data by rows.
+         */
+         for ( j=0; j<extra->offset[0]; j++)
+            {
+            cname[j] = (SpiceChar)mx_cname[i + (extra->count*j)];
+            }
 
-         cylsph_c(r, lonc, z, radius, colat, lon);
+         cname[extra->offset[0]] = '\0';
+
+         cnmfrm_c ( cname,
+                    DEFAULT_STR_LENGTH,
+                    &frcode,
+                    frname,
+                    &found   );
          CHECK_CALL_FAILURE(i);
+
+          mxDestroyArray( mxGetField( plhs[0], i, "frname" ) );
+          if ( found )
+             {
+             mxSetField( plhs[0], i, "name", mxCreateString(frname) );
+             }
+          else
+             {
+             mxSetField( plhs[0], i, "name", mxCreateString("\0") );
+             frcode = 0;
+             }
+
+          mxDestroyArray( mxGetField( plhs[0], i,"code" ) );
+          mxSetField( plhs[0], i,"code", zzmice_CreateIntScalar(frcode) );
+
+          mxDestroyArray( mxGetField( plhs[0], i, "found" ) );
+          mxSetField( plhs[0], i, "found",
+                          mxCreateLogicalScalar(found ? true: false));
          }
 
       }
    else
       {
+      mxGetString(prhs[1], cname, DEFAULT_STR_LENGTH);
 
-      cylsph_c(r, lonc, z, radius, colat, lon);
+      cnmfrm_c ( cname,
+                 DEFAULT_STR_LENGTH,
+                 &frcode,
+                 frname,
+                 &found   );
       CHECK_CALL_FAILURE(SCALAR);
+
+      mxDestroyArray( mxGetField( plhs[0], 0, "name" ) );
+      if ( found )
+         {
+         mxSetField(plhs[0], 0, "name", mxCreateString(frname)   );
+         }
+      else
+         {
+         mxSetField( plhs[0], 0, "name",  mxCreateString("\0") );
+         frcode = 0;
+         }
+
+      mxDestroyArray( mxGetField( plhs[0], 0,"code" ) );
+      mxSetField( plhs[0], 0,"code", zzmice_CreateIntScalar(frcode));
+
+      mxDestroyArray( mxGetField( plhs[0], 0, "found" ) );
+      mxSetField( plhs[0], 0, "found",
+                  mxCreateLogicalScalar(found ? true: false));
       }
 
    }
@@ -2713,153 +3198,131 @@ void cspice_cylsph(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dafac_c  ( SpiceInt            handle,
-                                SpiceInt            n,
-                                SpiceInt            lenvals,
-                                const void        * buffer  );
+   void              conics_c( ConstSpiceDouble  elts[8],
+                                SpiceDouble       et,
+                                SpiceDouble       state[6] )
 */
-void cspice_dafac(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_conics(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceInt             handle;
-   SpiceChar          * str;
-   SpiceChar         ** cvals = NULL;
-   SpiceInt             cvals_len;
-   SpiceInt             cvals_size;
-
-   mxChar             * mx_str;
+   SpiceDouble        * vec_elts;
+   SpiceDouble        * vec_et;
+   SpiceDouble        * vec_state;
+   SpiceDouble        * elts;
+   SpiceDouble          et;
+   SpiceDouble        * state;
 
    SpiceInt             i;
-   SpiceInt             j;
-   SpiceInt             count;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "handle", MiceInt,  0, {0}, 0},
-      { "buffer", MiceChar, 0, {0}, 1},
+      { "elts",  MiceDouble, 1, {8}, 1},
+      { "et",    MiceDouble, 0, {0}, 1},
+      { "state", MiceDouble, 1, {6}, 1},
       };
 
-   check_arg_num( nrhs, nlhs, 2, 0);
+   check_arg_num( nrhs, nlhs, 2, 1 );
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   handle = S_INT_ARGV(1);
-   mx_str = (mxChar *)mxGetChars(prhs[2]);
-
-   /*
-   The following logic differs slightly from other string input arguments.
-   A dafac_c input may consist of an array of strings, where the array
-   defines either a single string or an array or strings.
-
-   Recall, extra->count == 0 for scalar inputs. A scalar string requires
-   count as 1 (Is this a bug or design failure? EDW)
+   vec_elts  = A_DBL_ARGV(1);
+   vec_et    = A_DBL_ARGV(2);
+   vec_state = A_DBL_RET_ARGV(0);
 
-   Equivalent to mxGetM(prhs[2]).
-   */
    if (extra->count>1)
       {
-      count = extra->count;
-      }
-   else
-      {
-      count = 1;
-      }
-
-   cvals_len  = extra->offset[1] + 1;
-   cvals_size = count;
-   cvals      = alloc_SpiceString_C_array( cvals_len, cvals_size );
-   CHECK_CALL_FAILURE( SCALAR );
 
-   str = mxCalloc(cvals_len, sizeof(char));
+      for (i=0;i<extra->count;i++)
+         {
 
-   for ( i=0; i<count; i++)
-      {
+         elts  =  (vec_elts  + i*extra->offset[0]);
+         et    = *(vec_et    + i*extra->offset[1]);
+         state =  (vec_state + i*extra->offset[2]);
 
-      /*
-      Extract the string data, character by character, into
-      CSPICE strings. The mx_str array stores the data in a column
-      major format, we need to extract the data by rows.
-      */
-      for ( j=0; j<cvals_len - 1; j++)
-         {
-         str[j] = (char)mx_str[i + (count*j)];
+         conics_c(elts, et, state);
+         CHECK_CALL_FAILURE(i);
          }
 
-      str[cvals_len - 1] = '\0';
-
-      strncpy( *cvals + i*cvals_len,
-               str,
-               cvals_len);
       }
+   else
+      {
 
-   dafac_c ( handle, cvals_size, cvals_len, * cvals );
-   CHECK_CALL_FAILURE_MEM( 1, cvals );
-
-   /* Clean up temporary variables */
-   free_SpiceString_C_array ( 1, cvals );
+      elts  =  vec_elts;
+      et    = *vec_et;
+      state =  vec_state;
 
-   /*
-   Confirm the code released all allocated memory.
-   */
-   MICE_ALLOC_CHECK;
+      conics_c(elts, et, state);
+      CHECK_CALL_FAILURE(SCALAR);
+      }
 
    }
 
 
 
 
-
 /*
-   void              dafbbs_c ( SpiceInt            handle )
+   void              convrt_c ( SpiceDouble         x,
+                                ConstSpiceChar    * in,
+                                ConstSpiceChar    * out,
+                                SpiceDouble       * y    );
 */
-void cspice_dafbbs(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_convrt(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceInt             handle;
+   SpiceChar           in[DEFAULT_STR_LENGTH+1];
+   SpiceChar           out[DEFAULT_STR_LENGTH+1];
+   SpiceDouble         x;
+   SpiceDouble       * vec_x;
+   SpiceDouble       * y;
+   SpiceDouble       * vec_y;
+
+   SpiceInt            i;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "handle", MiceInt, 0, {0}, 0},
+      { "x",   MiceDouble, 0, {0}, 1},
+      { "in",  MiceChar,   0, {0}, 0},
+      { "out", MiceChar,   0, {0}, 0},
+      { "y",   MiceDouble, 0, {0}, 1},
       };
 
-   check_arg_num( nrhs, nlhs, 1, 0);
+   check_arg_num( nrhs, nlhs, 3, 1 );
 
    extra  = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   handle = S_INT_ARGV(1);
+   vec_x = A_DBL_ARGV(1);
 
-   dafbbs_c( handle );
-   CHECK_CALL_FAILURE(SCALAR);
+   mxGetString(prhs[2], in,  DEFAULT_STR_LENGTH);
+   mxGetString(prhs[3], out, DEFAULT_STR_LENGTH);
 
-   }
+   vec_y = A_DBL_RET_ARGV(0);
 
+   if (extra->count>1)
+      {
 
+      for (i=0;i<extra->count;i++)
+         {
 
+         x = *(vec_x + i*extra->offset[0]);
+         y =  (vec_y + i*extra->offset[3]);
 
-/*
-   void              dafbfs_c ( SpiceInt            handle )
-*/
-void cspice_dafbfs(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
-   {
+         convrt_c( x, in, out, y);
+         CHECK_CALL_FAILURE(i);
+         }
 
-   SpiceInt             handle;
 
-   struct extra_dims  * extra;
-   struct argcheck ArgCheck[] =
+      }
+   else
       {
-      { "handle", MiceInt, 0, {0}, 0},
-      };
-
-   check_arg_num( nrhs, nlhs, 1, 0);
-
-   extra  = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+      x = *vec_x;
+      y =  vec_y;
 
-   handle = S_INT_ARGV(1);
+      convrt_c( x, in, out, y);
+      CHECK_CALL_FAILURE(SCALAR);
 
-   dafbfs_c( handle );
-   CHECK_CALL_FAILURE(SCALAR);
+      }
 
    }
 
@@ -2867,55 +3330,82 @@ void cspice_dafbfs(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dafcls_c ( SpiceInt            handle )
+   void              cyllat_c( SpiceDouble    r,
+                                SpiceDouble    lonc,
+                                SpiceDouble    z,
+                                SpiceDouble *  radius,
+                                SpiceDouble *  lon,
+                                SpiceDouble *  lat )
 */
-void cspice_dafcls(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_cyllat(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceInt             handle;
+   SpiceDouble        * vec_r;
+   SpiceDouble        * vec_lonc;
+   SpiceDouble        * vec_z;
+   SpiceDouble        * vec_radius;
+   SpiceDouble        * vec_lon;
+   SpiceDouble        * vec_lat;
+   SpiceDouble          r;
+   SpiceDouble          lonc;
+   SpiceDouble          z;
+   SpiceDouble        * radius;
+   SpiceDouble        * lon;
+   SpiceDouble        * lat;
+
+   SpiceInt             i;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "handle", MiceInt, 0, {0}, 0},
-      };
-
-   check_arg_num( nrhs, nlhs, 1, 0);
-
-   extra  = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
-
-   handle = S_INT_ARGV(1);
-
-   dafcls_c( handle );
-   CHECK_CALL_FAILURE(SCALAR);
-
-   }
-
-
+      { "r",      MiceDouble, 0, {0}, 1},
+      { "lonc",   MiceDouble, 0, {0}, 1},
+      { "z",      MiceDouble, 0, {0}, 1},
+      { "radius", MiceDouble, 0, {0}, 1},
+      { "lon",    MiceDouble, 0, {0}, 1},
+      { "lat",    MiceDouble, 0, {0}, 1},
+      };
 
+   check_arg_num( nrhs, nlhs, 3, 3 );
 
-/*
-   void              dafcs_c  ( SpiceInt            handle )
-*/
-void cspice_dafcs(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
-   {
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   SpiceInt             handle;
+   vec_r      = A_DBL_ARGV(1);
+   vec_lonc   = A_DBL_ARGV(2);
+   vec_z      = A_DBL_ARGV(3);
+   vec_radius = A_DBL_RET_ARGV(0);
+   vec_lon    = A_DBL_RET_ARGV(1);
+   vec_lat    = A_DBL_RET_ARGV(2);
+   r          = *vec_r;
+   lonc       = *vec_lonc;
+   z          = *vec_z;
+   radius     =  vec_radius;
+   lon        =  vec_lon;
+   lat        =  vec_lat;
 
-   struct extra_dims  * extra;
-   struct argcheck ArgCheck[] =
+   if (extra->count>1)
       {
-      { "handle", MiceInt, 0, {0}, 0},
-      };
 
-   check_arg_num( nrhs, nlhs, 1, 0);
+      for (i=0;i<extra->count;i++)
+         {
+         r      = *(vec_r      + i*extra->offset[0]);
+         lonc   = *(vec_lonc   + i*extra->offset[1]);
+         z      = *(vec_z      + i*extra->offset[2]);
+         radius =  (vec_radius + i*extra->offset[3]);
+         lon    =  (vec_lon    + i*extra->offset[4]);
+         lat    =  (vec_lat    + i*extra->offset[5]);
 
-   extra  = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+         cyllat_c(r, lonc, z, radius, lon, lat);
+         CHECK_CALL_FAILURE(i);
+         }
 
-   handle = S_INT_ARGV(1);
+      }
+   else
+      {
 
-   dafcs_c( handle );
-   CHECK_CALL_FAILURE(SCALAR);
+      cyllat_c(r, lonc, z, radius, lon, lat);
+      CHECK_CALL_FAILURE(SCALAR); ;
+      }
 
    }
 
@@ -2923,27 +3413,69 @@ void cspice_dafcs(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dafdc_c  ( SpiceInt            handle )
+   void              cylrec_c( SpiceDouble r,
+                               SpiceDouble lon,
+                               SpiceDouble z,
+                               SpiceDouble rectan[3] )
 */
-void cspice_dafdc(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_cylrec(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceInt             handle;
+   SpiceDouble        * vec_r;
+   SpiceDouble        * vec_lon;
+   SpiceDouble        * vec_z;
+   SpiceDouble        * vec_rectan;
+   SpiceDouble          r;
+   SpiceDouble          lon;
+   SpiceDouble          z;
+   SpiceDouble        * rectan;
+
+   SpiceInt             i;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "handle", MiceInt, 0, {0}, 0},
+      { "r",      MiceDouble, 0, {0}, 1},
+      { "lon",    MiceDouble, 0, {0}, 1},
+      { "z",      MiceDouble, 0, {0}, 1},
+      { "rectan", MiceDouble, 1, {3}, 1},
       };
 
-   check_arg_num( nrhs, nlhs, 1, 0);
+   check_arg_num( nrhs, nlhs, 3, 1 );
 
-   extra  = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   handle = S_INT_ARGV(1);
+   vec_r      = A_DBL_ARGV(1);
+   vec_lon    = A_DBL_ARGV(2);
+   vec_z      = A_DBL_ARGV(3);
+   vec_rectan = A_DBL_RET_ARGV(0);
 
-   dafdc_c( handle );
-   CHECK_CALL_FAILURE(SCALAR);
+   r          = *(vec_r);
+   lon        = *(vec_lon);
+   z          = *(vec_z);
+   rectan     =  (vec_rectan);
+
+   if (extra->count>1)
+      {
+
+      for (i=0;i<extra->count;i++)
+         {
+         r      = *(vec_r      + i*extra->offset[0]);
+         lon    = *(vec_lon    + i*extra->offset[1]);
+         z      = *(vec_z      + i*extra->offset[2]);
+         rectan =  (vec_rectan + i*extra->offset[3]);
+
+         cylrec_c(r, lon, z, rectan);
+         CHECK_CALL_FAILURE(i);
+         }
+
+      }
+   else
+      {
+
+      cylrec_c(r, lon, z, rectan);
+      CHECK_CALL_FAILURE(SCALAR); ;
+      }
 
    }
 
@@ -2951,339 +3483,236 @@ void cspice_dafdc(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dafec_c  ( SpiceInt            handle,
-                                SpiceInt            bufsiz,
-                                SpiceInt            lenout,
-                                SpiceInt          * n,
-                                void              * buffer,
-                                SpiceBoolean      * done    );
+   void              cylsph_c( SpiceDouble    r,
+                               SpiceDouble    lonc,
+                               SpiceDouble    z,
+                               SpiceDouble *  radius,
+                               SpiceDouble *  colat,
+                               SpiceDouble *  lon )
 */
-void cspice_dafec(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_cylsph(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceInt             handle;
-   SpiceInt             bufsiz;
-   SpiceInt             lenout;
-   SpiceInt             n = 0;
-   SpiceChar         ** cvals;
-   SpiceChar         ** array;
-   SpiceBoolean         done = SPICETRUE;
+   SpiceDouble        * vec_r;
+   SpiceDouble        * vec_lonc;
+   SpiceDouble        * vec_z;
+   SpiceDouble        * vec_radius;
+   SpiceDouble        * vec_colat;
+   SpiceDouble        * vec_lon;
+   SpiceDouble          r;
+   SpiceDouble          lonc;
+   SpiceDouble          z;
+   SpiceDouble        * radius;
+   SpiceDouble        * colat;
+   SpiceDouble        * lon;
 
    SpiceInt             i;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "handle", MiceInt,    0, {0}, 0},
-      { "bufsiz", MiceInt,    0, {0}, 0},
-      { "lenout", MiceInt,    0, {0}, 0},
-      { "buffer", MiceIgnore, 0, {0}, 0},
-      { "done",   MiceIgnore, 0, {0}, 0},
+      { "r",      MiceDouble, 0, {0}, 1},
+      { "lonc",   MiceDouble, 0, {0}, 1},
+      { "z",      MiceDouble, 0, {0}, 1},
+      { "radius", MiceDouble, 0, {0}, 1},
+      { "colat",  MiceDouble, 0, {0}, 1},
+      { "lon",    MiceDouble, 0, {0}, 1},
       };
 
-   check_arg_num( nrhs, nlhs, 3, 2 );
+   check_arg_num( nrhs, nlhs, 3, 3 );
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   handle = S_INT_ARGV(1);
-   bufsiz = S_INT_ARGV(2);
-   lenout = S_INT_ARGV(3);
-
-   cvals  = (SpiceChar**)alloc_SpiceString_C_array( lenout, bufsiz );
-   array  = (SpiceChar**)alloc_SpiceString_Pointer_array(bufsiz);
-
-   CHECK_CALL_FAILURE_MEM1(SCALAR, 1, cvals, array);
-
-   dafec_c ( handle, bufsiz, lenout, &n, * cvals, &done );
-   CHECK_CALL_FAILURE_MEM1(SCALAR, 1, cvals, array);
+   vec_r      = A_DBL_ARGV(1);
+   vec_lonc   = A_DBL_ARGV(2);
+   vec_z      = A_DBL_ARGV(3);
+   vec_radius = A_DBL_RET_ARGV(0);
+   vec_colat  = A_DBL_RET_ARGV(1);
+   vec_lon    = A_DBL_RET_ARGV(2);
+   r          = *vec_r;
+   lonc       = *vec_lonc;
+   z          = *vec_z;
+   radius     = vec_radius;
+   colat      = vec_colat;
+   lon        = vec_lon;
 
-   if ( n > 0 )
+   if (extra->count>1)
       {
-      for (i=0;i<n;i++)
+
+      for (i=0;i<extra->count;i++)
          {
 
-         /*
-         Copy the ith string pointer to the array of pointers for input
-         to the mx call.
-         */
-         array[i] = *cvals + i*lenout;
+         r      = *(vec_r      + i*extra->offset[0]);
+         lonc   = *(vec_lonc   + i*extra->offset[1]);
+         z      = *(vec_z      + i*extra->offset[2]);
+         radius =  (vec_radius + i*extra->offset[3]);
+         colat  =  (vec_colat  + i*extra->offset[4]);
+         lon    =  (vec_lon    + i*extra->offset[5]);
+
+         cylsph_c(r, lonc, z, radius, colat, lon);
+         CHECK_CALL_FAILURE(i);
          }
 
-      /*
-      I think this functions as a copy, creating needed memory to 'plhs'.
-      */
-      plhs[0] = mxCreateCharMatrixFromStrings( n, (const char **)array);
       }
    else
       {
-      plhs[0] = mxCreateString( "\0" );
-      }
-
-   plhs[1] = zzmice_CreateIntScalar(done);
 
-   free_SpiceString_C_array( 1, cvals );
-   free_SpiceMemory( array );
+      cylsph_c(r, lonc, z, radius, colat, lon);
+      CHECK_CALL_FAILURE(SCALAR);
+      }
 
-   /*
-   Confirm the code released all allocated memory.
-   */
-   MICE_ALLOC_CHECK;
    }
 
 
 
 
 /*
-   void              daffna_c ( SpiceBoolean      * found )
+   void              dafac_c  ( SpiceInt            handle,
+                                SpiceInt            n,
+                                SpiceInt            lenvals,
+                                const void        * buffer  );
 */
-void cspice_daffna(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dafac(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceBoolean       found;
-
-   check_arg_num( nrhs, nlhs, 0, 1 );
-
-   /*
-   Directly return the scalar value.
-   */
-   daffna_c ( &found );
-   CHECK_CALL_FAILURE(SCALAR);
+   SpiceInt             handle;
+   SpiceChar          * str;
+   SpiceChar         ** cvals = NULL;
+   SpiceInt             cvals_len;
+   SpiceInt             cvals_size;
 
-   plhs[0] = mxCreateDoubleScalar( found );
+   mxChar             * mx_str;
 
-   }
-
-
-
-
-/*
-   void              daffpa_c ( SpiceBoolean      * found )
-*/
-void cspice_daffpa(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
-   {
-
-   SpiceBoolean       found;
-
-   check_arg_num( nrhs, nlhs, 0, 1 );
-
-   /*
-   Directly return the scalar value.
-   */
-   daffpa_c ( &found );
-   CHECK_CALL_FAILURE(SCALAR);
-
-   plhs[0] = mxCreateDoubleScalar( found );
-
-   }
-
-
-
-
-/*
-   void              dafgda_c ( SpiceInt            handle,
-                                SpiceInt            begin,
-                                SpiceInt            end,
-                                SpiceDouble       * data );
-*/
-void cspice_dafgda(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
-   {
-
-   SpiceInt             handle;
-   SpiceInt             begin;
-   SpiceInt             end;
-   SpiceDouble        * data;
-
-   SpiceInt             size;
-   SpiceDouble        * dvals_ret;
-   int                  sizearray[2];
+   SpiceInt             i;
+   SpiceInt             j;
+   SpiceInt             count;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "handle", MiceInt,     0, {0}, 0},
-      { "begin",  MiceInt,     0, {0}, 0},
-      { "end",    MiceInt,     0, {0}, 0},
-      { "data",   MiceIgnore,  0, {0}, 0},
+      { "handle", MiceInt,  0, {0}, 0},
+      { "buffer", MiceChar, 0, {0}, 1},
       };
 
-   check_arg_num( nrhs, nlhs, 3, 1);
+   check_arg_num( nrhs, nlhs, 2, 0);
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
    handle = S_INT_ARGV(1);
-   begin  = S_INT_ARGV(2);
-   end    = S_INT_ARGV(3);
-   size   = end - begin + 1;
+   mx_str = (mxChar *)mxGetChars(prhs[2]);
 
-   data = (SpiceDouble*)mxMalloc(size * sizeof(SpiceDouble) );
-   memset( data, 0, size * sizeof(SpiceDouble) );
+   /*
+   The following logic differs slightly from other string input arguments.
+   A dafac_c input may consist of an array of strings, where the array
+   defines either a single string or an array or strings.
 
-   dafgda_c( handle, begin, end, data);
+   Recall, extra->count == 0 for scalar inputs. A scalar string requires
+   count as 1 (Is this a bug or design failure? EDW)
 
-   /*
-   Check for a failure signal. Free the memory assigned to 'data'
-   before signaling a Matlab error.
+   Equivalent to mxGetM(prhs[2]).
    */
-   if ( failed_c())
+   if (extra->count>1)
       {
-      mxFree( data );
-
-      /*
-      The mice_fail call creates the error string then returns control
-      to the MATLAB interpreter.
-      */
-      mice_fail(SCALAR);
+      count = extra->count;
+      }
+   else
+      {
+      count = 1;
       }
 
-   /*
-   Define the size and shape of the Matlab return argument.
-   */
-   sizearray[0] = 1;
-   sizearray[1] = size;
-
-   plhs[0]   = mxCreateNumericArray( 2, sizearray, mxDOUBLE_CLASS, mxREAL);
-   dvals_ret = A_DBL_RET_ARGV(0);
+   cvals_len  = extra->offset[1] + 1;
+   cvals_size = count;
+   cvals      = alloc_SpiceString_C_array( cvals_len, cvals_size );
+   CHECK_CALL_FAILURE( SCALAR );
 
-   MOVED( data, size, dvals_ret );
-   mxFree( data );
+   str = mxCalloc(cvals_len, sizeof(char));
 
-   }
+   for ( i=0; i<count; i++)
+      {
 
+      /*
+      Extract the string data, character by character, into
+      CSPICE strings. The mx_str array stores the data in a column
+      major format, we need to extract the data by rows.
+      */
+      for ( j=0; j<cvals_len - 1; j++)
+         {
+         str[j] = (char)mx_str[i + (count*j)];
+         }
 
+      str[cvals_len - 1] = '\0';
 
+      strncpy( *cvals + i*cvals_len,
+               str,
+               cvals_len);
+      }
 
-/*
-   void              dafgn_c  ( SpiceInt            lenout,
-                                SpiceChar         * name   )
-*/
-void cspice_dafgn(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
-   {
+   dafac_c ( handle, cvals_size, cvals_len, * cvals );
+   CHECK_CALL_FAILURE_MEM( 1, cvals );
 
-   SpiceChar            name [DEFAULT_STR_LENGTH+1];
+   /* Clean up temporary variables */
+   free_SpiceString_C_array ( 1, cvals );
 
    /*
-   Very simple interface. No need to allocate memory. Use
-   the default string length as 'lenout'.
+   Confirm the code released all allocated memory.
    */
-   check_arg_num( nrhs, nlhs, 0, 1 );
-
-   dafgn_c ( DEFAULT_STR_LENGTH, name);
-
-   plhs[0] = mxCreateString( name );
-   if ( plhs[0] == NULL )
-      {
-      mexErrMsgTxt( "MICE(BUG): mxCreateString failed in cspice_dafgn" );
-      }
+   MICE_ALLOC_CHECK;
 
    }
 
 
 
 
-/*
-   void              dafgs_c  ( SpiceDouble         sum[] )
 
-   void              dafus_c  ( ConstSpiceDouble    sum [],
-                                SpiceInt            nd,
-                                SpiceInt            ni,
-                                SpiceDouble         dc  [],
-                                SpiceInt            ic  []  )
+/*
+   void              dafbbs_c ( SpiceInt            handle )
 */
-void cspice_dafgs(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dafbbs(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble          sum [MAXSUM];
-   SpiceInt             nd;
-   SpiceInt             ni;
-   SpiceDouble          dc  [MAXNDC];
-   SpiceInt             ic  [MAXNIC];
-
-   SpiceDouble        * dvals_ret;
-   SpiceInt           * ivals_ret;
-   int                  sizearray[2];
+   SpiceInt             handle;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "nd", MiceInt,     0, {0}, 0},
-      { "ni", MiceInt,     0, {0}, 0},
-      { "dc", MiceIgnore,  0, {0}, 0},
-      { "ic", MiceIgnore,  0, {0}, 0},
+      { "handle", MiceInt, 0, {0}, 0},
       };
 
-   check_arg_num( nrhs, nlhs, 2, 2);
-
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+   check_arg_num( nrhs, nlhs, 1, 0);
 
-   nd   = S_INT_ARGV(1);
-   ni   = S_INT_ARGV(2);
+   extra  = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   /*
-   Let's not do anything fancy. Make the calls using explicitly
-   sized args.
-   */
-   dafgs_c( sum );
-   dafus_c( sum, nd, ni, dc, ic );
+   handle = S_INT_ARGV(1);
 
+   dafbbs_c( handle );
    CHECK_CALL_FAILURE(SCALAR);
 
-   /*
-   Define the size and shape of the Matlab return argument. The
-   number of elements should not exceed MAXNDC. Enforce with the
-   conditional operator.
-   */
-   sizearray[0] = 1;
-   sizearray[1] = ( nd < MAXNDC ? nd: MAXNDC);
-
-   plhs[0]   = mxCreateNumericArray( 2, sizearray, mxDOUBLE_CLASS, mxREAL);
-   dvals_ret = A_DBL_RET_ARGV(0);
-
-   MOVED( dc, nd, dvals_ret );
-
-   /*
-   Define the size and shape of the Matlab return argument. The
-   number of elements should not exceed MAXNIC. Enforce with the
-   conditional operator.
-   */
-   sizearray[0] = 1;
-   sizearray[1] = ( ni < MAXNIC ? ni: MAXNIC);
-
-   plhs[1]   = mxCreateNumericArray( 2, sizearray, mxINT32_CLASS, mxREAL);
-   ivals_ret = A_INT_RET_ARGV(1);
-
-   MOVEI( ic, ni, ivals_ret );
-
    }
 
 
 
 
 /*
-   void              dafopr_c ( ConstSpiceChar    * fname,
-                                SpiceInt          * handle  )
+   void              dafbfs_c ( SpiceInt            handle )
 */
-void cspice_dafopr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dafbfs(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceChar            fname [DEFAULT_STR_LENGTH+1];
-   SpiceInt           * handle;
+   SpiceInt             handle;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "fname",  MiceChar, 0, {0}, 0},
-      { "handle", MiceInt,  0, {0}, 0},
+      { "handle", MiceInt, 0, {0}, 0},
       };
 
-   check_arg_num( nrhs, nlhs, 1, 1);
-
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+   check_arg_num( nrhs, nlhs, 1, 0);
 
-   mxGetString(prhs[1], fname,  DEFAULT_STR_LENGTH);
+   extra  = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   handle = A_INT_RET_ARGV(0);
+   handle = S_INT_ARGV(1);
 
-   dafopr_c( fname, handle );
+   dafbfs_c( handle );
    CHECK_CALL_FAILURE(SCALAR);
 
    }
@@ -3292,31 +3721,26 @@ void cspice_dafopr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dafopw_c ( ConstSpiceChar    * fname,
-                                SpiceInt          * handle  )
+   void              dafcls_c ( SpiceInt            handle )
 */
-void cspice_dafopw(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dafcls(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceChar            fname [DEFAULT_STR_LENGTH+1];
-   SpiceInt           * handle;
+   SpiceInt             handle;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "fname",  MiceChar, 0, {0}, 0},
-      { "handle", MiceInt,  0, {0}, 0},
+      { "handle", MiceInt, 0, {0}, 0},
       };
 
-   check_arg_num( nrhs, nlhs, 1, 1);
-
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+   check_arg_num( nrhs, nlhs, 1, 0);
 
-   mxGetString(prhs[1], fname,  DEFAULT_STR_LENGTH);
+   extra  = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   handle = A_INT_RET_ARGV(0);
+   handle = S_INT_ARGV(1);
 
-   dafopw_c( fname, handle );
+   dafcls_c( handle );
    CHECK_CALL_FAILURE(SCALAR);
 
    }
@@ -3325,223 +3749,184 @@ void cspice_dafopw(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dafus_c  ( ConstSpiceDouble    sum [],
-                                SpiceInt            nd,
-                                SpiceInt            ni,
-                                SpiceDouble         dc  [],
-                                SpiceInt            ic  []  )
+   void              dafcs_c  ( SpiceInt            handle )
 */
-void cspice_dafus(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dafcs(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * sum;
-   SpiceInt             nd;
-   SpiceInt             ni;
-   SpiceDouble          dc  [MAXNDC];
-   SpiceInt             ic  [MAXNIC];
-
-   SpiceDouble        * dvals_ret;
-   SpiceInt           * ivals_ret;
-   SpiceInt             sum_size;
-   int                  sizearray[2];
+   SpiceInt             handle;
 
    struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "sum", MiceDouble, 1, {0}, 0},
-      { "nd",  MiceInt,    0, {0}, 0},
-      { "ni",  MiceInt,    0, {0}, 0},
-      { "dc",  MiceIgnore, 0, {0}, 0},
-      { "ic",  MiceIgnore, 0, {0}, 0},
+      { "handle", MiceInt, 0, {0}, 0},
       };
 
-   check_arg_num( nrhs, nlhs, 3, 2);
+   check_arg_num( nrhs, nlhs, 1, 0);
 
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+   extra  = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   sum      = (SpiceDouble*)mxGetData(prhs[1]);
-   sum_size = mxGetNumberOfElements( prhs[1] );
+   handle = S_INT_ARGV(1);
 
-   /* Check dimensions of input arrays */
-   if ( sum_size > MAXSUM )
-      {
-      mexErrMsgTxt( "MICE(INVALIDSIZE): Size of summary array "
-                    "`sum` exceeds MAXSUM.");
-      }
+   dafcs_c( handle );
+   CHECK_CALL_FAILURE(SCALAR);
 
-   nd   = S_INT_ARGV(2);
-   ni   = S_INT_ARGV(3);
+   }
 
-   /*
-   Let's not do anything fancy. Make the calls using explicitly
-   sized args.
-   */
-   dafus_c( sum, nd, ni, dc, ic );
 
-   CHECK_CALL_FAILURE(SCALAR);
 
-   /*
-   Define the size and shape of the Matlab return argument. The
-   number of elements should not exceed MAXNDC. Enforce with the
-   conditional operator.
-   */
-   sizearray[0] = 1;
-   sizearray[1] = ( nd < MAXNDC ? nd: MAXNDC);
 
-   plhs[0]   = mxCreateNumericArray( 2, sizearray, mxDOUBLE_CLASS, mxREAL);
-   dvals_ret = A_DBL_RET_ARGV(0);
+/*
+   void              dafdc_c  ( SpiceInt            handle )
+*/
+void cspice_dafdc(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
 
-   MOVED( dc, nd, dvals_ret );
+   SpiceInt             handle;
 
-   /*
-   Define the size and shape of the Matlab return argument. The
-   number of elements should not exceed MAXNIC. Enforce with the
-   conditional operator.
-   */
-   sizearray[0] = 1;
-   sizearray[1] = ( ni < MAXNIC ? ni: MAXNIC);
+   struct extra_dims  * extra;
+   struct argcheck ArgCheck[] =
+      {
+      { "handle", MiceInt, 0, {0}, 0},
+      };
 
-   plhs[1]   = mxCreateNumericArray( 2, sizearray, mxINT32_CLASS, mxREAL);
-   ivals_ret = A_INT_RET_ARGV(1);
+   check_arg_num( nrhs, nlhs, 1, 0);
 
-   MOVEI( ic, ni, ivals_ret );
+   extra  = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+
+   handle = S_INT_ARGV(1);
+
+   dafdc_c( handle );
+   CHECK_CALL_FAILURE(SCALAR);
 
    }
 
-   
-   
-   
+
+
+
 /*
-   void              dcyldr_c ( SpiceDouble         x,
-                                SpiceDouble         y,
-                                SpiceDouble         z,
-                                SpiceDouble         jacobi[3][3] )
+   void              dafec_c  ( SpiceInt            handle,
+                                SpiceInt            bufsiz,
+                                SpiceInt            lenout,
+                                SpiceInt          * n,
+                                void              * buffer,
+                                SpiceBoolean      * done    );
 */
-void cspice_dcyldr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dafec(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_x;
-   SpiceDouble        * vec_y;
-   SpiceDouble        * vec_z;
-   SpiceDouble        * vec_jacobi;
-   SpiceDouble          x;
-   SpiceDouble          y;
-   SpiceDouble          z;
-   SpiceDouble        * jacobi;
-   SpiceDouble          xr[3][3];
+   SpiceInt             handle;
+   SpiceInt             bufsiz;
+   SpiceInt             lenout;
+   SpiceInt             n = 0;
+   SpiceChar         ** cvals;
+   SpiceChar         ** array;
+   SpiceBoolean         done = SPICETRUE;
 
    SpiceInt             i;
 
-   struct extra_dims *extra;
+   struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "x",      MiceDouble, 0, {0},    1},
-      { "y",      MiceDouble, 0, {0},    1},
-      { "z",      MiceDouble, 0, {0},    1},
-      { "jacobi", MiceDouble, 2, {3, 3}, 1},
+      { "handle", MiceInt,    0, {0}, 0},
+      { "bufsiz", MiceInt,    0, {0}, 0},
+      { "lenout", MiceInt,    0, {0}, 0},
+      { "buffer", MiceIgnore, 0, {0}, 0},
+      { "done",   MiceIgnore, 0, {0}, 0},
       };
 
-   check_arg_num( nrhs, nlhs, 3, 1 );
+   check_arg_num( nrhs, nlhs, 3, 2 );
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_x      = A_DBL_ARGV(1);
-   vec_y      = A_DBL_ARGV(2);
-   vec_z      = A_DBL_ARGV(3);
-   x          = *vec_x;
-   y          = *vec_y;
-   z          = *vec_z;
-   vec_jacobi = A_DBL_RET_ARGV(0);
-   jacobi     = vec_jacobi;
+   handle = S_INT_ARGV(1);
+   bufsiz = S_INT_ARGV(2);
+   lenout = S_INT_ARGV(3);
 
-   if (extra->count>1)
-      {
+   cvals  = (SpiceChar**)alloc_SpiceString_C_array( lenout, bufsiz );
+   array  = (SpiceChar**)alloc_SpiceString_Pointer_array(bufsiz);
 
-      for (i=0;i<extra->count;i++)
-         {
-         x   = *(vec_x + i*extra->offset[0]);
-         y   = *(vec_y + i*extra->offset[1]);
-         z   = *(vec_z + i*extra->offset[2]);
-         jacobi = (vec_jacobi + i*extra->offset[3]);
+   CHECK_CALL_FAILURE_MEM1(SCALAR, 1, cvals, array);
 
-         dcyldr_c(x, y, z, (SpiceDouble(*)[3])xr);
+   dafec_c ( handle, bufsiz, lenout, &n, * cvals, &done );
+   CHECK_CALL_FAILURE_MEM1(SCALAR, 1, cvals, array);
 
-         CHECK_CALL_FAILURE(i);
+   if ( n > 0 )
+      {
+      for (i=0;i<n;i++)
+         {
 
-         xpose_c( xr, (SpiceDouble(*)[3])jacobi );
+         /*
+         Copy the ith string pointer to the array of pointers for input
+         to the mx call.
+         */
+         array[i] = *cvals + i*lenout;
          }
 
+      /*
+      I think this functions as a copy, creating needed memory to 'plhs'.
+      */
+      plhs[0] = mxCreateCharMatrixFromStrings( n, (const char **)array);
       }
    else
       {
-      dcyldr_c(x, y, z, (SpiceDouble(*)[3])xr);
+      plhs[0] = mxCreateString( "\0" );
+      }
 
-      CHECK_CALL_FAILURE(SCALAR);
+   plhs[1] = zzmice_CreateIntScalar(done);
 
-      xpose_c( xr, (SpiceDouble(*)[3])jacobi );
-      }
+   free_SpiceString_C_array( 1, cvals );
+   free_SpiceMemory( array );
 
+   /*
+   Confirm the code released all allocated memory.
+   */
+   MICE_ALLOC_CHECK;
    }
 
 
 
 
 /*
-   void              deltet_c( SpiceDouble      epoch,
-                               ConstSpiceChar * eptype,
-                               SpiceDouble    * delta )
+   void              daffna_c ( SpiceBoolean      * found )
 */
-void cspice_deltet(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_daffna(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_epoch;
-   SpiceDouble          epoch;
-   SpiceChar            eptype[DEFAULT_STR_LENGTH+1];
-   SpiceDouble        * vec_delta;
-   SpiceDouble        * delta;
-
-   SpiceInt             i;
+   SpiceBoolean       found;
 
-   struct extra_dims  * extra;
-   struct argcheck ArgCheck[] =
-      {
-      { "epoch",  MiceDouble, 0, {0}, 1},
-      { "eptype", MiceChar,   0, {0}, 0},
-      { "delta",  MiceDouble, 0, {0}, 1},
-      };
+   check_arg_num( nrhs, nlhs, 0, 1 );
 
-   check_arg_num( nrhs, nlhs, 2, 1 );
+   /*
+   Directly return the scalar value.
+   */
+   daffna_c ( &found );
+   CHECK_CALL_FAILURE(SCALAR);
 
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+   plhs[0] = mxCreateDoubleScalar( found );
 
-   mxGetString(prhs[2], eptype, DEFAULT_STR_LENGTH);
+   }
 
-   vec_epoch = A_DBL_ARGV(1);
-   vec_delta = A_DBL_RET_ARGV(0);
 
-   if (extra->count>1)
-      {
 
-      for (i=0;i<extra->count;i++)
-         {
 
-         epoch = *(vec_epoch+i*extra->offset[0]);
-         delta = vec_delta + i*extra->offset[2];
+/*
+   void              daffpa_c ( SpiceBoolean      * found )
+*/
+void cspice_daffpa(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
 
-         deltet_c( epoch, eptype, delta );
-         CHECK_CALL_FAILURE(i);
-         }
+   SpiceBoolean       found;
 
-      }
-   else
-      {
+   check_arg_num( nrhs, nlhs, 0, 1 );
 
-      epoch = *vec_epoch;
-      delta = vec_delta;
+   /*
+   Directly return the scalar value.
+   */
+   daffpa_c ( &found );
+   CHECK_CALL_FAILURE(SCALAR);
 
-      deltet_c( epoch, eptype, delta );
-      CHECK_CALL_FAILURE(SCALAR);
-      }
+   plhs[0] = mxCreateDoubleScalar( found );
 
    }
 
@@ -3549,79 +3934,99 @@ void cspice_deltet(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dgeodr_c ( SpiceDouble         x,
-                                SpiceDouble         y,
-                                SpiceDouble         z,
-                                SpiceDouble         re,
-                                SpiceDouble         f,
-                                SpiceDouble         jacobi[3][3] )
+   void              dafgda_c ( SpiceInt            handle,
+                                SpiceInt            begin,
+                                SpiceInt            end,
+                                SpiceDouble       * data );
 */
-void cspice_dgeodr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dafgda(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_x;
-   SpiceDouble        * vec_y;
-   SpiceDouble        * vec_z;
-   SpiceDouble        * vec_jacobi;
-   SpiceDouble          x;
-   SpiceDouble          y;
-   SpiceDouble          z;
-   SpiceDouble          re;
-   SpiceDouble          f;
-   SpiceDouble        * jacobi;
-   SpiceDouble          xr[3][3];
+   SpiceInt             handle;
+   SpiceInt             begin;
+   SpiceInt             end;
+   SpiceDouble        * data;
 
-   SpiceInt             i;
+   SpiceInt             size;
+   SpiceDouble        * dvals_ret;
+   int                  sizearray[2];
 
-   struct extra_dims *extra;
+   struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "x",      MiceDouble, 0, {0},    1},
-      { "y",      MiceDouble, 0, {0},    1},
-      { "z",      MiceDouble, 0, {0},    1},
-      { "re",     MiceDouble, 0, {0},    0},
-      { "f",      MiceDouble, 0, {0},    0},
-      { "jacobi", MiceDouble, 2, {3, 3}, 1},
+      { "handle", MiceInt,     0, {0}, 0},
+      { "begin",  MiceInt,     0, {0}, 0},
+      { "end",    MiceInt,     0, {0}, 0},
+      { "data",   MiceIgnore,  0, {0}, 0},
       };
 
-   check_arg_num( nrhs, nlhs, 5, 1 );
+   check_arg_num( nrhs, nlhs, 3, 1);
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_x    = A_DBL_ARGV(1);
-   vec_y    = A_DBL_ARGV(2);
-   vec_z    = A_DBL_ARGV(3);
-   x        = *(vec_x);
-   y        = *(vec_y);
-   z        = *(vec_z);
-   re         = S_DBL_ARGV(4);
-   f          = S_DBL_ARGV(5);
-   vec_jacobi = A_DBL_RET_ARGV(0);
-   jacobi     = vec_jacobi;
+   handle = S_INT_ARGV(1);
+   begin  = S_INT_ARGV(2);
+   end    = S_INT_ARGV(3);
+   size   = end - begin + 1;
 
-   if (extra->count>1)
+   data = (SpiceDouble*)mxMalloc(size * sizeof(SpiceDouble) );
+   memset( data, 0, size * sizeof(SpiceDouble) );
+
+   dafgda_c( handle, begin, end, data);
+
+   /*
+   Check for a failure signal. Free the memory assigned to 'data'
+   before signaling a Matlab error.
+   */
+   if ( failed_c())
       {
+      mxFree( data );
 
-      for (i=0;i<extra->count;i++)
-         {
-         x      = *(vec_x     + i*extra->offset[0]);
-         y      = *(vec_y     + i*extra->offset[1]);
-         z      = *(vec_z     + i*extra->offset[2]);
-         jacobi = (vec_jacobi + i*extra->offset[5]);
+      /*
+      The mice_fail call creates the error string then returns control
+      to the MATLAB interpreter.
+      */
+      mice_fail(SCALAR);
+      }
 
-         dgeodr_c(x, y, z, re, f, (SpiceDouble(*)[3])xr);
-         CHECK_CALL_FAILURE(i);
+   /*
+   Define the size and shape of the Matlab return argument.
+   */
+   sizearray[0] = 1;
+   sizearray[1] = size;
 
-         xpose_c( xr, (SpiceDouble(*)[3])jacobi );
-         }
+   plhs[0]   = mxCreateNumericArray( 2, sizearray, mxDOUBLE_CLASS, mxREAL);
+   dvals_ret = A_DBL_RET_ARGV(0);
 
-      }
-   else
-      {
-      dgeodr_c(x, y, z, re, f, (SpiceDouble(*)[3])xr);
-      CHECK_CALL_FAILURE(SCALAR);
+   MOVED( data, size, dvals_ret );
+   mxFree( data );
 
-      xpose_c( xr, (SpiceDouble(*)[3])jacobi );
+   }
+
+
+
+
+/*
+   void              dafgn_c  ( SpiceInt            lenout,
+                                SpiceChar         * name   )
+*/
+void cspice_dafgn(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceChar            name [DEFAULT_STR_LENGTH+1];
+
+   /*
+   Very simple interface. No need to allocate memory. Use
+   the default string length as 'lenout'.
+   */
+   check_arg_num( nrhs, nlhs, 0, 1 );
+
+   dafgn_c ( DEFAULT_STR_LENGTH, name);
+
+   plhs[0] = mxCreateString( name );
+   if ( plhs[0] == NULL )
+      {
+      mexErrMsgTxt( "MICE(BUG): mxCreateString failed in cspice_dafgn" );
       }
 
    }
@@ -3630,74 +4035,77 @@ void cspice_dgeodr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dlatdr_c ( SpiceDouble         x,
-                                SpiceDouble         y,
-                                SpiceDouble         z,
-                                SpiceDouble         jacobi[3][3] );
+   void              dafgs_c  ( SpiceDouble         sum[] )
+
+   void              dafus_c  ( ConstSpiceDouble    sum [],
+                                SpiceInt            nd,
+                                SpiceInt            ni,
+                                SpiceDouble         dc  [],
+                                SpiceInt            ic  []  )
 */
-void cspice_dlatdr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dafgs(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_x;
-   SpiceDouble        * vec_y;
-   SpiceDouble        * vec_z;
-   SpiceDouble        * vec_jacobi;
-   SpiceDouble          x;
-   SpiceDouble          y;
-   SpiceDouble          z;
-   SpiceDouble        * jacobi;
-   SpiceDouble          xr[3][3];
+   SpiceDouble          sum [MAXSUM];
+   SpiceInt             nd;
+   SpiceInt             ni;
+   SpiceDouble          dc  [MAXNDC];
+   SpiceInt             ic  [MAXNIC];
 
-   SpiceInt             i;
+   SpiceDouble        * dvals_ret;
+   SpiceInt           * ivals_ret;
+   int                  sizearray[2];
 
-   struct extra_dims *extra;
+   struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "x",      MiceDouble, 0, {0},    1},
-      { "y",      MiceDouble, 0, {0},    1},
-      { "z",      MiceDouble, 0, {0},    1},
-      { "jacobi", MiceDouble, 2, {3, 3}, 1},
+      { "nd", MiceInt,     0, {0}, 0},
+      { "ni", MiceInt,     0, {0}, 0},
+      { "dc", MiceIgnore,  0, {0}, 0},
+      { "ic", MiceIgnore,  0, {0}, 0},
       };
 
-   check_arg_num( nrhs, nlhs, 3, 1 );
+   check_arg_num( nrhs, nlhs, 2, 2);
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_x      = A_DBL_ARGV(1);
-   vec_y      = A_DBL_ARGV(2);
-   vec_z      = A_DBL_ARGV(3);
-   x          = *vec_x;
-   y          = *vec_y;
-   z          = *vec_z;
-   vec_jacobi = A_DBL_RET_ARGV(0);
-   jacobi     = vec_jacobi;
+   nd   = S_INT_ARGV(1);
+   ni   = S_INT_ARGV(2);
 
-   if (extra->count>1)
-      {
+   /*
+   Let's not do anything fancy. Make the calls using explicitly
+   sized args.
+   */
+   dafgs_c( sum );
+   dafus_c( sum, nd, ni, dc, ic );
 
-      for (i=0;i<extra->count;i++)
-         {
-         x      = *(vec_x + i*extra->offset[0]);
-         y      = *(vec_y + i*extra->offset[1]);
-         z      = *(vec_z + i*extra->offset[2]);
-         jacobi = (vec_jacobi + i*extra->offset[3]);
+   CHECK_CALL_FAILURE(SCALAR);
 
-         dlatdr_c(x, y, z, (SpiceDouble(*)[3])xr);
+   /*
+   Define the size and shape of the Matlab return argument. The
+   number of elements should not exceed MAXNDC. Enforce with the
+   conditional operator.
+   */
+   sizearray[0] = 1;
+   sizearray[1] = ( nd < MAXNDC ? nd: MAXNDC);
 
-         CHECK_CALL_FAILURE(i);
+   plhs[0]   = mxCreateNumericArray( 2, sizearray, mxDOUBLE_CLASS, mxREAL);
+   dvals_ret = A_DBL_RET_ARGV(0);
 
-         xpose_c( xr, (SpiceDouble(*)[3])jacobi );
-         }
+   MOVED( dc, nd, dvals_ret );
 
-      }
-   else
-      {
-      dlatdr_c(x, y, z, (SpiceDouble(*)[3])xr);
+   /*
+   Define the size and shape of the Matlab return argument. The
+   number of elements should not exceed MAXNIC. Enforce with the
+   conditional operator.
+   */
+   sizearray[0] = 1;
+   sizearray[1] = ( ni < MAXNIC ? ni: MAXNIC);
 
-      CHECK_CALL_FAILURE(SCALAR);
+   plhs[1]   = mxCreateNumericArray( 2, sizearray, mxINT32_CLASS, mxREAL);
+   ivals_ret = A_INT_RET_ARGV(1);
 
-      xpose_c( xr, (SpiceDouble(*)[3])jacobi );
-      }
+   MOVEI( ic, ni, ivals_ret );
 
    }
 
@@ -3705,86 +4113,65 @@ void cspice_dlatdr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dpgrdr_c ( ConstSpiceChar    * body,
-                                SpiceDouble         x,
-                                SpiceDouble         y,
-                                SpiceDouble         z,
-                                SpiceDouble         re,
-                                SpiceDouble         f,
-                                SpiceDouble         jacobi[3][3] )
+   void              dafopr_c ( ConstSpiceChar    * fname,
+                                SpiceInt          * handle  )
 */
-void cspice_dpgrdr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dafopr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceChar            body       [DEFAULT_STR_LENGTH+1];
-   SpiceDouble        * vec_x;
-   SpiceDouble        * vec_y;
-   SpiceDouble        * vec_z;
-   SpiceDouble        * vec_jacobi;
-   SpiceDouble          x;
-   SpiceDouble          y;
-   SpiceDouble          z;
-   SpiceDouble          re;
-   SpiceDouble          f;
-   SpiceDouble        * jacobi;
-   SpiceDouble          xr[3][3];
-
-   SpiceInt             i;
+   SpiceChar            fname [DEFAULT_STR_LENGTH+1];
+   SpiceInt           * handle;
 
-   struct extra_dims *extra;
+   struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "body",   MiceChar,   0, {0},    0},
-      { "x",      MiceDouble, 0, {0},    1},
-      { "y",      MiceDouble, 0, {0},    1},
-      { "z",      MiceDouble, 0, {0},    1},
-      { "re",     MiceDouble, 0, {0},    0},
-      { "f",      MiceDouble, 0, {0},    0},
-      { "jacobi", MiceDouble, 2, {3, 3}, 1},
+      { "fname",  MiceChar, 0, {0}, 0},
+      { "handle", MiceInt,  0, {0}, 0},
       };
 
-   check_arg_num( nrhs, nlhs, 6, 1 );
+   check_arg_num( nrhs, nlhs, 1, 1);
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   mxGetString( prhs[1], body, DEFAULT_STR_LENGTH );
+   mxGetString(prhs[1], fname,  DEFAULT_STR_LENGTH);
 
-   vec_x      = A_DBL_ARGV(2);
-   vec_y      = A_DBL_ARGV(3);
-   vec_z      = A_DBL_ARGV(4);
-   re         = S_DBL_ARGV(5);
-   f          = S_DBL_ARGV(6);
-   vec_jacobi = A_DBL_RET_ARGV(0);
+   handle = A_INT_RET_ARGV(0);
 
-   x          = *(vec_x);
-   y          = *(vec_y);
-   z          = *(vec_z);
-   jacobi     = vec_jacobi;
+   dafopr_c( fname, handle );
+   CHECK_CALL_FAILURE(SCALAR);
 
-   if (extra->count>1)
-      {
+   }
 
-      for (i=0;i<extra->count;i++)
-         {
-         x    = *(vec_x     + i*extra->offset[1]);
-         y    = *(vec_y     + i*extra->offset[2]);
-         z    = *(vec_z     + i*extra->offset[3]);
-         jacobi = (vec_jacobi + i*extra->offset[6]);
 
-         dpgrdr_c( body, x, y, z, re, f, (SpiceDouble (*)[3])xr);
-         CHECK_CALL_FAILURE(i);
 
-         xpose_c( xr, (SpiceDouble(*)[3])jacobi );
-         }
 
-      }
-   else
+/*
+   void              dafopw_c ( ConstSpiceChar    * fname,
+                                SpiceInt          * handle  )
+*/
+void cspice_dafopw(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceChar            fname [DEFAULT_STR_LENGTH+1];
+   SpiceInt           * handle;
+
+   struct extra_dims  * extra;
+   struct argcheck ArgCheck[] =
       {
-      dpgrdr_c( body, x, y, z, re, f, (SpiceDouble (*)[3])xr);
-      CHECK_CALL_FAILURE(SCALAR);
+      { "fname",  MiceChar, 0, {0}, 0},
+      { "handle", MiceInt,  0, {0}, 0},
+      };
 
-      xpose_c( xr, (SpiceDouble(*)[3])jacobi );
-      }
+   check_arg_num( nrhs, nlhs, 1, 1);
+
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+
+   mxGetString(prhs[1], fname,  DEFAULT_STR_LENGTH);
+
+   handle = A_INT_RET_ARGV(0);
+
+   dafopw_c( fname, handle );
+   CHECK_CALL_FAILURE(SCALAR);
 
    }
 
@@ -3792,38 +4179,107 @@ void cspice_dpgrdr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   SpiceDouble              dpr_c( void )
+   void              dafus_c  ( ConstSpiceDouble    sum [],
+                                SpiceInt            nd,
+                                SpiceInt            ni,
+                                SpiceDouble         dc  [],
+                                SpiceInt            ic  []  )
 */
-void cspice_dpr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dafus(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   check_arg_num( nrhs, nlhs, 0, 1 );
+   SpiceDouble        * sum;
+   SpiceInt             nd;
+   SpiceInt             ni;
+   SpiceDouble          dc  [MAXNDC];
+   SpiceInt             ic  [MAXNIC];
+
+   SpiceDouble        * dvals_ret;
+   SpiceInt           * ivals_ret;
+   SpiceInt             sum_size;
+   int                  sizearray[2];
+
+   struct extra_dims  * extra;
+   struct argcheck ArgCheck[] =
+      {
+      { "sum", MiceDouble, 1, {0}, 0},
+      { "nd",  MiceInt,    0, {0}, 0},
+      { "ni",  MiceInt,    0, {0}, 0},
+      { "dc",  MiceIgnore, 0, {0}, 0},
+      { "ic",  MiceIgnore, 0, {0}, 0},
+      };
+
+   check_arg_num( nrhs, nlhs, 3, 2);
+
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+
+   sum      = (SpiceDouble*)mxGetData(prhs[1]);
+   sum_size = mxGetNumberOfElements( prhs[1] );
+
+   /* Check dimensions of input arrays */
+   if ( sum_size > MAXSUM )
+      {
+      mexErrMsgTxt( "MICE(INVALIDSIZE): Size of summary array "
+                    "`sum` exceeds MAXSUM.");
+      }
+
+   nd   = S_INT_ARGV(2);
+   ni   = S_INT_ARGV(3);
 
    /*
-   Directly return the scalar value. This simple case needs no
-   error checks.
+   Let's not do anything fancy. Make the calls using explicitly
+   sized args.
    */
-   plhs[0] = mxCreateDoubleScalar( dpr_c() );
-   }
+   dafus_c( sum, nd, ni, dc, ic );
+
+   CHECK_CALL_FAILURE(SCALAR);
+
+   /*
+   Define the size and shape of the Matlab return argument. The
+   number of elements should not exceed MAXNDC. Enforce with the
+   conditional operator.
+   */
+   sizearray[0] = 1;
+   sizearray[1] = ( nd < MAXNDC ? nd: MAXNDC);
+
+   plhs[0]   = mxCreateNumericArray( 2, sizearray, mxDOUBLE_CLASS, mxREAL);
+   dvals_ret = A_DBL_RET_ARGV(0);
+
+   MOVED( dc, nd, dvals_ret );
+
+   /*
+   Define the size and shape of the Matlab return argument. The
+   number of elements should not exceed MAXNIC. Enforce with the
+   conditional operator.
+   */
+   sizearray[0] = 1;
+   sizearray[1] = ( ni < MAXNIC ? ni: MAXNIC);
 
+   plhs[1]   = mxCreateNumericArray( 2, sizearray, mxINT32_CLASS, mxREAL);
+   ivals_ret = A_INT_RET_ARGV(1);
 
+   MOVEI( ic, ni, ivals_ret );
 
+   }
 
+   
+   
+   
 /*
-   void              drdcyl_c ( SpiceDouble    r,
-                                SpiceDouble    lon,
-                                SpiceDouble    z,
-                                SpiceDouble    jacobi[3][3] )
+   void              dcyldr_c ( SpiceDouble         x,
+                                SpiceDouble         y,
+                                SpiceDouble         z,
+                                SpiceDouble         jacobi[3][3] )
 */
-void cspice_drdcyl(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dcyldr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_r;
-   SpiceDouble        * vec_lon;
+   SpiceDouble        * vec_x;
+   SpiceDouble        * vec_y;
    SpiceDouble        * vec_z;
    SpiceDouble        * vec_jacobi;
-   SpiceDouble          r;
-   SpiceDouble          lon;
+   SpiceDouble          x;
+   SpiceDouble          y;
    SpiceDouble          z;
    SpiceDouble        * jacobi;
    SpiceDouble          xr[3][3];
@@ -3833,8 +4289,8 @@ void cspice_drdcyl(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    struct extra_dims *extra;
    struct argcheck ArgCheck[] =
       {
-      { "r",      MiceDouble, 0, {0},    1},
-      { "lon",    MiceDouble, 0, {0},    1},
+      { "x",      MiceDouble, 0, {0},    1},
+      { "y",      MiceDouble, 0, {0},    1},
       { "z",      MiceDouble, 0, {0},    1},
       { "jacobi", MiceDouble, 2, {3, 3}, 1},
       };
@@ -3843,12 +4299,12 @@ void cspice_drdcyl(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_r   = A_DBL_ARGV(1);
-   vec_lon = A_DBL_ARGV(2);
-   vec_z   = A_DBL_ARGV(3);
-   r       = *vec_r;
-   lon     = *vec_lon;
-   z       = *vec_z;
+   vec_x      = A_DBL_ARGV(1);
+   vec_y      = A_DBL_ARGV(2);
+   vec_z      = A_DBL_ARGV(3);
+   x          = *vec_x;
+   y          = *vec_y;
+   z          = *vec_z;
    vec_jacobi = A_DBL_RET_ARGV(0);
    jacobi     = vec_jacobi;
 
@@ -3857,12 +4313,13 @@ void cspice_drdcyl(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
       for (i=0;i<extra->count;i++)
          {
-         r      = *(vec_r     + i*extra->offset[0]);
-         lon    = *(vec_lon   + i*extra->offset[1]);
-         z      = *(vec_z     + i*extra->offset[2]);
+         x   = *(vec_x + i*extra->offset[0]);
+         y   = *(vec_y + i*extra->offset[1]);
+         z   = *(vec_z + i*extra->offset[2]);
          jacobi = (vec_jacobi + i*extra->offset[3]);
 
-         drdcyl_c(r, lon, z, (SpiceDouble(*)[3])xr);
+         dcyldr_c(x, y, z, (SpiceDouble(*)[3])xr);
+
          CHECK_CALL_FAILURE(i);
 
          xpose_c( xr, (SpiceDouble(*)[3])jacobi );
@@ -3871,7 +4328,8 @@ void cspice_drdcyl(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
       }
    else
       {
-      drdcyl_c(r, lon, z, (SpiceDouble(*)[3])xr);
+      dcyldr_c(x, y, z, (SpiceDouble(*)[3])xr);
+
       CHECK_CALL_FAILURE(SCALAR);
 
       xpose_c( xr, (SpiceDouble(*)[3])jacobi );
@@ -3883,80 +4341,61 @@ void cspice_drdcyl(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              drdgeo_c ( SpiceDouble         lon,
-                                SpiceDouble         lat,
-                                SpiceDouble         alt,
-                                SpiceDouble         re,
-                                SpiceDouble         f,
-                                SpiceDouble         jacobi[3][3] )
+   void              deltet_c( SpiceDouble      epoch,
+                               ConstSpiceChar * eptype,
+                               SpiceDouble    * delta )
 */
-void cspice_drdgeo(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_deltet(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_lon;
-   SpiceDouble        * vec_lat;
-   SpiceDouble        * vec_alt;
-   SpiceDouble        * vec_jacobi;
-   SpiceDouble          lon;
-   SpiceDouble          lat;
-   SpiceDouble          alt;
-   SpiceDouble          re;
-   SpiceDouble          f;
-   SpiceDouble        * jacobi;
-   SpiceDouble          xr[3][3];
+   SpiceDouble        * vec_epoch;
+   SpiceDouble          epoch;
+   SpiceChar            eptype[DEFAULT_STR_LENGTH+1];
+   SpiceDouble        * vec_delta;
+   SpiceDouble        * delta;
 
    SpiceInt             i;
 
-   struct extra_dims *extra;
+   struct extra_dims  * extra;
    struct argcheck ArgCheck[] =
       {
-      { "lon",    MiceDouble, 0, {0},    1},
-      { "lat",    MiceDouble, 0, {0},    1},
-      { "alt",    MiceDouble, 0, {0},    1},
-      { "re",     MiceDouble, 0, {0},    0},
-      { "f",      MiceDouble, 0, {0},    0},
-      { "jacobi", MiceDouble, 2, {3, 3}, 1},
+      { "epoch",  MiceDouble, 0, {0}, 1},
+      { "eptype", MiceChar,   0, {0}, 0},
+      { "delta",  MiceDouble, 0, {0}, 1},
       };
 
-   check_arg_num( nrhs, nlhs, 5, 1 );
+   check_arg_num( nrhs, nlhs, 2, 1 );
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_lon    = A_DBL_ARGV(1);
-   vec_lat    = A_DBL_ARGV(2);
-   vec_alt    = A_DBL_ARGV(3);
-   lon        = *(vec_lon);
-   lat        = *(vec_lat);
-   alt        = *(vec_alt);
-   re         = S_DBL_ARGV(4);
-   f          = S_DBL_ARGV(5);
-   vec_jacobi = A_DBL_RET_ARGV(0);
-   jacobi     = vec_jacobi;
+   mxGetString(prhs[2], eptype, DEFAULT_STR_LENGTH);
+
+   vec_epoch = A_DBL_ARGV(1);
+   vec_delta = A_DBL_RET_ARGV(0);
 
    if (extra->count>1)
       {
 
       for (i=0;i<extra->count;i++)
          {
-         lon    = *(vec_lon     + i*extra->offset[0]);
-         lat    = *(vec_lat     + i*extra->offset[1]);
-         alt    = *(vec_alt     + i*extra->offset[2]);
-         jacobi = (vec_jacobi + i*extra->offset[5]);
 
-         drdgeo_c(lon, lat, alt, re, f, (SpiceDouble(*)[3])xr);
-         CHECK_CALL_FAILURE(i);
+         epoch = *(vec_epoch+i*extra->offset[0]);
+         delta = vec_delta + i*extra->offset[2];
 
-         xpose_c( xr, (SpiceDouble(*)[3])jacobi );
+         deltet_c( epoch, eptype, delta );
+         CHECK_CALL_FAILURE(i);
          }
 
       }
    else
       {
-      drdgeo_c(lon, lat, alt, re, f, (SpiceDouble(*)[3])xr);
-      CHECK_CALL_FAILURE(SCALAR);
-
-      xpose_c( xr, (SpiceDouble(*)[3])jacobi );
-      }
+
+      epoch = *vec_epoch;
+      delta = vec_delta;
+
+      deltet_c( epoch, eptype, delta );
+      CHECK_CALL_FAILURE(SCALAR);
+      }
 
    }
 
@@ -3964,21 +4403,25 @@ void cspice_drdgeo(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              drdlat_c ( SpiceDouble    r,
-                                SpiceDouble    lon,
-                                SpiceDouble    lat,
-                                SpiceDouble    jacobi[3][3] )
+   void              dgeodr_c ( SpiceDouble         x,
+                                SpiceDouble         y,
+                                SpiceDouble         z,
+                                SpiceDouble         re,
+                                SpiceDouble         f,
+                                SpiceDouble         jacobi[3][3] )
 */
-void cspice_drdlat(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dgeodr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_r;
-   SpiceDouble        * vec_lon;
-   SpiceDouble        * vec_lat;
+   SpiceDouble        * vec_x;
+   SpiceDouble        * vec_y;
+   SpiceDouble        * vec_z;
    SpiceDouble        * vec_jacobi;
-   SpiceDouble          r;
-   SpiceDouble          lon;
-   SpiceDouble          lat;
+   SpiceDouble          x;
+   SpiceDouble          y;
+   SpiceDouble          z;
+   SpiceDouble          re;
+   SpiceDouble          f;
    SpiceDouble        * jacobi;
    SpiceDouble          xr[3][3];
 
@@ -3987,9 +4430,86 @@ void cspice_drdlat(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    struct extra_dims *extra;
    struct argcheck ArgCheck[] =
       {
-      { "r",      MiceDouble, 0, {0},    1},
-      { "lon",    MiceDouble, 0, {0},    1},
-      { "lat",    MiceDouble, 0, {0},    1},
+      { "x",      MiceDouble, 0, {0},    1},
+      { "y",      MiceDouble, 0, {0},    1},
+      { "z",      MiceDouble, 0, {0},    1},
+      { "re",     MiceDouble, 0, {0},    0},
+      { "f",      MiceDouble, 0, {0},    0},
+      { "jacobi", MiceDouble, 2, {3, 3}, 1},
+      };
+
+   check_arg_num( nrhs, nlhs, 5, 1 );
+
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+
+   vec_x    = A_DBL_ARGV(1);
+   vec_y    = A_DBL_ARGV(2);
+   vec_z    = A_DBL_ARGV(3);
+   x        = *(vec_x);
+   y        = *(vec_y);
+   z        = *(vec_z);
+   re         = S_DBL_ARGV(4);
+   f          = S_DBL_ARGV(5);
+   vec_jacobi = A_DBL_RET_ARGV(0);
+   jacobi     = vec_jacobi;
+
+   if (extra->count>1)
+      {
+
+      for (i=0;i<extra->count;i++)
+         {
+         x      = *(vec_x     + i*extra->offset[0]);
+         y      = *(vec_y     + i*extra->offset[1]);
+         z      = *(vec_z     + i*extra->offset[2]);
+         jacobi = (vec_jacobi + i*extra->offset[5]);
+
+         dgeodr_c(x, y, z, re, f, (SpiceDouble(*)[3])xr);
+         CHECK_CALL_FAILURE(i);
+
+         xpose_c( xr, (SpiceDouble(*)[3])jacobi );
+         }
+
+      }
+   else
+      {
+      dgeodr_c(x, y, z, re, f, (SpiceDouble(*)[3])xr);
+      CHECK_CALL_FAILURE(SCALAR);
+
+      xpose_c( xr, (SpiceDouble(*)[3])jacobi );
+      }
+
+   }
+
+
+
+
+/*
+   void              dlatdr_c ( SpiceDouble         x,
+                                SpiceDouble         y,
+                                SpiceDouble         z,
+                                SpiceDouble         jacobi[3][3] );
+*/
+void cspice_dlatdr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceDouble        * vec_x;
+   SpiceDouble        * vec_y;
+   SpiceDouble        * vec_z;
+   SpiceDouble        * vec_jacobi;
+   SpiceDouble          x;
+   SpiceDouble          y;
+   SpiceDouble          z;
+   SpiceDouble        * jacobi;
+   SpiceDouble          xr[3][3];
+
+   SpiceInt             i;
+
+   struct extra_dims *extra;
+   struct argcheck ArgCheck[] =
+      {
+      { "x",      MiceDouble, 0, {0},    1},
+      { "y",      MiceDouble, 0, {0},    1},
+      { "z",      MiceDouble, 0, {0},    1},
       { "jacobi", MiceDouble, 2, {3, 3}, 1},
       };
 
@@ -3997,12 +4517,12 @@ void cspice_drdlat(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_r      = A_DBL_ARGV(1);
-   vec_lon    = A_DBL_ARGV(2);
-   vec_lat    = A_DBL_ARGV(3);
-   r          = *vec_r;
-   lon        = *vec_lon;
-   lat        = *vec_lat;
+   vec_x      = A_DBL_ARGV(1);
+   vec_y      = A_DBL_ARGV(2);
+   vec_z      = A_DBL_ARGV(3);
+   x          = *vec_x;
+   y          = *vec_y;
+   z          = *vec_z;
    vec_jacobi = A_DBL_RET_ARGV(0);
    jacobi     = vec_jacobi;
 
@@ -4011,12 +4531,13 @@ void cspice_drdlat(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
       for (i=0;i<extra->count;i++)
          {
-         r     = *(vec_r + i*extra->offset[0]);
-         lon   = *(vec_lon + i*extra->offset[1]);
-         lat   = *(vec_lat + i*extra->offset[2]);
+         x      = *(vec_x + i*extra->offset[0]);
+         y      = *(vec_y + i*extra->offset[1]);
+         z      = *(vec_z + i*extra->offset[2]);
          jacobi = (vec_jacobi + i*extra->offset[3]);
 
-         drdlat_c(r, lon, lat, (SpiceDouble(*)[3])xr);
+         dlatdr_c(x, y, z, (SpiceDouble(*)[3])xr);
+
          CHECK_CALL_FAILURE(i);
 
          xpose_c( xr, (SpiceDouble(*)[3])jacobi );
@@ -4025,7 +4546,8 @@ void cspice_drdlat(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
       }
    else
       {
-      drdlat_c(r, lon, lat, (SpiceDouble(*)[3])xr);
+      dlatdr_c(x, y, z, (SpiceDouble(*)[3])xr);
+
       CHECK_CALL_FAILURE(SCALAR);
 
       xpose_c( xr, (SpiceDouble(*)[3])jacobi );
@@ -4037,25 +4559,25 @@ void cspice_drdlat(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              drdpgr_c ( ConstSpiceChar    * body,
-                                SpiceDouble         lon,
-                                SpiceDouble         lat,
-                                SpiceDouble         alt,
+   void              dpgrdr_c ( ConstSpiceChar    * body,
+                                SpiceDouble         x,
+                                SpiceDouble         y,
+                                SpiceDouble         z,
                                 SpiceDouble         re,
                                 SpiceDouble         f,
                                 SpiceDouble         jacobi[3][3] )
 */
-void cspice_drdpgr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dpgrdr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
    SpiceChar            body       [DEFAULT_STR_LENGTH+1];
-   SpiceDouble        * vec_lon;
-   SpiceDouble        * vec_lat;
-   SpiceDouble        * vec_alt;
+   SpiceDouble        * vec_x;
+   SpiceDouble        * vec_y;
+   SpiceDouble        * vec_z;
    SpiceDouble        * vec_jacobi;
-   SpiceDouble          lon;
-   SpiceDouble          lat;
-   SpiceDouble          alt;
+   SpiceDouble          x;
+   SpiceDouble          y;
+   SpiceDouble          z;
    SpiceDouble          re;
    SpiceDouble          f;
    SpiceDouble        * jacobi;
@@ -4067,9 +4589,9 @@ void cspice_drdpgr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    struct argcheck ArgCheck[] =
       {
       { "body",   MiceChar,   0, {0},    0},
-      { "lon",    MiceDouble, 0, {0},    1},
-      { "lat",    MiceDouble, 0, {0},    1},
-      { "alt",    MiceDouble, 0, {0},    1},
+      { "x",      MiceDouble, 0, {0},    1},
+      { "y",      MiceDouble, 0, {0},    1},
+      { "z",      MiceDouble, 0, {0},    1},
       { "re",     MiceDouble, 0, {0},    0},
       { "f",      MiceDouble, 0, {0},    0},
       { "jacobi", MiceDouble, 2, {3, 3}, 1},
@@ -4081,15 +4603,16 @@ void cspice_drdpgr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
    mxGetString( prhs[1], body, DEFAULT_STR_LENGTH );
 
-   vec_lon    = A_DBL_ARGV(2);
-   vec_lat    = A_DBL_ARGV(3);
-   vec_alt    = A_DBL_ARGV(4);
-   lon        = *(vec_lon);
-   lat        = *(vec_lat);
-   alt        = *(vec_alt);
+   vec_x      = A_DBL_ARGV(2);
+   vec_y      = A_DBL_ARGV(3);
+   vec_z      = A_DBL_ARGV(4);
    re         = S_DBL_ARGV(5);
    f          = S_DBL_ARGV(6);
    vec_jacobi = A_DBL_RET_ARGV(0);
+
+   x          = *(vec_x);
+   y          = *(vec_y);
+   z          = *(vec_z);
    jacobi     = vec_jacobi;
 
    if (extra->count>1)
@@ -4097,12 +4620,12 @@ void cspice_drdpgr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
       for (i=0;i<extra->count;i++)
          {
-         lon    = *(vec_lon     + i*extra->offset[1]);
-         lat    = *(vec_lat     + i*extra->offset[2]);
-         alt    = *(vec_alt     + i*extra->offset[3]);
+         x    = *(vec_x     + i*extra->offset[1]);
+         y    = *(vec_y     + i*extra->offset[2]);
+         z    = *(vec_z     + i*extra->offset[3]);
          jacobi = (vec_jacobi + i*extra->offset[6]);
 
-         drdpgr_c( body, lon, lat, alt, re, f, (SpiceDouble (*)[3])xr);
+         dpgrdr_c( body, x, y, z, re, f, (SpiceDouble (*)[3])xr);
          CHECK_CALL_FAILURE(i);
 
          xpose_c( xr, (SpiceDouble(*)[3])jacobi );
@@ -4111,7 +4634,7 @@ void cspice_drdpgr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
       }
    else
       {
-      drdpgr_c( body, lon, lat, alt, re, f, (SpiceDouble (*)[3])xr);
+      dpgrdr_c( body, x, y, z, re, f, (SpiceDouble (*)[3])xr);
       CHECK_CALL_FAILURE(SCALAR);
 
       xpose_c( xr, (SpiceDouble(*)[3])jacobi );
@@ -4123,21 +4646,39 @@ void cspice_drdpgr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              drdsph_c ( SpiceDouble    r,
-                                SpiceDouble    colat,
+   SpiceDouble              dpr_c( void )
+*/
+void cspice_dpr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   check_arg_num( nrhs, nlhs, 0, 1 );
+
+   /*
+   Directly return the scalar value. This simple case needs no
+   error checks.
+   */
+   plhs[0] = mxCreateDoubleScalar( dpr_c() );
+   }
+
+
+
+
+/*
+   void              drdcyl_c ( SpiceDouble    r,
                                 SpiceDouble    lon,
+                                SpiceDouble    z,
                                 SpiceDouble    jacobi[3][3] )
 */
-void cspice_drdsph(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_drdcyl(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
    SpiceDouble        * vec_r;
-   SpiceDouble        * vec_colat;
    SpiceDouble        * vec_lon;
+   SpiceDouble        * vec_z;
    SpiceDouble        * vec_jacobi;
    SpiceDouble          r;
-   SpiceDouble          colat;
    SpiceDouble          lon;
+   SpiceDouble          z;
    SpiceDouble        * jacobi;
    SpiceDouble          xr[3][3];
 
@@ -4147,8 +4688,8 @@ void cspice_drdsph(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    struct argcheck ArgCheck[] =
       {
       { "r",      MiceDouble, 0, {0},    1},
-      { "colat",  MiceDouble, 0, {0},    1},
       { "lon",    MiceDouble, 0, {0},    1},
+      { "z",      MiceDouble, 0, {0},    1},
       { "jacobi", MiceDouble, 2, {3, 3}, 1},
       };
 
@@ -4156,12 +4697,12 @@ void cspice_drdsph(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_r      = A_DBL_ARGV(1);
-   vec_colat  = A_DBL_ARGV(2);
-   vec_lon    = A_DBL_ARGV(3);
-   r          = *vec_r;
-   colat      = *vec_colat;
-   lon        = *vec_lon;
+   vec_r   = A_DBL_ARGV(1);
+   vec_lon = A_DBL_ARGV(2);
+   vec_z   = A_DBL_ARGV(3);
+   r       = *vec_r;
+   lon     = *vec_lon;
+   z       = *vec_z;
    vec_jacobi = A_DBL_RET_ARGV(0);
    jacobi     = vec_jacobi;
 
@@ -4171,11 +4712,11 @@ void cspice_drdsph(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
       for (i=0;i<extra->count;i++)
          {
          r      = *(vec_r     + i*extra->offset[0]);
-         colat  = *(vec_colat + i*extra->offset[1]);
-         lon    = *(vec_lon   + i*extra->offset[2]);
+         lon    = *(vec_lon   + i*extra->offset[1]);
+         z      = *(vec_z     + i*extra->offset[2]);
          jacobi = (vec_jacobi + i*extra->offset[3]);
 
-         drdsph_c(r, colat, lon, (SpiceDouble(*)[3])xr);
+         drdcyl_c(r, lon, z, (SpiceDouble(*)[3])xr);
          CHECK_CALL_FAILURE(i);
 
          xpose_c( xr, (SpiceDouble(*)[3])jacobi );
@@ -4184,7 +4725,7 @@ void cspice_drdsph(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
       }
    else
       {
-      drdsph_c(r, colat, lon, (SpiceDouble(*)[3])xr);
+      drdcyl_c(r, lon, z, (SpiceDouble(*)[3])xr);
       CHECK_CALL_FAILURE(SCALAR);
 
       xpose_c( xr, (SpiceDouble(*)[3])jacobi );
@@ -4196,21 +4737,25 @@ void cspice_drdsph(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dsphdr_c ( SpiceDouble         x,
-                                SpiceDouble         y,
-                                SpiceDouble         z,
-                                SpiceDouble         jacobi[3][3] );
+   void              drdgeo_c ( SpiceDouble         lon,
+                                SpiceDouble         lat,
+                                SpiceDouble         alt,
+                                SpiceDouble         re,
+                                SpiceDouble         f,
+                                SpiceDouble         jacobi[3][3] )
 */
-void cspice_dsphdr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_drdgeo(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_x;
-   SpiceDouble        * vec_y;
-   SpiceDouble        * vec_z;
+   SpiceDouble        * vec_lon;
+   SpiceDouble        * vec_lat;
+   SpiceDouble        * vec_alt;
    SpiceDouble        * vec_jacobi;
-   SpiceDouble          x;
-   SpiceDouble          y;
-   SpiceDouble          z;
+   SpiceDouble          lon;
+   SpiceDouble          lat;
+   SpiceDouble          alt;
+   SpiceDouble          re;
+   SpiceDouble          f;
    SpiceDouble        * jacobi;
    SpiceDouble          xr[3][3];
 
@@ -4219,22 +4764,26 @@ void cspice_dsphdr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    struct extra_dims *extra;
    struct argcheck ArgCheck[] =
       {
-      { "x",      MiceDouble, 0, {0},    1},
-      { "y",      MiceDouble, 0, {0},    1},
-      { "z",      MiceDouble, 0, {0},    1},
+      { "lon",    MiceDouble, 0, {0},    1},
+      { "lat",    MiceDouble, 0, {0},    1},
+      { "alt",    MiceDouble, 0, {0},    1},
+      { "re",     MiceDouble, 0, {0},    0},
+      { "f",      MiceDouble, 0, {0},    0},
       { "jacobi", MiceDouble, 2, {3, 3}, 1},
       };
 
-   check_arg_num( nrhs, nlhs, 3, 1 );
+   check_arg_num( nrhs, nlhs, 5, 1 );
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_x      = A_DBL_ARGV(1);
-   vec_y      = A_DBL_ARGV(2);
-   vec_z      = A_DBL_ARGV(3);
-   x          = *vec_x;
-   y          = *vec_y;
-   z          = *vec_z;
+   vec_lon    = A_DBL_ARGV(1);
+   vec_lat    = A_DBL_ARGV(2);
+   vec_alt    = A_DBL_ARGV(3);
+   lon        = *(vec_lon);
+   lat        = *(vec_lat);
+   alt        = *(vec_alt);
+   re         = S_DBL_ARGV(4);
+   f          = S_DBL_ARGV(5);
    vec_jacobi = A_DBL_RET_ARGV(0);
    jacobi     = vec_jacobi;
 
@@ -4243,12 +4792,12 @@ void cspice_dsphdr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
       for (i=0;i<extra->count;i++)
          {
-         x   = *(vec_x + i*extra->offset[0]);
-         y   = *(vec_y + i*extra->offset[1]);
-         z   = *(vec_z + i*extra->offset[2]);
-         jacobi = (vec_jacobi + i*extra->offset[3]);
+         lon    = *(vec_lon     + i*extra->offset[0]);
+         lat    = *(vec_lat     + i*extra->offset[1]);
+         alt    = *(vec_alt     + i*extra->offset[2]);
+         jacobi = (vec_jacobi + i*extra->offset[5]);
 
-         dsphdr_c(x, y, z, (SpiceDouble(*)[3])xr);
+         drdgeo_c(lon, lat, alt, re, f, (SpiceDouble(*)[3])xr);
          CHECK_CALL_FAILURE(i);
 
          xpose_c( xr, (SpiceDouble(*)[3])jacobi );
@@ -4257,7 +4806,7 @@ void cspice_dsphdr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
       }
    else
       {
-      dsphdr_c(x, y, z, (SpiceDouble(*)[3])xr);
+      drdgeo_c(lon, lat, alt, re, f, (SpiceDouble(*)[3])xr);
       CHECK_CALL_FAILURE(SCALAR);
 
       xpose_c( xr, (SpiceDouble(*)[3])jacobi );
@@ -4269,109 +4818,71 @@ void cspice_dsphdr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dtpool_c ( ConstSpiceChar      * name,
-                                SpiceBoolean        * found,
-                                SpiceInt            * n,
-                                SpiceChar             type [1] )
+   void              drdlat_c ( SpiceDouble    r,
+                                SpiceDouble    lon,
+                                SpiceDouble    lat,
+                                SpiceDouble    jacobi[3][3] )
 */
-void mice_dtpool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_drdlat(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceChar               name[DEFAULT_STR_LENGTH+1];
-   mxChar                * mx_name;
-   SpiceBoolean            found;
-   SpiceInt                n;
-   SpiceDouble             xn;
-   SpiceChar               type;
-   SpiceChar               type_buf[2];
+   SpiceDouble        * vec_r;
+   SpiceDouble        * vec_lon;
+   SpiceDouble        * vec_lat;
+   SpiceDouble        * vec_jacobi;
+   SpiceDouble          r;
+   SpiceDouble          lon;
+   SpiceDouble          lat;
+   SpiceDouble        * jacobi;
+   SpiceDouble          xr[3][3];
 
    SpiceInt             i;
-   SpiceInt             j;
 
-   struct extra_dims  * extra;
+   struct extra_dims *extra;
    struct argcheck ArgCheck[] =
       {
-      { "name",  MiceChar, 0, { 0 }, 1},
-      { "value", MicePool, 0, { 0 }, 1},
+      { "r",      MiceDouble, 0, {0},    1},
+      { "lon",    MiceDouble, 0, {0},    1},
+      { "lat",    MiceDouble, 0, {0},    1},
+      { "jacobi", MiceDouble, 2, {3, 3}, 1},
       };
 
-   /* Check the input contains the correct number of arguments. */
-   check_arg_num( nrhs, nlhs, 1, 1 );
+   check_arg_num( nrhs, nlhs, 3, 1 );
 
-   /*
-   Perform the input argument type checks, allocate any needed
-   memory for output args, copy the argument vector to a work copy.
-   */
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
+   vec_r      = A_DBL_ARGV(1);
+   vec_lon    = A_DBL_ARGV(2);
+   vec_lat    = A_DBL_ARGV(3);
+   r          = *vec_r;
+   lon        = *vec_lon;
+   lat        = *vec_lat;
+   vec_jacobi = A_DBL_RET_ARGV(0);
+   jacobi     = vec_jacobi;
+
    if (extra->count>1)
       {
-      mx_name = (mxChar *)mxGetChars(prhs[1]);
 
       for (i=0;i<extra->count;i++)
          {
+         r     = *(vec_r + i*extra->offset[0]);
+         lon   = *(vec_lon + i*extra->offset[1]);
+         lat   = *(vec_lat + i*extra->offset[2]);
+         jacobi = (vec_jacobi + i*extra->offset[3]);
 
-         /*
-         Extract the string data, character by character, into
-         CSPICE strings. The mx_name array stores the data in a column
-         major format, we need to extract the data by rows.
-         */
-         for ( j=0; j<extra->offset[0]; j++)
-            {
-            name[j] = (SpiceChar)mx_name[i + (extra->count*j)];
-            }
-
-         name[extra->offset[0]] = '\0';
-
-         dtpool_c( name, &found, &n, &type);
+         drdlat_c(r, lon, lat, (SpiceDouble(*)[3])xr);
          CHECK_CALL_FAILURE(i);
 
-         /* We return a string to MATLAB, so copy the char to a string. */
-         type_buf[0] = type;
-         type_buf[1] = '\0';
-
-         /*
-         Cast the number of found items to a double value.
-         */
-         xn = (SpiceDouble) n;
-
-         mxDestroyArray( mxGetField( plhs[0], i, "type" ) );
-         mxSetField( plhs[0], i, "type", mxCreateString(type_buf)  );
-
-         mxDestroyArray( mxGetField( plhs[0], i, "n" ) );
-         mxSetField( plhs[0], i, "n", mxCreateDoubleScalar(xn) );
-
-         mxDestroyArray( mxGetField( plhs[0], i, "found" ) );
-         mxSetField( plhs[0], i, "found",
-                     mxCreateLogicalScalar(found ? true: false));
+         xpose_c( xr, (SpiceDouble(*)[3])jacobi );
          }
 
       }
    else
       {
-      mxGetString(prhs[1], name, DEFAULT_STR_LENGTH);
-
-      dtpool_c( name, &found, &n, &type);
-      CHECK_CALL_FAILURE( SCALAR );
-
-      /* We return a string to MATLAB, so copy the char to a string. */
-      type_buf[0] = type;
-      type_buf[1] = '\0';
-
-      /*
-      Cast the number of found items to a double value.
-      */
-      xn = (SpiceDouble) n;
-
-      mxDestroyArray( mxGetField( plhs[0], 0, "type" ) );
-      mxSetField( plhs[0], 0, "type", mxCreateString(type_buf) );
-
-      mxDestroyArray( mxGetField( plhs[0], 0, "n" ) );
-      mxSetField( plhs[0], 0, "n", mxCreateDoubleScalar(xn) );
+      drdlat_c(r, lon, lat, (SpiceDouble(*)[3])xr);
+      CHECK_CALL_FAILURE(SCALAR);
 
-      mxDestroyArray( mxGetField( plhs[0], 0, "found" ) );
-      mxSetField( plhs[0], 0, "found",
-                  mxCreateLogicalScalar(found ? true: false));
+      xpose_c( xr, (SpiceDouble(*)[3])jacobi );
       }
 
    }
@@ -4380,60 +4891,84 @@ void mice_dtpool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              ducrss_c ( ConstSpiceDouble s1  [6],
-                                ConstSpiceDouble s2  [6],
-                                SpiceDouble      sout[6] )
+   void              drdpgr_c ( ConstSpiceChar    * body,
+                                SpiceDouble         lon,
+                                SpiceDouble         lat,
+                                SpiceDouble         alt,
+                                SpiceDouble         re,
+                                SpiceDouble         f,
+                                SpiceDouble         jacobi[3][3] )
 */
-void cspice_ducrss(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_drdpgr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_s1;
-   SpiceDouble        * vec_s2;
-   SpiceDouble        * vec_vout;
-   SpiceDouble        * s1;
-   SpiceDouble        * s2;
-   SpiceDouble        * vout;
+   SpiceChar            body       [DEFAULT_STR_LENGTH+1];
+   SpiceDouble        * vec_lon;
+   SpiceDouble        * vec_lat;
+   SpiceDouble        * vec_alt;
+   SpiceDouble        * vec_jacobi;
+   SpiceDouble          lon;
+   SpiceDouble          lat;
+   SpiceDouble          alt;
+   SpiceDouble          re;
+   SpiceDouble          f;
+   SpiceDouble        * jacobi;
+   SpiceDouble          xr[3][3];
 
    SpiceInt             i;
 
    struct extra_dims *extra;
    struct argcheck ArgCheck[] =
       {
-      { "s1",     MiceDouble, 1, {6}, 1},
-      { "s2",     MiceDouble, 1, {6}, 1},
-      { "ducrss", MiceDouble, 1, {6}, 1},
+      { "body",   MiceChar,   0, {0},    0},
+      { "lon",    MiceDouble, 0, {0},    1},
+      { "lat",    MiceDouble, 0, {0},    1},
+      { "alt",    MiceDouble, 0, {0},    1},
+      { "re",     MiceDouble, 0, {0},    0},
+      { "f",      MiceDouble, 0, {0},    0},
+      { "jacobi", MiceDouble, 2, {3, 3}, 1},
       };
 
-   check_arg_num( nrhs, nlhs, 2, 1 );
+   check_arg_num( nrhs, nlhs, 6, 1 );
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_s1   = A_DBL_ARGV(1);
-   vec_s2   = A_DBL_ARGV(2);
-   vec_vout = A_DBL_RET_ARGV(0);
+   mxGetString( prhs[1], body, DEFAULT_STR_LENGTH );
+
+   vec_lon    = A_DBL_ARGV(2);
+   vec_lat    = A_DBL_ARGV(3);
+   vec_alt    = A_DBL_ARGV(4);
+   lon        = *(vec_lon);
+   lat        = *(vec_lat);
+   alt        = *(vec_alt);
+   re         = S_DBL_ARGV(5);
+   f          = S_DBL_ARGV(6);
+   vec_jacobi = A_DBL_RET_ARGV(0);
+   jacobi     = vec_jacobi;
 
    if (extra->count>1)
       {
 
       for (i=0;i<extra->count;i++)
          {
-         s1   = (vec_s1   + i*extra->offset[0]);
-         s2   = (vec_s2   + i*extra->offset[1]);
-         vout = (vec_vout + i*extra->offset[2]);
+         lon    = *(vec_lon     + i*extra->offset[1]);
+         lat    = *(vec_lat     + i*extra->offset[2]);
+         alt    = *(vec_alt     + i*extra->offset[3]);
+         jacobi = (vec_jacobi + i*extra->offset[6]);
 
-         ducrss_c(s1, s2, vout);
+         drdpgr_c( body, lon, lat, alt, re, f, (SpiceDouble (*)[3])xr);
          CHECK_CALL_FAILURE(i);
+
+         xpose_c( xr, (SpiceDouble(*)[3])jacobi );
          }
 
       }
    else
       {
-      s1   = vec_s1;
-      s2   = vec_s2;
-      vout = vec_vout;
-
-      ducrss_c(s1, s2, vout);
+      drdpgr_c( body, lon, lat, alt, re, f, (SpiceDouble (*)[3])xr);
       CHECK_CALL_FAILURE(SCALAR);
+
+      xpose_c( xr, (SpiceDouble(*)[3])jacobi );
       }
 
    }
@@ -4442,60 +4977,71 @@ void cspice_ducrss(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dvcrss_c ( ConstSpiceDouble s1  [6],
-                                ConstSpiceDouble s2  [6],
-                                SpiceDouble      sout[6] )
+   void              drdsph_c ( SpiceDouble    r,
+                                SpiceDouble    colat,
+                                SpiceDouble    lon,
+                                SpiceDouble    jacobi[3][3] )
 */
-void cspice_dvcrss(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_drdsph(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_s1;
-   SpiceDouble        * vec_s2;
-   SpiceDouble        * vec_vout;
-   SpiceDouble        * s1;
-   SpiceDouble        * s2;
-   SpiceDouble        * vout;
-
-   SpiceInt             i;
-
-   struct extra_dims *extra;
+   SpiceDouble        * vec_r;
+   SpiceDouble        * vec_colat;
+   SpiceDouble        * vec_lon;
+   SpiceDouble        * vec_jacobi;
+   SpiceDouble          r;
+   SpiceDouble          colat;
+   SpiceDouble          lon;
+   SpiceDouble        * jacobi;
+   SpiceDouble          xr[3][3];
+
+   SpiceInt             i;
+
+   struct extra_dims *extra;
    struct argcheck ArgCheck[] =
       {
-      { "s1",     MiceDouble, 1, {6}, 1},
-      { "s2",     MiceDouble, 1, {6}, 1},
-      { "dvcrss", MiceDouble, 1, {6}, 1},
+      { "r",      MiceDouble, 0, {0},    1},
+      { "colat",  MiceDouble, 0, {0},    1},
+      { "lon",    MiceDouble, 0, {0},    1},
+      { "jacobi", MiceDouble, 2, {3, 3}, 1},
       };
 
-   check_arg_num( nrhs, nlhs, 2, 1 );
+   check_arg_num( nrhs, nlhs, 3, 1 );
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_s1   = A_DBL_ARGV(1);
-   vec_s2   = A_DBL_ARGV(2);
-   vec_vout = A_DBL_RET_ARGV(0);
+   vec_r      = A_DBL_ARGV(1);
+   vec_colat  = A_DBL_ARGV(2);
+   vec_lon    = A_DBL_ARGV(3);
+   r          = *vec_r;
+   colat      = *vec_colat;
+   lon        = *vec_lon;
+   vec_jacobi = A_DBL_RET_ARGV(0);
+   jacobi     = vec_jacobi;
 
    if (extra->count>1)
       {
 
       for (i=0;i<extra->count;i++)
          {
-         s1   = (vec_s1   + i*extra->offset[0]);
-         s2   = (vec_s2   + i*extra->offset[1]);
-         vout = (vec_vout + i*extra->offset[2]);
+         r      = *(vec_r     + i*extra->offset[0]);
+         colat  = *(vec_colat + i*extra->offset[1]);
+         lon    = *(vec_lon   + i*extra->offset[2]);
+         jacobi = (vec_jacobi + i*extra->offset[3]);
 
-         dvcrss_c(s1, s2, vout);
+         drdsph_c(r, colat, lon, (SpiceDouble(*)[3])xr);
          CHECK_CALL_FAILURE(i);
+
+         xpose_c( xr, (SpiceDouble(*)[3])jacobi );
          }
 
       }
    else
       {
-      s1   = vec_s1;
-      s2   = vec_s2;
-      vout = vec_vout;
-
-      dvcrss_c(s1, s2, vout);
+      drdsph_c(r, colat, lon, (SpiceDouble(*)[3])xr);
       CHECK_CALL_FAILURE(SCALAR);
+
+      xpose_c( xr, (SpiceDouble(*)[3])jacobi );
       }
 
    }
@@ -4504,59 +5050,71 @@ void cspice_dvcrss(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   SpiceDouble       dvdot_c  ( ConstSpiceDouble      s1[6],
-                                ConstSpiceDouble      s2[6] )
+   void              dsphdr_c ( SpiceDouble         x,
+                                SpiceDouble         y,
+                                SpiceDouble         z,
+                                SpiceDouble         jacobi[3][3] );
 */
-void cspice_dvdot(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dsphdr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_s1;
-   SpiceDouble        * vec_s2;
-   SpiceDouble        * s1;
-   SpiceDouble        * s2;
-   SpiceDouble        * retval;
-   SpiceDouble        * vec_retval;
+   SpiceDouble        * vec_x;
+   SpiceDouble        * vec_y;
+   SpiceDouble        * vec_z;
+   SpiceDouble        * vec_jacobi;
+   SpiceDouble          x;
+   SpiceDouble          y;
+   SpiceDouble          z;
+   SpiceDouble        * jacobi;
+   SpiceDouble          xr[3][3];
 
    SpiceInt             i;
 
    struct extra_dims *extra;
    struct argcheck ArgCheck[] =
       {
-      { "s1",    MiceDouble, 1, {6}, 1},
-      { "s2",    MiceDouble, 1, {6}, 1},
-      { "dvdot", MiceDouble, 0, {0}, 1},
+      { "x",      MiceDouble, 0, {0},    1},
+      { "y",      MiceDouble, 0, {0},    1},
+      { "z",      MiceDouble, 0, {0},    1},
+      { "jacobi", MiceDouble, 2, {3, 3}, 1},
       };
 
-   check_arg_num( nrhs, nlhs, 2, 1 );
+   check_arg_num( nrhs, nlhs, 3, 1 );
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_s1     = A_DBL_ARGV(1);
-   vec_s2     = A_DBL_ARGV(2);
-   vec_retval = A_DBL_RET_ARGV(0);
+   vec_x      = A_DBL_ARGV(1);
+   vec_y      = A_DBL_ARGV(2);
+   vec_z      = A_DBL_ARGV(3);
+   x          = *vec_x;
+   y          = *vec_y;
+   z          = *vec_z;
+   vec_jacobi = A_DBL_RET_ARGV(0);
+   jacobi     = vec_jacobi;
 
    if (extra->count>1)
       {
 
       for (i=0;i<extra->count;i++)
          {
-         s1     = (vec_s1     + i*extra->offset[0]);
-         s2     = (vec_s2     + i*extra->offset[1]);
-         retval = (vec_retval + i*extra->offset[2]);
+         x   = *(vec_x + i*extra->offset[0]);
+         y   = *(vec_y + i*extra->offset[1]);
+         z   = *(vec_z + i*extra->offset[2]);
+         jacobi = (vec_jacobi + i*extra->offset[3]);
 
-         *retval = dvdot_c(s1, s2);
+         dsphdr_c(x, y, z, (SpiceDouble(*)[3])xr);
          CHECK_CALL_FAILURE(i);
+
+         xpose_c( xr, (SpiceDouble(*)[3])jacobi );
          }
 
       }
    else
       {
-      s1     = vec_s1;
-      s2     = vec_s2;
-      retval = vec_retval;
-
-      *retval = dvdot_c(s1, s2);
+      dsphdr_c(x, y, z, (SpiceDouble(*)[3])xr);
       CHECK_CALL_FAILURE(SCALAR);
+
+      xpose_c( xr, (SpiceDouble(*)[3])jacobi );
       }
 
    }
@@ -4565,56 +5123,109 @@ void cspice_dvdot(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dvhat_c  ( ConstSpiceDouble      s1  [6],
-                                SpiceDouble           sout[6] )
+   void              dtpool_c ( ConstSpiceChar      * name,
+                                SpiceBoolean        * found,
+                                SpiceInt            * n,
+                                SpiceChar             type [1] )
 */
-void cspice_dvhat(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void mice_dtpool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceDouble        * vec_s1;
-   SpiceDouble        * vec_vout;
-   SpiceDouble        * s1;
-   SpiceDouble        * vout;
+   SpiceChar               name[DEFAULT_STR_LENGTH+1];
+   mxChar                * mx_name;
+   SpiceBoolean            found;
+   SpiceInt                n;
+   SpiceDouble             xn;
+   SpiceChar               type;
+   SpiceChar               type_buf[2];
 
    SpiceInt             i;
+   SpiceInt             j;
 
    struct extra_dims  * extra;
-
    struct argcheck ArgCheck[] =
       {
-      { "s1",   MiceDouble, 1, {6}, 1},
-      { "vout", MiceDouble, 1, {6}, 1},
+      { "name",  MiceChar, 0, { 0 }, 1},
+      { "value", MicePool, 0, { 0 }, 1},
       };
 
+   /* Check the input contains the correct number of arguments. */
    check_arg_num( nrhs, nlhs, 1, 1 );
 
+   /*
+   Perform the input argument type checks, allocate any needed
+   memory for output args, copy the argument vector to a work copy.
+   */
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_s1   = A_DBL_ARGV(1);
-   vec_vout = A_DBL_RET_ARGV(0);
-
    if (extra->count>1)
       {
+      mx_name = (mxChar *)mxGetChars(prhs[1]);
 
       for (i=0;i<extra->count;i++)
          {
 
-         s1   =  (vec_s1   + i*extra->offset[0]);
-         vout =  (vec_vout + i*extra->offset[1]);
+         /*
+         Extract the string data, character by character, into
+         CSPICE strings. The mx_name array stores the data in a column
+         major format, we need to extract the data by rows.
+         */
+         for ( j=0; j<extra->offset[0]; j++)
+            {
+            name[j] = (SpiceChar)mx_name[i + (extra->count*j)];
+            }
 
-         dvhat_c(s1, vout);
+         name[extra->offset[0]] = '\0';
+
+         dtpool_c( name, &found, &n, &type);
          CHECK_CALL_FAILURE(i);
+
+         /* We return a string to MATLAB, so copy the char to a string. */
+         type_buf[0] = type;
+         type_buf[1] = '\0';
+
+         /*
+         Cast the number of found items to a double value.
+         */
+         xn = (SpiceDouble) n;
+
+         mxDestroyArray( mxGetField( plhs[0], i, "type" ) );
+         mxSetField( plhs[0], i, "type", mxCreateString(type_buf)  );
+
+         mxDestroyArray( mxGetField( plhs[0], i, "n" ) );
+         mxSetField( plhs[0], i, "n", mxCreateDoubleScalar(xn) );
+
+         mxDestroyArray( mxGetField( plhs[0], i, "found" ) );
+         mxSetField( plhs[0], i, "found",
+                     mxCreateLogicalScalar(found ? true: false));
          }
 
       }
    else
       {
+      mxGetString(prhs[1], name, DEFAULT_STR_LENGTH);
 
-      s1   =  vec_s1;
-      vout =  vec_vout;
+      dtpool_c( name, &found, &n, &type);
+      CHECK_CALL_FAILURE( SCALAR );
 
-      dvhat_c( s1, vout);
-      CHECK_CALL_FAILURE(SCALAR);
+      /* We return a string to MATLAB, so copy the char to a string. */
+      type_buf[0] = type;
+      type_buf[1] = '\0';
+
+      /*
+      Cast the number of found items to a double value.
+      */
+      xn = (SpiceDouble) n;
+
+      mxDestroyArray( mxGetField( plhs[0], 0, "type" ) );
+      mxSetField( plhs[0], 0, "type", mxCreateString(type_buf) );
+
+      mxDestroyArray( mxGetField( plhs[0], 0, "n" ) );
+      mxSetField( plhs[0], 0, "n", mxCreateDoubleScalar(xn) );
+
+      mxDestroyArray( mxGetField( plhs[0], 0, "found" ) );
+      mxSetField( plhs[0], 0, "found",
+                  mxCreateLogicalScalar(found ? true: false));
       }
 
    }
@@ -4623,15 +5234,19 @@ void cspice_dvhat(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   SpiceDouble       dvnorm_c ( ConstSpiceDouble     state[6] )
+   void              ducrss_c ( ConstSpiceDouble s1  [6],
+                                ConstSpiceDouble s2  [6],
+                                SpiceDouble      sout[6] )
 */
-void cspice_dvnorm(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_ducrss(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
    SpiceDouble        * vec_s1;
+   SpiceDouble        * vec_s2;
+   SpiceDouble        * vec_vout;
    SpiceDouble        * s1;
-   SpiceDouble        * vec_retval;
-   SpiceDouble        * retval;
+   SpiceDouble        * s2;
+   SpiceDouble        * vout;
 
    SpiceInt             i;
 
@@ -4639,35 +5254,39 @@ void cspice_dvnorm(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    struct argcheck ArgCheck[] =
       {
       { "s1",     MiceDouble, 1, {6}, 1},
-      { "dvnorm", MiceDouble, 0, {0}, 1},
+      { "s2",     MiceDouble, 1, {6}, 1},
+      { "ducrss", MiceDouble, 1, {6}, 1},
       };
 
-   check_arg_num( nrhs, nlhs, 1, 1 );
+   check_arg_num( nrhs, nlhs, 2, 1 );
 
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   vec_s1     = A_DBL_ARGV(1);
-   vec_retval = A_DBL_RET_ARGV(0);
+   vec_s1   = A_DBL_ARGV(1);
+   vec_s2   = A_DBL_ARGV(2);
+   vec_vout = A_DBL_RET_ARGV(0);
 
    if (extra->count>1)
       {
 
       for (i=0;i<extra->count;i++)
          {
-         s1     = (vec_s1     + i*extra->offset[0]);
-         retval = (vec_retval + i*extra->offset[1]);
+         s1   = (vec_s1   + i*extra->offset[0]);
+         s2   = (vec_s2   + i*extra->offset[1]);
+         vout = (vec_vout + i*extra->offset[2]);
 
-         *retval = dvnorm_c( s1 );
+         ducrss_c(s1, s2, vout);
          CHECK_CALL_FAILURE(i);
          }
 
       }
    else
       {
-      s1     = vec_s1;
-      retval = vec_retval;
+      s1   = vec_s1;
+      s2   = vec_s2;
+      vout = vec_vout;
 
-      *retval = dvnorm_c( s1 );
+      ducrss_c(s1, s2, vout);
       CHECK_CALL_FAILURE(SCALAR);
       }
 
@@ -4677,18 +5296,253 @@ void cspice_dvnorm(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              dvpool_c ( ConstSpiceChar      * name );
+   void              dvcrss_c ( ConstSpiceDouble s1  [6],
+                                ConstSpiceDouble s2  [6],
+                                SpiceDouble      sout[6] )
 */
-void cspice_dvpool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void cspice_dvcrss(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
-   SpiceChar           name[DEFAULT_STR_LENGTH+1];
-   mxChar            * mx_name;
-
-   SpiceInt            i;
-   SpiceInt            j;
-
-   struct extra_dims * extra;
+   SpiceDouble        * vec_s1;
+   SpiceDouble        * vec_s2;
+   SpiceDouble        * vec_vout;
+   SpiceDouble        * s1;
+   SpiceDouble        * s2;
+   SpiceDouble        * vout;
+
+   SpiceInt             i;
+
+   struct extra_dims *extra;
+   struct argcheck ArgCheck[] =
+      {
+      { "s1",     MiceDouble, 1, {6}, 1},
+      { "s2",     MiceDouble, 1, {6}, 1},
+      { "dvcrss", MiceDouble, 1, {6}, 1},
+      };
+
+   check_arg_num( nrhs, nlhs, 2, 1 );
+
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+
+   vec_s1   = A_DBL_ARGV(1);
+   vec_s2   = A_DBL_ARGV(2);
+   vec_vout = A_DBL_RET_ARGV(0);
+
+   if (extra->count>1)
+      {
+
+      for (i=0;i<extra->count;i++)
+         {
+         s1   = (vec_s1   + i*extra->offset[0]);
+         s2   = (vec_s2   + i*extra->offset[1]);
+         vout = (vec_vout + i*extra->offset[2]);
+
+         dvcrss_c(s1, s2, vout);
+         CHECK_CALL_FAILURE(i);
+         }
+
+      }
+   else
+      {
+      s1   = vec_s1;
+      s2   = vec_s2;
+      vout = vec_vout;
+
+      dvcrss_c(s1, s2, vout);
+      CHECK_CALL_FAILURE(SCALAR);
+      }
+
+   }
+
+
+
+
+/*
+   SpiceDouble       dvdot_c  ( ConstSpiceDouble      s1[6],
+                                ConstSpiceDouble      s2[6] )
+*/
+void cspice_dvdot(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceDouble        * vec_s1;
+   SpiceDouble        * vec_s2;
+   SpiceDouble        * s1;
+   SpiceDouble        * s2;
+   SpiceDouble        * retval;
+   SpiceDouble        * vec_retval;
+
+   SpiceInt             i;
+
+   struct extra_dims *extra;
+   struct argcheck ArgCheck[] =
+      {
+      { "s1",    MiceDouble, 1, {6}, 1},
+      { "s2",    MiceDouble, 1, {6}, 1},
+      { "dvdot", MiceDouble, 0, {0}, 1},
+      };
+
+   check_arg_num( nrhs, nlhs, 2, 1 );
+
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+
+   vec_s1     = A_DBL_ARGV(1);
+   vec_s2     = A_DBL_ARGV(2);
+   vec_retval = A_DBL_RET_ARGV(0);
+
+   if (extra->count>1)
+      {
+
+      for (i=0;i<extra->count;i++)
+         {
+         s1     = (vec_s1     + i*extra->offset[0]);
+         s2     = (vec_s2     + i*extra->offset[1]);
+         retval = (vec_retval + i*extra->offset[2]);
+
+         *retval = dvdot_c(s1, s2);
+         CHECK_CALL_FAILURE(i);
+         }
+
+      }
+   else
+      {
+      s1     = vec_s1;
+      s2     = vec_s2;
+      retval = vec_retval;
+
+      *retval = dvdot_c(s1, s2);
+      CHECK_CALL_FAILURE(SCALAR);
+      }
+
+   }
+
+
+
+
+/*
+   void              dvhat_c  ( ConstSpiceDouble      s1  [6],
+                                SpiceDouble           sout[6] )
+*/
+void cspice_dvhat(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceDouble        * vec_s1;
+   SpiceDouble        * vec_vout;
+   SpiceDouble        * s1;
+   SpiceDouble        * vout;
+
+   SpiceInt             i;
+
+   struct extra_dims  * extra;
+
+   struct argcheck ArgCheck[] =
+      {
+      { "s1",   MiceDouble, 1, {6}, 1},
+      { "vout", MiceDouble, 1, {6}, 1},
+      };
+
+   check_arg_num( nrhs, nlhs, 1, 1 );
+
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+
+   vec_s1   = A_DBL_ARGV(1);
+   vec_vout = A_DBL_RET_ARGV(0);
+
+   if (extra->count>1)
+      {
+
+      for (i=0;i<extra->count;i++)
+         {
+
+         s1   =  (vec_s1   + i*extra->offset[0]);
+         vout =  (vec_vout + i*extra->offset[1]);
+
+         dvhat_c(s1, vout);
+         CHECK_CALL_FAILURE(i);
+         }
+
+      }
+   else
+      {
+
+      s1   =  vec_s1;
+      vout =  vec_vout;
+
+      dvhat_c( s1, vout);
+      CHECK_CALL_FAILURE(SCALAR);
+      }
+
+   }
+
+
+
+
+/*
+   SpiceDouble       dvnorm_c ( ConstSpiceDouble     state[6] )
+*/
+void cspice_dvnorm(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceDouble        * vec_s1;
+   SpiceDouble        * s1;
+   SpiceDouble        * vec_retval;
+   SpiceDouble        * retval;
+
+   SpiceInt             i;
+
+   struct extra_dims *extra;
+   struct argcheck ArgCheck[] =
+      {
+      { "s1",     MiceDouble, 1, {6}, 1},
+      { "dvnorm", MiceDouble, 0, {0}, 1},
+      };
+
+   check_arg_num( nrhs, nlhs, 1, 1 );
+
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+
+   vec_s1     = A_DBL_ARGV(1);
+   vec_retval = A_DBL_RET_ARGV(0);
+
+   if (extra->count>1)
+      {
+
+      for (i=0;i<extra->count;i++)
+         {
+         s1     = (vec_s1     + i*extra->offset[0]);
+         retval = (vec_retval + i*extra->offset[1]);
+
+         *retval = dvnorm_c( s1 );
+         CHECK_CALL_FAILURE(i);
+         }
+
+      }
+   else
+      {
+      s1     = vec_s1;
+      retval = vec_retval;
+
+      *retval = dvnorm_c( s1 );
+      CHECK_CALL_FAILURE(SCALAR);
+      }
+
+   }
+
+
+
+
+/*
+   void              dvpool_c ( ConstSpiceChar      * name );
+*/
+void cspice_dvpool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceChar           name[DEFAULT_STR_LENGTH+1];
+   mxChar            * mx_name;
+
+   SpiceInt            i;
+   SpiceInt            j;
+
+   struct extra_dims * extra;
    struct argcheck ArgCheck[] =
       {
       { "name", MiceChar, 0, {0}, 1},
@@ -4719,6 +5573,7 @@ void cspice_dvpool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
          name[extra->offset[0]] = '\0';
 
          dvpool_c(name);
+         zzmice_pool_reset();
          CHECK_CALL_FAILURE(i);
          }
 
@@ -4728,6 +5583,7 @@ void cspice_dvpool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
       mxGetString(prhs[1], name, DEFAULT_STR_LENGTH);
 
       dvpool_c(name);
+      zzmice_pool_reset();
       CHECK_CALL_FAILURE(SCALAR);
       }
 
@@ -6304,6 +7160,8 @@ void cspice_furnsh(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
    check_arg_num( nrhs, nlhs, 1, 0 );
 
+   zzmice_clear_caches();
+
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
    if (extra->count>1)
@@ -6327,6 +7185,7 @@ void cspice_furnsh(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
          file[extra->offset[0]] = '\0';
 
          furnsh_c(file);
+         zzmice_pool_kernel();
          CHECK_CALL_FAILURE(i);
          }
 
@@ -6336,6 +7195,7 @@ void cspice_furnsh(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
       mxGetString(prhs[1], file, DEFAULT_STR_LENGTH);
 
       furnsh_c(file);
+      zzmice_pool_kernel();
       CHECK_CALL_FAILURE(SCALAR);
       }
 
@@ -6749,6 +7609,9 @@ void cspice_gfdist(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    SpiceDouble        * result;
    SpiceDouble        * result_f;
 
+   ConstSpiceChar     * names [4];
+   SpiceDouble          dvals [3];
+
    int                 sizearray[2];
 
    SpiceInt            cnfine_size;
@@ -6842,16 +7705,32 @@ void cspice_gfdist(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    result_cell.base = result;
    result_cell.data = &result[SPICE_CELL_CTRLSZ];
 
-   (void) gfdist_c ( target,
-                     abcorr,
-                     obsrvr,
-                     relate,
-                     refval,
-                     adjust,
-                     step,
-                     nintvls,
-                     &cnfine_cell,
-                     &result_cell );
+   names[0] = target;
+   names[1] = abcorr;
+   names[2] = obsrvr;
+   names[3] = relate;
+
+   dvals[0] = refval;
+   dvals[1] = adjust;
+   dvals[2] = step;
+
+   /*
+   With the worker pool started, split the search across the workers.
+   */
+   if ( !zzmice_pool_gf( POOL_GFDIST, names, dvals, nintvls,
+                         &cnfine_cell, &result_cell ) )
+      {
+      (void) gfdist_c ( target,
+                        abcorr,
+                        obsrvr,
+                        relate,
+                        refval,
+                        adjust,
+                        step,
+                        nintvls,
+                        &cnfine_cell,
+                        &result_cell );
+      }
 
    /*
    Check for a failure signal. Free the memory assigned to 'result'
@@ -6923,6 +7802,9 @@ void cspice_gfilum(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    SpiceDouble        * result;
    SpiceDouble        * result_f;
 
+   ConstSpiceChar     * names [8];
+   SpiceDouble          dvals [6];
+
    int                  sizearray[2];
 
    SpiceInt             cnfine_size;
@@ -7028,21 +7910,44 @@ void cspice_gfilum(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    result_cell.base = result;
    result_cell.data = &result[SPICE_CELL_CTRLSZ];
 
-   (void) gfilum_c ( method,
-                     angtyp,
-                     target,
-                     illum,
-                     fixref,
-                     abcorr,
-                     obsrvr,
-                     spoint,
-                     relate,
-                     refval,
-                     adjust,
-                     step,
-                     nintvls,
-                     &cnfine_cell,
-                     &result_cell  );
+   names[0] = method;
+   names[1] = angtyp;
+   names[2] = target;
+   names[3] = illum;
+   names[4] = fixref;
+   names[5] = abcorr;
+   names[6] = obsrvr;
+   names[7] = relate;
+
+   dvals[0] = spoint[0];
+   dvals[1] = spoint[1];
+   dvals[2] = spoint[2];
+   dvals[3] = refval;
+   dvals[4] = adjust;
+   dvals[5] = step;
+
+   /*
+   With the worker pool started, split the search across the workers.
+   */
+   if ( !zzmice_pool_gf( POOL_GFILUM, names, dvals, nintvls,
+                         &cnfine_cell, &result_cell ) )
+      {
+      (void) gfilum_c ( method,
+                        angtyp,
+                        target,
+                        illum,
+                        fixref,
+                        abcorr,
+                        obsrvr,
+                        spoint,
+                        relate,
+                        refval,
+                        adjust,
+                        step,
+                        nintvls,
+                        &cnfine_cell,
+                        &result_cell  );
+      }
 
    /*
    Check for a failure signal. Free the memory assigned to 'result'
@@ -7109,6 +8014,9 @@ void cspice_gfoclt(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    SpiceDouble        * result;
    SpiceDouble        * result_f;
 
+   ConstSpiceChar     * names [9];
+   SpiceDouble          dvals [1];
+
    int                 sizearray[2];
 
    SpiceInt            cnfine_size;
@@ -7207,18 +8115,37 @@ void cspice_gfoclt(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    result_cell.base = result;
    result_cell.data = &result[SPICE_CELL_CTRLSZ];
 
-   (void) gfoclt_c ( occtyp,
-                     front,
-                     fshape,
-                     fframe,
-                     back,
-                     bshape,
-                     bframe,
-                     abcorr,
-                     obsrvr,
-                     step,
-                     &cnfine_cell,
-                     &result_cell  );
+   names[0] = occtyp;
+   names[1] = front;
+   names[2] = fshape;
+   names[3] = fframe;
+   names[4] = back;
+   names[5] = bshape;
+   names[6] = bframe;
+   names[7] = abcorr;
+   names[8] = obsrvr;
+
+   dvals[0] = step;
+
+   /*
+   With the worker pool started, split the search across the workers.
+   */
+   if ( !zzmice_pool_gf( POOL_GFOCLT, names, dvals, 0,
+                         &cnfine_cell, &result_cell ) )
+      {
+      (void) gfoclt_c ( occtyp,
+                        front,
+                        fshape,
+                        fframe,
+                        back,
+                        bshape,
+                        bframe,
+                        abcorr,
+                        obsrvr,
+                        step,
+                        &cnfine_cell,
+                        &result_cell  );
+      }
 
 
    /*
@@ -7284,6 +8211,9 @@ void cspice_gfpa(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    SpiceDouble        * result;
    SpiceDouble        * result_f;
 
+   ConstSpiceChar     * names [5];
+   SpiceDouble          dvals [3];
+
    int                 sizearray[2];
 
    SpiceInt            cnfine_size;
@@ -7379,17 +8309,34 @@ void cspice_gfpa(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    result_cell.base = result;
    result_cell.data = &result[SPICE_CELL_CTRLSZ];
 
-   (void) gfpa_c ( target,
-                   illum,
-                   abcorr,
-                   obsrvr,
-                   relate,
-                   refval,
-                   adjust,
-                   step,
-                   nintvls,
-                   &cnfine_cell,
-                   &result_cell );
+   names[0] = target;
+   names[1] = illum;
+   names[2] = abcorr;
+   names[3] = obsrvr;
+   names[4] = relate;
+
+   dvals[0] = refval;
+   dvals[1] = adjust;
+   dvals[2] = step;
+
+   /*
+   With the worker pool started, split the search across the workers.
+   */
+   if ( !zzmice_pool_gf( POOL_GFPA, names, dvals, nintvls,
+                         &cnfine_cell, &result_cell ) )
+      {
+      (void) gfpa_c ( target,
+                      illum,
+                      abcorr,
+                      obsrvr,
+                      relate,
+                      refval,
+                      adjust,
+                      step,
+                      nintvls,
+                      &cnfine_cell,
+                      &result_cell );
+      }
 
    /*
    Check for a failure signal. Free the memory assigned to 'result'
@@ -7458,6 +8405,9 @@ void cspice_gfposc(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    SpiceDouble        * result;
    SpiceDouble        * result_f;
 
+   ConstSpiceChar     * names [7];
+   SpiceDouble          dvals [3];
+
    int                 sizearray[2];
 
    SpiceInt            cnfine_size;
@@ -7557,19 +8507,38 @@ void cspice_gfposc(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    result_cell.base = result;
    result_cell.data = &result[SPICE_CELL_CTRLSZ];
 
-   (void) gfposc_c ( target,
-                     frame,
-                     abcorr,
-                     obsrvr,
-                     crdsys,
-                     coord,
-                     relate,
-                     refval,
-                     adjust,
-                     step,
-                     nintvls,
-                     &cnfine_cell,
-                     &result_cell  );
+   names[0] = target;
+   names[1] = frame;
+   names[2] = abcorr;
+   names[3] = obsrvr;
+   names[4] = crdsys;
+   names[5] = coord;
+   names[6] = relate;
+
+   dvals[0] = refval;
+   dvals[1] = adjust;
+   dvals[2] = step;
+
+   /*
+   With the worker pool started, split the search across the workers.
+   */
+   if ( !zzmice_pool_gf( POOL_GFPOSC, names, dvals, nintvls,
+                         &cnfine_cell, &result_cell ) )
+      {
+      (void) gfposc_c ( target,
+                        frame,
+                        abcorr,
+                        obsrvr,
+                        crdsys,
+                        coord,
+                        relate,
+                        refval,
+                        adjust,
+                        step,
+                        nintvls,
+                        &cnfine_cell,
+                        &result_cell  );
+      }
 
 
    /*
@@ -7628,6 +8597,9 @@ void cspice_gfrfov(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    SpiceDouble        * result;
    SpiceDouble        * result_f;
 
+   ConstSpiceChar     * names [4];
+   SpiceDouble          dvals [4];
+
    int                 sizearray[2];
 
    SpiceInt            cnfine_size;
@@ -7720,14 +8692,31 @@ void cspice_gfrfov(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    result_cell.base = result;
    result_cell.data = &result[SPICE_CELL_CTRLSZ];
 
-   (void) gfrfov_c ( inst,
-                     raydir,
-                     rframe,
-                     abcorr,
-                     obsrvr,
-                     step,
-                     &cnfine_cell,
-                     &result_cell  );
+   names[0] = inst;
+   names[1] = rframe;
+   names[2] = abcorr;
+   names[3] = obsrvr;
+
+   dvals[0] = raydir[0];
+   dvals[1] = raydir[1];
+   dvals[2] = raydir[2];
+   dvals[3] = step;
+
+   /*
+   With the worker pool started, split the search across the workers.
+   */
+   if ( !zzmice_pool_gf( POOL_GFRFOV, names, dvals, 0,
+                         &cnfine_cell, &result_cell ) )
+      {
+      (void) gfrfov_c ( inst,
+                        raydir,
+                        rframe,
+                        abcorr,
+                        obsrvr,
+                        step,
+                        &cnfine_cell,
+                        &result_cell  );
+      }
 
    /*
    Check for a failure signal. Free the memory assigned to 'result'
@@ -7790,6 +8779,9 @@ void cspice_gfrr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    SpiceDouble        * result;
    SpiceDouble        * result_f;
 
+   ConstSpiceChar     * names [4];
+   SpiceDouble          dvals [3];
+
    int                 sizearray[2];
 
    SpiceInt            cnfine_size;
@@ -7883,16 +8875,32 @@ void cspice_gfrr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    result_cell.base = result;
    result_cell.data = &result[SPICE_CELL_CTRLSZ];
 
-   (void) gfrr_c ( target,
-                   abcorr,
-                   obsrvr,
-                   relate,
-                   refval,
-                   adjust,
-                   step,
-                   nintvls,
-                   &cnfine_cell,
-                   &result_cell );
+   names[0] = target;
+   names[1] = abcorr;
+   names[2] = obsrvr;
+   names[3] = relate;
+
+   dvals[0] = refval;
+   dvals[1] = adjust;
+   dvals[2] = step;
+
+   /*
+   With the worker pool started, split the search across the workers.
+   */
+   if ( !zzmice_pool_gf( POOL_GFRR, names, dvals, nintvls,
+                         &cnfine_cell, &result_cell ) )
+      {
+      (void) gfrr_c ( target,
+                      abcorr,
+                      obsrvr,
+                      relate,
+                      refval,
+                      adjust,
+                      step,
+                      nintvls,
+                      &cnfine_cell,
+                      &result_cell );
+      }
 
    /*
    Check for a failure signal. Free the memory assigned to 'result'
@@ -7965,6 +8973,9 @@ void cspice_gfsep(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    SpiceDouble        * result;
    SpiceDouble        * result_f;
 
+   ConstSpiceChar     * names [9];
+   SpiceDouble          dvals [3];
+
    int                 sizearray[2];
 
    SpiceInt            cnfine_size;
@@ -8068,21 +9079,42 @@ void cspice_gfsep(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    result_cell.base = result;
    result_cell.data = &result[SPICE_CELL_CTRLSZ];
 
-   (void) gfsep_c (  targ1,
-                     shape1,
-                     frame1,
-                     targ2,
-                     shape2,
-                     frame2,
-                     abcorr,
-                     obsrvr,
-                     relate,
-                     refval,
-                     adjust,
-                     step,
-                     nintvls,
-                     &cnfine_cell,
-                     &result_cell );
+   names[0] = targ1;
+   names[1] = shape1;
+   names[2] = frame1;
+   names[3] = targ2;
+   names[4] = shape2;
+   names[5] = frame2;
+   names[6] = abcorr;
+   names[7] = obsrvr;
+   names[8] = relate;
+
+   dvals[0] = refval;
+   dvals[1] = adjust;
+   dvals[2] = step;
+
+   /*
+   With the worker pool started, split the search across the workers.
+   */
+   if ( !zzmice_pool_gf( POOL_GFSEP, names, dvals, nintvls,
+                         &cnfine_cell, &result_cell ) )
+      {
+      (void) gfsep_c (  targ1,
+                        shape1,
+                        frame1,
+                        targ2,
+                        shape2,
+                        frame2,
+                        abcorr,
+                        obsrvr,
+                        relate,
+                        refval,
+                        adjust,
+                        step,
+                        nintvls,
+                        &cnfine_cell,
+                        &result_cell );
+      }
 
    /*
    Check for a failure signal. Free the memory assigned to 'result'
@@ -8333,6 +9365,11 @@ void cspice_gfstol(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
    (void) gfstol_c ( value );
    CHECK_CALL_FAILURE(SCALAR);
+
+   /*
+   The workers hold the tolerance they started with.
+   */
+   zzmice_pool_reset();
    }
 
 
@@ -8374,6 +9411,9 @@ void cspice_gfsubc(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    SpiceDouble        * result;
    SpiceDouble        * result_f;
 
+   ConstSpiceChar     * names [8];
+   SpiceDouble          dvals [3];
+
    int                 sizearray[2];
 
    SpiceInt            cnfine_size;
@@ -8475,20 +9515,40 @@ void cspice_gfsubc(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    result_cell.base = result;
    result_cell.data = &result[SPICE_CELL_CTRLSZ];
 
-   (void) gfsubc_c ( target,
-                     fixref,
-                     method,
-                     abcorr,
-                     obsrvr,
-                     crdsys,
-                     coord,
-                     relate,
-                     refval,
-                     adjust,
-                     step,
-                     nintvls,
-                     &cnfine_cell,
-                     &result_cell  );
+   names[0] = target;
+   names[1] = fixref;
+   names[2] = method;
+   names[3] = abcorr;
+   names[4] = obsrvr;
+   names[5] = crdsys;
+   names[6] = coord;
+   names[7] = relate;
+
+   dvals[0] = refval;
+   dvals[1] = adjust;
+   dvals[2] = step;
+
+   /*
+   With the worker pool started, split the search across the workers.
+   */
+   if ( !zzmice_pool_gf( POOL_GFSUBC, names, dvals, nintvls,
+                         &cnfine_cell, &result_cell ) )
+      {
+      (void) gfsubc_c ( target,
+                        fixref,
+                        method,
+                        abcorr,
+                        obsrvr,
+                        crdsys,
+                        coord,
+                        relate,
+                        refval,
+                        adjust,
+                        step,
+                        nintvls,
+                        &cnfine_cell,
+                        &result_cell  );
+      }
 
 
    /*
@@ -8549,6 +9609,9 @@ void cspice_gftfov(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    SpiceDouble        * result;
    SpiceDouble        * result_f;
 
+   ConstSpiceChar     * names [6];
+   SpiceDouble          dvals [1];
+
    int                 sizearray[2];
 
    SpiceInt            cnfine_size;
@@ -8641,15 +9704,31 @@ void cspice_gftfov(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    result_cell.base = result;
    result_cell.data = &result[SPICE_CELL_CTRLSZ];
 
-   (void) gftfov_c ( inst,
-                     target,
-                     tshape,
-                     tframe,
-                     abcorr,
-                     obsrvr,
-                     step,
-                     &cnfine_cell,
-                     &result_cell  );
+   names[0] = inst;
+   names[1] = target;
+   names[2] = tshape;
+   names[3] = tframe;
+   names[4] = abcorr;
+   names[5] = obsrvr;
+
+   dvals[0] = step;
+
+   /*
+   With the worker pool started, split the search across the workers.
+   */
+   if ( !zzmice_pool_gf( POOL_GFTFOV, names, dvals, 0,
+                         &cnfine_cell, &result_cell ) )
+      {
+      (void) gftfov_c ( inst,
+                        target,
+                        tshape,
+                        tframe,
+                        abcorr,
+                        obsrvr,
+                        step,
+                        &cnfine_cell,
+                        &result_cell  );
+      }
 
    /*
    Check for a failure signal. Free the memory assigned to 'result'
@@ -9395,11 +10474,15 @@ void cspice_kclear(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
    check_arg_num( nrhs, nlhs, 0, 0 );
 
+   zzmice_clear_caches();
+
    /*
    Not much to do, make the call.
    */
    kclear_c();
 
+   zzmice_pool_kernel();
+
    }
 
 
@@ -9933,6 +11016,7 @@ void cspice_lmpool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
       }
 
    lmpool_c(  *cvals, cvals_len, cvals_size);
+   zzmice_pool_reset();
    CHECK_CALL_FAILURE_MEM( 1, cvals );
 
    /* Clean up temporary variables */
@@ -10870,6 +11954,7 @@ void cspice_pcpool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
       }
 
    pcpool_c(name,cvals_size,cvals_len,*cvals);
+   zzmice_pool_reset();
    CHECK_CALL_FAILURE_MEM( 1, cvals );
 
    /* Clean up temporary variables */
@@ -10914,6 +11999,7 @@ void cspice_pdpool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    dvals_size = mxGetNumberOfElements( prhs[2] );
 
    pdpool_c( name, dvals_size, dvals );
+   zzmice_pool_reset();
    CHECK_CALL_FAILURE(SCALAR);
 
    }
@@ -11108,6 +12194,7 @@ void cspice_pipool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    ivals_size = mxGetNumberOfElements( prhs[2] );
 
    pipool_c( name, ivals_size, ivals );
+   zzmice_pool_reset();
    CHECK_CALL_FAILURE(SCALAR);
 
    }
@@ -11401,6 +12488,62 @@ void cspice_psv2pl(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 
+/*
+   Worker pool for vectorized calls, see zzmice_pool.c.
+
+   mice('pool_s', 'start', n)   use n worker processes, 0 to stop
+   mice('pool_s', 'stop')       stop the workers
+   n = mice('pool_s', 'size')   number of workers, 0 if stopped
+
+   With the pool started, cspice_spkezr, cspice_spkpos, cspice_pxform
+   and cspice_sxform split large epoch arrays across the workers, the
+   cspice_gf* searches their confinement windows.
+*/
+void mice_pool(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceChar            cmd[DEFAULT_STR_LENGTH+1];
+   SpiceInt             n;
+
+   if ( nrhs < 2 || nrhs > 3 || nlhs > 1 || !mxIsChar(prhs[1]) )
+      {
+      mexErrMsgTxt( "MICE(BADARG): Usage mice('pool_s', 'start', n), "
+                    "mice('pool_s', 'stop') or n = mice('pool_s', 'size')." );
+      }
+
+   mxGetString(prhs[1], cmd, DEFAULT_STR_LENGTH);
+
+   if ( strcmp( cmd, "start" ) == 0 && nrhs == 3 )
+      {
+
+      if ( !mxIsNumeric(prhs[2]) || mxGetNumberOfElements(prhs[2]) != 1 )
+         {
+         mexErrMsgTxt( "MICE(BADARG): Input argument (`n') must be "
+                       "a numeric scalar." );
+         }
+
+      n = (SpiceInt)mxGetScalar(prhs[2]);
+      zzmice_pool_start( n );
+      }
+   else if ( strcmp( cmd, "stop" ) == 0 && nrhs == 2 )
+      {
+      zzmice_pool_stop();
+      }
+   else if ( strcmp( cmd, "size" ) != 0 || nrhs != 2 )
+      {
+      mexErrMsgTxt( "MICE(BADARG): Unknown pool command." );
+      }
+
+   if ( nlhs == 1 )
+      {
+      plhs[0] = zzmice_CreateIntScalar( zzmice_pool_size() );
+      }
+
+   }
+
+
+
+
 /*
    void              pxform_c ( ConstSpiceChar    * from,
                                 ConstSpiceChar    * to,
@@ -11418,6 +12561,8 @@ void cspice_pxform(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    SpiceDouble        * rotate;
    SpiceDouble          xr[3][3];
 
+   ConstSpiceChar     * names[2];
+
    SpiceInt             i;
 
    struct extra_dims  * extra;
@@ -11441,9 +12586,18 @@ void cspice_pxform(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    et         = *(vec_et);
    rotate     =  (vec_rotate);
 
+   names[0] = from;
+   names[1] = to;
+
    if (extra->count>1)
       {
 
+      if ( zzmice_pool_eval( POOL_PXFORM, names, extra->count, vec_et,
+                             vec_rotate, NULL ) )
+         {
+         return;
+         }
+
       for (i=0;i<extra->count;i++)
          {
          et     = *(vec_et     + i*extra->offset[2]);
@@ -11471,94 +12625,377 @@ void cspice_pxform(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 /*
-   void              pxfrm2_c ( ConstSpiceChar    * from,
-                                ConstSpiceChar    * to,
-                                SpiceDouble         etfrom,
-                                SpiceDouble         etto,
-                                SpiceDouble         rotate[3][3] );
- */
-void cspice_pxfrm2(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
-   {
+   Rotated vectors without the rotation matrices.
+
+   mice('pxform_v', from, to, et, vec, tol) returns the 3xN array of
+   the vectors vec(:,i) rotated from frame 'from' to frame 'to' at
+   et(i), i.e. what cspice_pxform(from, to, et(i)) * vec(:,i) gives,
+   without a 3x3xN array.
+
+   pxform_c is evaluated at a cadence adapted to the rotation rate: for
+   an interval of epochs the rotations at the ends are interpolated by
+   quaternion SLERP, which is accepted if at the interval midpoint it
+   differs from the pxform_c rotation by at most 'tol' radians. The
+   interval doubles while the difference stays well below 'tol' and is
+   halved when it exceeds it. tol = 0 evaluates pxform_c at every epoch.
+   Epochs need not be sorted, a decrease restarts the interpolation.
+*/
 
-   SpiceDouble        * vec_etfrom;
-   SpiceDouble        * vec_etto;
-   SpiceDouble        * vec_rotate;
-   SpiceChar            from  [DEFAULT_STR_LENGTH+1];
-   SpiceChar            to    [DEFAULT_STR_LENGTH+1];
-   SpiceDouble          etfrom;
-   SpiceDouble          etto;
-   SpiceDouble        * rotate;
-   SpiceDouble          xr[3][3];
+#define  PXV_H0          60.0
+#define  PXV_HMAX        86400.0
 
-   SpiceInt             i;
 
-   struct extra_dims  * extra;
-   struct argcheck ArgCheck[] =
-   /*                          dimension, shape, vectorized */
-      {
-      { "from",    MiceChar,   0, {0},    0},
-      { "to",      MiceChar,   0, {0},    0},
-      { "etfrom",  MiceDouble, 0, {0},    1},
-      { "etto",    MiceDouble, 0, {0},    1},
-      { "rotate",  MiceDouble, 2, {3, 3}, 1},
-      };
+/*
+Rotation angle between the unit quaternions 'a' and 'b'.
+*/
+static SpiceDouble pxv_angle( ConstSpiceDouble * a, ConstSpiceDouble * b )
+   {
+   SpiceDouble          sign;
+   SpiceDouble          d = 0.0;
+   SpiceInt             j;
 
-   /* check_arg_num checks to see if the number of input and output
-      arguments specified by the user are correct. */
+   sign = ( vdotg_c( a, b, 4 ) < 0.0 ) ? -1.0 : 1.0;
 
-   check_arg_num( nrhs, nlhs, 4, 1 );
+   for ( j=0; j<4; j++ )
+      {
+      d += (a[j] - sign*b[j]) * (a[j] - sign*b[j]);
+      }
 
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+   /*
+   |a - b| = 2 sin(angle/4), precise for small angles unlike acos.
+   */
+   return 4.0 * asin( MinVal( 1.0, 0.5*sqrt(d) ) );
+   }
 
-   /* extra-> offset corresponds to argcheck table from[0]*/
 
-   mxGetString(prhs[1], from, DEFAULT_STR_LENGTH);
-   mxGetString(prhs[2], to,   DEFAULT_STR_LENGTH);
+/*
+Spherical linear interpolation between the unit quaternions 'q0' and
+'q1', u in [0,1].
+*/
+static void pxv_slerp( ConstSpiceDouble * q0,
+                       ConstSpiceDouble * q1,
+                       SpiceDouble        u,
+                       SpiceDouble      * q )
+   {
+   SpiceDouble          c;
+   SpiceDouble          s = 0.0;
+   SpiceDouble          sign = 1.0;
+   SpiceDouble          theta;
+   SpiceDouble          w0;
+   SpiceDouble          w1;
+   SpiceDouble          n;
+   SpiceInt             j;
 
-    /* From function inputs.  Function is [0]*/
-   vec_etfrom   = A_DBL_ARGV(3);
-   vec_etto     = A_DBL_ARGV(4);
-   vec_rotate   = A_DBL_RET_ARGV(0);
-   etfrom       = *(vec_etfrom);
-   etto         = *(vec_etto);
-   rotate       =  (vec_rotate);
+   c = vdotg_c( q0, q1, 4 );
 
-   if (extra->count>1)
+   if ( c < 0.0 )
       {
+      c    = -c;
+      sign = -1.0;
+      }
 
-      for (i=0;i<extra->count;i++)
-         {
-         etfrom = *(vec_etfrom + i*extra->offset[2]);
-         etto   = *(vec_etto   + i*extra->offset[3]);
-         rotate =  (vec_rotate + i*extra->offset[4]);
-
-         pxfrm2_c(from, to, etfrom, etto, (SpiceDouble(*)[3])xr);
-         CHECK_CALL_FAILURE(i);
+   /*
+   sin(theta) from the component of q1 normal to q0, which unlike
+   acos(c) keeps its precision for small angles.
+   */
+   for ( j=0; j<4; j++ )
+      {
+      s += (sign*q1[j] - c*q0[j]) * (sign*q1[j] - c*q0[j]);
+      }
 
-         xpose_c( xr, (SpiceDouble(*)[3])rotate );
-         }
+   s = sqrt( s );
 
+   if ( s < 1.0e-12 )
+      {
+      /*
+      Identical to rounding, linear interpolation is exact.
+      */
+      w0 = 1.0 - u;
+      w1 = u;
       }
    else
       {
+      theta = atan2( s, c );
+      w0    = sin( (1.0 - u)*theta ) / s;
+      w1    = sin( u*theta )         / s;
+      }
 
-      pxfrm2_c(from, to, etfrom, etto, (SpiceDouble(*)[3])xr);
-      CHECK_CALL_FAILURE(SCALAR);
-
-      xpose_c( xr, (SpiceDouble(*)[3])rotate );
+   for ( j=0; j<4; j++ )
+      {
+      q[j] = w0*q0[j] + sign*w1*q1[j];
       }
 
+   n = sqrt( vdotg_c( q, q, 4 ) );
+
+   for ( j=0; j<4; j++ )
+      {
+      q[j] /= n;
+      }
    }
 
 
+void mice_pxform_v(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
 
+   SpiceDouble        * vec_et;
+   SpiceDouble        * vec_in;
+   SpiceDouble        * vec_out;
+   SpiceChar            from  [DEFAULT_STR_LENGTH+1];
+   SpiceChar            to    [DEFAULT_STR_LENGTH+1];
+   SpiceDouble          tol;
+   SpiceDouble          h = PXV_H0;
+   SpiceDouble          m [3][3];
+   SpiceDouble          q0[4];
+   SpiceDouble          q1[4];
+   SpiceDouble          qm[4];
+   SpiceDouble          qi[4];
+   SpiceDouble          t0;
+   SpiceDouble          t1;
+   SpiceDouble          tm;
+   SpiceDouble          err = 0.0;
 
-/*
-   void        q2m_c( ConstSpiceDouble  q[4],
-                      SpiceDouble       r[3][3] )
-*/
-void cspice_q2m(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
-   {
+   SpiceInt             n;
+   SpiceInt             i;
+   SpiceInt             j;
+   SpiceInt             k;
+
+   check_arg_num( nrhs, nlhs, 5, 1 );
+
+   if ( !mxIsChar(prhs[1]) || !mxIsChar(prhs[2]) )
+      {
+      mexErrMsgTxt( "MICE(BADARG): Input arguments (`from', `to') "
+                    "must be alphabetic." );
+      }
+
+   if ( !mxIsDouble(prhs[3]) || mxIsComplex(prhs[3]) ||
+        !mxIsDouble(prhs[4]) || mxIsComplex(prhs[4]) )
+      {
+      mexErrMsgTxt( "MICE(BADVAL): Input arguments (`et', `vec') "
+                    "must have type double." );
+      }
+
+   n = (SpiceInt)mxGetNumberOfElements(prhs[3]);
+
+   if ( mxGetM(prhs[4]) != 3 || (SpiceInt)mxGetN(prhs[4]) != n )
+      {
+      mexErrMsgTxt( "MICE(BADARG): Input argument (`vec') must be a 3xN "
+                    "array, N the number of elements of `et'." );
+      }
+
+   if ( !mxIsDouble(prhs[5]) || mxGetNumberOfElements(prhs[5]) != 1 ||
+        !(*mxGetPr(prhs[5]) >= 0.0) )
+      {
+      mexErrMsgTxt( "MICE(BADARG): Input argument (`tol') must be a "
+                    "non-negative scalar." );
+      }
+
+   mxGetString(prhs[1], from, DEFAULT_STR_LENGTH);
+   mxGetString(prhs[2], to,   DEFAULT_STR_LENGTH);
+
+   vec_et  = A_DBL_ARGV(3);
+   vec_in  = A_DBL_ARGV(4);
+   tol     = *A_DBL_ARGV(5);
+
+   plhs[0] = mxCreateDoubleMatrix( 3, n, mxREAL );
+   vec_out = A_DBL_RET_ARGV(0);
+
+   if ( n == 0 )
+      {
+      return;
+      }
+
+   /*
+   'i' is the first epoch not yet rotated, q0 the rotation at it.
+   */
+   i  = 0;
+   t0 = vec_et[0];
+   pxform_c( from, to, t0, m );
+   CHECK_CALL_FAILURE(0);
+   m2q_c( m, q0 );
+
+   while ( i < n )
+      {
+
+      mxv_c( m, vec_in + 3*i, vec_out + 3*i );
+
+      if ( i + 1 == n )
+         {
+         break;
+         }
+
+      if ( tol > 0.0 && vec_et[i+1] >= t0 )
+         {
+
+         for (;;)
+            {
+
+            /*
+            The last epoch within h of a non-decreasing run.
+            */
+            for ( j=i+1; j+1<n && vec_et[j+1] >= vec_et[j] &&
+                         vec_et[j+1] <= t0 + h; j++ )
+               {
+               }
+
+            if ( j == i + 1 )
+               {
+               break;
+               }
+
+            t1 = vec_et[j];
+            tm = 0.5*(t0 + t1);
+
+            pxform_c( from, to, t1, m );
+            CHECK_CALL_FAILURE(j);
+            m2q_c( m, q1 );
+
+            pxform_c( from, to, tm, m );
+            CHECK_CALL_FAILURE(j);
+            m2q_c( m, qm );
+
+            pxv_slerp( q0, q1, 0.5, qi );
+            err = pxv_angle( qi, qm );
+
+            if ( err <= tol )
+               {
+
+               for ( k=i+1; k<j; k++ )
+                  {
+                  pxv_slerp( q0, q1, (t1 > t0) ? (vec_et[k] - t0)/(t1 - t0)
+                                               : 0.0, qi );
+                  q2m_c( qi, m );
+                  mxv_c( m, vec_in + 3*k, vec_out + 3*k );
+                  }
+
+               /*
+               The error of the interpolation grows with h^2 or faster.
+               */
+               if ( err < tol/8.0 )
+                  {
+                  h = MinVal( 2.0*h, PXV_HMAX );
+                  }
+
+               break;
+               }
+
+            h = 0.5*(t1 - t0);
+            }
+
+         if ( j > i + 1 )
+            {
+            /*
+            Epochs i+1..j-1 are done, q1 is the rotation at j.
+            */
+            i  = j;
+            t0 = t1;
+            q2m_c( q1, m );
+            MOVED( q1, 4, q0 );
+            continue;
+            }
+
+         }
+
+      i++;
+      t0 = vec_et[i];
+      pxform_c( from, to, t0, m );
+      CHECK_CALL_FAILURE(i);
+      m2q_c( m, q0 );
+      }
+
+   }
+
+
+
+
+/*
+   void              pxfrm2_c ( ConstSpiceChar    * from,
+                                ConstSpiceChar    * to,
+                                SpiceDouble         etfrom,
+                                SpiceDouble         etto,
+                                SpiceDouble         rotate[3][3] );
+ */
+void cspice_pxfrm2(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceDouble        * vec_etfrom;
+   SpiceDouble        * vec_etto;
+   SpiceDouble        * vec_rotate;
+   SpiceChar            from  [DEFAULT_STR_LENGTH+1];
+   SpiceChar            to    [DEFAULT_STR_LENGTH+1];
+   SpiceDouble          etfrom;
+   SpiceDouble          etto;
+   SpiceDouble        * rotate;
+   SpiceDouble          xr[3][3];
+
+   SpiceInt             i;
+
+   struct extra_dims  * extra;
+   struct argcheck ArgCheck[] =
+   /*                          dimension, shape, vectorized */
+      {
+      { "from",    MiceChar,   0, {0},    0},
+      { "to",      MiceChar,   0, {0},    0},
+      { "etfrom",  MiceDouble, 0, {0},    1},
+      { "etto",    MiceDouble, 0, {0},    1},
+      { "rotate",  MiceDouble, 2, {3, 3}, 1},
+      };
+
+   /* check_arg_num checks to see if the number of input and output
+      arguments specified by the user are correct. */
+
+   check_arg_num( nrhs, nlhs, 4, 1 );
+
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+
+   /* extra-> offset corresponds to argcheck table from[0]*/
+
+   mxGetString(prhs[1], from, DEFAULT_STR_LENGTH);
+   mxGetString(prhs[2], to,   DEFAULT_STR_LENGTH);
+
+    /* From function inputs.  Function is [0]*/
+   vec_etfrom   = A_DBL_ARGV(3);
+   vec_etto     = A_DBL_ARGV(4);
+   vec_rotate   = A_DBL_RET_ARGV(0);
+   etfrom       = *(vec_etfrom);
+   etto         = *(vec_etto);
+   rotate       =  (vec_rotate);
+
+   if (extra->count>1)
+      {
+
+      for (i=0;i<extra->count;i++)
+         {
+         etfrom = *(vec_etfrom + i*extra->offset[2]);
+         etto   = *(vec_etto   + i*extra->offset[3]);
+         rotate =  (vec_rotate + i*extra->offset[4]);
+
+         pxfrm2_c(from, to, etfrom, etto, (SpiceDouble(*)[3])xr);
+         CHECK_CALL_FAILURE(i);
+
+         xpose_c( xr, (SpiceDouble(*)[3])rotate );
+         }
+
+      }
+   else
+      {
+
+      pxfrm2_c(from, to, etfrom, etto, (SpiceDouble(*)[3])xr);
+      CHECK_CALL_FAILURE(SCALAR);
+
+      xpose_c( xr, (SpiceDouble(*)[3])rotate );
+      }
+
+   }
+
+
+
+
+/*
+   void        q2m_c( ConstSpiceDouble  q[4],
+                      SpiceDouble       r[3][3] )
+*/
+void cspice_q2m(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
 
    SpiceDouble        * vec_q;
    SpiceDouble        * vec_r;
@@ -12963,6 +14400,117 @@ void cspice_sctiks(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 
+/*
+   Kernel pool snapshot, see zzmice_snap.c.
+
+   mice('snapshot_s', 'save', file)           save the loaded kernels
+   found = mice('snapshot_s', 'load', file)   restore them if no kernel
+                                              is loaded and none changed
+                                              since the save
+   found = mice('snapshot_s', 'load', file, kernels)
+                                              the same, if the top-level
+                                              kernels of the snapshot are
+                                              the rows of 'kernels'
+*/
+void mice_snapshot(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceChar            cmd [DEFAULT_STR_LENGTH+1];
+   SpiceChar            file[DEFAULT_STR_LENGTH+1];
+   SpiceChar         ** kernels = NULL;
+   mxChar             * mx_kernels;
+   SpiceInt             nkern = 0;
+   SpiceInt             len;
+   SpiceInt             i;
+   SpiceInt             j;
+   SpiceInt             k;
+   SpiceBoolean         found;
+
+   if ( nrhs < 3 || nrhs > 4 || nlhs > 1 ||
+        !mxIsChar(prhs[1]) || !mxIsChar(prhs[2]) ||
+        ( nrhs == 4 && !mxIsChar(prhs[3]) ) )
+      {
+      mexErrMsgTxt( "MICE(BADARG): Usage mice('snapshot_s', 'save', file) "
+                    "or found = mice('snapshot_s', 'load', file, "
+                    "[kernels])." );
+      }
+
+   mxGetString(prhs[1], cmd,  DEFAULT_STR_LENGTH);
+   mxGetString(prhs[2], file, DEFAULT_STR_LENGTH);
+
+   if ( nrhs == 4 )
+      {
+
+      /*
+      The rows of the kernel names, without the leading and trailing
+      blanks furnsh_c drops.
+      */
+      nkern      = (SpiceInt)mxGetM(prhs[3]);
+      len        = (SpiceInt)mxGetN(prhs[3]);
+      mx_kernels = (mxChar *)mxGetChars(prhs[3]);
+      kernels    = (SpiceChar**)mxMalloc( (nkern+1) * sizeof(SpiceChar*) );
+
+      for ( i=0; i<nkern; i++ )
+         {
+         kernels[i] = (SpiceChar*)mxMalloc( len + 1 );
+
+         for ( j=0; j<len && mx_kernels[i + nkern*j] == ' '; j++ )
+            {
+            }
+
+         for ( k=0; j<len; j++ )
+            {
+            kernels[i][k++] = (char)mx_kernels[i + nkern*j];
+            }
+
+         while ( k > 0 && kernels[i][k-1] == ' ' )
+            {
+            k--;
+            }
+
+         kernels[i][k] = '\0';
+         }
+
+      }
+
+   if ( strcmp( cmd, "save" ) == 0 )
+      {
+      found = zzmice_snap_save( file );
+      CHECK_CALL_FAILURE(SCALAR);
+
+      if ( !found )
+         {
+         mexErrMsgTxt( "MICE(BADVAL): Could not write the snapshot "
+                       "file, or read a loaded kernel." );
+         }
+      }
+   else if ( strcmp( cmd, "load" ) == 0 )
+      {
+      found = zzmice_snap_load( file, nkern, (ConstSpiceChar**)kernels );
+      CHECK_CALL_FAILURE(SCALAR);
+      }
+   else
+      {
+      mexErrMsgTxt( "MICE(BADARG): Unknown snapshot command." );
+      }
+
+   for ( i=0; i<nkern; i++ )
+      {
+      mxFree( kernels[i] );
+      }
+
+   mxFree( kernels );
+
+   if ( nlhs == 1 )
+      {
+      plhs[0] = mxCreateLogicalScalar( found ? true : false );
+      }
+
+   }
+
+
+
+
 /*
    SpiceDouble spd_c( void )
 */
@@ -13839,349 +15387,1098 @@ void mice_spkezr(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    SpiceDouble          starg[6];
    SpiceDouble          lt;
 
-   SpiceInt             i;
+   SpiceInt             i;
+
+   struct extra_dims  * extra;
+   struct argcheck ArgCheck[] =
+      {
+      { "targ",   MiceChar,   0, {0}, 0},
+      { "et",     MiceDouble, 0, {0}, 1},
+      { "ref",    MiceChar,   0, {0}, 0},
+      { "abcorr", MiceChar,   0, {0}, 0},
+      { "obs",    MiceChar,   0, {0}, 0},
+      { "state",  MiceState,  0, {0}, 1},
+      };
+
+   check_arg_num( nrhs, nlhs, 5, 1 );
+
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+
+   mxGetString(prhs[1], targ, DEFAULT_STR_LENGTH);
+
+   vec_et = A_DBL_ARGV(2);
+   et     = *(vec_et);
+
+   mxGetString(prhs[3], ref,    DEFAULT_STR_LENGTH);
+   mxGetString(prhs[4], abcorr, DEFAULT_STR_LENGTH);
+   mxGetString(prhs[5], obs,    DEFAULT_STR_LENGTH);
+
+   /*
+   Check for vectorized arguments.
+   */
+   if (extra->count>1)
+      {
+
+      /*
+      Something input as a N-vector, extract the input values
+      (vectorized or not) then execute the routine for each
+      set of inputs.
+      */
+      for (i=0;i<extra->count;i++)
+         {
+
+         et = *(vec_et + i*extra->offset[1]);
+
+         spkezr_c(targ, et, ref, abcorr, obs, starg, &lt);
+         CHECK_CALL_FAILURE(i);
+
+         /*
+         Copy the state and light time values into the ith structure
+         element.
+         */
+         memcpy( mxGetPr( mxGetField(plhs[0],i,"state") ),
+                 starg,
+                 6*sizeof(SpiceDouble));
+
+         mxDestroyArray( mxGetField( plhs[0], i, "lt" ) );
+         mxSetField( plhs[0], i, "lt", mxCreateDoubleScalar(lt) );
+
+         }
+
+      }
+   else
+      {
+
+      spkezr_c(targ, et, ref, abcorr, obs, starg, &lt);
+      CHECK_CALL_FAILURE(SCALAR);
+
+      /*
+      Copy the state vector and the lighttime value into the return structure.
+      */
+      memcpy( mxGetPr( mxGetField(plhs[0],0,"state") ),
+              starg,
+              6*sizeof(SpiceDouble));
+
+      mxDestroyArray( mxGetField( plhs[0], 0, "lt" ) );
+      mxSetField( plhs[0], 0, "lt", mxCreateDoubleScalar(lt) );
+
+      }
+
+   }
+
+
+
+
+/*
+   void              spkobj_c ( ConstSpiceChar    * spk,
+                                SpiceCell         * ids );
+
+*/
+void cspice_spkobj(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+   SpiceChar           spk[DEFAULT_STR_LENGTH+1];
+   mxChar            * mx_spk;
+
+   SpiceInt            i;
+   SpiceInt            j;
+   int                 sizearray[2];
+
+   SpiceInt            card = 0;
+   SpiceInt            size;
+   SpiceInt          * ids_f;
+   SpiceInt          * ids;
+
+   struct extra_dims * extra;
+   struct argcheck ArgCheck[] =
+      {
+      { "spk",  MiceChar,   0, {0}, 1},
+      { "size", MiceInt,    0, {0}, 0},
+      { "ids",  MiceIgnore, 0, {0}, 0},
+      };
+
+   check_arg_num( nrhs, nlhs, 2, 1 );
+
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+
+   size = S_INT_ARGV(2);
+   ids  = (SpiceInt*)mxMalloc( (size + SPICE_CELL_CTRLSZ)*sizeof(SpiceInt)  );
+
+   ssizei_( ( integer * ) &size, ( integer * ) ids   );
+   scardi_( ( integer * ) &card, ( integer * ) ids   );
+
+   if (extra->count>1)
+      {
+
+      mx_spk = (mxChar *)mxGetChars(prhs[1]);
+
+      for ( i=0; i<extra->count; i++)
+         {
+
+         /*
+         Extract the string data, character by character, into
+         CSPICE strings. The mx_str array stores the data in a column
+         major format, we need to extract the data by rows.
+         */
+         for ( j=0; j<extra->offset[0]; j++)
+            {
+            spk[j] = (char)mx_spk[i + (extra->count*j)];
+            }
+
+         spk[extra->offset[0]] = '\0';
+
+         spkobj_(  ( char       * ) spk,
+                   ( integer    * ) (ids),
+                   ( ftnlen       ) strlen(spk)   );
+
+         /*
+         Check for a failure signal. Free the memory assigned to 'ids'
+         before signaling a Matlab error.
+         */
+         if ( failed_c())
+            {
+            mxFree( ids );
+
+            /*
+            The mice_fail call creates the error string then returns control
+            to the MATLAB interpreter.
+            */
+            mice_fail(i);
+            }
+
+         }
+
+      }
+   else
+      {
+      mxGetString(prhs[1], spk, DEFAULT_STR_LENGTH);
+
+      spkobj_(  ( char       * ) spk,
+                ( integer    * ) (ids),
+                ( ftnlen       ) strlen(spk)   );
+
+      /*
+      Check for a failure signal. Free the memory assigned to 'ids'
+      before signaling a Matlab error.
+      */
+      if ( failed_c())
+         {
+         mxFree( ids );
+
+         /*
+         The mice_fail call creates the error string then returns control
+         to the MATLAB interpreter.
+         */
+         mice_fail(SCALAR);
+         }
+
+      }
+
+   /*
+   Array element 6, index 5, contains the cell cardinality. Create an output
+   array CARDx1.
+   */
+   sizearray[0] = ids[5];
+   sizearray[1] = 1;
+
+   plhs[0] = mxCreateNumericArray( 2, sizearray, mxINT32_CLASS, mxREAL);
+   ids_f   = A_INT_RET_ARGV(0);
+
+   MOVEI( ids + SPICE_CELL_CTRLSZ, ids[5], ids_f );
+   mxFree( ids );
+   }
+
+
+
+
+/*
+   void              spkopn_c ( ConstSpiceChar    * name,
+                                ConstSpiceChar    * ifname,
+                                SpiceInt            ncomch,
+                                SpiceInt          * handle  );
+*/
+void cspice_spkopn(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceChar            fname [DEFAULT_STR_LENGTH+1];
+   SpiceChar            ifname[DEFAULT_STR_LENGTH+1];
+   SpiceInt             ncomch;
+   SpiceInt           * handle;
+
+   struct extra_dims  * extra;
+   struct argcheck ArgCheck[] =
+      {
+      { "fname",  MiceChar, 0, {0}, 0},
+      { "ifname", MiceChar, 0, {0}, 0},
+      { "ncomch", MiceInt,  0, {0}, 0},
+      { "handle", MiceInt,  0, {0}, 0},
+      };
+
+   check_arg_num( nrhs, nlhs, 3, 1);
+
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+
+   mxGetString(prhs[1], fname,  DEFAULT_STR_LENGTH);
+   mxGetString(prhs[2], ifname, DEFAULT_STR_LENGTH);
+
+   ncomch = S_INT_ARGV(3);
+   handle = A_INT_RET_ARGV(0);
+
+   spkopn_c( fname, ifname, ncomch, handle );
+   CHECK_CALL_FAILURE(SCALAR);
+
+   }
+
+
+
+
+/*
+   void              spkpos_c ( ConstSpiceChar    * targ,
+                                SpiceDouble         et,
+                                ConstSpiceChar    * ref,
+                                ConstSpiceChar    * abcorr,
+                                ConstSpiceChar    * obs,
+                                SpiceDouble         ptarg[3],
+                                SpiceDouble       * lt        );
+*/
+void mice_spkpos(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceDouble        * vec_et;
+   SpiceChar            targ  [DEFAULT_STR_LENGTH+1];
+   SpiceChar            ref   [DEFAULT_STR_LENGTH+1];
+   SpiceChar            abcorr[DEFAULT_STR_LENGTH+1];
+   SpiceChar            obs   [DEFAULT_STR_LENGTH+1];
+   SpiceDouble          et;
+   SpiceDouble          ptarg[3];
+   SpiceDouble          lt;
+
+   SpiceInt             i;
+
+   struct extra_dims  * extra;
+   struct argcheck ArgCheck[] =
+      {
+      { "targ",   MiceChar,   0, {0}, 0},
+      { "et",     MiceDouble, 0, {0}, 1},
+      { "ref",    MiceChar,   0, {0}, 0},
+      { "abcorr", MiceChar,   0, {0}, 0},
+      { "obs",    MiceChar,   0, {0}, 0},
+      { "ptarg",  MicePos,    0, {0}, 1},
+      };
+
+   check_arg_num( nrhs, nlhs, 5, 1 );
+
+   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+
+   mxGetString(prhs[1], targ, DEFAULT_STR_LENGTH);
+
+   vec_et = A_DBL_ARGV(2);
+   et     = *(vec_et);
+
+   mxGetString(prhs[3], ref,    DEFAULT_STR_LENGTH);
+   mxGetString(prhs[4], abcorr, DEFAULT_STR_LENGTH);
+   mxGetString(prhs[5], obs,    DEFAULT_STR_LENGTH);
+
+   /*
+   Check for vectorized arguments.
+   */
+   if (extra->count>1)
+      {
+
+      /*
+      Something input as a N-vector, extract the input values
+      (vectorized or not) then execute the routine for each
+      set of inputs.
+      */
+      for (i=0;i<extra->count;i++)
+         {
+
+         et    = *(vec_et + i*extra->offset[1]);
+
+         /*
+         Call the routine for this iteration.
+         */
+         spkpos_c(targ, et, ref, abcorr, obs, ptarg, &lt);
+         CHECK_CALL_FAILURE(i);
+
+         /*
+         Copy the position and light time values into the ith structure
+         element.
+         */
+         memcpy( mxGetPr( mxGetField(plhs[0],i,"pos") ),
+                 ptarg,
+                 3*sizeof(SpiceDouble));
+
+         mxDestroyArray( mxGetField( plhs[0], i, "lt" ) );
+         mxSetField( plhs[0], i, "lt", mxCreateDoubleScalar(lt) );
+
+         }
+
+      }
+   else
+      {
+
+      spkpos_c(targ, et, ref, abcorr, obs, ptarg, &lt);
+      CHECK_CALL_FAILURE(SCALAR);
+
+      /*
+      Copy the position and the light time value into the return structure.
+      */
+      memcpy( mxGetPr( mxGetField(plhs[0],0, "pos") ),
+              ptarg,
+              3*sizeof(SpiceDouble));
+
+      mxDestroyArray( mxGetField( plhs[0], 0, "lt" ) );
+      mxSetField( plhs[0], 0, "lt", mxCreateDoubleScalar(lt) );
+
+      }
+
+   }
+
+
+
+
+/*
+   Matrix returns for spkezr_c and spkpos_c.
+
+   mice('spkezr_m', targ, et, ref, abcorr, obs) returns
+
+      state   6xNxK double array, state of target k at et(i) in
+              state(:,i,k)
+
+      lt      1xNxK double array of the corresponding light times
+
+   and mice('spkpos_m', ...) the 3xNxK positions and the light times.
+   'targ' is a KxM character array, one target name per row, so the
+   states of several targets (e.g. MMS1 to MMS4) return from one call.
+   The values are written directly into the return arrays, no
+   structure array or per-epoch MATLAB allocation is involved.
+*/
+static void spk_matrix(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[],
+                       SpiceInt nstate)
+   {
+
+   SpiceDouble        * vec_et;
+   SpiceDouble        * vec_state;
+   SpiceDouble        * vec_lt;
+   SpiceChar            targ  [DEFAULT_STR_LENGTH+1];
+   SpiceChar            ref   [DEFAULT_STR_LENGTH+1];
+   SpiceChar            abcorr[DEFAULT_STR_LENGTH+1];
+   SpiceChar            obs   [DEFAULT_STR_LENGTH+1];
+   ConstSpiceChar     * names [4];
+   mxChar             * mx_targ;
+   int                  sizearray[3];
+
+   SpiceInt             ntarg;
+   SpiceInt             len;
+   SpiceInt             n;
+   SpiceInt             i;
+   SpiceInt             j;
+   SpiceInt             k;
+
+   check_arg_num( nrhs, nlhs, 5, 2 );
+
+   if ( !mxIsChar(prhs[1]) || mxGetNumberOfDimensions(prhs[1]) != 2 ||
+        mxGetN(prhs[1]) > DEFAULT_STR_LENGTH )
+      {
+      mexErrMsgTxt( "MICE(BADARG): Input argument (`targ') must be a "
+                    "character array with one target name per row." );
+      }
+
+   if ( !mxIsDouble(prhs[2]) || mxIsComplex(prhs[2]) )
+      {
+      mexErrMsgTxt( "MICE(BADVAL): All elements of input argument (`et') "
+                    "must have type double." );
+      }
+
+   for ( i=3; i<=5; i++ )
+      {
+      if ( !mxIsChar(prhs[i]) )
+         {
+         mexErrMsgTxt( "MICE(BADARG): Input arguments (`ref', `abcorr', "
+                       "`obs') must be alphabetic." );
+         }
+      }
+
+   mxGetString(prhs[3], ref,    DEFAULT_STR_LENGTH);
+   mxGetString(prhs[4], abcorr, DEFAULT_STR_LENGTH);
+   mxGetString(prhs[5], obs,    DEFAULT_STR_LENGTH);
+
+   ntarg   = (SpiceInt)mxGetM(prhs[1]);
+   len     = (SpiceInt)mxGetN(prhs[1]);
+   n       = (SpiceInt)mxGetNumberOfElements(prhs[2]);
+   mx_targ = (mxChar *)mxGetChars(prhs[1]);
+   vec_et  = A_DBL_ARGV(2);
+
+   sizearray[0] = nstate;
+   sizearray[1] = n;
+   sizearray[2] = ntarg;
+   plhs[0] = mxCreateNumericArray( 3, sizearray, mxDOUBLE_CLASS, mxREAL );
+
+   sizearray[0] = 1;
+   plhs[1] = mxCreateNumericArray( 3, sizearray, mxDOUBLE_CLASS, mxREAL );
+
+   vec_state = A_DBL_RET_ARGV(0);
+   vec_lt    = A_DBL_RET_ARGV(1);
+
+   for ( k=0; k<ntarg; k++ )
+      {
+
+      /*
+      The character array is stored by column, extract row k.
+      */
+      for ( j=0; j<len; j++ )
+         {
+         targ[j] = (char)mx_targ[k + ntarg*j];
+         }
+
+      targ[len] = '\0';
+
+      names[0] = targ;
+      names[1] = ref;
+      names[2] = abcorr;
+      names[3] = obs;
+
+      if ( zzmice_pool_eval( nstate == 6 ? POOL_SPKEZR : POOL_SPKPOS, names,
+                             n, vec_et, vec_state + nstate*n*k,
+                             vec_lt + n*k ) )
+         {
+         continue;
+         }
+
+      for ( i=0; i<n; i++ )
+         {
+
+         if ( nstate == 6 )
+            {
+            spkezr_c( targ, vec_et[i], ref, abcorr, obs,
+                      vec_state + 6*(i + n*k), vec_lt + i + n*k );
+            }
+         else
+            {
+            spkpos_c( targ, vec_et[i], ref, abcorr, obs,
+                      vec_state + 3*(i + n*k), vec_lt + i + n*k );
+            }
+
+         CHECK_CALL_FAILURE(i);
+         }
+
+      }
+
+   }
+
+
+
+
+void mice_spkezr_m(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+   spk_matrix( nlhs, plhs, nrhs, prhs, 6 );
+   }
+
 
-   struct extra_dims  * extra;
-   struct argcheck ArgCheck[] =
-      {
-      { "targ",   MiceChar,   0, {0}, 0},
-      { "et",     MiceDouble, 0, {0}, 1},
-      { "ref",    MiceChar,   0, {0}, 0},
-      { "abcorr", MiceChar,   0, {0}, 0},
-      { "obs",    MiceChar,   0, {0}, 0},
-      { "state",  MiceState,  0, {0}, 1},
-      };
 
-   check_arg_num( nrhs, nlhs, 5, 1 );
 
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+void mice_spkpos_m(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+   spk_matrix( nlhs, plhs, nrhs, prhs, 3 );
+   }
 
-   mxGetString(prhs[1], targ, DEFAULT_STR_LENGTH);
 
-   vec_et = A_DBL_ARGV(2);
-   et     = *(vec_et);
 
-   mxGetString(prhs[3], ref,    DEFAULT_STR_LENGTH);
-   mxGetString(prhs[4], abcorr, DEFAULT_STR_LENGTH);
-   mxGetString(prhs[5], obs,    DEFAULT_STR_LENGTH);
 
-   /*
-   Check for vectorized arguments.
-   */
-   if (extra->count>1)
-      {
+/*
+   Interpolated states from a knot cache.
+
+   mice('spkezr_h', targ, et, ref, abcorr, obs, tol) returns the 6xN
+   states of 'targ' at the epochs 'et', interpolated from states that
+   spkezr_c computes at adaptively spaced knots. Between two knots the
+   position is the cubic Hermite polynomial through the knot positions
+   and velocities, the velocity its derivative.
+
+   tol = [ptol vtol] bounds the interpolation error in position (km) and
+   velocity (km/s). A knot interval is accepted when the interpolated
+   state at its midpoint, which is evaluated and kept as a knot as well,
+   is within the bounds, otherwise the interval is halved. Intervals
+   are not halved below EPH_HMIN seconds, which limits the accuracy
+   for bounds below the numerical noise of the ephemeris.
+
+   The knots persist between calls for the same target, frame,
+   correction, observer and tolerance, so consecutive data intervals
+   reuse them. Epochs outside the covered spans add new spans, epochs
+   closer than EPH_GAP seconds to each other share a span. Beyond
+   EPH_MAX_KNOTS knots the spans not used by the current call are
+   dropped. The state at a NaN or infinite epoch is NaN.
+   mice('spkezr_h') frees the knots, which also happens when kernels are
+   loaded or unloaded.
+*/
 
-      /*
-      Something input as a N-vector, extract the input values
-      (vectorized or not) then execute the routine for each
-      set of inputs.
-      */
-      for (i=0;i<extra->count;i++)
-         {
+#define  EPH_H0          60.0
+#define  EPH_HMIN        1.0
+#define  EPH_HMAX        86400.0
+#define  EPH_GAP         3600.0
+#define  EPH_MAX_KNOTS   4000000
 
-         et = *(vec_et + i*extra->offset[1]);
+struct eph_span
+   {
+   SpiceInt             n;
+   SpiceDouble        * et;
+   SpiceDouble        * state;
+   SpiceInt             call;
+   };
 
-         spkezr_c(targ, et, ref, abcorr, obs, starg, &lt);
-         CHECK_CALL_FAILURE(i);
+struct eph_cache
+   {
+   SpiceChar            key[4*DEFAULT_STR_LENGTH+64];
+   SpiceInt             nspan;
+   struct eph_span    * span;
+   struct eph_cache   * next;
+   };
 
-         /*
-         Copy the state and light time values into the ith structure
-         element.
-         */
-         memcpy( mxGetPr( mxGetField(plhs[0],i,"state") ),
-                 starg,
-                 6*sizeof(SpiceDouble));
+static struct eph_cache * eph_caches = NULL;
+static SpiceInt           eph_nknots = 0;
+static SpiceInt           eph_call   = 0;
 
-         mxDestroyArray( mxGetField( plhs[0], i, "lt" ) );
-         mxSetField( plhs[0], i, "lt", mxCreateDoubleScalar(lt) );
 
+static void eph_clear( void )
+   {
+   struct eph_cache   * c;
+   SpiceInt             i;
+
+   while ( (c = eph_caches) != NULL )
+      {
+      eph_caches = c->next;
+
+      for ( i=0; i<c->nspan; i++ )
+         {
+         free( c->span[i].et    );
+         free( c->span[i].state );
          }
 
+      free( c->span );
+      free( c );
       }
-   else
-      {
 
-      spkezr_c(targ, et, ref, abcorr, obs, starg, &lt);
-      CHECK_CALL_FAILURE(SCALAR);
+   eph_nknots = 0;
+   }
 
-      /*
-      Copy the state vector and the lighttime value into the return structure.
-      */
-      memcpy( mxGetPr( mxGetField(plhs[0],0,"state") ),
-              starg,
-              6*sizeof(SpiceDouble));
 
-      mxDestroyArray( mxGetField( plhs[0], 0, "lt" ) );
-      mxSetField( plhs[0], 0, "lt", mxCreateDoubleScalar(lt) );
+/*
+Cubic Hermite interpolation of 'state' at 't' in span 's'.
+*/
+static void eph_hermite( const struct eph_span * s,
+                         SpiceDouble             t,
+                         SpiceDouble           * state )
+   {
+   SpiceInt             lo = 0;
+   SpiceInt             hi = s->n - 1;
+   SpiceInt             mid;
+   SpiceInt             j;
+   SpiceDouble          h;
+   SpiceDouble          u;
+   SpiceDouble          h00, h10, h01, h11;
+   SpiceDouble          d00, d10, d01, d11;
+   const SpiceDouble  * s0;
+   const SpiceDouble  * s1;
+
+   if ( s->n == 1 )
+      {
+      MOVED( s->state, 6, state );
+      return;
+      }
+
+   while ( hi - lo > 1 )
+      {
+      mid = (lo + hi) / 2;
 
+      if ( s->et[mid] <= t )
+         {
+         lo = mid;
+         }
+      else
+         {
+         hi = mid;
+         }
       }
 
-   }
+   h  = s->et[hi] - s->et[lo];
+   u  = (t - s->et[lo]) / h;
+   s0 = s->state + 6*lo;
+   s1 = s->state + 6*hi;
 
+   h00 = (2.0*u - 3.0)*u*u + 1.0;
+   h10 = ((u - 2.0)*u + 1.0)*u*h;
+   h01 = (3.0 - 2.0*u)*u*u;
+   h11 = (u - 1.0)*u*u*h;
 
+   d00 = 6.0*(u - 1.0)*u/h;
+   d10 = (3.0*u - 4.0)*u + 1.0;
+   d01 = -d00;
+   d11 = (3.0*u - 2.0)*u;
 
+   for ( j=0; j<3; j++ )
+      {
+      state[j]   = h00*s0[j] + h10*s0[j+3] + h01*s1[j] + h11*s1[j+3];
+      state[j+3] = d00*s0[j] + d10*s0[j+3] + d01*s1[j] + d11*s1[j+3];
+      }
+   }
 
-/*
-   void              spkobj_c ( ConstSpiceChar    * spk,
-                                SpiceCell         * ids );
 
+/*
+Index of the span of 'c' covering 't', -1 if none.
 */
-void cspice_spkobj(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+static SpiceInt eph_find( const struct eph_cache * c, SpiceDouble t )
    {
-   SpiceChar           spk[DEFAULT_STR_LENGTH+1];
-   mxChar            * mx_spk;
+   SpiceInt             lo = 0;
+   SpiceInt             hi = c->nspan;
+   SpiceInt             mid;
 
-   SpiceInt            i;
-   SpiceInt            j;
-   int                 sizearray[2];
+   while ( lo < hi )
+      {
+      mid = (lo + hi) / 2;
 
-   SpiceInt            card = 0;
-   SpiceInt            size;
-   SpiceInt          * ids_f;
-   SpiceInt          * ids;
+      if ( c->span[mid].et[0] <= t )
+         {
+         lo = mid + 1;
+         }
+      else
+         {
+         hi = mid;
+         }
+      }
 
-   struct extra_dims * extra;
-   struct argcheck ArgCheck[] =
+   if ( lo > 0 && t <= c->span[lo-1].et[c->span[lo-1].n - 1] )
       {
-      { "spk",  MiceChar,   0, {0}, 1},
-      { "size", MiceInt,    0, {0}, 0},
-      { "ids",  MiceIgnore, 0, {0}, 0},
-      };
+      return lo - 1;
+      }
 
-   check_arg_num( nrhs, nlhs, 2, 1 );
+   return -1;
+   }
 
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
-   size = S_INT_ARGV(2);
-   ids  = (SpiceInt*)mxMalloc( (size + SPICE_CELL_CTRLSZ)*sizeof(SpiceInt)  );
+/*
+Knots covering [a, b]. The arrays are allocated with mxMalloc, so a
+SPICE error in the middle leaves nothing behind.
+*/
+static void eph_build( ConstSpiceChar  * targ,
+                       ConstSpiceChar  * ref,
+                       ConstSpiceChar  * abcorr,
+                       ConstSpiceChar  * obs,
+                       SpiceDouble       ptol,
+                       SpiceDouble       vtol,
+                       SpiceDouble       a,
+                       SpiceDouble       b,
+                       struct eph_span * span )
+   {
+   SpiceDouble          t;
+   SpiceDouble          t1;
+   SpiceDouble          tm;
+   SpiceDouble          h = EPH_H0;
+   SpiceDouble          s0[6];
+   SpiceDouble          s1[6];
+   SpiceDouble          sm[6];
+   SpiceDouble          si[6];
+   SpiceDouble          lt;
+   SpiceDouble          perr;
+   SpiceDouble          verr;
+   SpiceInt             size = 1024;
+   SpiceInt             n    = 0;
+   SpiceInt             j;
+   struct eph_span      pair;
+   SpiceDouble          pet[2];
+   SpiceDouble          pstate[12];
 
-   ssizei_( ( integer * ) &size, ( integer * ) ids   );
-   scardi_( ( integer * ) &card, ( integer * ) ids   );
+   span->et    = (SpiceDouble*)mxMalloc( size   * sizeof(SpiceDouble) );
+   span->state = (SpiceDouble*)mxMalloc( 6*size * sizeof(SpiceDouble) );
 
-   if (extra->count>1)
+   t = a;
+   spkezr_c( targ, t, ref, abcorr, obs, s0, &lt );
+   CHECK_CALL_FAILURE(SCALAR);
+
+   span->et[n] = t;
+   MOVED( s0, 6, span->state + 6*n );
+   n++;
+
+   pair.n     = 2;
+   pair.et    = pet;
+   pair.state = pstate;
+
+   while ( t < b )
       {
 
-      mx_spk = (mxChar *)mxGetChars(prhs[1]);
+      h  = MinVal( h, b - t );
+      t1 = t + h;
+      spkezr_c( targ, t1, ref, abcorr, obs, s1, &lt );
+      CHECK_CALL_FAILURE(SCALAR);
 
-      for ( i=0; i<extra->count; i++)
+      for (;;)
          {
+         tm = t + 0.5*h;
+         spkezr_c( targ, tm, ref, abcorr, obs, sm, &lt );
+         CHECK_CALL_FAILURE(SCALAR);
 
-         /*
-         Extract the string data, character by character, into
-         CSPICE strings. The mx_str array stores the data in a column
-         major format, we need to extract the data by rows.
-         */
-         for ( j=0; j<extra->offset[0]; j++)
-            {
-            spk[j] = (char)mx_spk[i + (extra->count*j)];
-            }
+         pet[0] = t;
+         pet[1] = t1;
+         MOVED( s0, 6, pstate     );
+         MOVED( s1, 6, pstate + 6 );
+         eph_hermite( &pair, tm, si );
 
-         spk[extra->offset[0]] = '\0';
+         perr = 0.0;
+         verr = 0.0;
 
-         spkobj_(  ( char       * ) spk,
-                   ( integer    * ) (ids),
-                   ( ftnlen       ) strlen(spk)   );
+         for ( j=0; j<3; j++ )
+            {
+            perr = MaxVal( perr, fabs( si[j]   - sm[j]   ) );
+            verr = MaxVal( verr, fabs( si[j+3] - sm[j+3] ) );
+            }
 
          /*
-         Check for a failure signal. Free the memory assigned to 'ids'
-         before signaling a Matlab error.
+         The velocity error of the cubic vanishes at the midpoint to
+         leading order, its maximum is 16/(3*sqrt(3)) perr/h.
          */
-         if ( failed_c())
-            {
-            mxFree( ids );
+         verr = MaxVal( verr, 3.08*perr/h );
 
-            /*
-            The mice_fail call creates the error string then returns control
-            to the MATLAB interpreter.
-            */
-            mice_fail(i);
+         if ( (perr <= ptol && verr <= vtol) || h <= EPH_HMIN )
+            {
+            break;
             }
 
+         /*
+         Halve the interval, the midpoint becomes the new end.
+         */
+         h  = 0.5*h;
+         t1 = tm;
+         MOVED( sm, 6, s1 );
          }
 
-      }
-   else
-      {
-      mxGetString(prhs[1], spk, DEFAULT_STR_LENGTH);
+      if ( n + 2 > size )
+         {
+         size *= 2;
+         span->et    = (SpiceDouble*)mxRealloc( span->et,
+                                         size   * sizeof(SpiceDouble) );
+         span->state = (SpiceDouble*)mxRealloc( span->state,
+                                         6*size * sizeof(SpiceDouble) );
+         }
 
-      spkobj_(  ( char       * ) spk,
-                ( integer    * ) (ids),
-                ( ftnlen       ) strlen(spk)   );
+      span->et[n] = tm;
+      MOVED( sm, 6, span->state + 6*n );
+      n++;
+
+      span->et[n] = t1;
+      MOVED( s1, 6, span->state + 6*n );
+      n++;
 
       /*
-      Check for a failure signal. Free the memory assigned to 'ids'
-      before signaling a Matlab error.
+      The error of the cubic scales with h^4, so doubling is safe
+      well below the bounds.
       */
-      if ( failed_c())
+      if ( perr < ptol/32.0 && verr < vtol/16.0 )
          {
-         mxFree( ids );
-
-         /*
-         The mice_fail call creates the error string then returns control
-         to the MATLAB interpreter.
-         */
-         mice_fail(SCALAR);
+         h = MinVal( 2.0*h, EPH_HMAX );
          }
 
+      t = t1;
+      MOVED( s1, 6, s0 );
       }
 
-   /*
-   Array element 6, index 5, contains the cell cardinality. Create an output
-   array CARDx1.
-   */
-   sizearray[0] = ids[5];
-   sizearray[1] = 1;
-
-   plhs[0] = mxCreateNumericArray( 2, sizearray, mxINT32_CLASS, mxREAL);
-   ids_f   = A_INT_RET_ARGV(0);
-
-   MOVEI( ids + SPICE_CELL_CTRLSZ, ids[5], ids_f );
-   mxFree( ids );
+   span->n = n;
    }
 
 
-
-
 /*
-   void              spkopn_c ( ConstSpiceChar    * name,
-                                ConstSpiceChar    * ifname,
-                                SpiceInt            ncomch,
-                                SpiceInt          * handle  );
+Move a built span to persistent memory and insert it in 'c', keeping the
+spans sorted.
 */
-void cspice_spkopn(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+static void eph_insert( struct eph_cache * c, const struct eph_span * s )
    {
+   struct eph_span      p;
+   struct eph_span    * spans;
+   SpiceInt             k;
 
-   SpiceChar            fname [DEFAULT_STR_LENGTH+1];
-   SpiceChar            ifname[DEFAULT_STR_LENGTH+1];
-   SpiceInt             ncomch;
-   SpiceInt           * handle;
+   p.n     = s->n;
+   p.et    = (SpiceDouble*)malloc(   s->n * sizeof(SpiceDouble) );
+   p.state = (SpiceDouble*)malloc( 6*s->n * sizeof(SpiceDouble) );
+   spans   = (struct eph_span*)realloc( c->span,
+                                  (c->nspan + 1) * sizeof(struct eph_span) );
 
-   struct extra_dims  * extra;
-   struct argcheck ArgCheck[] =
+   if ( p.et == NULL || p.state == NULL || spans == NULL )
       {
-      { "fname",  MiceChar, 0, {0}, 0},
-      { "ifname", MiceChar, 0, {0}, 0},
-      { "ncomch", MiceInt,  0, {0}, 0},
-      { "handle", MiceInt,  0, {0}, 0},
-      };
+      free( p.et );
+      free( p.state );
 
-   check_arg_num( nrhs, nlhs, 3, 1);
+      if ( spans != NULL )
+         {
+         c->span = spans;
+         }
 
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+      mexErrMsgTxt( "MICE(MALLOCFAILED): Cannot store interpolation knots." );
+      }
 
-   mxGetString(prhs[1], fname,  DEFAULT_STR_LENGTH);
-   mxGetString(prhs[2], ifname, DEFAULT_STR_LENGTH);
+   memcpy( p.et,    s->et,      s->n * sizeof(SpiceDouble) );
+   memcpy( p.state, s->state, 6*s->n * sizeof(SpiceDouble) );
+   c->span = spans;
 
-   ncomch = S_INT_ARGV(3);
-   handle = A_INT_RET_ARGV(0);
+   for ( k=c->nspan; k>0 && c->span[k-1].et[0] > p.et[0]; k-- )
+      {
+      c->span[k] = c->span[k-1];
+      }
 
-   spkopn_c( fname, ifname, ncomch, handle );
-   CHECK_CALL_FAILURE(SCALAR);
+   p.call     = eph_call;
+   c->span[k] = p;
+   c->nspan++;
+   eph_nknots += p.n;
+   }
+
+
+/*
+Drop the other caches and the spans of 'c' not used by the current
+call.
+*/
+static void eph_evict( struct eph_cache * c )
+   {
+   struct eph_cache   * p;
+   SpiceInt             k;
+   SpiceInt             m = 0;
+
+   for ( p=eph_caches; p; p=p->next )
+      {
+      if ( p->next == c )
+         {
+         p->next = c->next;
+         }
+      }
+
+   if ( eph_caches == c )
+      {
+      eph_caches = c->next;
+      }
+
+   c->next = NULL;
+   eph_clear();
+
+   for ( k=0; k<c->nspan; k++ )
+      {
+      if ( c->span[k].call == eph_call )
+         {
+         c->span[m++] = c->span[k];
+         eph_nknots  += c->span[k].n;
+         }
+      else
+         {
+         free( c->span[k].et    );
+         free( c->span[k].state );
+         }
+      }
 
+   c->nspan   = m;
+   eph_caches = c;
    }
 
 
+static int eph_compare( const void * a, const void * b )
+   {
+   SpiceDouble x = *(const SpiceDouble*)a;
+   SpiceDouble y = *(const SpiceDouble*)b;
+
+   return (x > y) - (x < y);
+   }
 
 
-/*
-   void              spkpos_c ( ConstSpiceChar    * targ,
-                                SpiceDouble         et,
-                                ConstSpiceChar    * ref,
-                                ConstSpiceChar    * abcorr,
-                                ConstSpiceChar    * obs,
-                                SpiceDouble         ptarg[3],
-                                SpiceDouble       * lt        );
-*/
-void mice_spkpos(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+void mice_spkezr_h(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
    SpiceDouble        * vec_et;
+   SpiceDouble        * vec_state;
+   SpiceDouble        * tol;
+   SpiceDouble        * todo;
    SpiceChar            targ  [DEFAULT_STR_LENGTH+1];
    SpiceChar            ref   [DEFAULT_STR_LENGTH+1];
    SpiceChar            abcorr[DEFAULT_STR_LENGTH+1];
    SpiceChar            obs   [DEFAULT_STR_LENGTH+1];
-   SpiceDouble          et;
-   SpiceDouble          ptarg[3];
-   SpiceDouble          lt;
+   SpiceChar            key   [4*DEFAULT_STR_LENGTH+64];
+   SpiceDouble          ptol;
+   SpiceDouble          vtol;
+   struct eph_cache   * c;
+   struct eph_span      span;
 
+   SpiceInt             n;
+   SpiceInt             ntodo;
+   SpiceInt             first;
    SpiceInt             i;
+   SpiceInt             k;
+   SpiceInt             last = -1;
 
-   struct extra_dims  * extra;
-   struct argcheck ArgCheck[] =
+   if ( nrhs == 1 )
       {
-      { "targ",   MiceChar,   0, {0}, 0},
-      { "et",     MiceDouble, 0, {0}, 1},
-      { "ref",    MiceChar,   0, {0}, 0},
-      { "abcorr", MiceChar,   0, {0}, 0},
-      { "obs",    MiceChar,   0, {0}, 0},
-      { "ptarg",  MicePos,    0, {0}, 1},
-      };
+      check_arg_num( nrhs, nlhs, 0, 0 );
+      eph_clear();
+      return;
+      }
 
-   check_arg_num( nrhs, nlhs, 5, 1 );
+   check_arg_num( nrhs, nlhs, 6, 1 );
 
-   extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
+   if ( !mxIsChar(prhs[1]) || !mxIsChar(prhs[3]) ||
+        !mxIsChar(prhs[4]) || !mxIsChar(prhs[5]) )
+      {
+      mexErrMsgTxt( "MICE(BADARG): Input arguments (`targ', `ref', "
+                    "`abcorr', `obs') must be alphabetic." );
+      }
 
-   mxGetString(prhs[1], targ, DEFAULT_STR_LENGTH);
+   if ( !mxIsDouble(prhs[2]) || mxIsComplex(prhs[2]) )
+      {
+      mexErrMsgTxt( "MICE(BADVAL): All elements of input argument (`et') "
+                    "must have type double." );
+      }
 
-   vec_et = A_DBL_ARGV(2);
-   et     = *(vec_et);
+   if ( !mxIsDouble(prhs[6]) || mxGetNumberOfElements(prhs[6]) != 2 )
+      {
+      mexErrMsgTxt( "MICE(BADARG): Input argument (`tol') must be a "
+                    "2-vector [ptol vtol]." );
+      }
 
+   mxGetString(prhs[1], targ,   DEFAULT_STR_LENGTH);
    mxGetString(prhs[3], ref,    DEFAULT_STR_LENGTH);
    mxGetString(prhs[4], abcorr, DEFAULT_STR_LENGTH);
    mxGetString(prhs[5], obs,    DEFAULT_STR_LENGTH);
 
+   tol  = A_DBL_ARGV(6);
+   ptol = tol[0];
+   vtol = tol[1];
+
+   if ( !(ptol > 0.0) || !(vtol > 0.0) )
+      {
+      mexErrMsgTxt( "MICE(BADARG): The tolerances must be positive." );
+      }
+
+   sprintf( key, "%s|%s|%s|%s|%.17g|%.17g", targ, ref, abcorr, obs, ptol, vtol );
+
+   for ( c=eph_caches; c; c=c->next )
+      {
+      if ( strcmp( c->key, key ) == 0 )
+         {
+         break;
+         }
+      }
+
+   if ( c == NULL )
+      {
+      c = (struct eph_cache*)calloc( 1, sizeof(struct eph_cache) );
+
+      if ( c == NULL )
+         {
+         mexErrMsgTxt( "MICE(MALLOCFAILED): Cannot store interpolation knots." );
+         }
+
+      strcpy( c->key, key );
+      c->next    = eph_caches;
+      eph_caches = c;
+      }
+
+   n         = (SpiceInt)mxGetNumberOfElements(prhs[2]);
+   vec_et    = A_DBL_ARGV(2);
+   plhs[0]   = mxCreateDoubleMatrix( 6, n, mxREAL );
+   vec_state = A_DBL_RET_ARGV(0);
+
    /*
-   Check for vectorized arguments.
+   Epochs not covered by the knots so far.
    */
-   if (extra->count>1)
+   todo  = (SpiceDouble*)mxMalloc( (n+1) * sizeof(SpiceDouble) );
+   ntodo = 0;
+   eph_call++;
+
+   for ( i=0; i<n; i++ )
       {
+      if ( !isfinite( vec_et[i] ) )
+         {
+         continue;
+         }
 
-      /*
-      Something input as a N-vector, extract the input values
-      (vectorized or not) then execute the routine for each
-      set of inputs.
-      */
-      for (i=0;i<extra->count;i++)
+      if ( last < 0 || vec_et[i] < c->span[last].et[0] ||
+           vec_et[i] > c->span[last].et[c->span[last].n - 1] )
          {
+         last = eph_find( c, vec_et[i] );
+         }
 
-         et    = *(vec_et + i*extra->offset[1]);
+      if ( last < 0 )
+         {
+         todo[ntodo++] = vec_et[i];
+         }
+      else
+         {
+         c->span[last].call = eph_call;
+         }
+      }
 
-         /*
-         Call the routine for this iteration.
-         */
-         spkpos_c(targ, et, ref, abcorr, obs, ptarg, &lt);
-         CHECK_CALL_FAILURE(i);
+   if ( ntodo > 0 )
+      {
+
+      qsort( todo, ntodo, sizeof(SpiceDouble), eph_compare );
+
+      first = 0;
+
+      for ( i=1; i<=ntodo; i++ )
+         {
 
          /*
-         Copy the position and light time values into the ith structure
-         element.
+         A span ends at a large gap or where a cached span begins.
          */
-         memcpy( mxGetPr( mxGetField(plhs[0],i,"pos") ),
-                 ptarg,
-                 3*sizeof(SpiceDouble));
+         if ( i < ntodo && todo[i] - todo[i-1] < EPH_GAP )
+            {
+            for ( k=0; k<c->nspan; k++ )
+               {
+               if ( c->span[k].et[0] > todo[i-1] && c->span[k].et[0] < todo[i] )
+                  {
+                  break;
+                  }
+               }
+
+            if ( k == c->nspan )
+               {
+               continue;
+               }
+            }
 
-         mxDestroyArray( mxGetField( plhs[0], i, "lt" ) );
-         mxSetField( plhs[0], i, "lt", mxCreateDoubleScalar(lt) );
+         eph_build( targ, ref, abcorr, obs, ptol, vtol,
+                    todo[first], todo[i-1], &span );
+
+         if ( eph_nknots + span.n > EPH_MAX_KNOTS )
+            {
+            eph_evict( c );
+            }
 
+         eph_insert( c, &span );
+         mxFree( span.et    );
+         mxFree( span.state );
+
+         first = i;
          }
 
       }
-   else
-      {
 
-      spkpos_c(targ, et, ref, abcorr, obs, ptarg, &lt);
-      CHECK_CALL_FAILURE(SCALAR);
+   mxFree( todo );
 
-      /*
-      Copy the position and the light time value into the return structure.
-      */
-      memcpy( mxGetPr( mxGetField(plhs[0],0, "pos") ),
-              ptarg,
-              3*sizeof(SpiceDouble));
+   /*
+   All finite epochs are covered now.
+   */
+   last = -1;
 
-      mxDestroyArray( mxGetField( plhs[0], 0, "lt" ) );
-      mxSetField( plhs[0], 0, "lt", mxCreateDoubleScalar(lt) );
+   for ( i=0; i<n; i++ )
+      {
+      if ( last < 0 || vec_et[i] < c->span[last].et[0] ||
+           vec_et[i] > c->span[last].et[c->span[last].n - 1] )
+         {
+         last = eph_find( c, vec_et[i] );
+         }
+
+      if ( last < 0 || !isfinite( vec_et[i] ) )
+         {
+         for ( k=0; k<6; k++ )
+            {
+            vec_state[6*i + k] = mxGetNaN();
+            }
+
+         continue;
+         }
 
+      eph_hermite( c->span + last, vec_et[i], vec_state + 6*i );
       }
 
    }
@@ -14189,6 +16486,19 @@ void mice_spkpos(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
 
 
+/*
+Free the knots of mice_spkezr_h and mice_ckgp_q, loading or unloading
+kernels may change the states and attitudes.
+*/
+void zzmice_clear_caches( void )
+   {
+   eph_clear();
+   ckq_clear();
+   }
+
+
+
+
 /*
    void              spkpvn_c ( SpiceInt            handle,
                                 ConstSpiceDouble    descr [5],
@@ -14466,84 +16776,369 @@ void mice_srfxpt(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    mxGetString(prhs[1], method, DEFAULT_STR_LENGTH);
    mxGetString(prhs[2], target, DEFAULT_STR_LENGTH);
 
-   vec_et = A_DBL_ARGV(3);
+   vec_et = A_DBL_ARGV(3);
+
+   mxGetString(prhs[4], abcorr, DEFAULT_STR_LENGTH);
+   mxGetString(prhs[5], obsrvr, DEFAULT_STR_LENGTH);
+   mxGetString(prhs[6], dref,   DEFAULT_STR_LENGTH);
+
+   dvec = A_DBL_ARGV(7);
+
+   if (extra->count>1)
+      {
+
+      for (i=0;i<extra->count;i++)
+         {
+
+         et = *(vec_et + i*extra->offset[2]);
+
+         srfxpt_c( method, target,   et,
+                   abcorr, obsrvr, dref,
+                   dvec,   spoint, &dist,
+                   &trgepc, obspos, &found );
+         CHECK_CALL_FAILURE(i);
+
+         memcpy( mxGetPr( mxGetField(plhs[0],i,"spoint" ) ),
+                 spoint,
+                 3*sizeof(SpiceDouble));
+
+         memcpy( mxGetPr( mxGetField(plhs[0],i,"obspos" ) ),
+                 obspos,
+                 3*sizeof(SpiceDouble));
+
+         mxDestroyArray( mxGetField( plhs[0], i, "dist" ) );
+         mxSetField( plhs[0], i, "dist", mxCreateDoubleScalar(dist) );
+
+         mxDestroyArray( mxGetField( plhs[0], i, "trgepc" ) );
+         mxSetField( plhs[0], i, "trgepc", mxCreateDoubleScalar(trgepc) );
+
+         mxDestroyArray( mxGetField( plhs[0], i, "found" ) );
+         mxSetField( plhs[0], i, "found",
+                     mxCreateLogicalScalar(found ? true: false));
+         }
+
+      }
+   else
+      {
+
+      et = *vec_et;
+
+      srfxpt_c( method, target,     et,
+                abcorr, obsrvr,   dref,
+                dvec,   spoint,  &dist,
+                &trgepc, obspos, &found );
+      CHECK_CALL_FAILURE(SCALAR);
+
+      memcpy( mxGetPr( mxGetField(plhs[0],0,"spoint" ) ),
+              spoint,
+              3*sizeof(SpiceDouble));
+
+      memcpy( mxGetPr( mxGetField(plhs[0],0,"obspos" ) ),
+              obspos,
+              3*sizeof(SpiceDouble));
+
+      mxDestroyArray( mxGetField( plhs[0], 0, "dist" ) );
+      mxSetField( plhs[0], 0, "dist", mxCreateDoubleScalar(dist) );
+
+      mxDestroyArray( mxGetField( plhs[0], 0, "trgepc" ) );
+      mxSetField( plhs[0], 0, "trgepc", mxCreateDoubleScalar(trgepc) );
+
+      mxDestroyArray( mxGetField( plhs[0], 0, "found" ) );
+      mxSetField( plhs[0], 0, "found",
+                  mxCreateLogicalScalar(found ? true: false));
+      }
+
+   }
+
+
+
+
+
+/*
+Batched ISO-8601 parsing for cspice_str2et.
+
+iso_parse parses the rows of a MATLAB char matrix in the forms
+
+   YYYY-MM-DDThh:mm:ss[.fff...]
+   YYYY-MM-DD hh:mm:ss[.fff...]
+
+padded with blanks, directly from the column major mxChar buffer. A
+column of the buffer holds one character position of all rows, so the
+digit fields convert with one pass per column over contiguous data,
+loops the compiler vectorizes. The parsed time vectors go to TTRANS,
+the conversion str2et_c itself applies to them after parsing, which
+takes the leap seconds from the loaded LSK; the seconds field is read
+with NPARSD, as str2et_c reads it.
+
+Rows in other forms, with fields out of range, before the Gregorian
+reform or in a leap second go to str2et_c as before. So does the
+whole call if the time system, calendar or zone defaults were changed
+with cspice_timdef, or if any of a sample of the parsed rows does not
+convert exactly as str2et_c converts it.
+
+Returns an array flagging the rows converted, NULL if none was.
+*/
+#define ISO_MIN_ROWS     16
+#define ISO_SAMPLE       1024
+
+static unsigned char * iso_parse( const mxChar * mx_str,
+                                  SpiceInt       nrow,
+                                  SpiceInt       ncol,
+                                  SpiceDouble  * et )
+   {
+
+   static const SpiceInt   dim[13] = { 0, 31, 28, 31, 30, 31, 30,
+                                          31, 31, 30, 31, 30, 31 };
+   static const struct { SpiceInt col; SpiceInt len; } fld[6] =
+      {
+      { 0, 4 }, { 5, 2 }, { 8, 2 }, { 11, 2 }, { 14, 2 }, { 17, 2 }
+      };
+
+   unsigned char      * ok;
+   unsigned char      * st;
+   SpiceInt           * val[6];
+   SpiceInt           * send;
+   SpiceChar            str  [DEFAULT_STR_LENGTH+1];
+   SpiceChar            value[DEFAULT_STR_LENGTH+1];
+   SpiceChar            error[DEFAULT_STR_LENGTH+1];
+   SpiceDouble          tvec[6];
+   SpiceDouble          check;
+   const mxChar       * col;
+   mxChar               c;
+   SpiceInt             ptr;
+   SpiceInt             leap;
+   SpiceInt             i;
+   SpiceInt             j;
+   SpiceInt             k;
+   unsigned             d;
+
+   if ( nrow < ISO_MIN_ROWS || ncol < 19 || ncol > DEFAULT_STR_LENGTH )
+      {
+      return NULL;
+      }
+
+   timdef_c( "GET", "SYSTEM", DEFAULT_STR_LENGTH, value );
+
+   if ( !eqstr_c( value, "UTC" ) )
+      {
+      return NULL;
+      }
+
+   timdef_c( "GET", "CALENDAR", DEFAULT_STR_LENGTH, value );
+
+   if ( eqstr_c( value, "JULIAN" ) )
+      {
+      return NULL;
+      }
+
+   /*
+   The default zone comes back as an empty string.
+   */
+   timdef_c( "GET", "ZONE", DEFAULT_STR_LENGTH, value );
+
+   if ( !iswhsp_c( value ) || failed_c() )
+      {
+      reset_c();
+      return NULL;
+      }
+
+   ok   = (unsigned char*)malloc( 2 * (size_t)nrow );
+   send = (SpiceInt*)malloc( 7 * (size_t)nrow * sizeof(SpiceInt) );
+
+   if ( ok == NULL || send == NULL )
+      {
+      free( ok );
+      free( send );
+      return NULL;
+      }
+
+   st = ok + nrow;
+
+   for ( k=0; k<6; k++ )
+      {
+      val[k] = send + (k+1)*nrow;
+      }
+
+   memset( ok, 1, (size_t)nrow );
+   memset( st, 0, (size_t)nrow );
+
+   /*
+   Digit fields, one column at a time.
+   */
+   for ( k=0; k<6; k++ )
+      {
+      memset( val[k], 0, (size_t)nrow * sizeof(SpiceInt) );
+
+      for ( j=fld[k].col; j<fld[k].col+fld[k].len; j++ )
+         {
+         col = mx_str + j*nrow;
 
-   mxGetString(prhs[4], abcorr, DEFAULT_STR_LENGTH);
-   mxGetString(prhs[5], obsrvr, DEFAULT_STR_LENGTH);
-   mxGetString(prhs[6], dref,   DEFAULT_STR_LENGTH);
+         for ( i=0; i<nrow; i++ )
+            {
+            d          = (unsigned)col[i] - '0';
+            ok[i]     &= ( d <= 9 );
+            val[k][i]  = val[k][i]*10 + (SpiceInt)d;
+            }
+         }
+      }
 
-   dvec = A_DBL_ARGV(7);
+   /*
+   Separators.
+   */
+   for ( i=0; i<nrow; i++ )
+      {
+      c      = mx_str[10*nrow + i];
+      ok[i] &= ( mx_str[ 4*nrow + i] == '-' )
+             & ( mx_str[ 7*nrow + i] == '-' )
+             & ( c == 'T' || c == ' ' )
+             & ( mx_str[13*nrow + i] == ':' )
+             & ( mx_str[16*nrow + i] == ':' );
+      send[i] = ncol;
+      }
 
-   if (extra->count>1)
+   /*
+   Fraction and padding. The state of a row is 0 after the seconds, 1
+   after the decimal point, 2 in the fraction digits, 3 in the padding
+   and 4 if the row is malformed. A trailing 'Z' is left to str2et_c,
+   the N0065 toolkit rejects it.
+   */
+   for ( j=19; j<ncol; j++ )
       {
+      col = mx_str + j*nrow;
 
-      for (i=0;i<extra->count;i++)
+      for ( i=0; i<nrow; i++ )
          {
+         c = col[i];
 
-         et = *(vec_et + i*extra->offset[2]);
+         if ( (unsigned)c - '0' <= 9 && ( st[i] == 1 || st[i] == 2 ) )
+            {
+            st[i] = 2;
+            }
+         else if ( c == '.' && st[i] == 0 )
+            {
+            st[i] = 1;
+            }
+         else if ( c == ' ' && st[i] != 1 && st[i] != 4 )
+            {
+            if ( st[i] != 3 )
+               {
+               send[i] = j;
+               }
 
-         srfxpt_c( method, target,   et,
-                   abcorr, obsrvr, dref,
-                   dvec,   spoint, &dist,
-                   &trgepc, obspos, &found );
-         CHECK_CALL_FAILURE(i);
+            st[i] = 3;
+            }
+         else
+            {
+            st[i] = 4;
+            }
+         }
+      }
 
-         memcpy( mxGetPr( mxGetField(plhs[0],i,"spoint" ) ),
-                 spoint,
-                 3*sizeof(SpiceDouble));
+   for ( i=0; i<nrow; i++ )
+      {
+      leap = ( val[0][i] % 4 == 0 && val[0][i] % 100 != 0 )
+          || ( val[0][i] % 400 == 0 );
 
-         memcpy( mxGetPr( mxGetField(plhs[0],i,"obspos" ) ),
-                 obspos,
-                 3*sizeof(SpiceDouble));
+      ok[i] &= ( st[i] != 1 ) & ( st[i] != 4 )
+             & ( val[0][i] >= 1583 )
+             & ( val[1][i] >= 1 ) & ( val[1][i] <= 12 )
+             & ( val[2][i] >= 1 )
+             & ( val[3][i] <= 23 ) & ( val[4][i] <= 59 )
+             & ( val[5][i] <= 59 );
 
-         mxDestroyArray( mxGetField( plhs[0], i, "dist" ) );
-         mxSetField( plhs[0], i, "dist", mxCreateDoubleScalar(dist) );
+      if ( ok[i] )
+         {
+         ok[i] = val[2][i] <= dim[val[1][i]] + ( val[1][i] == 2 && leap );
+         }
+      }
 
-         mxDestroyArray( mxGetField( plhs[0], i, "trgepc" ) );
-         mxSetField( plhs[0], i, "trgepc", mxCreateDoubleScalar(trgepc) );
+   /*
+   Convert.
+   */
+   for ( i=0; i<nrow && !failed_c(); i++ )
+      {
+      if ( !ok[i] )
+         {
+         continue;
+         }
 
-         mxDestroyArray( mxGetField( plhs[0], i, "found" ) );
-         mxSetField( plhs[0], i, "found",
-                     mxCreateLogicalScalar(found ? true: false));
+      tvec[0] = (SpiceDouble)val[0][i];
+      tvec[1] = (SpiceDouble)val[1][i];
+      tvec[2] = (SpiceDouble)val[2][i];
+      tvec[3] = (SpiceDouble)val[3][i];
+      tvec[4] = (SpiceDouble)val[4][i];
+      tvec[5] = (SpiceDouble)val[5][i];
+
+      if ( send[i] > 19 )
+         {
+         for ( j=17; j<send[i]; j++ )
+            {
+            str[j-17] = (char)mx_str[i + nrow*j];
+            }
+
+         nparsd_( ( char       * ) str,
+                  ( doublereal * ) (tvec+5),
+                  ( char       * ) error,
+                  ( integer    * ) &ptr,
+                  ( ftnlen       ) (send[i] - 17),
+                  ( ftnlen       ) DEFAULT_STR_LENGTH );
+
+         if ( ptr != 0 )
+            {
+            ok[i] = 0;
+            continue;
+            }
          }
 
+      ttrans_( ( char       * ) "YMDF",
+               ( char       * ) "TDB",
+               ( doublereal * ) tvec,
+               ( ftnlen       ) 4,
+               ( ftnlen       ) 3 );
+
+      et[i] = tvec[0];
       }
-   else
-      {
 
-      et = *vec_et;
+   /*
+   Check a sample of the rows against str2et_c.
+   */
+   for ( i=0; i<nrow && !failed_c(); i++ )
+      {
+      if ( !ok[i] || ( i % ISO_SAMPLE != 0 && i != nrow-1 ) )
+         {
+         continue;
+         }
 
-      srfxpt_c( method, target,     et,
-                abcorr, obsrvr,   dref,
-                dvec,   spoint,  &dist,
-                &trgepc, obspos, &found );
-      CHECK_CALL_FAILURE(SCALAR);
+      for ( j=0; j<ncol; j++ )
+         {
+         str[j] = (char)mx_str[i + nrow*j];
+         }
 
-      memcpy( mxGetPr( mxGetField(plhs[0],0,"spoint" ) ),
-              spoint,
-              3*sizeof(SpiceDouble));
+      str[ncol] = '\0';
 
-      memcpy( mxGetPr( mxGetField(plhs[0],0,"obspos" ) ),
-              obspos,
-              3*sizeof(SpiceDouble));
+      str2et_c( str, &check );
 
-      mxDestroyArray( mxGetField( plhs[0], 0, "dist" ) );
-      mxSetField( plhs[0], 0, "dist", mxCreateDoubleScalar(dist) );
+      if ( check != et[i] )
+         {
+         break;
+         }
+      }
 
-      mxDestroyArray( mxGetField( plhs[0], 0, "trgepc" ) );
-      mxSetField( plhs[0], 0, "trgepc", mxCreateDoubleScalar(trgepc) );
+   free( send );
 
-      mxDestroyArray( mxGetField( plhs[0], 0, "found" ) );
-      mxSetField( plhs[0], 0, "found",
-                  mxCreateLogicalScalar(found ? true: false));
+   if ( failed_c() || i < nrow )
+      {
+      reset_c();
+      free( ok );
+      return NULL;
       }
 
+   return ok;
    }
 
 
 
 
-
 /*
    void              str2et_c( ConstSpiceChar * str,
                                SpiceDouble    * et   )
@@ -14555,6 +17150,7 @@ void cspice_str2et(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    mxChar             * mx_str;
    SpiceDouble        * et;
    SpiceDouble        * vec_et;
+   unsigned char      * parsed;
 
    SpiceInt             i;
    SpiceInt             j;
@@ -14576,10 +17172,16 @@ void cspice_str2et(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
       {
 
       mx_str = (mxChar *)mxGetChars(prhs[1]);
+      parsed = iso_parse( mx_str, extra->count, extra->offset[0], vec_et );
 
       for ( i=0; i<extra->count; i++)
          {
 
+         if ( parsed != NULL && parsed[i] )
+            {
+            continue;
+            }
+
          /*
          Extract the string data, character by character, into
          CSPICE strings. The mx_str array stores the data in a column
@@ -14594,9 +17196,15 @@ void cspice_str2et(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
          et                    = (vec_et+i*extra->offset[1]);
 
          str2et_c(str, et);
-         CHECK_CALL_FAILURE(i);
+
+         if ( failed_c() )
+            {
+            free( parsed );
+            mice_fail(i);
+            }
          }
 
+      free( parsed );
       }
    else
       {
@@ -15165,6 +17773,8 @@ void cspice_sxform(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    SpiceDouble        * xform;
    SpiceDouble          xr[6][6];
 
+   ConstSpiceChar     * names[2];
+
    SpiceInt             i;
 
    struct extra_dims  * extra;
@@ -15188,9 +17798,18 @@ void cspice_sxform(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    et        = *vec_et;
    xform     =  vec_xform;
 
+   names[0] = from;
+   names[1] = to;
+
    if (extra->count>1)
       {
 
+      if ( zzmice_pool_eval( POOL_SXFORM, names, extra->count, vec_et,
+                             vec_xform, NULL ) )
+         {
+         return;
+         }
+
       for (i=0;i<extra->count;i++)
          {
 
@@ -15621,6 +18240,8 @@ void cspice_unload(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
    check_arg_num( nrhs, nlhs, 1, 0 );
 
+   zzmice_clear_caches();
+
    extra = mice_checkargs(nlhs,plhs,nrhs,prhs,ArgCheck);
 
 
@@ -15640,6 +18261,7 @@ void cspice_unload(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
          file[extra->offset[0]] = '\0';
 
          unload_c(file);
+         zzmice_pool_kernel();
          CHECK_CALL_FAILURE(i);
          }
 
@@ -15650,6 +18272,7 @@ void cspice_unload(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
       mxGetString(prhs[1], file, DEFAULT_STR_LENGTH-1);
 
       unload_c(file);
+      zzmice_pool_kernel();
       CHECK_CALL_FAILURE(SCALAR);
       }
 
@@ -17917,6 +20540,9 @@ void mice_cleanup()
    char                    msg[1024];
 
    hashtable_destroy();
+   zzmice_plans_free();
+   zzmice_clear_caches();
+   zzmice_pool_stop();
 
    /*
    This error should never signal. If it does, an unknown error exists
@@ -17947,6 +20573,14 @@ void mice_cleanup()
 */
 
 
+/*
+Batched call interfaces, defined after the name to function pointer list
+as they dispatch through it.
+*/
+void mice_batch     (int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]);
+void mice_batch_plan(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]);
+
+
 /*
 Now, with the interfaces defined above, include the name to function
 pointer list.
@@ -17954,6 +20588,291 @@ pointer list.
 #include "npf_cspice.h"
 
 
+
+
+/*
+Batched calls.
+
+   mice('batch_s', calls) executes all the interface calls listed in
+   the Nx2 or Nx3 cell array 'calls' within one MEX call:
+
+      calls{k,1}   the interface name as the cspice_*.m and mice_*.m
+                   wrappers pass it to mice, e.g. 'pxform_c' or
+                   'spkezr_s', or an int32 handle from 'batch_plan_s'
+
+      calls{k,2}   cell array of the input arguments, converted as the
+                   wrapper would convert them (zzmice_str, zzmice_dp, ...)
+
+      calls{k,3}   the number of output arguments, 1 if omitted
+
+   All function names are resolved before the first call executes, a name
+   repeated on consecutive rows costs a single hash lookup. The return
+   value is an NxM cell array, M the largest output count, with the
+   outputs of call k in row k. A SPICE error in any call aborts the batch
+   and signals the error as the single call would.
+
+   mice('batch_plan_s', names) resolves the interface names in the cell
+   array 'names' and returns a 1xN int32 array of handles, which select
+   the interface in 'batch_s' without a name lookup.
+*/
+
+#define  BATCH_MAX_ARGS   32
+#define  NPF_SIZE         ( (SpiceInt)( sizeof(NPF)/sizeof(NPF[0]) ) )
+
+typedef void (*mice_interface)(int, mxArray*[], int, const mxArray*[]);
+
+
+void mice_batch_plan(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceChar            name[STR_LEN+1];
+   SpiceChar            msg [1024];
+   const mxArray      * cell;
+   SpiceInt           * handles;
+   SpiceInt             n;
+   SpiceInt             i;
+   SpiceInt             j;
+
+   check_arg_num( nrhs, nlhs, 1, 1 );
+
+   if ( !mxIsCell(prhs[1]) )
+      {
+      mexErrMsgTxt( "MICE(BADARG): Input argument (`names') must be "
+                    "a cell array of interface names." );
+      }
+
+   n       = (SpiceInt)mxGetNumberOfElements( prhs[1] );
+   plhs[0] = mxCreateNumericMatrix( 1, n, mxINT32_CLASS, mxREAL );
+   handles = A_INT_RET_ARGV(0);
+
+   for ( i=0; i<n; i++ )
+      {
+
+      cell = mxGetCell( prhs[1], i );
+
+      if ( cell == NULL || !mxIsChar(cell) ||
+           mxGetString( cell, name, STR_LEN ) != 0 )
+         {
+         sprintf( msg, "MICE(BADARG): Element %ld of input argument "
+                       "(`names') is not an interface name.",
+                       (long)(i+INDEX_BASE) );
+         mexErrMsgTxt( msg );
+         }
+
+      /*
+      Plans are built once, a linear search of the list suffices.
+      */
+      handles[i] = 0;
+
+      for ( j=0; j<NPF_SIZE; j++ )
+         {
+         if ( strcmp( NPF[j].name, name ) == 0 )
+            {
+            handles[i] = j + 1;
+            break;
+            }
+         }
+
+      if ( handles[i] == 0 )
+         {
+         sprintf( msg, "MICE(UNKNOWNCALL): Unknown CSPICE interface "
+                       "function call: %s", name );
+         mexErrMsgTxt( msg );
+         }
+
+      }
+
+   }
+
+
+
+
+void mice_batch(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+   {
+
+   SpiceChar            name[STR_LEN+1];
+   SpiceChar            last[STR_LEN+1];
+   SpiceChar            msg [1024];
+   const mxArray      * calls;
+   const mxArray      * cell;
+   const mxArray      * sub_rhs[BATCH_MAX_ARGS+1];
+   mxArray            * sub_lhs[BATCH_MAX_ARGS];
+   mice_interface     * plan;
+   struct bucket      * b     = NULL;
+   SpiceInt           * slots;
+   int                * nouts;
+   int                * nargs;
+   SpiceInt             ncall;
+   SpiceInt             ncol;
+   SpiceInt             maxout = 1;
+   SpiceInt             handle;
+   SpiceInt             i;
+   SpiceInt             j;
+
+   check_arg_num( nrhs, nlhs, 1, 1 );
+
+   calls = prhs[1];
+
+   if ( !mxIsCell(calls) || mxGetNumberOfDimensions(calls) != 2 ||
+        (ncol = (SpiceInt)mxGetN(calls)) < 2 || ncol > 3 )
+      {
+      mexErrMsgTxt( "MICE(BADARG): Input argument (`calls') must be "
+                    "an Nx2 or Nx3 cell array." );
+      }
+
+   ncall = (SpiceInt)mxGetM(calls);
+   plan  = (mice_interface*)mxMalloc( (ncall+1) * sizeof(mice_interface) );
+   nouts = (int*)mxMalloc( (ncall+1) * sizeof(int) );
+   nargs = (int*)mxMalloc( (ncall+1) * sizeof(int) );
+   slots = (SpiceInt*)mxMalloc( (ncall+1) * sizeof(SpiceInt) );
+   last[0] = '\0';
+
+   /*
+   Resolve every call and check the argument lists before executing any.
+   */
+   for ( i=0; i<ncall; i++ )
+      {
+
+      cell = mxGetCell( calls, i );
+
+      if ( cell != NULL && mxIsInt32(cell) && mxGetNumberOfElements(cell) == 1 )
+         {
+         handle = *(SpiceInt*)mxGetData(cell);
+
+         if ( handle < 1 || handle > NPF_SIZE )
+            {
+            sprintf( msg, "MICE(BADARG): Call %ld uses an invalid "
+                          "batch handle %ld.",
+                          (long)(i+INDEX_BASE), (long)handle );
+            mexErrMsgTxt( msg );
+            }
+
+         plan[i]  = NPF[handle-1].pfunc;
+         slots[i] = handle - 1;
+         }
+      else if ( cell != NULL && mxIsChar(cell) &&
+                mxGetString( cell, name, STR_LEN ) == 0 )
+         {
+         if ( strcmp( name, last ) != 0 )
+            {
+            b = hashtable_bucket( name );
+            strcpy( last, name );
+            }
+
+         if ( b == NULL )
+            {
+            sprintf( msg, "MICE(UNKNOWNCALL): Unknown CSPICE interface "
+                          "function call: %s", name );
+            mexErrMsgTxt( msg );
+            }
+
+         plan[i]  = b->binding;
+         slots[i] = b->slot;
+         }
+      else
+         {
+         sprintf( msg, "MICE(BADARG): Call %ld has no interface name "
+                       "or handle.", (long)(i+INDEX_BASE) );
+         mexErrMsgTxt( msg );
+         }
+
+      cell = mxGetCell( calls, i + ncall );
+
+      if ( cell != NULL && !mxIsCell(cell) )
+         {
+         sprintf( msg, "MICE(BADARG): The arguments of call %ld must "
+                       "be a cell array.", (long)(i+INDEX_BASE) );
+         mexErrMsgTxt( msg );
+         }
+
+      nargs[i] = cell == NULL ? 0 : (int)mxGetNumberOfElements(cell);
+
+      for ( j=0; j<nargs[i]; j++ )
+         {
+         if ( mxGetCell( cell, j ) == NULL )
+            {
+            sprintf( msg, "MICE(BADARG): Argument %ld of call %ld "
+                          "is empty.",
+                          (long)(j+INDEX_BASE), (long)(i+INDEX_BASE) );
+            mexErrMsgTxt( msg );
+            }
+         }
+
+      nouts[i] = 1;
+
+      cell = ncol == 3 ? mxGetCell( calls, i + 2*ncall ) : NULL;
+
+      if ( cell != NULL && !mxIsEmpty(cell) )
+         {
+         if ( !mxIsNumeric(cell) || mxGetNumberOfElements(cell) != 1 )
+            {
+            sprintf( msg, "MICE(BADARG): The output count of call %ld "
+                          "must be a scalar.", (long)(i+INDEX_BASE) );
+            mexErrMsgTxt( msg );
+            }
+
+         nouts[i] = (int)mxGetScalar(cell);
+         }
+
+      if ( nargs[i] > BATCH_MAX_ARGS ||
+           nouts[i] < 0 || nouts[i] > BATCH_MAX_ARGS )
+         {
+         sprintf( msg, "MICE(BADARG): Call %ld exceeds %d input or "
+                       "output arguments.",
+                       (long)(i+INDEX_BASE), BATCH_MAX_ARGS );
+         mexErrMsgTxt( msg );
+         }
+
+      maxout = MaxVal( maxout, nouts[i] );
+      }
+
+   plhs[0] = mxCreateCellMatrix( ncall, maxout );
+
+   /*
+   Execute the calls. The interfaces ignore prhs[0], pass the name cell.
+   */
+   for ( i=0; i<ncall; i++ )
+      {
+
+      sub_rhs[0] = mxGetCell( calls, i );
+      cell       = mxGetCell( calls, i + ncall );
+
+      for ( j=0; j<nargs[i]; j++ )
+         {
+         sub_rhs[j+1] = mxGetCell( cell, j );
+         }
+
+      /*
+      No stale outputs of the previous call, an interface which leaves
+      an output unset gives an empty cell.
+      */
+      for ( j=0; j<nouts[i]; j++ )
+         {
+         sub_lhs[j] = NULL;
+         }
+
+      zzmice_enter( slots[i] );
+      (*plan[i])( nouts[i], sub_lhs, nargs[i]+1, sub_rhs );
+      zzmice_leave();
+
+      for ( j=0; j<nouts[i]; j++ )
+         {
+         if ( sub_lhs[j] != NULL )
+            {
+            mxSetCell( plhs[0], i + j*ncall, sub_lhs[j] );
+            }
+         }
+
+      }
+
+   mxFree( plan  );
+   mxFree( nouts );
+   mxFree( nargs );
+   mxFree( slots );
+   }
+
+
+
 void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    {
 
@@ -17971,11 +20890,7 @@ void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    char                  erract_buf[1024];
    char                * function_name;
    integer               divisor = HASHSIZE;
-
-   void                (*function_reference)(int,
-                                             mxArray*[],
-                                             int,
-                                             const mxArray*[]);
+   struct bucket       * function_bucket;
 
    /*
    Ensure the user doesn't try to directly call the Mice library
@@ -18005,9 +20920,15 @@ void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
       for ( i=0; i<SIZE; i++)
          {
-         hashtable_insert(NPF[i].name, NPF[i].pfunc);
+         hashtable_insert(NPF[i].name, NPF[i].pfunc, i);
          }
 
+      /*
+      One argument validation plan slot per interface, see
+      mice_checkargs.
+      */
+      zzmice_plans_init( SIZE );
+
       /*
       By default, CSPICE calls exit() when an error occurs. This response
       causes the MATLAB application to exit (collapse).
@@ -18054,15 +20975,19 @@ void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
    /*
    Now find the address of the function corresponding to the call name...
    */
-   function_reference = hashtable_lookup(function_name);
+   function_bucket = hashtable_bucket(function_name);
 
    /*
-   ...if found, execute that function. If not found, signal an error
-   to the user.
+   ...if found, execute that function in its call frame. If not found,
+   signal an error to the user. A SPICE error in the previous call left
+   that call's frame entered, start from the top.
    */
-   if (function_reference)
+   if (function_bucket)
       {
-      (*function_reference)(nlhs, plhs, nrhs, prhs);
+      zzmice_reset();
+      zzmice_enter(function_bucket->slot);
+      (*function_bucket->binding)(nlhs, plhs, nrhs, prhs);
+      zzmice_leave();
       }
    else
       {
@@ -136,6 +136,50 @@
 Prototypes.
 */
 mxArray * zzmice_CreateIntScalar( SpiceInt n);
+void      zzmice_clear_caches( void );
+
+void         zzmice_pool_start ( SpiceInt n );
+void         zzmice_pool_stop  ( void );
+SpiceInt     zzmice_pool_size  ( void );
+void         zzmice_pool_kernel( void );
+SpiceBoolean zzmice_pool_eval  ( SpiceInt           task,
+                                 ConstSpiceChar   * name[],
+                                 SpiceInt           n,
+                                 ConstSpiceDouble * et,
+                                 SpiceDouble      * out,
+                                 SpiceDouble      * lt );
+SpiceBoolean zzmice_pool_gf    ( SpiceInt           task,
+                                 ConstSpiceChar   * name[],
+                                 ConstSpiceDouble * dval,
+                                 SpiceInt           nintvls,
+                                 SpiceCell        * cnfine,
+                                 SpiceCell        * result );
+void         zzmice_pool_reset ( void );
+
+SpiceBoolean zzmice_snap_save  ( ConstSpiceChar   * file );
+SpiceBoolean zzmice_snap_load  ( ConstSpiceChar   * file,
+                                 SpiceInt           nkern,
+                                 ConstSpiceChar  ** kernels );
+
+
+/*
+Tasks of the worker pool, zzmice_pool.c.
+*/
+#define       POOL_SPKEZR        1
+#define       POOL_SPKPOS        2
+#define       POOL_PXFORM        3
+#define       POOL_SXFORM        4
+
+#define       POOL_GFDIST        5
+#define       POOL_GFILUM        6
+#define       POOL_GFOCLT        7
+#define       POOL_GFPA          8
+#define       POOL_GFPOSC        9
+#define       POOL_GFRFOV       10
+#define       POOL_GFRR         11
+#define       POOL_GFSEP        12
+#define       POOL_GFSUBC       13
+#define       POOL_GFTFOV       14
 
 
 /*
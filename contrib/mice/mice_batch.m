@@ -0,0 +1,150 @@
+%-Abstract
+%
+%   MICE_BATCH executes a list of Mice interface calls in a single
+%   call to the MEX library.
+%
+%-Disclaimer
+%
+%   THIS SOFTWARE AND ANY RELATED MATERIALS WERE CREATED BY THE
+%   CALIFORNIA  INSTITUTE OF TECHNOLOGY (CALTECH) UNDER A U.S.
+%   GOVERNMENT CONTRACT WITH THE NATIONAL AERONAUTICS AND SPACE
+%   ADMINISTRATION (NASA). THE SOFTWARE IS TECHNOLOGY AND SOFTWARE
+%   PUBLICLY AVAILABLE UNDER U.S. EXPORT LAWS AND IS PROVIDED
+%   "AS-IS" TO THE RECIPIENT WITHOUT WARRANTY OF ANY KIND, INCLUDING
+%   ANY WARRANTIES OF PERFORMANCE OR MERCHANTABILITY OR FITNESS FOR
+%   A PARTICULAR USE OR PURPOSE (AS SET FORTH IN UNITED STATES UCC
+%   SECTIONS 2312-2313) OR FOR ANY PURPOSE WHATSOEVER, FOR THE
+%   SOFTWARE AND RELATED MATERIALS, HOWEVER USED.
+%
+%   IN NO EVENT SHALL CALTECH, ITS JET PROPULSION LABORATORY,
+%   OR NASA BE LIABLE FOR ANY DAMAGES AND/OR COSTS, INCLUDING,
+%   BUT NOT LIMITED TO, INCIDENTAL OR CONSEQUENTIAL DAMAGES OF
+%   ANY KIND, INCLUDING ECONOMIC DAMAGE OR INJURY TO PROPERTY
+%   AND LOST PROFITS, REGARDLESS OF WHETHER CALTECH, JPL, OR
+%   NASA BE ADVISED, HAVE REASON TO KNOW, OR, IN FACT, SHALL
+%   KNOW OF THE POSSIBILITY.
+%
+%   RECIPIENT BEARS ALL RISK RELATING TO QUALITY AND PERFORMANCE
+%   OF THE SOFTWARE AND ANY RELATED MATERIALS, AND AGREES TO
+%   INDEMNIFY CALTECH AND NASA FOR ALL THIRD-PARTY CLAIMS RESULTING
+%   FROM THE ACTIONS OF RECIPIENT IN THE USE OF THE SOFTWARE.
+%
+%-I/O
+%
+%   Given:
+%
+%      calls   an Nx2 or Nx3 cell array listing the calls to execute,
+%              one per row:
+%
+%              calls{k,1}   the interface name as the cspice_*.m and
+%                           mice_*.m wrappers pass it to the MEX library,
+%                           e.g. 'pxform_c' for cspice_pxform or
+%                           'spkezr_s' for cspice_spkezr/mice_spkezr,
+%                           or a handle returned by mice_batch('plan',...)
+%
+%              calls{k,2}   cell array of the input arguments. Strings
+%                           must be char, double precision values double
+%                           and integers int32, as the wrappers pass them.
+%
+%              calls{k,3}   the number of outputs of the interface,
+%                           1 if the column is absent or empty
+%
+%      names   a cell array of interface names
+%
+%   the call:
+%
+%      out = mice_batch( calls )
+%
+%   returns:
+%
+%      out     an NxM cell array, M the largest number of outputs, the
+%              outputs of the call in row k of 'calls' in row k of 'out'.
+%              The outputs are those of the MEX interface, i.e. a
+%              structure array for 'spkezr_s' (see mice_spkezr).
+%
+%   the call:
+%
+%      handles = mice_batch( 'plan', names )
+%
+%   returns:
+%
+%      handles   1xN int32 array of handles, which may replace the
+%                names in 'calls' to skip the name lookup
+%
+%-Examples
+%
+%      %
+%      % Rotation matrices and states at epochs computed one at a time
+%      % in a loop, without one MEX call per epoch.
+%      %
+%      h = mice_batch( 'plan', {'pxform_c', 'spkezr_s'} );
+%
+%      calls = cell( 2*numel(et), 2 );
+%      for i = 1:numel(et)
+%         calls(2*i-1,:) = { h(1), {'J2000', 'IAU_EARTH', et(i)} };
+%         calls(2*i,  :) = { h(2), {'MOON', et(i), 'J2000', 'LT+S', 'EARTH'} };
+%      end
+%
+%      out = mice_batch( calls );
+%
+%      rotate = out{1,1};
+%      state  = out{2,1}.state;
+%
+%-Particulars
+%
+%   The calls execute in order. A SPICE error in any call signals the
+%   error as the single call would, the outputs of the calls before it
+%   are not returned.
+%
+%-Required Reading
+%
+%   MICE.REQ
+%
+%-Version
+%
+%   -Mice Version 1.0.0, 18-OCT-2026
+%
+%-Index_Entries
+%
+%   execute a list of Mice calls in one MEX call
+%
+%-&
+
+function [out] = mice_batch(varargin)
+
+   switch nargin
+      case 1
+
+         calls = varargin{1};
+         cmd   = 'batch_s';
+
+         if ~iscell(calls)
+            error( 'MICE(BADARG): calls must be a cell array.' )
+         end
+
+      case 2
+
+         if ~strcmp( varargin{1}, 'plan' )
+            error ( 'Usage: [_handles_] = mice_batch( ''plan'', {names} )' )
+         end
+
+         calls = varargin{2};
+         cmd   = 'batch_plan_s';
+
+         if ischar(calls)
+            calls = cellstr(calls);
+         end
+
+      otherwise
+
+         error ( [ 'Usage: [{out}] = mice_batch( {calls} ) or ' ...
+                   '[_handles_] = mice_batch( ''plan'', {names} )' ] )
+
+   end
+
+   try
+      [out] = mice(cmd, calls);
+   catch
+      rethrow(lasterror)
+   end
+
@@ -0,0 +1,177 @@
+%-Abstract
+%
+%   MICE_CKGP_QUAT returns the C-kernel attitude of an instrument at a
+%   series of epochs as quaternions or spin phases, interpolated from a
+%   cache of pointing instances.
+%
+%-Disclaimer
+%
+%   THIS SOFTWARE AND ANY RELATED MATERIALS WERE CREATED BY THE
+%   CALIFORNIA  INSTITUTE OF TECHNOLOGY (CALTECH) UNDER A U.S.
+%   GOVERNMENT CONTRACT WITH THE NATIONAL AERONAUTICS AND SPACE
+%   ADMINISTRATION (NASA). THE SOFTWARE IS TECHNOLOGY AND SOFTWARE
+%   PUBLICLY AVAILABLE UNDER U.S. EXPORT LAWS AND IS PROVIDED
+%   "AS-IS" TO THE RECIPIENT WITHOUT WARRANTY OF ANY KIND, INCLUDING
+%   ANY WARRANTIES OF PERFORMANCE OR MERCHANTABILITY OR FITNESS FOR
+%   A PARTICULAR USE OR PURPOSE (AS SET FORTH IN UNITED STATES UCC
+%   SECTIONS 2312-2313) OR FOR ANY PURPOSE WHATSOEVER, FOR THE
+%   SOFTWARE AND RELATED MATERIALS, HOWEVER USED.
+%
+%   IN NO EVENT SHALL CALTECH, ITS JET PROPULSION LABORATORY,
+%   OR NASA BE LIABLE FOR ANY DAMAGES AND/OR COSTS, INCLUDING,
+%   BUT NOT LIMITED TO, INCIDENTAL OR CONSEQUENTIAL DAMAGES OF
+%   ANY KIND, INCLUDING ECONOMIC DAMAGE OR INJURY TO PROPERTY
+%   AND LOST PROFITS, REGARDLESS OF WHETHER CALTECH, JPL, OR
+%   NASA BE ADVISED, HAVE REASON TO KNOW, OR, IN FACT, SHALL
+%   KNOW OF THE POSSIBILITY.
+%
+%   RECIPIENT BEARS ALL RISK RELATING TO QUALITY AND PERFORMANCE
+%   OF THE SOFTWARE AND ANY RELATED MATERIALS, AND AGREES TO
+%   INDEMNIFY CALTECH AND NASA FOR ALL THIRD-PARTY CLAIMS RESULTING
+%   FROM THE ACTIONS OF RECIPIENT IN THE USE OF THE SOFTWARE.
+%
+%-I/O
+%
+%   Given:
+%
+%      inst   the NAIF ID of the instrument or structure, as for
+%             cspice_ckgp; its spacecraft clock is the one cspice_ckmeta
+%             gives: CK_<inst>_SCLK from the kernel pool if set,
+%             otherwise that of spacecraft fix(inst/1000)
+%
+%             [1,1] = size(inst); int32 = class(inst)
+%
+%      et     epochs in ephemeris seconds past J2000 (TDB)
+%
+%             [1,n] = size(et); double = class(et)
+%
+%      ref    the name of the reference frame of the attitude
+%
+%             [1,m] = size(ref); char = class(ref)
+%
+%      form   optional, 'QUAT' (default) for quaternions, 'SPIN' for
+%             spin phases
+%
+%             [1,l] = size(form); char = class(form)
+%
+%      tol    optional [ticks angle]: the SCLK tolerance as for
+%             cspice_ckgp, default 0, and the bound of the
+%             interpolation error in radians, default 1e-8
+%
+%             [1,2] = size(tol); double = class(tol)
+%
+%   the call:
+%
+%      [att, found] = mice_ckgp_quat( inst, et, ref, [form], [tol] )
+%
+%   returns:
+%
+%      att     for 'QUAT' the 4xN quaternions of the C-matrices of
+%              cspice_ckgp at et, as cspice_m2q gives them; for 'SPIN'
+%              the 1xN spin phases in radians, [0, 2pi): the angle
+%              counterclockwise about the +Z axis of 'ref' from its +X
+%              axis to the projection of the +X axis of 'inst'. NaN
+%              where no pointing is available.
+%
+%      found   1xN logical, true where pointing is available
+%
+%   the call:
+%
+%      mice_ckgp_quat( 'clear' )
+%
+%   frees the cached attitude.
+%
+%-Examples
+%
+%      %
+%      % Spin phase of a spinning spacecraft at the sampling of a wave
+%      % instrument.
+%      %
+%      et             = cspice_str2et( '2026-10-18T10:00:00' ) + (0:1/450:60);
+%      [phase, found] = mice_ckgp_quat( -68000, et, 'J2000', 'SPIN' );
+%
+%-Particulars
+%
+%   cspice_ckgp searches the CK segments for every epoch. When the
+%   attitude is needed at the cadence of the science data, the same
+%   records are searched again for thousands of neighbouring epochs.
+%
+%   mice_ckgp_quat evaluates the pointing once at knots whose spacing
+%   adapts to the attitude motion, keeps their quaternions in memory and
+%   interpolates between them by SLERP. A knot interval is used when the
+%   interpolation agrees with cspice_ckgp at its midpoint within the
+%   angle tolerance and the knots are less than 45 degrees apart; the
+%   latter keeps the test valid for spinning spacecraft. Intervals at
+%   coverage edges or attitude jumps that do not pass down to one
+%   millisecond are not interpolated, epochs in them are evaluated
+%   exactly.
+%
+%   The knots persist between calls for the same instrument, frame and
+%   tolerances, so repeated lookups in a covered interval only search
+%   and interpolate the knots. Loading or unloading kernels frees them.
+%
+%-Required Reading
+%
+%   MICE.REQ
+%   CK.REQ
+%   SCLK.REQ
+%
+%-Version
+%
+%   -Mice Version 1.0.0, 18-OCT-2026
+%
+%-Index_Entries
+%
+%   interpolated C-kernel attitude at a series of epochs
+%   spin phase from a C-kernel
+%
+%-&
+
+function [att, found] = mice_ckgp_quat(varargin)
+
+   form = 'QUAT';
+   tol  = [0 1e-8];
+
+   switch nargin
+      case 1
+
+         if ~strcmp( varargin{1}, 'clear' )
+            error ( 'Usage: mice_ckgp_quat( ''clear'' )' )
+         end
+
+         try
+            mice( 'ckgp_q' );
+         catch
+            rethrow(lasterror)
+         end
+
+         return
+
+      case 3
+
+      case 4
+
+         form = varargin{4};
+
+      case 5
+
+         form = varargin{4};
+         tol  = varargin{5};
+
+      otherwise
+
+         error ( [ 'Usage: [att, found] = mice_ckgp_quat( inst, et(N), ' ...
+                   '`ref`, [`form`], [tol(2)] )' ] )
+
+   end
+
+   %
+   % Call the MEX library.
+   %
+   try
+      [att, found] = mice( 'ckgp_q', varargin{1}, varargin{2}, ...
+                           varargin{3}, double(tol), form );
+   catch
+      rethrow(lasterror)
+   end
+
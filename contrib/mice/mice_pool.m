@@ -0,0 +1,146 @@
+%-Abstract
+%
+%   MICE_POOL starts or stops the worker processes which evaluate large
+%   vectorized Mice calls in parallel.
+%
+%-Disclaimer
+%
+%   THIS SOFTWARE AND ANY RELATED MATERIALS WERE CREATED BY THE
+%   CALIFORNIA  INSTITUTE OF TECHNOLOGY (CALTECH) UNDER A U.S.
+%   GOVERNMENT CONTRACT WITH THE NATIONAL AERONAUTICS AND SPACE
+%   ADMINISTRATION (NASA). THE SOFTWARE IS TECHNOLOGY AND SOFTWARE
+%   PUBLICLY AVAILABLE UNDER U.S. EXPORT LAWS AND IS PROVIDED
+%   "AS-IS" TO THE RECIPIENT WITHOUT WARRANTY OF ANY KIND, INCLUDING
+%   ANY WARRANTIES OF PERFORMANCE OR MERCHANTABILITY OR FITNESS FOR
+%   A PARTICULAR USE OR PURPOSE (AS SET FORTH IN UNITED STATES UCC
+%   SECTIONS 2312-2313) OR FOR ANY PURPOSE WHATSOEVER, FOR THE
+%   SOFTWARE AND RELATED MATERIALS, HOWEVER USED.
+%
+%   IN NO EVENT SHALL CALTECH, ITS JET PROPULSION LABORATORY,
+%   OR NASA BE LIABLE FOR ANY DAMAGES AND/OR COSTS, INCLUDING,
+%   BUT NOT LIMITED TO, INCIDENTAL OR CONSEQUENTIAL DAMAGES OF
+%   ANY KIND, INCLUDING ECONOMIC DAMAGE OR INJURY TO PROPERTY
+%   AND LOST PROFITS, REGARDLESS OF WHETHER CALTECH, JPL, OR
+%   NASA BE ADVISED, HAVE REASON TO KNOW, OR, IN FACT, SHALL
+%   KNOW OF THE POSSIBILITY.
+%
+%   RECIPIENT BEARS ALL RISK RELATING TO QUALITY AND PERFORMANCE
+%   OF THE SOFTWARE AND ANY RELATED MATERIALS, AND AGREES TO
+%   INDEMNIFY CALTECH AND NASA FOR ALL THIRD-PARTY CLAIMS RESULTING
+%   FROM THE ACTIONS OF RECIPIENT IN THE USE OF THE SOFTWARE.
+%
+%-I/O
+%
+%   Given:
+%
+%      n      the number of worker processes, 0 stops the pool.
+%             Default the number of online processors.
+%
+%   the call:
+%
+%      mice_pool( 'start', [n] )
+%      mice_pool( 'stop' )
+%      n = mice_pool( 'size' )
+%
+%   returns:
+%
+%      n      the number of worker processes, 0 if the pool is stopped
+%
+%-Examples
+%
+%      cspice_furnsh( 'thor_kernels.tm' )
+%      mice_pool( 'start' )
+%
+%      %
+%      % Ten years of positions at one minute resolution, split across
+%      % the workers.
+%      %
+%      et  = cspice_str2et( '2020-01-01' ) + (0:60:10*365.25*86400);
+%      pos = cspice_spkpos( 'THOR', et, 'GSE', 'NONE', 'EARTH' );
+%
+%      %
+%      % Eclipses over the same decade, one search per worker.
+%      %
+%      cnfine = cspice_wninsd( et(1), et(end) );
+%      result = cspice_gfoclt( 'ANY', 'EARTH', 'ELLIPSOID', 'IAU_EARTH', ...
+%                              'SUN', 'ELLIPSOID', 'IAU_SUN', 'LT', ...
+%                              'THOR', 60, cnfine, 10000 );
+%
+%      mice_pool( 'stop' )
+%
+%-Particulars
+%
+%   CSPICE is not thread safe, so Mice evaluates a vectorized call on a
+%   single core. With the pool started, cspice_spkezr, cspice_spkpos,
+%   cspice_pxform and cspice_sxform split epoch arrays of more than a
+%   few hundred elements across worker processes forked from MATLAB.
+%   The epochs and results pass through shared memory.
+%
+%   Each worker starts with the kernel pool of the MATLAB session and
+%   loads again the binary kernels the session has loaded, in the same
+%   order and by the absolute paths they were loaded from. Files a
+%   meta-kernel loaded and cspice_unload unloaded since stay unloaded.
+%   cspice_furnsh, cspice_unload, cspice_kclear and the calls assigning
+%   or deleting kernel pool variables (cspice_pdpool, cspice_pipool,
+%   cspice_pcpool, cspice_lmpool, cspice_dvpool, cspice_clpool) stop
+%   the workers, the next parallel call starts new ones with the
+%   changed kernels.
+%
+%   The geometry finder searches cspice_gfdist, cspice_gfilum,
+%   cspice_gfoclt, cspice_gfpa, cspice_gfposc, cspice_gfrfov,
+%   cspice_gfrr, cspice_gfsep, cspice_gfsubc and cspice_gftfov split
+%   the confinement window into one piece of equal measure per worker.
+%   Each worker searches its piece extended by two steps on either side;
+%   the results are cut back to the pieces and joined, intervals which
+%   meet at a piece boundary merging into one. Searches for ABSMAX and
+%   ABSMIN, and windows shorter than 64 steps per worker, run serially.
+%   cspice_gfstol restarts the workers with the new tolerance.
+%
+%   A SPICE error in a worker repeats the call in MATLAB, which signals
+%   the error as without the pool.
+%
+%   Available on Linux and macOS only.
+%
+%-Required Reading
+%
+%   MICE.REQ
+%   KERNEL.REQ
+%
+%-Version
+%
+%   -Mice Version 1.0.0, 18-OCT-2026
+%
+%-Index_Entries
+%
+%   evaluate vectorized Mice calls in parallel processes
+%
+%-&
+
+function [n] = mice_pool(cmd, n)
+
+   switch nargin
+      case 1
+
+         if strcmp( cmd, 'start' )
+            n = feature( 'numcores' );
+         end
+
+      case 2
+
+      otherwise
+
+         error ( [ 'Usage: mice_pool( ''start'', [n] ), ' ...
+                   'mice_pool( ''stop'' ) or n = mice_pool( ''size'' )' ] )
+
+   end
+
+   try
+      if strcmp( cmd, 'start' )
+         [n] = mice( 'pool_s', cmd, double(n) );
+      else
+         [n] = mice( 'pool_s', cmd );
+      end
+   catch
+      rethrow(lasterror)
+   end
+
@@ -0,0 +1,137 @@
+%-Abstract
+%
+%   MICE_PXFORM_VEC rotates a series of position vectors from one
+%   reference frame to another, each at its own epoch.
+%
+%-Disclaimer
+%
+%   THIS SOFTWARE AND ANY RELATED MATERIALS WERE CREATED BY THE
+%   CALIFORNIA  INSTITUTE OF TECHNOLOGY (CALTECH) UNDER A U.S.
+%   GOVERNMENT CONTRACT WITH THE NATIONAL AERONAUTICS AND SPACE
+%   ADMINISTRATION (NASA). THE SOFTWARE IS TECHNOLOGY AND SOFTWARE
+%   PUBLICLY AVAILABLE UNDER U.S. EXPORT LAWS AND IS PROVIDED
+%   "AS-IS" TO THE RECIPIENT WITHOUT WARRANTY OF ANY KIND, INCLUDING
+%   ANY WARRANTIES OF PERFORMANCE OR MERCHANTABILITY OR FITNESS FOR
+%   A PARTICULAR USE OR PURPOSE (AS SET FORTH IN UNITED STATES UCC
+%   SECTIONS 2312-2313) OR FOR ANY PURPOSE WHATSOEVER, FOR THE
+%   SOFTWARE AND RELATED MATERIALS, HOWEVER USED.
+%
+%   IN NO EVENT SHALL CALTECH, ITS JET PROPULSION LABORATORY,
+%   OR NASA BE LIABLE FOR ANY DAMAGES AND/OR COSTS, INCLUDING,
+%   BUT NOT LIMITED TO, INCIDENTAL OR CONSEQUENTIAL DAMAGES OF
+%   ANY KIND, INCLUDING ECONOMIC DAMAGE OR INJURY TO PROPERTY
+%   AND LOST PROFITS, REGARDLESS OF WHETHER CALTECH, JPL, OR
+%   NASA BE ADVISED, HAVE REASON TO KNOW, OR, IN FACT, SHALL
+%   KNOW OF THE POSSIBILITY.
+%
+%   RECIPIENT BEARS ALL RISK RELATING TO QUALITY AND PERFORMANCE
+%   OF THE SOFTWARE AND ANY RELATED MATERIALS, AND AGREES TO
+%   INDEMNIFY CALTECH AND NASA FOR ALL THIRD-PARTY CLAIMS RESULTING
+%   FROM THE ACTIONS OF RECIPIENT IN THE USE OF THE SOFTWARE.
+%
+%-I/O
+%
+%   Given:
+%
+%      from   the name of the reference frame of 'vec'
+%
+%             [1,m] = size(from); char = class(from)
+%
+%      to     the name of the reference frame of the returned vectors
+%
+%             [1,l] = size(to); char = class(to)
+%
+%      et     epochs in ephemeris seconds past J2000 (TDB) at which the
+%             rotation is evaluated
+%
+%             [1,n] = size(et); double = class(et)
+%
+%      vec    the vectors in frame 'from', vec(:,i) at et(i)
+%
+%             [3,n] = size(vec); double = class(vec)
+%
+%      tol    optional bound of the rotation error in radians,
+%             default 1e-10. tol = 0 evaluates the rotation at every
+%             epoch.
+%
+%             [1,1] = size(tol); double = class(tol)
+%
+%   the call:
+%
+%      vout = mice_pxform_vec( from, to, et, vec, [tol] )
+%
+%   returns:
+%
+%      vout   the vectors in frame 'to', vout(:,i) equal to
+%             cspice_pxform( from, to, et(i) ) * vec(:,i) within the
+%             rotation error 'tol'
+%
+%             [3,n] = size(vout); double = class(vout)
+%
+%-Examples
+%
+%      %
+%      % Magnetic field samples from GSE to J2000.
+%      %
+%      et  = cspice_str2et( '2015-10-16T10:33:00' ) + (0:1/128:3600);
+%      bj2 = mice_pxform_vec( 'GSE', 'J2000', et, bgse );
+%
+%-Particulars
+%
+%   cspice_pxform returns a 3x3xN array of rotation matrices which
+%   then multiply the vectors. mice_pxform_vec applies the rotations in
+%   the MEX library and returns only the rotated vectors.
+%
+%   Frames rotating slowly compared to the sampling are evaluated at a
+%   reduced cadence: between two epochs at which the rotation is
+%   computed, it is interpolated by SLERP of the corresponding
+%   quaternions. An interval is used when the interpolated rotation at
+%   its midpoint is within 'tol' of the computed one, otherwise it is
+%   halved; it grows again while the error remains small. Uniform
+%   rotation about a fixed axis, e.g. IAU_EARTH relative to J2000 on
+%   short scales, interpolates without error.
+%
+%   Epochs need not be sorted, but sorted epochs allow the longest
+%   interpolation intervals.
+%
+%-Required Reading
+%
+%   MICE.REQ
+%   FRAMES.REQ
+%   ROTATION.REQ
+%
+%-Version
+%
+%   -Mice Version 1.0.0, 18-OCT-2026
+%
+%-Index_Entries
+%
+%   rotate vectors from one frame to another at a series of epochs
+%
+%-&
+
+function [vout] = mice_pxform_vec(from, to, et, vec, tol)
+
+   switch nargin
+      case 4
+
+         tol = 1e-10;
+
+      case 5
+
+      otherwise
+
+         error ( [ 'Usage: [vout(3,N)] = mice_pxform_vec( `from`, `to`, ' ...
+                   'et(N), vec(3,N), [tol] )' ] )
+
+   end
+
+   %
+   % Call the MEX library.
+   %
+   try
+      [vout] = mice( 'pxform_v', from, to, et, vec, double(tol) );
+   catch
+      rethrow(lasterror)
+   end
+
@@ -0,0 +1,182 @@
+%-Abstract
+%
+%   MICE_SNAPSHOT saves the kernel pool and the list of loaded binary
+%   kernels to a cache file, and restores them from it without parsing
+%   the text kernels again.
+%
+%-Disclaimer
+%
+%   THIS SOFTWARE AND ANY RELATED MATERIALS WERE CREATED BY THE
+%   CALIFORNIA  INSTITUTE OF TECHNOLOGY (CALTECH) UNDER A U.S.
+%   GOVERNMENT CONTRACT WITH THE NATIONAL AERONAUTICS AND SPACE
+%   ADMINISTRATION (NASA). THE SOFTWARE IS TECHNOLOGY AND SOFTWARE
+%   PUBLICLY AVAILABLE UNDER U.S. EXPORT LAWS AND IS PROVIDED
+%   "AS-IS" TO THE RECIPIENT WITHOUT WARRANTY OF ANY KIND, INCLUDING
+%   ANY WARRANTIES OF PERFORMANCE OR MERCHANTABILITY OR FITNESS FOR
+%   A PARTICULAR USE OR PURPOSE (AS SET FORTH IN UNITED STATES UCC
+%   SECTIONS 2312-2313) OR FOR ANY PURPOSE WHATSOEVER, FOR THE
+%   SOFTWARE AND RELATED MATERIALS, HOWEVER USED.
+%
+%   IN NO EVENT SHALL CALTECH, ITS JET PROPULSION LABORATORY,
+%   OR NASA BE LIABLE FOR ANY DAMAGES AND/OR COSTS, INCLUDING,
+%   BUT NOT LIMITED TO, INCIDENTAL OR CONSEQUENTIAL DAMAGES OF
+%   ANY KIND, INCLUDING ECONOMIC DAMAGE OR INJURY TO PROPERTY
+%   AND LOST PROFITS, REGARDLESS OF WHETHER CALTECH, JPL, OR
+%   NASA BE ADVISED, HAVE REASON TO KNOW, OR, IN FACT, SHALL
+%   KNOW OF THE POSSIBILITY.
+%
+%   RECIPIENT BEARS ALL RISK RELATING TO QUALITY AND PERFORMANCE
+%   OF THE SOFTWARE AND ANY RELATED MATERIALS, AND AGREES TO
+%   INDEMNIFY CALTECH AND NASA FOR ALL THIRD-PARTY CLAIMS RESULTING
+%   FROM THE ACTIONS OF RECIPIENT IN THE USE OF THE SOFTWARE.
+%
+%-I/O
+%
+%   Given:
+%
+%      file      the name of the snapshot file
+%
+%      kernels   a kernel file name, or a cell array or character
+%                array of them, as cspice_furnsh accepts them
+%
+%   the call:
+%
+%      mice_snapshot( 'save', file )
+%
+%   writes a snapshot of the loaded kernels to 'file'.
+%
+%   the call:
+%
+%      found = mice_snapshot( 'load', file )
+%
+%   returns:
+%
+%      found   true if no kernel is loaded and 'file' holds a snapshot
+%              whose kernels are all unchanged on disk, in which case
+%              the kernels of the snapshot are loaded; false, with the
+%              kernel pool untouched, otherwise
+%
+%   the call:
+%
+%      found = mice_snapshot( 'furnsh', kernels, file )
+%
+%   restores the snapshot in 'file' if it is valid and was saved from
+%   'kernels', otherwise loads 'kernels' with cspice_furnsh and, if no
+%   other kernel was loaded, saves a new snapshot to 'file'. 'found'
+%   tells which happened.
+%
+%-Examples
+%
+%      %
+%      % A batch job loading the same meta-kernel as thousands of
+%      % others. The first job parses the kernels and writes the
+%      % snapshot, the following ones restore it.
+%      %
+%      mice_snapshot( 'furnsh', 'thor.tm', '/tmp/thor_tm.snap' );
+%
+%      et = cspice_str2et( '2026 OCT 18 12:00' );
+%
+%-Particulars
+%
+%   A snapshot holds the values of all kernel pool variables, the
+%   binary kernels (SPK, CK, binary PCK, DSK, EK) in load order and a
+%   key of every loaded file: size and checksum for text kernels and
+%   meta-kernels, size and modification time for binary kernels.
+%   Restoring a snapshot whose kernels all match their keys assigns the
+%   pool variables and loads the binary kernels again. Editing,
+%   replacing or removing any kernel makes the snapshot stale.
+%
+%   A snapshot is restored only while no kernel is loaded, it never
+%   replaces kernels loaded otherwise. The 'furnsh' call also requires
+%   the kernels loaded at top level when the snapshot was saved to be
+%   'kernels', in the same order, so a snapshot file shared by calls
+%   with different kernels is replaced rather than restored.
+%
+%   The snapshot is written to a temporary file then renamed, so jobs
+%   running concurrently may share a snapshot file.
+%
+%-Restrictions
+%
+%   After a restore cspice_ktotal and cspice_kdata list the binary
+%   kernels only, and cspice_unload of a text or meta-kernel has no
+%   effect; use cspice_kclear to start again.
+%
+%   A snapshot file is specific to the platform writing it.
+%
+%-Required Reading
+%
+%   KERNEL.REQ
+%   MICE.REQ
+%
+%-Version
+%
+%   -Mice Version 1.0.0, 18-OCT-2026
+%
+%-Index_Entries
+%
+%   save and restore the kernel pool
+%   fast kernel loading from a snapshot
+%
+%-&
+
+function [found] = mice_snapshot(varargin)
+
+   switch nargin
+      case 2
+
+         cmd  = varargin{1};
+         file = varargin{2};
+
+         if ~( ischar(cmd) && any( strcmp( cmd, {'save', 'load'} ) ) )
+            error ( [ 'Usage: mice_snapshot( ''save'', `file` ) or ' ...
+                      '[found] = mice_snapshot( ''load'', `file` )' ] )
+         end
+
+      case 3
+
+         if ~strcmp( varargin{1}, 'furnsh' )
+            error ( [ 'Usage: [found] = mice_snapshot( ''furnsh'', ' ...
+                      '_`kernels`_, `file` )' ] )
+         end
+
+         kernels = zzmice_str( varargin{2} );
+         file    = varargin{3};
+
+         try
+            [found] = mice( 'snapshot_s', 'load', file, kernels );
+         catch
+            rethrow(lasterror)
+         end
+
+         if ~found
+            loaded = cspice_ktotal( 'ALL' );
+
+            cspice_furnsh( kernels );
+
+            if loaded == 0
+               mice_snapshot( 'save', file );
+            end
+         end
+
+         return
+
+      otherwise
+
+         error ( [ 'Usage: mice_snapshot( ''save'', `file` ), ' ...
+                   '[found] = mice_snapshot( ''load'', `file` ) or ' ...
+                   '[found] = mice_snapshot( ''furnsh'', _`kernels`_, ' ...
+                   '`file` )' ] )
+
+   end
+
+   try
+      if strcmp( cmd, 'save' )
+         mice( 'snapshot_s', cmd, file );
+         found = true;
+      else
+         [found] = mice( 'snapshot_s', cmd, file );
+      end
+   catch
+      rethrow(lasterror)
+   end
+
@@ -0,0 +1,155 @@
+%-Abstract
+%
+%   MICE_SPKEZR_HERMITE returns the states of a target body relative to
+%   an observing body, interpolated within a given error bound from
+%   states cached at adaptively spaced epochs.
+%
+%-Disclaimer
+%
+%   THIS SOFTWARE AND ANY RELATED MATERIALS WERE CREATED BY THE
+%   CALIFORNIA  INSTITUTE OF TECHNOLOGY (CALTECH) UNDER A U.S.
+%   GOVERNMENT CONTRACT WITH THE NATIONAL AERONAUTICS AND SPACE
+%   ADMINISTRATION (NASA). THE SOFTWARE IS TECHNOLOGY AND SOFTWARE
+%   PUBLICLY AVAILABLE UNDER U.S. EXPORT LAWS AND IS PROVIDED
+%   "AS-IS" TO THE RECIPIENT WITHOUT WARRANTY OF ANY KIND, INCLUDING
+%   ANY WARRANTIES OF PERFORMANCE OR MERCHANTABILITY OR FITNESS FOR
+%   A PARTICULAR USE OR PURPOSE (AS SET FORTH IN UNITED STATES UCC
+%   SECTIONS 2312-2313) OR FOR ANY PURPOSE WHATSOEVER, FOR THE
+%   SOFTWARE AND RELATED MATERIALS, HOWEVER USED.
+%
+%   IN NO EVENT SHALL CALTECH, ITS JET PROPULSION LABORATORY,
+%   OR NASA BE LIABLE FOR ANY DAMAGES AND/OR COSTS, INCLUDING,
+%   BUT NOT LIMITED TO, INCIDENTAL OR CONSEQUENTIAL DAMAGES OF
+%   ANY KIND, INCLUDING ECONOMIC DAMAGE OR INJURY TO PROPERTY
+%   AND LOST PROFITS, REGARDLESS OF WHETHER CALTECH, JPL, OR
+%   NASA BE ADVISED, HAVE REASON TO KNOW, OR, IN FACT, SHALL
+%   KNOW OF THE POSSIBILITY.
+%
+%   RECIPIENT BEARS ALL RISK RELATING TO QUALITY AND PERFORMANCE
+%   OF THE SOFTWARE AND ANY RELATED MATERIALS, AND AGREES TO
+%   INDEMNIFY CALTECH AND NASA FOR ALL THIRD-PARTY CLAIMS RESULTING
+%   FROM THE ACTIONS OF RECIPIENT IN THE USE OF THE SOFTWARE.
+%
+%-I/O
+%
+%   Given:
+%
+%      targ     the name of the target body, as for cspice_spkezr
+%
+%      et       the ephemeris times, expressed as seconds past J2000
+%               TDB, a double scalar or 1xN array
+%
+%      ref      the name of the reference frame
+%
+%      abcorr   the aberration correction flag
+%
+%      obs      the name of the observing body
+%
+%      tol      optional [ptol vtol], the bounds of the interpolation
+%               error in position (km) and velocity (km/s).
+%               Default [1e-3 1e-6].
+%
+%   the call:
+%
+%      state = mice_spkezr_hermite( targ, et, ref, abcorr, obs, [tol] )
+%
+%   returns:
+%
+%      state    6xN double array of the states of 'targ' at 'et', the
+%               position (km) in state(1:3,:), the velocity (km/s) in
+%               state(4:6,:)
+%
+%   the call:
+%
+%      mice_spkezr_hermite( 'clear' )
+%
+%   frees the cached states.
+%
+%-Examples
+%
+%      %
+%      % Spacecraft position at the 128 samples/s of a field instrument.
+%      %
+%      cspice_furnsh( 'mms1_kernels.tm' )
+%
+%      et    = cspice_str2et( '2015-10-16T10:33:00' ) + (0:1/128:3600);
+%      state = mice_spkezr_hermite( '-140', et, 'J2000', 'NONE', 'EARTH' );
+%
+%-Particulars
+%
+%   cspice_spkezr evaluates the ephemeris at every epoch. Data sampled
+%   much faster than the ephemeris changes spend most of that time on
+%   states which a low order interpolation gives as well.
+%
+%   mice_spkezr_hermite computes states at knots whose spacing adapts to
+%   'tol': an interval between two knots is accepted when the cubic
+%   Hermite interpolation through the knot positions and velocities
+%   agrees with the state at the interval midpoint within 'tol',
+%   otherwise it is halved. The position returned is the Hermite cubic,
+%   the velocity its derivative.
+%
+%   The knots remain in memory for the same target, frame, correction,
+%   observer and tolerance, so later calls for overlapping epochs do not
+%   evaluate the ephemeris again. Loading or unloading kernels with
+%   cspice_furnsh, cspice_unload or cspice_kclear frees them.
+%
+%   Knots are not spaced closer than one second, for bounds below the
+%   numerical noise of the ephemeris the returned error exceeds 'tol'.
+%
+%-Required Reading
+%
+%   MICE.REQ
+%   SPK.REQ
+%
+%-Version
+%
+%   -Mice Version 1.0.0, 18-OCT-2026
+%
+%-Index_Entries
+%
+%   interpolated state of target body relative to observer
+%
+%-&
+
+function [state] = mice_spkezr_hermite(varargin)
+
+   switch nargin
+      case 1
+
+         if ~strcmp( varargin{1}, 'clear' )
+            error ( 'Usage: mice_spkezr_hermite( ''clear'' )' )
+         end
+
+         try
+            mice( 'spkezr_h' );
+         catch
+            rethrow(lasterror)
+         end
+
+         return
+
+      case 5
+
+         tol = [1e-3 1e-6];
+
+      case 6
+
+         tol = varargin{6};
+
+      otherwise
+
+         error ( [ 'Usage: [state(6,N)] = mice_spkezr_hermite( `targ`, ' ...
+                   'et(N), `ref`, `abcorr`, `obs`, [tol(2)] )' ] )
+
+   end
+
+   %
+   % Call the MEX library.
+   %
+   try
+      [state] = mice( 'spkezr_h', varargin{1}, varargin{2}, varargin{3}, ...
+                      varargin{4}, varargin{5}, double(tol) );
+   catch
+      rethrow(lasterror)
+   end
+
@@ -74,6 +74,9 @@
    name_s maps to a mice_name and cspice_name call from MATLAB where
    "name" represents the call base name.
 
+   A "name" with format name_m maps to a variant of the name_s call
+   returning plain arrays instead of a structure array.
+
    Update this list to add a new interface call to Mice.
 
 -Examples
@@ -228,6 +231,8 @@ static struct npf
      { "axisar_c", &cspice_axisar },
      { "b1900_c",  &cspice_b1900  },
      { "b1950_c",  &cspice_b1950  },
+     { "batch_plan_s", &mice_batch_plan },
+     { "batch_s",  &mice_batch    },
      { "bodc2n_s", &mice_bodc2n   },
      { "bodc2s_s", &mice_bodc2s   },
      { "boddef_c", &cspice_boddef },
@@ -240,6 +245,7 @@ static struct npf
      { "ckcls_c",  &cspice_ckcls  },
      { "ckcov_c",  &cspice_ckcov  },
      { "ckgp_c",   &cspice_ckgp   },
+     { "ckgp_q",   &mice_ckgp_q   },
      { "ckgpav_c", &cspice_ckgpav },
      { "ckobj_c",  &cspice_ckobj  },
      { "ckopn_c",  &cspice_ckopn  },
@@ -369,8 +375,10 @@ static struct npf
      { "pl2nvc_c", &cspice_pl2nvc },
      { "pl2nvp_c", &cspice_pl2nvp },
      { "pl2psv_c", &cspice_pl2psv },
+     { "pool_s",   &mice_pool     },
      { "psv2pl_c", &cspice_psv2pl },
      { "pxform_c", &cspice_pxform },
+     { "pxform_v", &mice_pxform_v },
      { "pxfrm2_c", &cspice_pxfrm2 },
      { "q2m_c",    &cspice_q2m    },
      { "radrec_c", &cspice_radrec },
@@ -394,6 +402,7 @@ static struct npf
      { "sct2e_c",  &cspice_sct2e  },
      { "sctiks_c", &cspice_sctiks },
      { "sincpt_s", &mice_sincpt   },
+     { "snapshot_s", &mice_snapshot },
      { "spd_c",    &cspice_spd    },
      { "sphcyl_c", &cspice_sphcyl },
      { "sphlat_c", &cspice_sphlat },
@@ -404,9 +413,12 @@ static struct npf
      { "spkcpt_s", &mice_spkcpt   },
      { "spkcvo_s", &mice_spkcvo   },
      { "spkcvt_s", &mice_spkcvt   },
+     { "spkezr_h", &mice_spkezr_h },
+     { "spkezr_m", &mice_spkezr_m },
      { "spkezr_s", &mice_spkezr   },
      { "spkobj_c", &cspice_spkobj },
      { "spkopn_c", &cspice_spkopn },
+     { "spkpos_m", &mice_spkpos_m },
      { "spkpos_s", &mice_spkpos   },
      { "spkpvn_s", &mice_spkpvn   },
      { "spksfs_s", &mice_spksfs   },
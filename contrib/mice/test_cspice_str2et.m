@@ -0,0 +1,130 @@
+classdef test_cspice_str2et < matlab.unittest.TestCase
+	%TEST_CSPICE_STR2ET batched cspice_str2et against the row by row call
+	%
+	% A char matrix of at least 16 ISO-8601 rows is parsed by the batched
+	% path of mice.c (iso_parse), a single row by str2et_c. Both must give
+	% the same ephemeris times, bit for bit. The test loads a leap seconds
+	% kernel of its own and is skipped without the mice mex file.
+
+	properties
+		lskFile
+	end
+
+	methods (TestClassSetup)
+		function load_lsk(testCase)
+			testCase.assumeEqual(exist('mice','file'),3,'mice is not compiled');
+			testCase.lskFile = [tempname '.tls'];
+			fid = fopen(testCase.lskFile,'w');
+			fprintf(fid,'KPL/LSK\n\n\\begindata\n\n');
+			fprintf(fid,'DELTET/DELTA_T_A = 32.184\n');
+			fprintf(fid,'DELTET/K = 1.657D-3\n');
+			fprintf(fid,'DELTET/EB = 1.671D-2\n');
+			fprintf(fid,'DELTET/M = ( 6.239996D0 1.99096871D-7 )\n');
+			fprintf(fid,'DELTET/DELTA_AT = ( 10, @1972-JAN-1\n');
+			leap = {'1972-JUL-1','1973-JAN-1','1974-JAN-1','1975-JAN-1',...
+				'1976-JAN-1','1977-JAN-1','1978-JAN-1','1979-JAN-1','1980-JAN-1',...
+				'1981-JUL-1','1982-JUL-1','1983-JUL-1','1985-JUL-1','1988-JAN-1',...
+				'1990-JAN-1','1991-JAN-1','1992-JUL-1','1993-JUL-1','1994-JUL-1',...
+				'1996-JAN-1','1997-JUL-1','1999-JAN-1','2006-JAN-1','2009-JAN-1',...
+				'2012-JUL-1','2015-JUL-1','2017-JAN-1'};
+			for k = 1:length(leap)
+				fprintf(fid,'                     %d, @%s\n',10+k,leap{k});
+			end
+			fprintf(fid,'                   )\n\n\\begintext\n');
+			fclose(fid);
+			cspice_furnsh(testCase.lskFile);
+			testCase.addTeardown(@() cspice_unload(testCase.lskFile));
+			testCase.addTeardown(@() delete(testCase.lskFile));
+		end
+	end
+
+	methods (Test)
+		function test_random_rows(testCase)
+			% random dates with 'T' and blank separators and 0 to 13
+			% fraction digits, rows of different length
+			rng(42);
+			n = 5000;
+			t = datenum(1960,1,1) + rand(n,1)*80*365.25;
+			t(1:10:end) = datenum(1583,1,1) + rand(ceil(n/10),1)*8000*365.25;
+			rows = cell(n,1);
+			for i = 1:n
+				rows{i} = [datestr(t(i),'yyyy-mm-dd') 'T' datestr(t(i),'HH:MM:SS')];
+				if rand < 0.5, rows{i}(11) = ' '; end
+				nFrac = randi([0 13]);
+				if nFrac > 0
+					rows{i} = [rows{i} '.' char('0'+randi([0 9],1,nFrac))];
+				end
+			end
+			verify_rows(testCase,rows);
+		end
+		function test_fractional_seconds(testCase)
+			% carry of 59.999... into the next minute, day and year
+			rows = {'2015-12-31T23:59:59.9999999999999'
+				'2015-12-31T23:59:59.999999999'
+				'2015-12-31T23:59:59.5'
+				'2016-02-28T23:59:59.99999999'
+				'2016-02-29 23:59:59.0000001'
+				'2000-01-01T11:58:55.816'
+				'2000-01-01T12:00:00.'
+				'2000-01-01T12:00:00.000000000000000000000001'
+				'1999-12-31T23:59:59.99999999999999999'
+				'2010-06-15T06:30:00.1'
+				'2010-06-15T06:30:00.12'
+				'2010-06-15T06:30:00.123'
+				'2010-06-15T06:30:00.1234'
+				'2010-06-15T06:30:00.12345'
+				'2010-06-15T06:30:00.123456'
+				'2010-06-15T06:30:00.1234567'
+				'2010-06-15T06:30:00.12345678'
+				'2010-06-15T06:30:00.123456789'};
+			verify_rows(testCase,rows);
+		end
+		function test_leap_second_days(testCase)
+			% days ending in a leap second, the second itself is left to
+			% str2et_c by the batched path
+			days = {'1972-06-30','1972-12-31','1998-12-31','2005-12-31',...
+				'2008-12-31','2012-06-30','2015-06-30','2016-12-31'};
+			times = {'T00:00:00','T12:00:00.5','T23:59:58.999999','T23:59:59',...
+				'T23:59:59.5','T23:59:59.999999999','T23:59:60','T23:59:60.25',...
+				'T23:59:60.999999'};
+			rows = cell(length(days)*length(times),1);
+			k = 0;
+			for d = 1:length(days)
+				for m = 1:length(times)
+					k = k + 1;
+					rows{k} = [days{d} times{m}];
+				end
+			end
+			verify_rows(testCase,rows);
+		end
+		function test_mixed_forms(testCase)
+			% rows the batched path leaves to str2et_c among those it parses
+			rows = {'2016-01-01T00:00:00'
+				'2016 JAN 01 00:00:00'
+				'2016-001T00:00:00'
+				'2016-01-01T00:00'
+				'1582-10-15T00:00:00'
+				'1600-02-29T00:00:00'
+				'2016-01-01 00:00:00.5 TDB'
+				'2016-01-01T00:00:00.5'
+				'JD 2451545.0'
+				'2016-12-31T23:59:60'
+				'2017-01-01T00:00:00'
+				'2017-01-01 00:00:00.000001'
+				'9999-12-31T23:59:59.999'
+				'2000-01-01T12:00:00'
+				'2000-01-01T12:00:00'
+				'2000-01-01T12:00:00'};
+			verify_rows(testCase,rows);
+		end
+	end
+end
+
+function verify_rows(testCase,rows)
+% the rows as one char matrix and row by row
+et = cspice_str2et(char(rows));
+testCase.verifySize(et,[1 length(rows)]);
+for i = 1:length(rows)
+	testCase.verifyEqual(et(i),cspice_str2et(rows{i}),rows{i});
+end
+end
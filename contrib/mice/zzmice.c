@@ -87,6 +87,12 @@
 
 -Version
 
+   -Mice Version 1.3.0 18-OCT-2026
+
+      mice_checkargs validates against per-interface plans and returns
+      the vectorization state in per-call frames. The former table walk
+      is zzmice_walkargs.
+
    -Mice Version 1.2.0 30-OCT-2012 (EDW)
 
       Added definitions and conditions for MiceFrinfo, MiceSFS,
@@ -111,6 +117,8 @@
 */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "SpiceUsr.h"
 #include "SpiceZmc.h"
 #include "mex.h"
@@ -584,7 +592,7 @@ void struct_fields( enum   MiceType          type,
 
 
 /*
--Procedure mice_checkargs ( argument checking routine )
+-Procedure zzmice_walkargs ( argument checking, full table walk )
 
 -Abstract
 
@@ -656,11 +664,12 @@ void struct_fields( enum   MiceType          type,
 
 -&
 */
-struct extra_dims  * mice_checkargs(int                 nlhs,
-                                    mxArray           * plhs[],
-                                    int                 nrhs,
-                                    const mxArray     * prhs[],
-                                    struct argcheck   * argcheck)
+static void zzmice_walkargs(int                 nlhs,
+                            mxArray           * plhs[],
+                            int                 nrhs,
+                            const mxArray     * prhs[],
+                            struct argcheck   * argcheck,
+                            struct extra_dims * extra)
    {
    SpiceInt                    ii;
    SpiceInt                i;
@@ -683,25 +692,9 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
 
    const enum MiceType   * ftypes;
 
-   /* for vectorizable functions */
-   static struct           extra_dims extra;
-
    /*
-   Initialize  the 'extra' fields.
-   */
-   extra.count = 0;
+   The caller initialized the 'extra' fields, see mice_checkargs.
 
-   /*
-   Clunky implementation, but obvious as regards function.
-   */
-   for (i=0; i<32; i++)
-      {
-      extra.vectorized[i] = -1;
-      extra.offset[i]     =  0;
-      }
-
-
-   /*
    Argument check index for descriptions in ArgCheck.
    */
    ii = 0;
@@ -925,7 +918,7 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
            mxGetClassID(prhs[i]) == mxINT32_CLASS )
          {
 
-         extra.vectorized[ii] = 0;
+         extra->vectorized[ii] = 0;
 
          /*
          The following blocks assumes error checks confirmed 'arg_dimension'
@@ -933,7 +926,7 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
          */
          if ( arg_dimension == 3 )
             {
-            extra.vectorized[ii] = 1;
+            extra->vectorized[ii] = 1;
             }
          else
             {
@@ -941,14 +934,14 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
                 && Dims[1]  > 1
                 && argcheck[ii].min_dims == 0 )
                {
-               extra.vectorized[ii] = 1;
+               extra->vectorized[ii] = 1;
                }
 
             if(     (Dims[0]               == argcheck[ii].dims[0])
                 &&  (argcheck[ii].min_dims == 1)
                 &&  (Dims[1]               >  1) )
                {
-               extra.vectorized[ii] = 1;
+               extra->vectorized[ii] = 1;
                }
 
             }
@@ -997,12 +990,12 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
             Store the required measure of vectorization for all vectorized
             arguments.
             */
-            if (extra.count == 0)
+            if (extra->count == 0)
                {
-               extra.first_vector_arg_index = ii;
-               extra.count                  = vec_measure;
+               extra->first_vector_arg_index = ii;
+               extra->count                  = vec_measure;
                }
-            else if (extra.count != vec_measure)
+            else if (extra->count != vec_measure)
                {
                sprintf( msg,
                         "MICE(BADARG): Input argument (`%s') "
@@ -1010,8 +1003,8 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
                         "have same measure as `%s', %ld",
                         argcheck[ii].name,
                         (long) vec_measure,
-                        argcheck[extra.first_vector_arg_index].name,
-                        (long) extra.count
+                        argcheck[extra->first_vector_arg_index].name,
+                        (long) extra->count
                         );
 
                mexErrMsgTxt(msg);
@@ -1020,7 +1013,7 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
             }
 
 
-         if (!argcheck[ii].is_vectorizable && extra.vectorized[ii])
+         if (!argcheck[ii].is_vectorizable && extra->vectorized[ii])
             {
             sprintf(msg,
                "Input argument (`%s') is not vectorizable.",
@@ -1030,22 +1023,22 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
             }
 
 
-         if ( argcheck[ii].is_vectorizable && extra.vectorized[ii] )
+         if ( argcheck[ii].is_vectorizable && extra->vectorized[ii] )
             {
             n = 2;
 
             switch ( argcheck[ii].min_dims )
                {
                case 0:
-                  extra.offset[ii] = 1;
+                  extra->offset[ii] = 1;
                   break;
 
                case 1:
-                  extra.offset[ii] = argcheck[ii].dims[0];
+                  extra->offset[ii] = argcheck[ii].dims[0];
                   break;
 
                case 2:
-                  extra.offset[ii] = argcheck[ii].dims[0]
+                  extra->offset[ii] = argcheck[ii].dims[0]
                                    * argcheck[ii].dims[1];
                   break;
 
@@ -1179,23 +1172,23 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
                      as with vectorized inputs to ensure the required
                      consistency in column length.
                      */
-                     if (extra.count == 0)
+                     if (extra->count == 0)
                         {
-                        extra.first_vector_arg_index = ii;
-                        extra.count                  = Dims[1];
+                        extra->first_vector_arg_index = ii;
+                        extra->count                  = Dims[1];
                         }
-                     else if (extra.count != Dims[1])
+                     else if (extra->count != Dims[1])
                         {
                         sprintf( msg,
                            "Input argument (`%s') must have "
                            "same length as `%s'",
                            argcheck[ii].name,
-                           argcheck[extra.first_vector_arg_index].name);
+                           argcheck[extra->first_vector_arg_index].name);
 
                         mexErrMsgTxt(msg);
                         }
 
-                     extra.vectorized[ii] = 1;
+                     extra->vectorized[ii] = 1;
 
                      }
                   else
@@ -1255,15 +1248,15 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
          In this case, we use the string length as the offset.
          Assume the variable as not vectorized till proven otherwise.
          */
-         extra.offset[ii]     = Dims[1];
-         extra.vectorized[ii] = 0;
+         extra->offset[ii]     = Dims[1];
+         extra->vectorized[ii] = 0;
 
          if( Dims[0] > 1 )
             {
-            extra.vectorized[ii] = 1;
+            extra->vectorized[ii] = 1;
             }
 
-         if (!argcheck[ii].is_vectorizable && extra.vectorized[ii])
+         if (!argcheck[ii].is_vectorizable && extra->vectorized[ii])
             {
             sprintf( msg,
                      "MICE(BADARG): Input argument (`%s') "
@@ -1273,25 +1266,25 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
             mexErrMsgTxt(msg);
             }
 
-         if (argcheck[ii].is_vectorizable && extra.vectorized[ii])
+         if (argcheck[ii].is_vectorizable && extra->vectorized[ii])
             {
 
             /*
             Store the size of the input vector for return to the
             interface call.
             */
-            if (extra.count == 0)
+            if (extra->count == 0)
                {
-               extra.first_vector_arg_index = ii;
-               extra.count                  = Dims[0];
+               extra->first_vector_arg_index = ii;
+               extra->count                  = Dims[0];
                }
-            else if (extra.count != Dims[0] )
+            else if (extra->count != Dims[0] )
                {
                sprintf( msg,
                         "MICE(BADARG): Input argument (`%s') "
                         "must have the same vectorization measure as `%s'",
                         argcheck[ii].name,
-                        argcheck[extra.first_vector_arg_index].name);
+                        argcheck[extra->first_vector_arg_index].name);
 
                mexErrMsgTxt(msg);
                }
@@ -1309,14 +1302,14 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
 
          Vectorized structure: 1 x N
          */
-         extra.vectorized[ii] = 0;
+         extra->vectorized[ii] = 0;
 
          if( Dims[1] > 1 )
             {
-            extra.vectorized[ii] = 1;
+            extra->vectorized[ii] = 1;
             }
 
-         if (!argcheck[ii].is_vectorizable && extra.vectorized[ii])
+         if (!argcheck[ii].is_vectorizable && extra->vectorized[ii])
             {
             sprintf( msg,
                      "MICE(BADARG): Input argument (`%s') "
@@ -1326,25 +1319,25 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
             mexErrMsgTxt(msg);
             }
 
-         if (argcheck[ii].is_vectorizable && extra.vectorized[ii])
+         if (argcheck[ii].is_vectorizable && extra->vectorized[ii])
             {
 
             /*
             Store the size of the input vector for return to the
             interface call.
             */
-            if (extra.count == 0)
+            if (extra->count == 0)
                {
-               extra.first_vector_arg_index = ii;
-               extra.count                  = Dims[1];
+               extra->first_vector_arg_index = ii;
+               extra->count                  = Dims[1];
                }
-            else if (extra.count != Dims[0] )
+            else if (extra->count != Dims[0] )
                {
                sprintf( msg,
                         "MICE(BADARG): Input argument (`%s') "
                         "must have the same vectorization measure as `%s'",
                         argcheck[ii].name,
-                        argcheck[extra.first_vector_arg_index].name);
+                        argcheck[extra->first_vector_arg_index].name);
 
                mexErrMsgTxt(msg);
                }
@@ -1402,7 +1395,7 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
         - vectorized matrix [N,M,R], i.e. R versions of
           a [N,M] matrix.
 
-      extra.count describes the measure of vectorization (R).
+      extra->count describes the measure of vectorization (R).
       */
 
       if ( argcheck[ii].min_dims != 0 &&
@@ -1456,29 +1449,29 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
                {
                n                = 2;
                sizearray[0]     = 1;
-               sizearray[1]     = extra.count;
+               sizearray[1]     = extra->count;
 
-               extra.offset[ii] = 1;
+               extra->offset[ii] = 1;
                }
             else if (argcheck[ii].min_dims == 1)
                {
                n                = 2;
                sizearray[0]     = argcheck[ii].dims[0];
-               sizearray[1]     = extra.count;
+               sizearray[1]     = extra->count;
 
-               extra.offset[ii] = argcheck[ii].dims[0];
+               extra->offset[ii] = argcheck[ii].dims[0];
                }
             else if (argcheck[ii].min_dims == 2)
                {
                n                = 3;
                sizearray[0]     = argcheck[ii].dims[0];
                sizearray[1]     = argcheck[ii].dims[1];
-               sizearray[2]     = extra.count;
+               sizearray[2]     = extra->count;
 
-               extra.offset[ii] = argcheck[ii].dims[1] * argcheck[ii].dims[0];
+               extra->offset[ii] = argcheck[ii].dims[1] * argcheck[ii].dims[0];
                }
 
-            extra.vectorized[ii] = 1;
+            extra->vectorized[ii] = 1;
 
             }
          else
@@ -1513,7 +1506,7 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
                }
 
             n = 2;
-            extra.vectorized[ii] = 0;
+            extra->vectorized[ii] = 0;
 
             }
 
@@ -1554,8 +1547,8 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
          if (argcheck[ii].is_vectorizable && vec_flag)
             {
 
-            n                = extra.count;
-            extra.offset[ii] = 1;
+            n                = extra->count;
+            extra->offset[ii] = 1;
 
             }
          else
@@ -1631,10 +1624,822 @@ struct extra_dims  * mice_checkargs(int                 nlhs,
       ii++;
       }
 
-   return &extra;
+   return;
+   }
+
+
+
+
+
+
+
+
+
+/*
+Argument validation plans and call frames.
+
+mexFunction allocates one plan slot per NPF entry when it builds the
+hash table, and enters a call frame holding the slot before it calls the
+interface. The first call of an interface records its ArgCheck table in
+the slot along with the values mice_checkargs derives from it (expected
+class, vectorization offset, output shape, structure fields); later
+calls check the arguments against the plan without walking the table.
+A slot keeps one plan per distinct ArgCheck table, so interfaces with
+optional arguments get one plan per argument count.
+
+The vectorization state lives in the frame, not in a static, so an
+interface called from within another (mice_batch) keeps its own state.
+Any argument the plan does not accept goes through zzmice_walkargs,
+which signals the same errors as always.
+*/
+
+#define  PLAN_MIN_ARGS     32
+#define  PLAN_MAX_DEPTH    8
+#define  PLAN_MAX_CHAIN    8
+
+#define  PLAN_WALK         0
+#define  PLAN_DOUBLE       1
+#define  PLAN_INT          2
+#define  PLAN_CHAR         3
+#define  PLAN_STRUCT       4
+#define  PLAN_IGNORE       5
+
+struct argplan
+   {
+   int                     kind;
+   mxClassID               class;
+   SpiceInt                offset;
+   int                     ndim;
+   int                     size[3];
+   SpiceInt                nfields;
+   const char           ** fnames;
+   const enum MiceType   * ftypes;
+   const int             * fsizes;
+   };
+
+struct checkplan
+   {
+   int                     nlhs;
+   int                     nrhs;
+   SpiceInt                narg;
+   SpiceBoolean            uninit;
+   struct argcheck       * argcheck;
+   struct argplan        * arg;
+   struct checkplan      * next;
+   };
+
+struct checkframe
+   {
+   SpiceInt                slot;
+   SpiceInt                size;
+   struct extra_dims       extra;
+   };
+
+static struct checkplan ** plans  = NULL;
+static SpiceInt            nplans = 0;
+
+static struct checkframe   frames[PLAN_MAX_DEPTH+1];
+static int                 depth  = 0;
+
+
+
+
+/*
+-Procedure zzmice_plans_init ( allocate the validation plan slots )
+*/
+void zzmice_plans_init( SpiceInt n )
+   {
+
+   zzmice_plans_free();
+
+   plans = (struct checkplan **)calloc( n, sizeof(struct checkplan *) );
+
+   if ( plans == NULL )
+      {
+      mexErrMsgTxt( "MICE(MALLOCFAILED): calloc failed for the argument "
+                    "plans. This is a fatal error. Please contact NAIF.");
+      }
+
+   nplans = n;
+   }
+
+
+
+
+/*
+-Procedure zzmice_plans_free ( free the validation plans and frames )
+*/
+void zzmice_plans_free( void )
+   {
+   struct checkplan      * p;
+   SpiceInt                i;
+
+   for ( i=0; i<nplans; i++ )
+      {
+      while ( (p = plans[i]) != NULL )
+         {
+         plans[i] = p->next;
+         free( p->argcheck );
+         free( p->arg );
+         free( p );
+         }
+      }
+
+   free( plans );
+   plans  = NULL;
+   nplans = 0;
+
+   for ( i=0; i<=PLAN_MAX_DEPTH; i++ )
+      {
+      free( frames[i].extra.vectorized );
+      memset( &frames[i], 0, sizeof(frames[i]) );
+      }
+
+   depth = 0;
+   }
+
+
+
+
+/*
+-Procedure zzmice_enter ( enter the call frame of an interface )
+
+   'slot' is the NPF index of the interface, -1 if unknown. mexFunction
+   calls zzmice_reset first as an error in a previous call leaves the
+   frames of that call entered.
+*/
+void zzmice_enter( SpiceInt slot )
+   {
+
+   if ( depth >= PLAN_MAX_DEPTH )
+      {
+      mexErrMsgTxt( "MICE(BUG): Interface calls nested too deeply. "
+                    "This indicates an interface bug. Contact NAIF.");
+      }
+
+   depth++;
+   frames[depth].slot = ( slot >= 0 && slot < nplans ) ? slot : -1;
+   }
+
+
+
+void zzmice_leave( void )
+   {
+
+   if ( depth > 0 )
+      {
+      depth--;
+      }
+
+   }
+
+
+
+void zzmice_reset( void )
+   {
+   depth = 0;
+   }
+
+
+
+
+/*
+-Procedure zzplan_build ( derive a validation plan from ArgCheck )
+
+   Returns NULL if the table has entries the plan cannot describe;
+   the interface then always walks its table.
+*/
+static struct checkplan * zzplan_build( int                nlhs,
+                                        int                nrhs,
+                                        struct argcheck  * argcheck )
+   {
+   struct checkplan      * plan;
+   struct argplan        * a;
+   struct argcheck       * c;
+   SpiceInt                narg = nrhs - 1 + nlhs;
+   SpiceInt                i;
+
+   plan = (struct checkplan *)calloc( 1, sizeof(struct checkplan) );
+
+   if ( plan == NULL )
+      {
+      return NULL;
+      }
+
+   plan->nlhs     = nlhs;
+   plan->nrhs     = nrhs;
+   plan->narg     = narg;
+   plan->uninit   = SPICETRUE;
+   plan->argcheck = (struct argcheck *)malloc(
+                                   MaxVal(narg,1) * sizeof(struct argcheck) );
+   plan->arg      = (struct argplan  *)calloc(
+                                   MaxVal(narg,1), sizeof(struct argplan) );
+
+   if ( plan->argcheck == NULL || plan->arg == NULL )
+      {
+      free( plan->argcheck );
+      free( plan->arg );
+      free( plan );
+      return NULL;
+      }
+
+   memcpy( plan->argcheck, argcheck, narg * sizeof(struct argcheck) );
+
+   for ( i=0; i<narg; i++ )
+      {
+      c = argcheck   + i;
+      a = plan->arg  + i;
+
+      a->kind = PLAN_WALK;
+
+      if ( c->min_dims < 0 || c->min_dims > 2 )
+         {
+         continue;
+         }
+
+      /*
+      The offset of a vectorized argument, as zzmice_walkargs sets it.
+      */
+      switch ( c->min_dims )
+         {
+         case 0:  a->offset = 1;                       break;
+         case 1:  a->offset = c->dims[0];              break;
+         default: a->offset = c->dims[0] * c->dims[1]; break;
+         }
+
+      if ( i < nrhs - 1 )
+         {
+
+         /*
+         Inputs. Structures keep to the table walk.
+         */
+         switch ( c->type )
+            {
+            case MiceDouble:
+            case MiceWin:
+               a->kind  = PLAN_DOUBLE;
+               a->class = mxDOUBLE_CLASS;
+               break;
+
+            case MiceInt:
+            case MiceBoolean:
+               a->kind  = PLAN_INT;
+               a->class = mxINT32_CLASS;
+               break;
+
+            case MiceChar:
+               a->kind  = c->min_dims == 0 ? PLAN_CHAR : PLAN_WALK;
+               a->class = mxCHAR_CLASS;
+               break;
+
+            default:
+               break;
+            }
+
+         if ( c->min_dims == 2 && ( c->dims[0] == 0 ||
+                                  ( c->dims[1] == 0 && c->is_vectorizable ) ) )
+            {
+            a->kind = PLAN_WALK;
+            }
+
+         continue;
+         }
+
+      /*
+      Outputs.
+      */
+      switch ( c->type )
+         {
+         case MiceIgnore:
+         case MiceChar:
+            a->kind = PLAN_IGNORE;
+            break;
+
+         case MiceDouble:
+         case MiceInt:
+         case MiceBoolean:
+
+            a->kind    = c->type == MiceDouble ? PLAN_DOUBLE : PLAN_INT;
+            a->ndim    = 2;
+            a->size[0] = c->min_dims == 0 ? 1 : c->dims[0];
+            a->size[1] = c->min_dims == 2 ? c->dims[1] : 1;
+
+            if ( c->is_vectorizable && c->min_dims == 2 )
+               {
+               a->ndim = 3;
+               }
+
+            /*
+            Interfaces returning a found flag leave the other outputs
+            unset when not found, those outputs start as zeros.
+            */
+            if ( c->type == MiceBoolean )
+               {
+               plan->uninit = SPICEFALSE;
+               }
+
+            break;
+
+         case MiceNameID:
+         case MicePlane:
+         case MiceEllipse:
+         case MicePos:
+         case MiceNear:
+         case MiceSurf:
+         case MicePool:
+         case MiceSub_PS:
+         case MiceSurf_PS:
+         case MiceIlum:
+         case MiceWnsumd:
+         case MiceFrinfo:
+         case MiceSFS:
+         case MicePVN:
+         case MiceState:
+
+            a->nfields = 0;
+            struct_fields( c->type, &a->nfields,
+                           &a->fnames, &a->ftypes, &a->fsizes );
+
+            a->kind = a->fnames == NULL ? PLAN_WALK : PLAN_STRUCT;
+            break;
+
+         default:
+            break;
+         }
+
+      }
+
+#ifdef MICE_NO_UNINIT
+   plan->uninit = SPICEFALSE;
+#endif
+
+   return plan;
+   }
+
+
+
+
+/*
+-Procedure zzplan_same ( compare ArgCheck tables )
+
+   Compares member by member, the padding of the tables is undefined.
+*/
+static SpiceBoolean zzplan_same( struct argcheck  * a,
+                                 struct argcheck  * b,
+                                 SpiceInt           n )
+   {
+   SpiceInt                i;
+
+   for ( i=0; i<n; i++ )
+      {
+      if ( a[i].name            != b[i].name            ||
+           a[i].type            != b[i].type            ||
+           a[i].min_dims        != b[i].min_dims        ||
+           a[i].dims[0]         != b[i].dims[0]         ||
+           a[i].dims[1]         != b[i].dims[1]         ||
+           a[i].dims[2]         != b[i].dims[2]         ||
+           a[i].dims[3]         != b[i].dims[3]         ||
+           a[i].is_vectorizable != b[i].is_vectorizable  )
+         {
+         return SPICEFALSE;
+         }
+      }
+
+   return SPICETRUE;
+   }
+
+
+
+
+/*
+-Procedure zzplan_find ( the plan of the current frame )
+*/
+static struct checkplan * zzplan_find( int                nlhs,
+                                       int                nrhs,
+                                       struct argcheck  * argcheck )
+   {
+   struct checkplan      * plan;
+   SpiceInt                slot  = frames[depth].slot;
+   SpiceInt                narg  = nrhs - 1 + nlhs;
+   SpiceInt                chain = 0;
+
+   if ( depth == 0 || slot < 0 || narg < 0 )
+      {
+      return NULL;
+      }
+
+   for ( plan = plans[slot]; plan != NULL; plan = plan->next )
+      {
+      if ( plan->nlhs == nlhs && plan->nrhs == nrhs &&
+           zzplan_same( plan->argcheck, argcheck, narg ) )
+         {
+         return plan;
+         }
+
+      chain++;
+      }
+
+   /*
+   An interface building its ArgCheck table at run time would add
+   plans without bound, it keeps to the table walk.
+   */
+   if ( chain >= PLAN_MAX_CHAIN )
+      {
+      return NULL;
+      }
+
+   if ( (plan = zzplan_build( nlhs, nrhs, argcheck )) != NULL )
+      {
+      plan->next   = plans[slot];
+      plans[slot]  = plan;
+      }
+
+   return plan;
+   }
+
+
+
+
+/*
+-Procedure zzplan_inputs ( check the inputs against a plan )
+
+   Returns SPICEFALSE, without signaling, for any argument the plan
+   does not accept. zzmice_walkargs then repeats the check and signals
+   the error.
+*/
+static SpiceBoolean zzplan_inputs( const mxArray      * prhs[],
+                                   struct checkplan   * plan,
+                                   struct extra_dims  * extra,
+                                   SpiceInt           * vec_flag )
+   {
+   struct argplan        * a;
+   struct argcheck       * c;
+   const int             * Dims;
+   SpiceInt                measure;
+   SpiceInt                vec;
+   SpiceInt                i;
+
+   for ( i=0; i<plan->nrhs-1; i++ )
+      {
+      a = plan->arg      + i;
+      c = plan->argcheck + i;
+
+      if ( a->kind == PLAN_WALK                         ||
+           mxGetClassID( prhs[i+1] ) != a->class        ||
+           mxGetNumberOfDimensions( prhs[i+1] ) != 2 )
+         {
+         return SPICEFALSE;
+         }
+
+      Dims = mxGetDimensions( prhs[i+1] );
+
+      if ( a->kind == PLAN_CHAR )
+         {
+         extra->offset[i]     = Dims[1];
+         extra->vectorized[i] = Dims[0] > 1;
+
+         if ( extra->vectorized[i] )
+            {
+
+            if ( !c->is_vectorizable )
+               {
+               return SPICEFALSE;
+               }
+
+            if ( extra->count == 0 )
+               {
+               extra->first_vector_arg_index = i;
+               extra->count                  = Dims[0];
+               }
+            else if ( extra->count != Dims[0] )
+               {
+               return SPICEFALSE;
+               }
+
+            *vec_flag = 1;
+            }
+
+         continue;
+         }
+
+      vec = ( Dims[0] == 1         && Dims[1] > 1 && c->min_dims == 0 ) ||
+            ( Dims[0] == c->dims[0] && Dims[1] > 1 && c->min_dims == 1 );
+
+      extra->vectorized[i] = vec;
+
+      if ( c->is_vectorizable )
+         {
+         measure = c->min_dims == 2 ? 1 : Dims[1];
+
+         if ( extra->count == 0 )
+            {
+            extra->first_vector_arg_index = i;
+            extra->count                  = measure;
+            }
+         else if ( extra->count != measure )
+            {
+            return SPICEFALSE;
+            }
+
+         if ( vec )
+            {
+            extra->offset[i] = a->offset;
+            *vec_flag        = 1;
+            continue;
+            }
+
+         }
+      else if ( vec )
+         {
+         return SPICEFALSE;
+         }
+
+      switch ( c->min_dims )
+         {
+         case 0:
+
+            if ( Dims[0] != 1 || Dims[1] != 1 )
+               {
+               return SPICEFALSE;
+               }
+
+            break;
+
+         case 1:
+
+            if ( Dims[1] != 1 || ( c->dims[0] != 0 && Dims[0] != c->dims[0] ) )
+               {
+               return SPICEFALSE;
+               }
+
+            break;
+
+         default:
+
+            if ( Dims[0] != c->dims[0] )
+               {
+               return SPICEFALSE;
+               }
+
+            if ( c->dims[1] != 0 )
+               {
+
+               if ( Dims[1] != c->dims[1] )
+                  {
+                  return SPICEFALSE;
+                  }
+
+               }
+            else
+               {
+
+               /*
+               An Mx0 matrix, its column count sets the measure.
+               */
+               if ( extra->count == 0 )
+                  {
+                  extra->first_vector_arg_index = i;
+                  extra->count                  = Dims[1];
+                  }
+               else if ( extra->count != Dims[1] )
+                  {
+                  return SPICEFALSE;
+                  }
+
+               extra->vectorized[i] = 1;
+               }
+
+            break;
+         }
+
+      }
+
+   return SPICETRUE;
    }
 
 
 
 
+/*
+-Procedure zzplan_outputs ( allocate the outputs described by a plan )
+*/
+static void zzplan_outputs( mxArray            * plhs[],
+                            struct checkplan   * plan,
+                            struct extra_dims  * extra,
+                            SpiceInt             vec_flag )
+   {
+   struct argplan        * a;
+   struct argcheck       * c;
+   mxClassID               class;
+   mxArray               * field;
+   int                     sizearray[3];
+   int                     ndim;
+   SpiceInt                base = plan->nrhs - 1;
+   SpiceInt                vec;
+   SpiceInt                ii;
+   SpiceInt                n;
+   SpiceInt                i;
+   SpiceInt                j;
+   SpiceInt                k;
 
+   for ( i=0; i<plan->nlhs; i++ )
+      {
+      ii = base + i;
+      a  = plan->arg      + ii;
+      c  = plan->argcheck + ii;
+
+      if ( a->kind == PLAN_IGNORE )
+         {
+         continue;
+         }
+
+      vec = c->is_vectorizable && vec_flag;
+
+      if ( a->kind == PLAN_STRUCT )
+         {
+         n = 1;
+
+         if ( vec )
+            {
+            n                = extra->count;
+            extra->offset[ii] = 1;
+            }
+
+         plhs[i] = mxCreateStructMatrix( 1, n, a->nfields, a->fnames );
+
+         for ( j=0; j<n; j++ )
+            {
+            for ( k=0; k<a->nfields; k++ )
+               {
+
+               if ( a->ftypes[k] == MiceDouble || a->ftypes[k] == MiceInt )
+                  {
+                  field = mxCreateDoubleMatrix( a->fsizes[k], 1, mxREAL );
+                  }
+               else if ( a->ftypes[k] == MiceBoolean )
+                  {
+                  field = mxCreateLogicalMatrix( a->fsizes[k], 1 );
+                  }
+               else if ( a->ftypes[k] == MiceChar )
+                  {
+                  sizearray[0] = 1;
+                  sizearray[1] = DEFAULT_STR_LENGTH;
+                  field        = mxCreateCharArray( 2, sizearray );
+                  }
+               else
+                  {
+                  continue;
+                  }
+
+               mxSetField( plhs[i], j, a->fnames[k], field );
+               }
+            }
+
+         continue;
+         }
+
+      /*
+      Double precision and integer outputs.
+      */
+      sizearray[0] = a->size[0];
+      sizearray[1] = a->size[1];
+      ndim         = 2;
+
+      if ( vec )
+         {
+         ndim                  = a->ndim;
+         sizearray[ndim-1]     = extra->count;
+         extra->offset[ii]     = a->offset;
+         extra->vectorized[ii] = 1;
+         }
+      else
+         {
+         extra->vectorized[ii] = 0;
+         }
+
+      class = a->kind == PLAN_DOUBLE ? mxDOUBLE_CLASS : mxINT32_CLASS;
+
+#ifndef MICE_NO_UNINIT
+      if ( plan->uninit )
+         {
+         plhs[i] = mxCreateUninitNumericArray( ndim, sizearray,
+                                               class, mxREAL );
+         continue;
+         }
+#endif
+
+      plhs[i] = mxCreateNumericArray( ndim, sizearray, class, mxREAL );
+      }
+
+   }
+
+
+
+
+/*
+-Procedure mice_checkargs ( argument checking routine )
+
+-Abstract
+
+   Check the arguments of an interface call against its ArgCheck
+   table, allocate the outputs and return the vectorization state.
+
+-Particulars
+
+   The returned state belongs to the frame of the current interface
+   call and remains valid until the interface returns.
+
+   Within a frame entered by mexFunction or mice_batch the arguments
+   are checked against the plan of the interface. Calls the plan
+   does not accept, including all erroneous calls, and calls outside
+   any frame use zzmice_walkargs.
+
+   Numeric outputs of interfaces without a found flag are created
+   uninitialized, the interfaces assign every element. Compile with
+   MICE_NO_UNINIT for MATLAB releases lacking mxCreateUninitNumericArray.
+
+-&
+*/
+struct extra_dims  * mice_checkargs(int                 nlhs,
+                                    mxArray           * plhs[],
+                                    int                 nrhs,
+                                    const mxArray     * prhs[],
+                                    struct argcheck   * argcheck)
+   {
+   struct checkframe     * frame = frames + depth;
+   struct checkplan      * plan;
+   SpiceInt                narg  = MaxVal( nrhs - 1 + nlhs, 0 );
+   SpiceInt                need  = MaxVal( narg, PLAN_MIN_ARGS );
+   SpiceInt              * store;
+   SpiceInt                vec_flag = 0;
+   SpiceInt                i;
+
+   /*
+   Grow the frame's storage, once per frame and argument count.
+   */
+   if ( frame->size < need )
+      {
+      store = (SpiceInt *)realloc( frame->extra.vectorized,
+                                   2 * need * sizeof(SpiceInt) );
+
+      if ( store == NULL )
+         {
+         mexErrMsgTxt( "MICE(MALLOCFAILED): realloc failed for the "
+                       "vectorization state. This is a fatal error. "
+                       "Please contact NAIF.");
+         }
+
+      frame->size             = need;
+      frame->extra.vectorized = store;
+      frame->extra.offset     = store + need;
+      }
+
+   /*
+   Initialize the 'extra' fields.
+   */
+   frame->extra.count                  = 0;
+   frame->extra.first_vector_arg_index = 0;
+
+   for ( i=0; i<frame->size; i++ )
+      {
+      frame->extra.vectorized[i] = -1;
+      frame->extra.offset[i]     =  0;
+      }
+
+   plan = zzplan_find( nlhs, nrhs, argcheck );
+
+   if ( plan != NULL &&
+        zzplan_inputs( prhs, plan, &frame->extra, &vec_flag ) )
+      {
+      for ( i=plan->nrhs-1; i<plan->narg; i++ )
+         {
+         if ( plan->arg[i].kind == PLAN_WALK )
+            {
+            break;
+            }
+         }
+
+      if ( i == plan->narg )
+         {
+         zzplan_outputs( plhs, plan, &frame->extra, vec_flag );
+         return &frame->extra;
+         }
+
+      }
+
+   /*
+   Start over on the full table walk.
+   */
+   frame->extra.count                  = 0;
+   frame->extra.first_vector_arg_index = 0;
+
+   for ( i=0; i<frame->size; i++ )
+      {
+      frame->extra.vectorized[i] = -1;
+      frame->extra.offset[i]     =  0;
+      }
+
+   zzmice_walkargs( nlhs, plhs, nrhs, prhs, argcheck, &frame->extra );
+
+   return &frame->extra;
+   }
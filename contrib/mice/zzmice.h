@@ -190,13 +190,15 @@ struct argcheck {
 /* 
 
 The structure defining the vectorization state. Returned by 'mice_checkargs'.
+'vectorized' and 'offset' point to the storage of the call frame, one
+element per ArgCheck entry and at least 32.
  
 */
 struct           extra_dims {
-                            SpiceInt  count;
-                            SpiceInt  first_vector_arg_index;
-                            SpiceInt  vectorized [32];
-                            SpiceInt  offset     [32];
+                            SpiceInt    count;
+                            SpiceInt    first_vector_arg_index;
+                            SpiceInt  * vectorized;
+                            SpiceInt  * offset;
                             };
 
 
@@ -216,6 +218,16 @@ struct         extra_dims  * mice_checkargs(int                 nlhs,
                                             const mxArray     * prhs[],
                                             struct argcheck   * argcheck);
 
+void           zzmice_plans_init( SpiceInt n );
+
+void           zzmice_plans_free( void );
+
+void           zzmice_enter( SpiceInt slot );
+
+void           zzmice_leave( void );
+
+void           zzmice_reset( void );
+
 
 #endif
 
@@ -0,0 +1,1167 @@
+/*
+
+-Procedure zzmice_pool ( Mice parallel evaluation pool )
+
+-Abstract
+
+   Evaluate vectorized CSPICE calls in a pool of worker processes.
+
+-Disclaimer
+
+   THIS SOFTWARE AND ANY RELATED MATERIALS WERE CREATED BY THE
+   CALIFORNIA  INSTITUTE OF TECHNOLOGY (CALTECH) UNDER A U.S.
+   GOVERNMENT CONTRACT WITH THE NATIONAL AERONAUTICS AND SPACE
+   ADMINISTRATION (NASA). THE SOFTWARE IS TECHNOLOGY AND SOFTWARE
+   PUBLICLY AVAILABLE UNDER U.S. EXPORT LAWS AND IS PROVIDED
+   "AS-IS" TO THE RECIPIENT WITHOUT WARRANTY OF ANY KIND, INCLUDING
+   ANY WARRANTIES OF PERFORMANCE OR MERCHANTABILITY OR FITNESS FOR
+   A PARTICULAR USE OR PURPOSE (AS SET FORTH IN UNITED STATES UCC
+   SECTIONS 2312-2313) OR FOR ANY PURPOSE WHATSOEVER, FOR THE
+   SOFTWARE AND RELATED MATERIALS, HOWEVER USED.
+
+   IN NO EVENT SHALL CALTECH, ITS JET PROPULSION LABORATORY,
+   OR NASA BE LIABLE FOR ANY DAMAGES AND/OR COSTS, INCLUDING,
+   BUT NOT LIMITED TO, INCIDENTAL OR CONSEQUENTIAL DAMAGES OF
+   ANY KIND, INCLUDING ECONOMIC DAMAGE OR INJURY TO PROPERTY
+   AND LOST PROFITS, REGARDLESS OF WHETHER CALTECH, JPL, OR
+   NASA BE ADVISED, HAVE REASON TO KNOW, OR, IN FACT, SHALL
+   KNOW OF THE POSSIBILITY.
+
+   RECIPIENT BEARS ALL RISK RELATING TO QUALITY AND PERFORMANCE
+   OF THE SOFTWARE AND ANY RELATED MATERIALS, AND AGREES TO
+   INDEMNIFY CALTECH AND NASA FOR ALL THIRD-PARTY CLAIMS RESULTING
+   FROM THE ACTIONS OF RECIPIENT IN THE USE OF THE SOFTWARE.
+
+
+-Required_Reading
+
+   MICE.REQ
+
+-Keywords
+
+   MATLAB
+
+-Particulars
+
+   CSPICE is not thread safe, so a vectorized call runs on one core.
+   zzmice_pool_start forks worker processes, each of which unloads the
+   binary kernels it inherits and loads them again, in the order the
+   MEX session holds them. Reloading gives every worker its own file
+   descriptors: forked processes share the file offsets of inherited
+   descriptors, and concurrent reads through them would interleave.
+   The kernel pool holds no open files and the workers keep the copy
+   they inherit, so the variables of text kernels and meta-kernels and
+   those assigned directly (cspice_pdpool etc.) are the parent's.
+
+   The list of binary kernels is taken from the kernel subsystem
+   (ktotal_c, kdata_c) when the workers start, so files a meta-kernel
+   loaded and the session unloaded since stay unloaded. Each file is
+   reloaded by the absolute path it had when it was loaded, as a
+   relative name may point elsewhere after a change of the working
+   directory.
+
+   zzmice_pool_eval copies the epochs of a call to a memory region
+   shared with the workers, gives each worker a contiguous block of
+   them, and copies back the results the workers write to the region.
+   Calls larger than the region run in several rounds.
+
+   zzmice_pool_gf runs a geometry finder search by splitting the
+   confinement window into pieces of equal measure, one per worker.
+   Each worker searches its piece extended by two search steps on
+   either side, so events near the piece boundaries are resolved with
+   the same context as in a search over the whole window. The result
+   of each worker is then cut back to its piece and the pieces are
+   joined in time order, intervals meeting at a piece boundary merging
+   into one as wnunid_c merges them. Searches for absolute extrema
+   (ABSMAX, ABSMIN) do not decompose this way and run serially.
+
+   The pool is opt-in: without zzmice_pool_start, or for calls with few
+   epochs, zzmice_pool_eval returns SPICEFALSE and the interface
+   evaluates the call itself. It does so as well when a worker signals
+   a SPICE error, so the error reaches MATLAB exactly as from the serial
+   call.
+
+   Loading or unloading kernels or changing kernel pool variables stops
+   the workers, the next parallel call forks new ones with the changed
+   kernel set.
+
+-Restrictions
+
+   Unix only. The workers are copies of the MATLAB process and must
+   not call any MATLAB API function.
+
+   Files opened outside the kernel subsystem (cspice_dafopr) are not
+   reloaded and must not be read during a parallel call.
+
+-Version
+
+   -Mice Version 1.0.0 18-OCT-2026
+
+-Index_Entries
+
+   MATLAB
+
+-&
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include "mex.h"
+#include "SpiceUsr.h"
+#include "SpiceZmc.h"
+#include "mice.h"
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS      MAP_ANON
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL       0
+#endif
+
+#define  POOL_MAX_WORKERS   64
+#define  POOL_ARENA         (64*1024*1024)
+#define  POOL_MIN_EPOCHS    256
+#define  POOL_MIN_STEPS     64
+#define  POOL_NAMES         9
+
+
+/*
+One block of a call, as sent to a worker.
+*/
+struct pool_task
+   {
+   SpiceInt             task;
+   SpiceInt             n;
+   size_t               in;
+   size_t               out;
+   size_t               lt;
+   SpiceInt             nintvls;
+   SpiceInt             size;
+   SpiceDouble          dval[6];
+   SpiceChar            name[POOL_NAMES][DEFAULT_STR_LENGTH+1];
+   };
+
+struct pool_worker
+   {
+   pid_t                pid;
+   int                  fd;
+   };
+
+static struct pool_worker   workers[POOL_MAX_WORKERS];
+static SpiceInt             nworkers = 0;
+static SpiceInt             pool_size = 0;
+static char               * arena = NULL;
+
+/*
+A binary kernel as the kernel subsystem knows it, with the absolute
+path it had when loaded.
+*/
+struct pool_file
+   {
+   SpiceChar          * name;
+   SpiceChar          * path;
+   SpiceInt             handle;
+   };
+
+static struct pool_file   * kernels = NULL;
+static SpiceInt             nkernels = 0;
+
+
+/*
+Full-length transfers on the worker sockets, 0 on success.
+*/
+static int pool_read( int fd, void * buf, size_t len )
+   {
+   char               * p = (char*)buf;
+   ssize_t              r;
+
+   while ( len > 0 )
+      {
+      r = recv( fd, p, len, 0 );
+
+      if ( r < 0 && errno == EINTR )
+         {
+         continue;
+         }
+
+      if ( r <= 0 )
+         {
+         return -1;
+         }
+
+      p   += r;
+      len -= (size_t)r;
+      }
+
+   return 0;
+   }
+
+
+static int pool_write( int fd, const void * buf, size_t len )
+   {
+   const char         * p = (const char*)buf;
+   ssize_t              r;
+
+   while ( len > 0 )
+      {
+      r = send( fd, p, len, MSG_NOSIGNAL );
+
+      if ( r < 0 && errno == EINTR )
+         {
+         continue;
+         }
+
+      if ( r <= 0 )
+         {
+         return -1;
+         }
+
+      p   += r;
+      len -= (size_t)r;
+      }
+
+   return 0;
+   }
+
+
+/*
+The arguments of the geometry finder tasks: the number of strings,
+the number of doubles, the step the last of them, and the index of
+'relate' among the strings, -1 for searches without.
+*/
+static const struct
+   {
+   SpiceInt             task;
+   SpiceInt             nname;
+   SpiceInt             ndval;
+   SpiceInt             relate;
+   }
+   pool_gfargs[] =
+   {
+   { POOL_GFDIST, 4, 3,  3 },
+   { POOL_GFILUM, 8, 6,  7 },
+   { POOL_GFOCLT, 9, 1, -1 },
+   { POOL_GFPA,   5, 3,  4 },
+   { POOL_GFPOSC, 7, 3,  6 },
+   { POOL_GFRFOV, 4, 4, -1 },
+   { POOL_GFRR,   4, 3,  3 },
+   { POOL_GFSEP,  9, 3,  8 },
+   { POOL_GFSUBC, 8, 3,  7 },
+   { POOL_GFTFOV, 6, 1, -1 },
+   };
+
+
+/*
+Doubles per epoch written by 'task', the light time excluded.
+*/
+static SpiceInt pool_stride( SpiceInt task )
+   {
+   switch ( task )
+      {
+      case POOL_SPKEZR: return 6;
+      case POOL_SPKPOS: return 3;
+      case POOL_PXFORM: return 9;
+      case POOL_SXFORM: return 36;
+      }
+
+   return 0;
+   }
+
+
+/*
+Run a geometry finder search in a worker, 0 on success. The number of
+result values goes to 'card'.
+*/
+static int pool_exec_gf( const struct pool_task * t, SpiceInt * card )
+   {
+   SpiceDouble        * win = (SpiceDouble*)(arena + t->in);
+   SpiceDouble        * res = (SpiceDouble*)(arena + t->out);
+   const SpiceDouble  * d   = t->dval;
+
+   SpiceCell           cnfine = { SPICE_DP,
+                                  0,
+                                  0,
+                                  0,
+                                  SPICETRUE,
+                                  SPICEFALSE,
+                                  SPICEFALSE,
+                                  NULL,
+                                  NULL };
+
+   SpiceCell           result = { SPICE_DP,
+                                  0,
+                                  0,
+                                  0,
+                                  SPICETRUE,
+                                  SPICEFALSE,
+                                  SPICEFALSE,
+                                  NULL,
+                                  NULL };
+
+   cnfine.size = t->n;
+   cnfine.card = t->n;
+   cnfine.base = win;
+   cnfine.data = win + SPICE_CELL_CTRLSZ;
+
+   result.size = t->size;
+   result.base = res;
+   result.data = res + SPICE_CELL_CTRLSZ;
+
+   switch ( t->task )
+      {
+      case POOL_GFDIST:
+         gfdist_c( t->name[0], t->name[1], t->name[2], t->name[3],
+                   d[0], d[1], d[2], t->nintvls, &cnfine, &result );
+         break;
+
+      case POOL_GFILUM:
+         gfilum_c( t->name[0], t->name[1], t->name[2], t->name[3],
+                   t->name[4], t->name[5], t->name[6], d, t->name[7],
+                   d[3], d[4], d[5], t->nintvls, &cnfine, &result );
+         break;
+
+      case POOL_GFOCLT:
+         gfoclt_c( t->name[0], t->name[1], t->name[2], t->name[3],
+                   t->name[4], t->name[5], t->name[6], t->name[7],
+                   t->name[8], d[0], &cnfine, &result );
+         break;
+
+      case POOL_GFPA:
+         gfpa_c( t->name[0], t->name[1], t->name[2], t->name[3],
+                 t->name[4], d[0], d[1], d[2], t->nintvls,
+                 &cnfine, &result );
+         break;
+
+      case POOL_GFPOSC:
+         gfposc_c( t->name[0], t->name[1], t->name[2], t->name[3],
+                   t->name[4], t->name[5], t->name[6], d[0], d[1], d[2],
+                   t->nintvls, &cnfine, &result );
+         break;
+
+      case POOL_GFRFOV:
+         gfrfov_c( t->name[0], d, t->name[1], t->name[2], t->name[3],
+                   d[3], &cnfine, &result );
+         break;
+
+      case POOL_GFRR:
+         gfrr_c( t->name[0], t->name[1], t->name[2], t->name[3],
+                 d[0], d[1], d[2], t->nintvls, &cnfine, &result );
+         break;
+
+      case POOL_GFSEP:
+         gfsep_c( t->name[0], t->name[1], t->name[2], t->name[3],
+                  t->name[4], t->name[5], t->name[6], t->name[7],
+                  t->name[8], d[0], d[1], d[2], t->nintvls,
+                  &cnfine, &result );
+         break;
+
+      case POOL_GFSUBC:
+         gfsubc_c( t->name[0], t->name[1], t->name[2], t->name[3],
+                   t->name[4], t->name[5], t->name[6], t->name[7],
+                   d[0], d[1], d[2], t->nintvls, &cnfine, &result );
+         break;
+
+      case POOL_GFTFOV:
+         gftfov_c( t->name[0], t->name[1], t->name[2], t->name[3],
+                   t->name[4], t->name[5], d[0], &cnfine, &result );
+         break;
+
+      default:
+         return -1;
+      }
+
+   if ( failed_c() )
+      {
+      reset_c();
+      return -1;
+      }
+
+   *card = card_c( &result );
+
+   return 0;
+   }
+
+
+/*
+Evaluate a block in a worker, 0 on success.
+*/
+static int pool_exec( const struct pool_task * t )
+   {
+   SpiceDouble        * et  = (SpiceDouble*)(arena + t->in);
+   SpiceDouble        * out = (SpiceDouble*)(arena + t->out);
+   SpiceDouble        * lt  = (SpiceDouble*)(arena + t->lt);
+   SpiceDouble          m [3][3];
+   SpiceDouble          xm[6][6];
+   SpiceInt             i;
+
+   for ( i=0; i<t->n; i++ )
+      {
+
+      switch ( t->task )
+         {
+         case POOL_SPKEZR:
+            spkezr_c( t->name[0], et[i], t->name[1], t->name[2],
+                      t->name[3], out + 6*i, lt + i );
+            break;
+
+         case POOL_SPKPOS:
+            spkpos_c( t->name[0], et[i], t->name[1], t->name[2],
+                      t->name[3], out + 3*i, lt + i );
+            break;
+
+         /*
+         MATLAB stores by column, transpose as the interfaces do.
+         */
+         case POOL_PXFORM:
+            pxform_c( t->name[0], t->name[1], et[i], m );
+            xpose_c( m, (SpiceDouble(*)[3])(out + 9*i) );
+            break;
+
+         case POOL_SXFORM:
+            sxform_c( t->name[0], t->name[1], et[i], xm );
+            xpose6_c( xm, (SpiceDouble(*)[6])(out + 36*i) );
+            break;
+
+         default:
+            return -1;
+         }
+
+      if ( failed_c() )
+         {
+         reset_c();
+         return -1;
+         }
+
+      }
+
+   return 0;
+   }
+
+
+/*
+Main loop of a worker process, never returns.
+*/
+static void pool_serve( int fd )
+   {
+   struct pool_task   * t;
+   SpiceInt             reply[2];
+   SpiceInt             init;
+   SpiceInt             i;
+
+   signal( SIGINT, SIG_IGN );
+
+   for ( i=0; i<nkernels; i++ )
+      {
+      unload_c( kernels[i].name );
+      }
+
+   for ( i=0; i<nkernels; i++ )
+      {
+      furnsh_c( kernels[i].path );
+      }
+
+   init = failed_c() ? -1 : 0;
+   reset_c();
+
+   /*
+   The task is too large for the stack of some MATLAB threads.
+   */
+   t = (struct pool_task*)malloc( sizeof(struct pool_task) );
+
+   if ( t == NULL )
+      {
+      _exit( 1 );
+      }
+
+   while ( pool_read( fd, t, sizeof(struct pool_task) ) == 0 )
+      {
+      reply[0] = -1;
+      reply[1] = 0;
+
+      if ( init == 0 )
+         {
+         reply[0] = ( t->task >= POOL_GFDIST ) ? pool_exec_gf( t, reply + 1 )
+                                               : pool_exec( t );
+         }
+
+      if ( pool_write( fd, reply, sizeof(reply) ) != 0 )
+         {
+         break;
+         }
+      }
+
+   _exit( 0 );
+   }
+
+
+static void pool_kill( void )
+   {
+   SpiceInt             i;
+
+   for ( i=0; i<nworkers; i++ )
+      {
+      close( workers[i].fd );
+      kill( workers[i].pid, SIGKILL );
+      waitpid( workers[i].pid, NULL, 0 );
+      }
+
+   nworkers = 0;
+   }
+
+
+/*
+Take the binary kernels from the kernel subsystem, in load order. Files
+already listed under the same name and handle keep their path, new ones
+get theirs from the current working directory.
+*/
+static void pool_scan( void )
+   {
+   struct pool_file   * list;
+   SpiceChar            file   [DEFAULT_STR_LENGTH+1];
+   SpiceChar            type   [32];
+   SpiceChar            source [DEFAULT_STR_LENGTH+1];
+   SpiceInt             handle;
+   SpiceInt             count;
+   SpiceInt             n = 0;
+   SpiceInt             i;
+   SpiceInt             j;
+   SpiceBoolean         found;
+
+   ktotal_c( "ALL", &count );
+
+   list = (struct pool_file*)malloc( (count + 1) * sizeof(struct pool_file) );
+
+   if ( failed_c() || list == NULL )
+      {
+      free( list );
+      return;
+      }
+
+   for ( i=0; i<count; i++ )
+      {
+      kdata_c( i, "ALL", sizeof(file), sizeof(type), sizeof(source),
+               file, type, source, &handle, &found );
+
+      if ( !found || eqstr_c( type, "TEXT" ) || eqstr_c( type, "META" ) )
+         {
+         continue;
+         }
+
+      for ( j=0; j<nkernels; j++ )
+         {
+         if ( kernels[j].name != NULL && kernels[j].handle == handle
+              && strcmp( kernels[j].name, file ) == 0 )
+            {
+            break;
+            }
+         }
+
+      if ( j < nkernels )
+         {
+         list[n++] = kernels[j];
+         kernels[j].name = NULL;
+         continue;
+         }
+
+      list[n].name   = (SpiceChar*)malloc( strlen(file) + 1 );
+      list[n].path   = realpath( file, NULL );
+      list[n].handle = handle;
+
+      if ( list[n].name == NULL )
+         {
+         free( list[n].path );
+         continue;
+         }
+
+      strcpy( list[n].name, file );
+
+      if ( list[n].path == NULL )
+         {
+         list[n].path = (SpiceChar*)malloc( strlen(file) + 1 );
+
+         if ( list[n].path == NULL )
+            {
+            free( list[n].name );
+            continue;
+            }
+
+         strcpy( list[n].path, file );
+         }
+
+      n++;
+      }
+
+   for ( j=0; j<nkernels; j++ )
+      {
+      if ( kernels[j].name != NULL )
+         {
+         free( kernels[j].name );
+         free( kernels[j].path );
+         }
+      }
+
+   free( kernels );
+   kernels  = list;
+   nkernels = n;
+   }
+
+
+/*
+Fork the workers, SPICEFALSE if that fails.
+*/
+static SpiceBoolean pool_spawn( void )
+   {
+   int                  sv[2];
+   pid_t                pid;
+   SpiceInt             i;
+   SpiceInt             j;
+
+   pool_scan();
+
+   if ( failed_c() )
+      {
+      reset_c();
+      return SPICEFALSE;
+      }
+
+   if ( arena == NULL )
+      {
+      arena = (char*)mmap( NULL, POOL_ARENA, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_ANONYMOUS, -1, 0 );
+
+      if ( arena == (char*)MAP_FAILED )
+         {
+         arena = NULL;
+         return SPICEFALSE;
+         }
+      }
+
+   for ( i=0; i<pool_size; i++ )
+      {
+
+      if ( socketpair( AF_UNIX, SOCK_STREAM, 0, sv ) != 0 )
+         {
+         pool_kill();
+         return SPICEFALSE;
+         }
+
+#ifdef SO_NOSIGPIPE
+      j = 1;
+      setsockopt( sv[0], SOL_SOCKET, SO_NOSIGPIPE, &j, sizeof(j) );
+#endif
+
+      pid = fork();
+
+      if ( pid == 0 )
+         {
+         for ( j=0; j<nworkers; j++ )
+            {
+            close( workers[j].fd );
+            }
+
+         close( sv[0] );
+         pool_serve( sv[1] );
+         }
+
+      close( sv[1] );
+
+      if ( pid < 0 )
+         {
+         close( sv[0] );
+         pool_kill();
+         return SPICEFALSE;
+         }
+
+      workers[nworkers].pid = pid;
+      workers[nworkers].fd  = sv[0];
+      nworkers++;
+      }
+
+   return SPICETRUE;
+   }
+
+
+/*
+Set the number of workers, 0 stops the pool. The workers start with
+the first parallel call.
+*/
+void zzmice_pool_start( SpiceInt n )
+   {
+   pool_kill();
+   pool_size = MaxVal( 0, MinVal( n, POOL_MAX_WORKERS ) );
+   }
+
+
+/*
+Stop the workers, e.g. after a change of a setting they inherit. The
+next parallel call forks new ones.
+*/
+void zzmice_pool_reset( void )
+   {
+   pool_kill();
+   }
+
+
+void zzmice_pool_stop( void )
+   {
+   pool_kill();
+   pool_size = 0;
+
+   if ( arena != NULL )
+      {
+      munmap( arena, POOL_ARENA );
+      arena = NULL;
+      }
+   }
+
+
+SpiceInt zzmice_pool_size( void )
+   {
+   return pool_size;
+   }
+
+
+/*
+Record a change of the kernel set. Running workers have the old set
+and stop. The absolute paths of the files just loaded are taken now,
+while the working directory is the one they were loaded from.
+*/
+void zzmice_pool_kernel( void )
+   {
+   pool_kill();
+
+   if ( !failed_c() )
+      {
+      pool_scan();
+      }
+   }
+
+
+/*
+Evaluate 'task' at the 'n' epochs 'et' in the workers: 'stride' doubles
+per epoch to 'out', the light times to 'lt' for POOL_SPKEZR and
+POOL_SPKPOS. 'name' holds the target, frame, correction and observer,
+or the two frames. Returns SPICEFALSE if the call was not evaluated.
+*/
+SpiceBoolean zzmice_pool_eval( SpiceInt           task,
+                               ConstSpiceChar   * name[],
+                               SpiceInt           n,
+                               ConstSpiceDouble * et,
+                               SpiceDouble      * out,
+                               SpiceDouble      * lt )
+   {
+   struct pool_task   * t;
+   SpiceInt             stride = pool_stride( task );
+   SpiceInt             nname;
+   SpiceInt             per;
+   SpiceInt             cap;
+   SpiceInt             first;
+   SpiceInt             chunk;
+   SpiceInt             block;
+   SpiceInt             nw;
+   SpiceInt             reply[2];
+   SpiceInt             i;
+   SpiceBoolean         ok   = SPICETRUE;
+   SpiceBoolean         dead = SPICEFALSE;
+
+   if ( pool_size < 2 || stride == 0 || n < 2*POOL_MIN_EPOCHS )
+      {
+      return SPICEFALSE;
+      }
+
+   nname = ( task == POOL_SPKEZR || task == POOL_SPKPOS ) ? 4 : 2;
+
+   for ( i=0; i<nname; i++ )
+      {
+      if ( strlen( name[i] ) > DEFAULT_STR_LENGTH )
+         {
+         return SPICEFALSE;
+         }
+      }
+
+   if ( nworkers == 0 && !pool_spawn() )
+      {
+      return SPICEFALSE;
+      }
+
+   t = (struct pool_task*)mxCalloc( 1, sizeof(struct pool_task) );
+
+   t->task = task;
+
+   for ( i=0; i<nname; i++ )
+      {
+      strcpy( t->name[i], name[i] );
+      }
+
+   /*
+   Epoch, output and light time of an epoch occupy 'per' doubles of the
+   shared region.
+   */
+   per = 1 + stride + ( lt != NULL ? 1 : 0 );
+   cap = (SpiceInt)( POOL_ARENA / (per * sizeof(SpiceDouble)) );
+
+   for ( first=0; ok && first<n; first+=chunk )
+      {
+
+      chunk = MinVal( cap, n - first );
+      nw    = MaxVal( 1, MinVal( nworkers, chunk/POOL_MIN_EPOCHS ) );
+      block = (chunk + nw - 1) / nw;
+
+      memcpy( arena, et + first, chunk * sizeof(SpiceDouble) );
+
+      for ( i=0; i<nw; i++ )
+         {
+         t->n   = MinVal( block, chunk - i*block );
+         t->in  = (size_t)( i*block ) * sizeof(SpiceDouble);
+         t->out = (size_t)( chunk + i*block*stride ) * sizeof(SpiceDouble);
+         t->lt  = (size_t)( chunk*(1 + stride) + i*block )
+                                                    * sizeof(SpiceDouble);
+
+         if ( t->n > 0 && pool_write( workers[i].fd, t,
+                                      sizeof(struct pool_task) ) != 0 )
+            {
+            ok   = SPICEFALSE;
+            dead = SPICETRUE;
+            nw   = i;
+            }
+         }
+
+      for ( i=0; i<nw; i++ )
+         {
+         if ( MinVal( block, chunk - i*block ) <= 0 )
+            {
+            continue;
+            }
+
+         if ( pool_read( workers[i].fd, reply, sizeof(reply) ) != 0 )
+            {
+            ok   = SPICEFALSE;
+            dead = SPICETRUE;
+            continue;
+            }
+
+         if ( reply[0] != 0 )
+            {
+            ok = SPICEFALSE;
+            }
+         }
+
+      if ( ok )
+         {
+         memcpy( out + first*stride, arena + chunk*sizeof(SpiceDouble),
+                 chunk * stride * sizeof(SpiceDouble) );
+
+         if ( lt != NULL )
+            {
+            memcpy( lt + first,
+                    arena + chunk*(1 + stride)*sizeof(SpiceDouble),
+                    chunk * sizeof(SpiceDouble) );
+            }
+         }
+
+      }
+
+   mxFree( t );
+
+   /*
+   A worker died, the next call starts a new set.
+   */
+   if ( dead )
+      {
+      pool_kill();
+      }
+
+   return ok;
+   }
+
+
+
+/*
+Run the geometry finder search 'task' with the strings 'name' and the
+doubles 'dval' in the order of the CSPICE argument list, over the
+window 'cnfine', in the workers. The merged windows go to 'result'.
+Returns SPICEFALSE if the search was not run.
+*/
+SpiceBoolean zzmice_pool_gf( SpiceInt           task,
+                             ConstSpiceChar   * name[],
+                             ConstSpiceDouble * dval,
+                             SpiceInt           nintvls,
+                             SpiceCell        * cnfine,
+                             SpiceCell        * result )
+   {
+   struct pool_task   * t;
+   SpiceDouble        * win;
+   SpiceDouble        * cut;
+   SpiceDouble        * piece;
+   SpiceDouble        * res;
+   SpiceDouble        * out;
+   SpiceDouble          measure = 0.0;
+   SpiceDouble          step;
+   SpiceDouble          ov;
+   SpiceDouble          lo;
+   SpiceDouble          hi;
+   SpiceDouble          a;
+   SpiceDouble          b;
+   SpiceDouble          acc;
+   SpiceDouble          goal;
+   size_t               off;
+   size_t             * in;
+   size_t             * res_off;
+   SpiceInt           * card;
+   SpiceInt             reply[2];
+   SpiceInt             nwin;
+   SpiceInt             nout = 0;
+   SpiceInt             np;
+   SpiceInt             nsent;
+   SpiceInt             g;
+   SpiceInt             i;
+   SpiceInt             j;
+   SpiceInt             k;
+   SpiceBoolean         ok   = SPICETRUE;
+   SpiceBoolean         dead = SPICEFALSE;
+
+   if ( pool_size < 2 )
+      {
+      return SPICEFALSE;
+      }
+
+   for ( g=0; g<(SpiceInt)(sizeof(pool_gfargs)/sizeof(pool_gfargs[0])); g++ )
+      {
+      if ( pool_gfargs[g].task == task )
+         {
+         break;
+         }
+      }
+
+   if ( g == (SpiceInt)(sizeof(pool_gfargs)/sizeof(pool_gfargs[0])) )
+      {
+      return SPICEFALSE;
+      }
+
+   if ( pool_gfargs[g].relate >= 0 &&
+        ( eqstr_c( name[pool_gfargs[g].relate], "ABSMAX" ) ||
+          eqstr_c( name[pool_gfargs[g].relate], "ABSMIN" ) ) )
+      {
+      return SPICEFALSE;
+      }
+
+   for ( i=0; i<pool_gfargs[g].nname; i++ )
+      {
+      if ( strlen( name[i] ) > DEFAULT_STR_LENGTH )
+         {
+         return SPICEFALSE;
+         }
+      }
+
+   win  = (SpiceDouble*)cnfine->data;
+   nwin = card_c( cnfine );
+   step = dval[pool_gfargs[g].ndval - 1];
+
+   if ( failed_c() || nwin < 2 || nwin % 2 != 0 || !(step > 0.0) )
+      {
+      return SPICEFALSE;
+      }
+
+   for ( i=0; i<nwin; i+=2 )
+      {
+      measure += win[i+1] - win[i];
+      }
+
+   np = pool_size;
+
+   if ( measure < np * POOL_MIN_STEPS * step )
+      {
+      return SPICEFALSE;
+      }
+
+   /*
+   Each piece takes a window of at most nwin + 2 values in the shared
+   region, and a result of the size of the full result.
+   */
+   off = (size_t)np * ( 2*SPICE_CELL_CTRLSZ + nwin + 2 + result->size );
+
+   if ( off * sizeof(SpiceDouble) > POOL_ARENA )
+      {
+      return SPICEFALSE;
+      }
+
+   if ( nworkers == 0 && !pool_spawn() )
+      {
+      return SPICEFALSE;
+      }
+
+   t       = (struct pool_task*)mxCalloc( 1, sizeof(struct pool_task) );
+   cut     = (SpiceDouble*)mxMalloc( (np + 1) * sizeof(SpiceDouble) );
+   in      = (size_t*)mxMalloc( np * sizeof(size_t) );
+   res_off = (size_t*)mxMalloc( np * sizeof(size_t) );
+   card    = (SpiceInt*)mxCalloc( np, sizeof(SpiceInt) );
+
+   /*
+   Piece boundaries at equal measure of the window.
+   */
+   cut[0]  = win[0];
+   cut[np] = win[nwin-1];
+   acc     = 0.0;
+   i       = 0;
+
+   for ( k=1; k<np; k++ )
+      {
+      goal = measure * k / np;
+
+      while ( i + 2 < nwin && acc + (win[i+1] - win[i]) < goal )
+         {
+         acc += win[i+1] - win[i];
+         i   += 2;
+         }
+
+      cut[k] = win[i] + (goal - acc);
+      }
+
+   t->task    = task;
+   t->nintvls = nintvls;
+   t->size    = (SpiceInt)result->size;
+
+   for ( i=0; i<pool_gfargs[g].nname; i++ )
+      {
+      strcpy( t->name[i], name[i] );
+      }
+
+   for ( i=0; i<pool_gfargs[g].ndval; i++ )
+      {
+      t->dval[i] = dval[i];
+      }
+
+   /*
+   The windows of the pieces, each extended by 'ov' on both sides
+   within the confinement window.
+   */
+   ov  = 2.0 * step;
+   off = 0;
+
+   for ( k=0; k<np; k++ )
+      {
+      lo    = cut[k]   - ov;
+      hi    = cut[k+1] + ov;
+      piece = (SpiceDouble*)arena + off + SPICE_CELL_CTRLSZ;
+
+      memset( (SpiceDouble*)arena + off, 0,
+              SPICE_CELL_CTRLSZ * sizeof(SpiceDouble) );
+
+      for ( i=j=0; i<nwin; i+=2 )
+         {
+         a = MaxVal( win[i],   lo );
+         b = MinVal( win[i+1], hi );
+
+         if ( a <= b )
+            {
+            piece[j++] = a;
+            piece[j++] = b;
+            }
+         }
+
+      in[k]      = off;
+      off       += SPICE_CELL_CTRLSZ + j;
+      res_off[k] = off;
+      off       += SPICE_CELL_CTRLSZ + result->size;
+
+      memset( (SpiceDouble*)arena + res_off[k], 0,
+              SPICE_CELL_CTRLSZ * sizeof(SpiceDouble) );
+
+      t->n   = j;
+      t->in  = in[k]      * sizeof(SpiceDouble);
+      t->out = res_off[k] * sizeof(SpiceDouble);
+
+      if ( pool_write( workers[k].fd, t, sizeof(struct pool_task) ) != 0 )
+         {
+         ok   = SPICEFALSE;
+         dead = SPICETRUE;
+         break;
+         }
+      }
+
+   nsent = k;
+
+   for ( k=0; k<nsent; k++ )
+      {
+      if ( pool_read( workers[k].fd, reply, sizeof(reply) ) != 0 )
+         {
+         ok   = SPICEFALSE;
+         dead = SPICETRUE;
+         continue;
+         }
+
+      if ( reply[0] != 0 )
+         {
+         ok = SPICEFALSE;
+         }
+
+      card[k] = reply[1];
+      }
+
+   /*
+   Cut each result back to its piece and join the pieces. Intervals
+   which meet at a piece boundary merge.
+   */
+   out = (SpiceDouble*)result->data;
+
+   for ( k=0; ok && k<np; k++ )
+      {
+      res = (SpiceDouble*)arena + res_off[k] + SPICE_CELL_CTRLSZ;
+
+      for ( i=0; i<card[k]; i+=2 )
+         {
+         a = MaxVal( res[i],   cut[k]   );
+         b = MinVal( res[i+1], cut[k+1] );
+
+         if ( a > b )
+            {
+            continue;
+            }
+
+         if ( nout > 0 && a <= out[nout-1] )
+            {
+            out[nout-1] = MaxVal( out[nout-1], b );
+            }
+         else if ( nout + 2 > result->size )
+            {
+            /*
+            Too many intervals, the serial search signals the error.
+            */
+            ok = SPICEFALSE;
+            break;
+            }
+         else
+            {
+            out[nout++] = a;
+            out[nout++] = b;
+            }
+         }
+      }
+
+   if ( ok )
+      {
+      scard_c( nout, result );
+      }
+
+   mxFree( t );
+   mxFree( cut );
+   mxFree( in );
+   mxFree( res_off );
+   mxFree( card );
+
+   if ( dead )
+      {
+      pool_kill();
+      }
+
+   return ok;
+   }
@@ -0,0 +1,652 @@
+/*
+
+-Procedure zzmice_snap ( Mice kernel pool snapshot )
+
+-Abstract
+
+   Save the kernel pool and the list of loaded binary kernels to a
+   file, and restore them from it without parsing the text kernels.
+
+-Disclaimer
+
+   THIS SOFTWARE AND ANY RELATED MATERIALS WERE CREATED BY THE
+   CALIFORNIA  INSTITUTE OF TECHNOLOGY (CALTECH) UNDER A U.S.
+   GOVERNMENT CONTRACT WITH THE NATIONAL AERONAUTICS AND SPACE
+   ADMINISTRATION (NASA). THE SOFTWARE IS TECHNOLOGY AND SOFTWARE
+   PUBLICLY AVAILABLE UNDER U.S. EXPORT LAWS AND IS PROVIDED
+   "AS-IS" TO THE RECIPIENT WITHOUT WARRANTY OF ANY KIND, INCLUDING
+   ANY WARRANTIES OF PERFORMANCE OR MERCHANTABILITY OR FITNESS FOR
+   A PARTICULAR USE OR PURPOSE (AS SET FORTH IN UNITED STATES UCC
+   SECTIONS 2312-2313) OR FOR ANY PURPOSE WHATSOEVER, FOR THE
+   SOFTWARE AND RELATED MATERIALS, HOWEVER USED.
+
+   IN NO EVENT SHALL CALTECH, ITS JET PROPULSION LABORATORY,
+   OR NASA BE LIABLE FOR ANY DAMAGES AND/OR COSTS, INCLUDING,
+   BUT NOT LIMITED TO, INCIDENTAL OR CONSEQUENTIAL DAMAGES OF
+   ANY KIND, INCLUDING ECONOMIC DAMAGE OR INJURY TO PROPERTY
+   AND LOST PROFITS, REGARDLESS OF WHETHER CALTECH, JPL, OR
+   NASA BE ADVISED, HAVE REASON TO KNOW, OR, IN FACT, SHALL
+   KNOW OF THE POSSIBILITY.
+
+   RECIPIENT BEARS ALL RISK RELATING TO QUALITY AND PERFORMANCE
+   OF THE SOFTWARE AND ANY RELATED MATERIALS, AND AGREES TO
+   INDEMNIFY CALTECH AND NASA FOR ALL THIRD-PARTY CLAIMS RESULTING
+   FROM THE ACTIONS OF RECIPIENT IN THE USE OF THE SOFTWARE.
+
+
+-Required_Reading
+
+   KERNEL.REQ
+   MICE.REQ
+
+-Keywords
+
+   MATLAB
+
+-Particulars
+
+   zzmice_snap_save writes a snapshot file holding
+
+      - a key for each loaded kernel file, as ktotal_c/kdata_c list
+        them: the file size and a checksum of the contents for text
+        and meta-kernels, the file size and modification time for
+        binary kernels,
+
+      - the names, types and values of all kernel pool variables,
+
+      - the binary kernels in load order.
+
+   zzmice_snap_load restores a snapshot only while no kernel is
+   loaded, so it never replaces kernels the session loaded itself. Given
+   the names of the kernels the caller is about to load, it also
+   requires them to be the kernels loaded at top level when the
+   snapshot was saved, in the same order. It then checks the key of
+   every kernel in the snapshot against the file on disk. If all match,
+   it assigns the pool variables and loads the binary kernels again, in
+   their original order. Text kernels are not read beyond their
+   checksum, which replaces the parse of the kernel with a sequential
+   read.
+
+   Binary kernels are keyed by size and modification time rather than
+   a checksum of their contents: reading a multi-gigabyte SPK file to
+   validate a snapshot would cost more than loading it.
+
+   The snapshot is written to a temporary file renamed over the
+   snapshot file, so concurrent jobs sharing a snapshot file never
+   read a partial one.
+
+-Restrictions
+
+   After a restore, ktotal_c and kdata_c list the binary kernels only;
+   the text kernels contributed to the pool but are not loaded, and
+   unload_c of a text or meta-kernel has no effect.
+
+   The snapshot file uses the byte order and type sizes of the machine
+   writing it; a file written on another platform is rejected as stale.
+
+-Version
+
+   -Mice Version 1.0.0 18-OCT-2026
+
+-Index_Entries
+
+   MATLAB
+
+-&
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "mex.h"
+#include "SpiceUsr.h"
+#include "SpiceZmc.h"
+#include "mice.h"
+#include "cspice_params.h"
+
+#define  SNAP_MAGIC         "MICESNP1"
+#define  SNAP_NAMES         64
+#define  SNAP_BLOCK         65536
+
+
+/*
+One kernel of a snapshot.
+*/
+struct snap_file
+   {
+   SpiceInt             binary;
+   SpiceInt             top;
+   SpiceDouble          key[2];
+   SpiceChar          * path;
+   };
+
+
+/*
+Compute the key of a kernel file, 0 on success.
+*/
+static int snap_key( ConstSpiceChar * path,
+                     SpiceInt         binary,
+                     SpiceDouble      key[2] )
+   {
+   struct stat          st;
+   FILE               * fp;
+   unsigned char        buf[SNAP_BLOCK];
+   unsigned long        sum;
+   size_t               r;
+   size_t               i;
+
+   if ( stat( path, &st ) != 0 )
+      {
+      return -1;
+      }
+
+   key[0] = (SpiceDouble)st.st_size;
+
+   if ( binary )
+      {
+      key[1] = (SpiceDouble)st.st_mtime;
+      return 0;
+      }
+
+   fp = fopen( path, "rb" );
+
+   if ( fp == NULL )
+      {
+      return -1;
+      }
+
+   /*
+   32-bit FNV-1a of the contents, exact in a double.
+   */
+   sum = 2166136261UL;
+
+   while ( (r = fread( buf, 1, SNAP_BLOCK, fp )) > 0 )
+      {
+      for ( i=0; i<r; i++ )
+         {
+         sum = ( (sum ^ buf[i]) * 16777619UL ) & 0xFFFFFFFFUL;
+         }
+      }
+
+   fclose( fp );
+
+   key[1] = (SpiceDouble)sum;
+
+   return 0;
+   }
+
+
+/*
+Write a record, 0 on success.
+*/
+static int snap_put( FILE * fp, const void * buf, size_t len )
+   {
+   return ( len == 0 || fwrite( buf, 1, len, fp ) == len ) ? 0 : -1;
+   }
+
+
+/*
+Read a record from the snapshot image, 0 on success.
+*/
+static int snap_get( const char ** p,
+                     const char  * end,
+                     void        * buf,
+                     size_t        len )
+   {
+
+   if ( (size_t)(end - *p) < len )
+      {
+      return -1;
+      }
+
+   memcpy( buf, *p, len );
+   *p += len;
+
+   return 0;
+   }
+
+
+/*
+Write the pool variables, 0 on success. A SPICE error leaves the
+error status set and returns 0, the caller checks failed_c.
+*/
+static int snap_vars( FILE * fp, SpiceInt * nvars )
+   {
+   SpiceChar            names[SNAP_NAMES][MAXLEN+1];
+   SpiceChar            type;
+   SpiceChar          * cvals;
+   SpiceDouble        * dvals;
+   SpiceInt             start;
+   SpiceInt             nn;
+   SpiceInt             n;
+   SpiceInt             rec[3];
+   SpiceInt             i;
+   SpiceBoolean         found;
+   int                  status;
+
+   *nvars = 0;
+   start  = 0;
+
+   do
+      {
+      gnpool_c( "*", start, SNAP_NAMES, MAXLEN+1, &nn, names, &found );
+
+      if ( failed_c() || !found )
+         {
+         return 0;
+         }
+
+      for ( i=0; i<nn; i++ )
+         {
+         dtpool_c( names[i], &found, &n, &type );
+
+         if ( failed_c() )
+            {
+            return 0;
+            }
+
+         if ( !found || n < 1 )
+            {
+            continue;
+            }
+
+         rec[0] = (SpiceInt)strlen( names[i] );
+         rec[1] = ( type == 'C' );
+         rec[2] = n;
+
+         if ( snap_put( fp, rec, sizeof(rec) )
+           || snap_put( fp, names[i], (size_t)rec[0] ) )
+            {
+            return -1;
+            }
+
+         if ( rec[1] )
+            {
+            cvals = (SpiceChar*)malloc( (size_t)n * (MAXCHR+1) );
+
+            if ( cvals == NULL )
+               {
+               return -1;
+               }
+
+            gcpool_c( names[i], 0, n, MAXCHR+1, &n, cvals, &found );
+
+            status = snap_put( fp, cvals, (size_t)n * (MAXCHR+1) );
+            free( cvals );
+            }
+         else
+            {
+            dvals = (SpiceDouble*)malloc( (size_t)n * sizeof(SpiceDouble) );
+
+            if ( dvals == NULL )
+               {
+               return -1;
+               }
+
+            gdpool_c( names[i], 0, n, &n, dvals, &found );
+
+            status = snap_put( fp, dvals, (size_t)n * sizeof(SpiceDouble) );
+            free( dvals );
+            }
+
+         if ( status || failed_c() )
+            {
+            return status;
+            }
+
+         (*nvars)++;
+         }
+
+      start += nn;
+      }
+   while ( nn == SNAP_NAMES );
+
+   return 0;
+   }
+
+
+/*
+Save a snapshot of the loaded kernels to 'file'. Returns SPICEFALSE
+if the snapshot could not be written, or a kernel could not be read.
+*/
+SpiceBoolean zzmice_snap_save( ConstSpiceChar * file )
+   {
+   SpiceChar            path  [DEFAULT_STR_LENGTH+1];
+   SpiceChar            filtyp[DEFAULT_STR_LENGTH+1];
+   SpiceChar            source[DEFAULT_STR_LENGTH+1];
+   SpiceChar          * tmp;
+   SpiceDouble          key[2];
+   SpiceInt             hdr[4];
+   SpiceInt             rec[3];
+   SpiceInt             handle;
+   SpiceInt             count;
+   SpiceInt             nvars = 0;
+   SpiceInt             i;
+   SpiceBoolean         found;
+   FILE               * fp;
+   long                 pos;
+   int                  status;
+
+   ktotal_c( "ALL", &count );
+
+   if ( failed_c() )
+      {
+      return SPICEFALSE;
+      }
+
+   tmp = (SpiceChar*)malloc( strlen(file) + 32 );
+
+   if ( tmp == NULL )
+      {
+      return SPICEFALSE;
+      }
+
+   sprintf( tmp, "%s.%ld.tmp", file, (long)getpid() );
+
+   fp = fopen( tmp, "wb" );
+
+   if ( fp == NULL )
+      {
+      free( tmp );
+      return SPICEFALSE;
+      }
+
+   hdr[0] = (SpiceInt)sizeof(SpiceInt);
+   hdr[1] = (SpiceInt)sizeof(SpiceDouble);
+   hdr[2] = count;
+   hdr[3] = 0;
+
+   status = snap_put( fp, SNAP_MAGIC, 8 );
+
+   pos = ftell( fp );
+   status = status || snap_put( fp, hdr, sizeof(hdr) );
+
+   for ( i=0; i<count && !status; i++ )
+      {
+      kdata_c( i, "ALL",
+               DEFAULT_STR_LENGTH, DEFAULT_STR_LENGTH, DEFAULT_STR_LENGTH,
+               path, filtyp, source, &handle, &found );
+
+      if ( failed_c() || !found )
+         {
+         status = -1;
+         break;
+         }
+
+      rec[0] = !( eqstr_c( filtyp, "TEXT" ) || eqstr_c( filtyp, "META" ) );
+      rec[1] = ( source[0] == '\0' );
+      rec[2] = (SpiceInt)strlen( path );
+
+      status = snap_key( path, rec[0], key )
+            || snap_put( fp, rec, sizeof(rec) )
+            || snap_put( fp, key, sizeof(key) )
+            || snap_put( fp, path, (size_t)rec[2] );
+      }
+
+   status = status || snap_vars( fp, &nvars ) || failed_c();
+
+   /*
+   The number of variables is known at the end, patch the header.
+   */
+   hdr[3] = nvars;
+
+   status = status
+         || fseek( fp, pos, SEEK_SET )
+         || snap_put( fp, hdr, sizeof(hdr) );
+
+   status = fclose( fp ) || status;
+
+   if ( status || rename( tmp, file ) != 0 )
+      {
+      remove( tmp );
+      free( tmp );
+      return SPICEFALSE;
+      }
+
+   free( tmp );
+
+   return SPICETRUE;
+   }
+
+
+/*
+Restore the snapshot in 'file'. Unless 'kernels' is NULL, the 'nkern'
+names in it must be those of the top-level kernels of the snapshot.
+Returns SPICEFALSE, with the kernel pool unchanged, if a kernel is
+loaded, or the file is missing, unreadable, stale or of other kernels.
+A SPICE error while restoring is left signalled for the caller.
+*/
+SpiceBoolean zzmice_snap_load( ConstSpiceChar  * file,
+                               SpiceInt          nkern,
+                               ConstSpiceChar ** kernels )
+   {
+   struct snap_file   * files = NULL;
+   struct stat          st;
+   FILE               * fp;
+   char               * image = NULL;
+   const char         * p;
+   const char         * end;
+   const char         * vars;
+   SpiceChar            name[MAXLEN+1];
+   SpiceChar          * cvals;
+   SpiceDouble        * dvals;
+   SpiceDouble          key[2];
+   SpiceInt             hdr[4];
+   SpiceInt             rec[3];
+   SpiceInt             count;
+   SpiceInt             ntop = 0;
+   SpiceInt             i;
+   SpiceBoolean         valid = SPICEFALSE;
+
+   ktotal_c( "ALL", &count );
+
+   if ( failed_c() || count > 0 )
+      {
+      return SPICEFALSE;
+      }
+
+   /*
+   Read the whole snapshot, it is parsed in place.
+   */
+   if ( stat( file, &st ) != 0 || st.st_size < 8 + (off_t)sizeof(hdr) )
+      {
+      return SPICEFALSE;
+      }
+
+   fp = fopen( file, "rb" );
+
+   if ( fp == NULL )
+      {
+      return SPICEFALSE;
+      }
+
+   image = (char*)malloc( (size_t)st.st_size );
+
+   if ( image == NULL
+     || fread( image, 1, (size_t)st.st_size, fp ) != (size_t)st.st_size )
+      {
+      fclose( fp );
+      free( image );
+      return SPICEFALSE;
+      }
+
+   fclose( fp );
+
+   p   = image;
+   end = image + st.st_size;
+
+   if ( memcmp( p, SNAP_MAGIC, 8 ) != 0 )
+      {
+      free( image );
+      return SPICEFALSE;
+      }
+
+   p += 8;
+   snap_get( &p, end, hdr, sizeof(hdr) );
+
+   if ( hdr[0] != (SpiceInt)sizeof(SpiceInt)
+     || hdr[1] != (SpiceInt)sizeof(SpiceDouble)
+     || hdr[2] < 0
+     || hdr[3] < 0 )
+      {
+      free( image );
+      return SPICEFALSE;
+      }
+
+   files = (struct snap_file*)calloc( (size_t)hdr[2] + 1,
+                                      sizeof(struct snap_file) );
+
+   if ( files == NULL )
+      {
+      free( image );
+      return SPICEFALSE;
+      }
+
+   /*
+   Check every kernel before touching the loaded set.
+   */
+   for ( i=0; i<hdr[2]; i++ )
+      {
+      if ( snap_get( &p, end, rec, sizeof(rec) )
+        || snap_get( &p, end, files[i].key, sizeof(key) )
+        || rec[2] < 1
+        || rec[2] > DEFAULT_STR_LENGTH
+        || end - p < rec[2] )
+         {
+         goto done;
+         }
+
+      files[i].binary = rec[0];
+      files[i].top    = rec[1];
+      files[i].path   = (SpiceChar*)malloc( (size_t)rec[2] + 1 );
+
+      if ( files[i].path == NULL )
+         {
+         goto done;
+         }
+
+      memcpy( files[i].path, p, (size_t)rec[2] );
+      files[i].path[rec[2]] = '\0';
+      p += rec[2];
+
+      if ( kernels != NULL && files[i].top )
+         {
+         if ( ntop >= nkern || strcmp( files[i].path, kernels[ntop] ) != 0 )
+            {
+            goto done;
+            }
+
+         ntop++;
+         }
+
+      if ( snap_key( files[i].path, files[i].binary, key )
+        || key[0] != files[i].key[0]
+        || key[1] != files[i].key[1] )
+         {
+         goto done;
+         }
+      }
+
+   if ( kernels != NULL && ntop != nkern )
+      {
+      goto done;
+      }
+
+   /*
+   Check the variable records are complete.
+   */
+   vars = p;
+
+   for ( i=0; i<hdr[3]; i++ )
+      {
+      if ( snap_get( &p, end, rec, sizeof(rec) )
+        || rec[0] < 1
+        || rec[0] > MAXLEN
+        || rec[2] < 1 )
+         {
+         goto done;
+         }
+
+      p += rec[0];
+
+      if ( rec[1] )
+         {
+         p += (size_t)rec[2] * (MAXCHR+1);
+         }
+      else
+         {
+         p += (size_t)rec[2] * sizeof(SpiceDouble);
+         }
+
+      if ( p > end )
+         {
+         goto done;
+         }
+      }
+
+   valid = SPICETRUE;
+
+   p = vars;
+
+   for ( i=0; i<hdr[3] && !failed_c(); i++ )
+      {
+      snap_get( &p, end, rec, sizeof(rec) );
+
+      memcpy( name, p, (size_t)rec[0] );
+      name[rec[0]] = '\0';
+      p += rec[0];
+
+      if ( rec[1] )
+         {
+         cvals = (SpiceChar*)p;
+         pcpool_c( name, rec[2], MAXCHR+1, cvals );
+         p += (size_t)rec[2] * (MAXCHR+1);
+         }
+      else
+         {
+         dvals = (SpiceDouble*)malloc( (size_t)rec[2] * sizeof(SpiceDouble) );
+
+         if ( dvals == NULL )
+            {
+            setmsg_c( "Cannot allocate # doubles for kernel variable #." );
+            errint_c( "#", rec[2] );
+            errch_c ( "#", name );
+            sigerr_c( "SPICE(MALLOCFAILED)" );
+            break;
+            }
+
+         memcpy( dvals, p, (size_t)rec[2] * sizeof(SpiceDouble) );
+         pdpool_c( name, rec[2], dvals );
+         free( dvals );
+
+         p += (size_t)rec[2] * sizeof(SpiceDouble);
+         }
+      }
+
+   for ( i=0; i<hdr[2] && !failed_c(); i++ )
+      {
+      if ( files[i].binary )
+         {
+         furnsh_c( files[i].path );
+         }
+      }
+
+   zzmice_clear_caches();
+   zzmice_pool_kernel();
+
+   done:
+
+   for ( i=0; i<hdr[2]; i++ )
+      {
+      free( files[i].path );
+      }
+
+   free( files );
+   free( image );
+
+   return valid;
+   }
+
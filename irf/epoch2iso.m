@@ -22,6 +22,11 @@ function out = epoch2iso(t,fmt)
 
 if nargin<2, fmt = 0; end
 
+if exist('irf_isotime_mx','file') == 3 && any(fmt==[0 1])
+	out = irf_isotime_mx(double(t(:)),'epoch',6-3*fmt);
+	return
+end
+
 switch fmt % set rounding precision for different formats
     case 0
         dt_res = 5e-7;
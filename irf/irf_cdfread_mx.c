@@ -0,0 +1,1292 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <yuri@irfu.se> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   Yuri Khotyaintsev
+ * ----------------------------------------------------------------------------
+ *
+ * irf_cdfread_mx.c  MEX function to read record ranges of CDF variables
+ *
+ * [FIRST, COUNT] = IRF_CDFREAD_MX('range', FILENAME, TIMEVAR, TINT)
+ *
+ *   Finds the records of the TT2000 or EPOCH variable TIMEVAR with
+ *   TINT(1) <= t < TINT(2) by binary search. TINT is in the units of the
+ *   variable (TT2000 ns, int64 or double, or EPOCH ms). The times must be
+ *   nondecreasing. FIRST is zero based, COUNT may be 0.
+ *
+ * DATA = IRF_CDFREAD_MX('read', FILENAME, VARNAME, FIRST, COUNT)
+ *
+ *   Reads COUNT records of VARNAME starting at record FIRST (zero based).
+ *   DATA is COUNT x DIMS of the class spdfcdfread gives (TT2000 int64,
+ *   EPOCH double), i.e. record varying variables come out as DATAOBJ has
+ *   them after reading with spdfcdfread: 3-D records DIM3 x DIM1 x DIM2,
+ *   others in CDF order. Missing records are padded, or
+ *   repeat the previous record, as the variable's sparse records say.
+ *
+ * DATA = IRF_CDFREAD_MX('load', FILENAMES, TIMEVAR, TINT, VARNAMES, NTHREADS)
+ *
+ *   Reads the records within TINT of the record varying variables VARNAMES
+ *   (string or cell array of strings, may include TIMEVAR) from all the
+ *   files FILENAMES (cell array) into one array per variable, DATA{i} for
+ *   VARNAMES{i}, as 'range' and 'read' would for every file followed by
+ *   concatenation. TIMEVAR must be TT2000, TINT is as for 'range'. The
+ *   files are concatenated in the order of their first time within TINT,
+ *   files without records within TINT are left out. Overlapping files are
+ *   not merged, the caller has to sort the times if they can overlap.
+ *   NTHREADS (default 0, one per CPU) files are worked on at a time.
+ *
+ * IRF_CDFREAD_MX('close')
+ *
+ *   Closes the file kept open between calls.
+ *
+ * Only the blocks (VVRs) holding the requested records are read. GZIP and
+ * RLE compressed blocks (CVVRs) are inflated one at a time, the last one of
+ * every variable is kept so that the binary search of 'range' inflates a
+ * block at most once. Files compressed as a whole are inflated completely.
+ * The file stays mapped until another file is read, it changes on disk or
+ * 'close'.
+ *
+ * 'load' works in two passes over a pool of threads claiming files from a
+ * shared counter. The first opens the files, binary searches TINT and asks
+ * the kernel to read ahead the blocks of the records within TINT
+ * (madvise), the second inflates and copies the records of every file
+ * straight into its rows of the outputs, so that reading the files from
+ * disk overlaps with inflating them. The threads do not call the MATLAB
+ * API. The files stay open between the passes, a file compressed as a
+ * whole is inflated once.
+ *
+ * Single-file, row major version 3 CDFs in IEEE encodings are read. Other
+ * files, EPOCH16 and character variables and HUFF/AHUFF compression are
+ * errors, for which the caller should fall back to spdfcdfread.
+ *
+ * Compile with:
+ *   mex -v irf_cdfread_mx.c CFLAGS='$CFLAGS -O2 -pthread' -lz
+ *
+ * $Id$
+ */
+
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "mex.h"
+
+/*
+ * This typedef is needed for MATLAB < 7.3
+ */
+#ifndef MWSIZE_MAX
+typedef int mwSize;
+#endif
+
+#define CDF_MAX_DIMS 10
+#define CDF_MAX_DEPTH 16	/* of nested VXRs */
+#define ERR_LEN 512
+#define MAX_THREADS 64
+
+#define MAGIC_V3 0xCDF30001u
+#define MAGIC_PLAIN 0x0000FFFFu
+#define MAGIC_COMPRESSED 0xCCCC0001u
+
+/* internal record types */
+enum { CDR = 1, GDR = 2, ZVDR = 8, RVDR = 3, VXR = 6, VVR = 7, CCR = 10,
+	CPR = 11, CVVR = 13 };
+
+/* compression types */
+enum { C_NONE = 0, C_RLE = 1, C_GZIP = 5 };
+
+/* data types */
+enum { T_INT1 = 1, T_INT2 = 2, T_INT4 = 4, T_INT8 = 8, T_UINT1 = 11,
+	T_UINT2 = 12, T_UINT4 = 14, T_REAL4 = 21, T_REAL8 = 22, T_EPOCH = 31,
+	T_EPOCH16 = 32, T_TT2000 = 33, T_BYTE = 41, T_FLOAT = 44,
+	T_DOUBLE = 45, T_CHAR = 51, T_UCHAR = 52 };
+
+typedef struct {
+	long long first, last;	/* records in the block */
+	long long offset;	/* of its VVR or CVVR */
+} cdf_block;
+
+typedef struct {
+	char name[257];
+	int type;
+	int size;		/* bytes of one value */
+	int ndims;
+	int dims[CDF_MAX_DIMS];
+	long long nvalues;	/* values in a record */
+	size_t rec_size;	/* bytes of a record */
+	int recvary;		/* record variance T */
+	int sparse;		/* 0 none, 1 pad, 2 previous */
+	int compression;
+	long long maxrec;
+	unsigned char pad[8];
+	const char *bad;	/* why the variable cannot be read */
+	cdf_block *blocks;
+	int nblocks;
+	unsigned char *cache;	/* last inflated block */
+	size_t cache_size;
+	int cache_block;	/* -1 for none */
+} cdf_var;
+
+typedef struct {
+	char path[PATH_MAX];
+	dev_t dev;
+	ino_t ino;
+	time_t mtime;
+	off_t size;
+	unsigned char *map;
+	size_t map_size;
+	unsigned char *buf;	/* the file, map or inflated */
+	size_t len;
+	int swap;		/* values in the other byte order */
+	int nvars;
+	cdf_var *vars;
+} cdf_file;
+
+static cdf_file cur;
+
+static int fail(char *err, const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	vsnprintf(err, ERR_LEN, fmt, ap);
+	va_end(ap);
+	return -1;
+}
+
+static unsigned int get32(const unsigned char *p)
+{
+	return ((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16) |
+		((unsigned int)p[2] << 8) | p[3];
+}
+
+static long long get64(const unsigned char *p)
+{
+	return (long long)(((unsigned long long)get32(p) << 32) | get32(p + 4));
+}
+
+/* N bytes at OFF of the file, NULL if outside */
+static const unsigned char *at(const cdf_file *f, long long off, long long n)
+{
+	if ( off < 0 || n < 0 || (unsigned long long)off > f->len ||
+		(unsigned long long)n > f->len - (size_t)off )
+		return NULL;
+	return f->buf + off;
+}
+
+static int value_size(int type)
+{
+	switch ( type ) {
+	case T_INT1: case T_UINT1: case T_BYTE: case T_CHAR: case T_UCHAR:
+		return 1;
+	case T_INT2: case T_UINT2:
+		return 2;
+	case T_INT4: case T_UINT4: case T_REAL4: case T_FLOAT:
+		return 4;
+	case T_INT8: case T_REAL8: case T_EPOCH: case T_TT2000: case T_DOUBLE:
+		return 8;
+	case T_EPOCH16:
+		return 16;
+	}
+	return 0;
+}
+
+static mxClassID value_class(int type)
+{
+	switch ( type ) {
+	case T_INT1: case T_BYTE: return mxINT8_CLASS;
+	case T_INT2: return mxINT16_CLASS;
+	case T_INT4: return mxINT32_CLASS;
+	case T_INT8: case T_TT2000: return mxINT64_CLASS;
+	case T_UINT1: return mxUINT8_CLASS;
+	case T_UINT2: return mxUINT16_CLASS;
+	case T_UINT4: return mxUINT32_CLASS;
+	case T_REAL4: case T_FLOAT: return mxSINGLE_CLASS;
+	}
+	return mxDOUBLE_CLASS;
+}
+
+/* pad value of the CDF library (3.6) when the variable has none */
+static void default_pad(cdf_var *v, int swap)
+{
+	union { signed char i1; short i2; int i4; long long i8;
+		unsigned char u1; unsigned short u2; unsigned int u4;
+		float r4; double r8; unsigned char b[8]; } u;
+	int i;
+
+	memset(&u, 0, sizeof(u));
+	switch ( v->type ) {
+	case T_INT1: case T_BYTE: u.i1 = -127; break;
+	case T_INT2: u.i2 = -32767; break;
+	case T_INT4: u.i4 = -2147483647; break;
+	case T_INT8: case T_TT2000: u.i8 = -9223372036854775807LL; break;
+	case T_UINT1: u.u1 = 254; break;
+	case T_UINT2: u.u2 = 65534; break;
+	case T_UINT4: u.u4 = 4294967294u; break;
+	case T_REAL4: case T_FLOAT: u.r4 = -1e30f; break;
+	case T_REAL8: case T_DOUBLE: u.r8 = -1e30; break;
+	}
+	/* stored in the file's byte order, as a pad value read from the VDR */
+	for ( i = 0; i < v->size && i < 8; i++ )
+		v->pad[i] = swap ? u.b[v->size - 1 - i] : u.b[i];
+}
+
+static int host_little(void)
+{
+	const unsigned short one = 1;
+
+	return *(const unsigned char *)&one;
+}
+
+static int inflate_gzip(const unsigned char *in, size_t in_len,
+	unsigned char *out, size_t out_len)
+{
+	z_stream zs;
+	int ret;
+
+	if ( in_len > UINT_MAX || out_len > UINT_MAX )
+		return -1;
+	memset(&zs, 0, sizeof(zs));
+	if ( inflateInit2(&zs, 15 + 32) != Z_OK )
+		return -1;
+	zs.next_in = (Bytef *)in;
+	zs.avail_in = (uInt)in_len;
+	zs.next_out = out;
+	zs.avail_out = (uInt)out_len;
+	ret = inflate(&zs, Z_FINISH);
+	inflateEnd(&zs);
+	return ( ret == Z_STREAM_END && zs.total_out == out_len ) ? 0 : -1;
+}
+
+/* CDF run length encoding: a zero byte followed by N stands for N+1 zeros */
+static int inflate_rle(const unsigned char *in, size_t in_len,
+	unsigned char *out, size_t out_len)
+{
+	size_t i = 0, o = 0, n;
+
+	while ( i < in_len ) {
+		if ( in[i] ) {
+			if ( o == out_len )
+				return -1;
+			out[o++] = in[i++];
+			continue;
+		}
+		if ( i + 1 == in_len )
+			return -1;
+		n = (size_t)in[i + 1] + 1;
+		if ( n > out_len - o )
+			return -1;
+		memset(out + o, 0, n);
+		o += n;
+		i += 2;
+	}
+	return o == out_len ? 0 : -1;
+}
+
+static int expand(int compression, const unsigned char *in, size_t in_len,
+	unsigned char *out, size_t out_len)
+{
+	if ( compression == C_GZIP )
+		return inflate_gzip(in, in_len, out, out_len);
+	return inflate_rle(in, in_len, out, out_len);
+}
+
+/* compression type of the CPR at OFF */
+static int read_cpr(const cdf_file *f, long long off, int *compression,
+	char *err)
+{
+	const unsigned char *p = at(f, off, 28);
+
+	if ( !p || get32(p + 8) != CPR )
+		return fail(err, "%s: bad compression record", f->path);
+	*compression = (int)get32(p + 12);
+	if ( *compression != C_RLE && *compression != C_GZIP )
+		return fail(err, "%s: compression type %d is not supported",
+			f->path, *compression);
+	return 0;
+}
+
+static int cmp_block(const void *a, const void *b)
+{
+	const cdf_block *x = a, *y = b;
+
+	return ( x->first > y->first ) - ( x->first < y->first );
+}
+
+/* append the VVRs and CVVRs of the VXR chain at OFF to the blocks of V */
+static int load_vxr(const cdf_file *f, cdf_var *v, long long off, int depth,
+	char *err)
+{
+	const unsigned char *p, *e, *r;
+	long long first, last, o;
+	int n, used, i;
+	cdf_block *b;
+
+	if ( depth > CDF_MAX_DEPTH )
+		return fail(err, "%s: %s: VXRs nested too deep", f->path, v->name);
+	while ( off ) {
+		p = at(f, off, 28);
+		if ( !p || get32(p + 8) != VXR )
+			return fail(err, "%s: %s: bad VXR", f->path, v->name);
+		n = (int)get32(p + 20);
+		used = (int)get32(p + 24);
+		e = at(f, off + 28, 16 * (long long)n);
+		if ( !e || used < 0 || used > n )
+			return fail(err, "%s: %s: bad VXR", f->path, v->name);
+		for ( i = 0; i < used; i++ ) {
+			first = (int)get32(e + 4 * i);
+			last = (int)get32(e + 4 * (long long)n + 4 * i);
+			o = get64(e + 8 * (long long)n + 8 * i);
+			r = at(f, o, 12);
+			if ( !r || first < 0 || last < first )
+				return fail(err, "%s: %s: bad VXR entry", f->path,
+					v->name);
+			switch ( get32(r + 8) ) {
+			case VXR:
+				if ( load_vxr(f, v, o, depth + 1, err) )
+					return -1;
+				break;
+			case VVR: case CVVR:
+				b = realloc(v->blocks, (v->nblocks + 1) * sizeof(*b));
+				if ( !b )
+					return fail(err, "out of memory");
+				v->blocks = b;
+				b[v->nblocks].first = first;
+				b[v->nblocks].last = last;
+				b[v->nblocks].offset = o;
+				v->nblocks++;
+				break;
+			default:
+				return fail(err, "%s: %s: bad VXR entry", f->path,
+					v->name);
+			}
+		}
+		off = get64(p + 12);
+	}
+	return 0;
+}
+
+static int load_vdr(const cdf_file *f, long long off, int z, int r_ndims,
+	const int *r_dims, cdf_var *v, char *err)
+{
+	const unsigned char *p = at(f, off, 340), *d, *varys;
+	unsigned int flags;
+	int nelems, i;
+
+	if ( !p || get32(p + 8) != (unsigned int)( z ? ZVDR : RVDR ) )
+		return fail(err, "%s: bad variable record", f->path);
+	v->cache_block = -1;
+	memcpy(v->name, p + 84, 256);
+	v->name[256] = 0;
+	v->type = (int)get32(p + 20);
+	v->maxrec = (int)get32(p + 24);
+	flags = get32(p + 44);
+	v->recvary = (flags & 1) != 0;
+	v->sparse = (int)get32(p + 48);
+	nelems = (int)get32(p + 64);
+	v->size = value_size(v->type);
+	if ( z ) {
+		d = at(f, off + 340, 4);
+		v->ndims = d ? (int)get32(d) : -1;
+		if ( v->ndims < 0 || v->ndims > CDF_MAX_DIMS ||
+			!(d = at(f, off + 344, 8 * (long long)v->ndims)) )
+			return fail(err, "%s: %s: bad dimensions", f->path, v->name);
+		varys = d + 4 * v->ndims;
+	} else {
+		v->ndims = r_ndims;
+		d = NULL;
+		if ( !(varys = at(f, off + 340, 4 * (long long)v->ndims)) )
+			return fail(err, "%s: %s: bad dimensions", f->path, v->name);
+	}
+	v->nvalues = 1;
+	for ( i = 0; i < v->ndims; i++ ) {
+		v->dims[i] = d ? (int)get32(d + 4 * i) : r_dims[i];
+		if ( v->dims[i] < 1 )
+			return fail(err, "%s: %s: bad dimensions", f->path, v->name);
+		v->nvalues *= v->dims[i];
+		if ( !get32(varys + 4 * i) )
+			v->bad = "dimension variance F";
+	}
+	v->rec_size = (size_t)v->nvalues * v->size * (nelems > 0 ? nelems : 1);
+
+	if ( !v->size )
+		v->bad = "unknown data type";
+	else if ( v->type == T_EPOCH16 )
+		v->bad = "EPOCH16";
+	else if ( v->type == T_CHAR || v->type == T_UCHAR )
+		v->bad = "character data";
+	else if ( nelems != 1 )
+		v->bad = "several elements per value";
+	else if ( v->sparse < 0 || v->sparse > 2 )
+		v->bad = "unknown sparse records";
+
+	if ( flags & 2 ) {
+		d = at(f, (varys - f->buf) + 4 * (long long)v->ndims, v->size);
+		if ( !d )
+			return fail(err, "%s: %s: bad pad value", f->path, v->name);
+		memcpy(v->pad, d, v->size < 8 ? v->size : 8);
+	} else
+		default_pad(v, f->swap);
+
+	if ( flags & 4 ) {
+		if ( read_cpr(f, get64(p + 72), &v->compression, err) )
+			return -1;
+	}
+
+	if ( load_vxr(f, v, get64(p + 28), 0, err) )
+		return -1;
+	qsort(v->blocks, v->nblocks, sizeof(*v->blocks), cmp_block);
+	return 0;
+}
+
+static void cdf_close(cdf_file *f)
+{
+	int i;
+
+	for ( i = 0; i < f->nvars; i++ ) {
+		free(f->vars[i].blocks);
+		free(f->vars[i].cache);
+	}
+	free(f->vars);
+	if ( f->buf && f->buf != f->map )
+		free(f->buf);
+	if ( f->map )
+		munmap(f->map, f->map_size);
+	memset(f, 0, sizeof(*f));
+}
+
+/* inflate a file compressed as a whole (CCR) into f->buf */
+static int inflate_file(cdf_file *f, char *err)
+{
+	const unsigned char *p;
+	long long size, usize;
+	int compression;
+
+	p = at(f, 8, 32);
+	if ( !p || get32(p + 8) != CCR )
+		return fail(err, "%s: bad compressed CDF record", f->path);
+	size = get64(p);
+	usize = get64(p + 20);
+	/* deflate does not expand more than about 1000 times */
+	if ( size < 32 || !at(f, 8, size) || usize < 0 ||
+		usize / 1100 > size || (unsigned long long)usize > (size_t)-1 - 8 )
+		return fail(err, "%s: bad compressed CDF record", f->path);
+	if ( read_cpr(f, get64(p + 12), &compression, err) )
+		return -1;
+	f->buf = malloc((size_t)usize + 8);
+	if ( !f->buf ) {
+		f->buf = f->map;
+		return fail(err, "%s: out of memory", f->path);
+	}
+	memcpy(f->buf, f->map, 8);
+	if ( expand(compression, f->map + 40, (size_t)size - 32, f->buf + 8,
+		(size_t)usize) ) {
+		free(f->buf);
+		f->buf = f->map;
+		return fail(err, "%s: cannot inflate the file", f->path);
+	}
+	f->len = (size_t)usize + 8;
+	return 0;
+}
+
+static int cdf_open(cdf_file *f, const char *path, char *err)
+{
+	const unsigned char *cdr, *gdr, *p;
+	struct stat st;
+	long long off[2];
+	int nvars[2], r_dims[CDF_MAX_DIMS], r_ndims, encoding, little, z, i, n;
+	unsigned int flags;
+	int fd;
+
+	memset(f, 0, sizeof(*f));
+	snprintf(f->path, sizeof(f->path), "%s", path);
+	fd = open(path, O_RDONLY);
+	if ( fd < 0 )
+		return fail(err, "%s: cannot open", path);
+	if ( fstat(fd, &st) || st.st_size < 16 ) {
+		close(fd);
+		return fail(err, "%s: not a CDF", path);
+	}
+	f->dev = st.st_dev;
+	f->ino = st.st_ino;
+	f->mtime = st.st_mtime;
+	f->size = st.st_size;
+	f->map_size = (size_t)st.st_size;
+	f->map = mmap(NULL, f->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if ( f->map == MAP_FAILED ) {
+		f->map = NULL;
+		return fail(err, "%s: cannot map", path);
+	}
+	f->buf = f->map;
+	f->len = f->map_size;
+
+	if ( get32(f->map) != MAGIC_V3 )
+		goto bad_file;
+	if ( get32(f->map + 4) == MAGIC_COMPRESSED ) {
+		if ( inflate_file(f, err) )
+			goto error;
+	} else if ( get32(f->map + 4) != MAGIC_PLAIN )
+		goto bad_file;
+
+	cdr = at(f, 8, 56);
+	if ( !cdr || get32(cdr + 8) != CDR )
+		goto bad_file;
+	encoding = (int)get32(cdr + 28);
+	flags = get32(cdr + 32);
+	switch ( encoding ) {
+	case 4: case 6: case 13: case 16: case 17:
+		little = 1;
+		break;
+	case 1: case 2: case 5: case 7: case 9: case 11: case 12: case 18:
+		little = 0;
+		break;
+	default:
+		fail(err, "%s: encoding %d is not supported", path, encoding);
+		goto error;
+	}
+	f->swap = little != host_little();
+	if ( !(flags & 1) ) {
+		fail(err, "%s: column major CDFs are not supported", path);
+		goto error;
+	}
+	if ( !(flags & 2) ) {
+		fail(err, "%s: multi-file CDFs are not supported", path);
+		goto error;
+	}
+
+	gdr = at(f, get64(cdr + 12), 84);
+	if ( !gdr || get32(gdr + 8) != GDR )
+		goto bad_file;
+	off[0] = get64(gdr + 12);
+	off[1] = get64(gdr + 20);
+	nvars[0] = (int)get32(gdr + 44);
+	nvars[1] = (int)get32(gdr + 60);
+	r_ndims = (int)get32(gdr + 56);
+	/* a VDR takes at least 340 bytes */
+	if ( r_ndims < 0 || r_ndims > CDF_MAX_DIMS || nvars[0] < 0 ||
+		nvars[1] < 0 || (size_t)nvars[0] + nvars[1] > f->len / 340 ||
+		!(p = at(f, get64(cdr + 12) + 84, 4 * r_ndims)) )
+		goto bad_file;
+	for ( i = 0; i < r_ndims; i++ )
+		r_dims[i] = (int)get32(p + 4 * i);
+
+	f->vars = calloc((size_t)nvars[0] + nvars[1] + 1, sizeof(*f->vars));
+	if ( !f->vars ) {
+		fail(err, "%s: out of memory", path);
+		goto error;
+	}
+	for ( z = 0; z < 2; z++ ) {
+		for ( n = 0; n < nvars[z] && off[z]; n++ ) {
+			f->nvars++;
+			if ( load_vdr(f, off[z], z, r_ndims, r_dims,
+				&f->vars[f->nvars - 1], err) )
+				goto error;
+			p = at(f, off[z], 20);
+			off[z] = get64(p + 12);
+		}
+	}
+	return 0;
+
+bad_file:
+	fail(err, "%s: not a version 3 CDF or corrupted", path);
+error:
+	cdf_close(f);
+	return -1;
+}
+
+static cdf_var *cdf_find(cdf_file *f, const char *name)
+{
+	int i;
+
+	for ( i = 0; i < f->nvars; i++ )
+		if ( !strcmp(f->vars[i].name, name) )
+			return &f->vars[i];
+	return NULL;
+}
+
+/* records of block IB of V, inflated if compressed */
+static const unsigned char *block_data(cdf_file *f, cdf_var *v, int ib,
+	char *err)
+{
+	const cdf_block *b = &v->blocks[ib];
+	const unsigned char *p = at(f, b->offset, 24), *c;
+	size_t n = (size_t)(b->last - b->first + 1) * v->rec_size;
+	long long csize;
+	unsigned char *tmp;
+
+	if ( !p ) {
+		fail(err, "%s: %s: bad data record", f->path, v->name);
+		return NULL;
+	}
+	if ( get32(p + 8) == VVR ) {
+		if ( !(c = at(f, b->offset + 12, (long long)n)) )
+			fail(err, "%s: %s: truncated data record", f->path, v->name);
+		return c;
+	}
+	if ( v->cache_block == ib )
+		return v->cache;
+	if ( !v->compression ) {
+		fail(err, "%s: %s: compressed data without CPR", f->path, v->name);
+		return NULL;
+	}
+	csize = get64(p + 16);
+	if ( !(c = at(f, b->offset + 24, csize)) ) {
+		fail(err, "%s: %s: truncated data record", f->path, v->name);
+		return NULL;
+	}
+	if ( n > v->cache_size ) {
+		if ( !(tmp = realloc(v->cache, n)) ) {
+			fail(err, "%s: %s: out of memory", f->path, v->name);
+			return NULL;
+		}
+		v->cache = tmp;
+		v->cache_size = n;
+	}
+	v->cache_block = -1;
+	if ( expand(v->compression, c, (size_t)csize, v->cache, n) ) {
+		fail(err, "%s: %s: cannot inflate records %lld to %lld", f->path,
+			v->name, b->first, b->last);
+		return NULL;
+	}
+	v->cache_block = ib;
+	return v->cache;
+}
+
+/* first block of V with last >= REC */
+static int find_block(const cdf_var *v, long long rec)
+{
+	int lo = 0, hi = v->nblocks, mid;
+
+	while ( lo < hi ) {
+		mid = lo + (hi - lo) / 2;
+		if ( v->blocks[mid].last < rec )
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/*
+ * dimension of V, in CDF order, that is dimension I + 1 of the data:
+ * DATAOBJ permutes the 3-D records of spdfcdfread to DIM3 x DIM1 x DIM2
+ */
+static int mat_dim(const cdf_var *v, int i)
+{
+	return v->ndims == 3 ? (i + 2) % 3 : i;
+}
+
+/* copy record SRC to row R of OUT, LD x DIMS in MATLAB order */
+static void put_record(const cdf_file *f, const cdf_var *v,
+	const unsigned char *src, long long r, long long ld,
+	unsigned char *out)
+{
+	int sub[CDF_MAX_DIMS], size = v->size, i, d;
+	long long stride[CDF_MAX_DIMS], k, m;
+	unsigned char *dst;
+
+	if ( v->nvalues == 1 && !f->swap ) {
+		memcpy(out + r * size, src, size);
+		return;
+	}
+	/* the record is row major, MATLAB has the first dimension fastest */
+	m = ld;
+	for ( i = 0; i < v->ndims; i++ ) {
+		d = mat_dim(v, i);
+		stride[d] = m;
+		m *= v->dims[d];
+		sub[d] = 0;
+	}
+	m = r;
+	for ( k = 0; k < v->nvalues; k++, src += size ) {
+		dst = out + m * size;
+		if ( f->swap )
+			for ( i = 0; i < size; i++ )
+				dst[i] = src[size - 1 - i];
+		else
+			memcpy(dst, src, size);
+		for ( d = v->ndims - 1; d >= 0; d-- ) {
+			m += stride[d];
+			if ( ++sub[d] < v->dims[d] )
+				break;
+			m -= stride[d] * v->dims[d];
+			sub[d] = 0;
+		}
+	}
+}
+
+/*
+ * COUNT records of V from FIRST into the first rows of OUT (LD x DIMS,
+ * MATLAB order)
+ */
+static int cdf_read(cdf_file *f, cdf_var *v, long long first, long long count,
+	long long ld, unsigned char *out, char *err)
+{
+	const unsigned char *data, *prev;
+	unsigned char *padrec = NULL;
+	const cdf_block *b;
+	long long r = first, end = first + count, stop;
+	int ib;
+
+	if ( v->bad )
+		return fail(err, "%s: %s: %s is not supported", f->path, v->name,
+			v->bad);
+	if ( first < 0 || count < 0 )
+		return fail(err, "%s: %s: bad record range", f->path, v->name);
+	ib = find_block(v, first);
+	while ( r < end ) {
+		b = &v->blocks[ib];
+		if ( ib < v->nblocks && b->first <= r ) {
+			if ( !(data = block_data(f, v, ib, err)) )
+				break;
+			stop = b->last + 1 < end ? b->last + 1 : end;
+			for ( ; r < stop; r++ )
+				put_record(f, v, data + (r - b->first) * v->rec_size,
+					r - first, ld, out);
+			ib++;
+			continue;
+		}
+		/* records missing up to the next block */
+		stop = ib < v->nblocks && b->first < end ? b->first : end;
+		if ( v->sparse == 0 && r <= v->maxrec ) {
+			fail(err, "%s: %s: record %lld does not exist", f->path,
+				v->name, r);
+			break;
+		}
+		if ( v->sparse == 2 && ib > 0 && r <= v->maxrec ) {
+			if ( !(prev = block_data(f, v, ib - 1, err)) )
+				break;
+			prev += (v->blocks[ib - 1].last - v->blocks[ib - 1].first) *
+				v->rec_size;
+		} else {
+			if ( !padrec ) {
+				long long k;
+
+				if ( !(padrec = malloc(v->rec_size)) ) {
+					fail(err, "%s: %s: out of memory", f->path, v->name);
+					break;
+				}
+				for ( k = 0; k < v->nvalues; k++ )
+					memcpy(padrec + k * v->size, v->pad, v->size);
+			}
+			prev = padrec;
+		}
+		for ( ; r < stop; r++ )
+			put_record(f, v, prev, r - first, ld, out);
+	}
+	free(padrec);
+	return r < end ? -1 : 0;
+}
+
+/* first record of the time variable V with a time >= T */
+static int lower_bound(cdf_file *f, cdf_var *v, double t, long long tt,
+	long long *rec, char *err)
+{
+	long long lo = 0, hi = v->maxrec + 1, mid, ival;
+	double dval;
+	int less;
+
+	while ( lo < hi ) {
+		mid = lo + (hi - lo) / 2;
+		if ( v->type == T_TT2000 ) {
+			if ( cdf_read(f, v, mid, 1, 1, (unsigned char *)&ival, err) )
+				return -1;
+			less = ival < tt;
+		} else {
+			if ( cdf_read(f, v, mid, 1, 1, (unsigned char *)&dval, err) )
+				return -1;
+			less = dval < t;
+		}
+		if ( less )
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	*rec = lo;
+	return 0;
+}
+
+/* a file of 'load' */
+typedef struct {
+	char *path;
+	cdf_file f;
+	cdf_var *vars[1];	/* TIMEVAR, then VARNAMES; more allocated */
+} load_file;
+
+typedef struct load_job load_job;
+typedef int (*load_fn)(load_job *, int);
+
+struct load_job {
+	int nfiles;
+	load_file **files;
+	long long *first, *count;	/* records within TINT */
+	long long *t0;			/* first time within TINT */
+	long long *row;			/* of the first record in the outputs */
+	char (*err)[ERR_LEN];
+	const char *timevar;
+	char **varnames;
+	int nvars;
+	long long tt[2];
+	long long rows;
+	unsigned char **out;
+	/* the pool */
+	int *todo;
+	int ntodo, next, failed;
+	load_fn fn;
+	pthread_mutex_t mtx;
+};
+
+/* ask the kernel to read ahead the blocks of V with records FIRST..+COUNT */
+static void prefetch(const cdf_file *f, const cdf_var *v, long long first,
+	long long count)
+{
+	long long page = sysconf(_SC_PAGESIZE), start, end = 0, b0, b1;
+	const unsigned char *p;
+	int ib;
+
+	if ( f->buf != f->map || count <= 0 || page <= 0 )
+		return;
+	start = -1;
+	for ( ib = find_block(v, first);
+		ib < v->nblocks && v->blocks[ib].first < first + count; ib++ ) {
+		if ( !(p = at(f, v->blocks[ib].offset, 8)) )
+			break;
+		b0 = v->blocks[ib].offset / page * page;
+		b1 = v->blocks[ib].offset + get64(p);
+		if ( b1 <= b0 || (unsigned long long)b1 > f->len )
+			break;
+		/* adjacent blocks in one call */
+		if ( start >= 0 && b0 > end ) {
+			madvise(f->map + start, (size_t)(end - start), MADV_WILLNEED);
+			start = -1;
+		}
+		if ( start < 0 )
+			start = b0;
+		if ( b1 > end )
+			end = b1;
+	}
+	if ( start >= 0 )
+		madvise(f->map + start, (size_t)(end - start), MADV_WILLNEED);
+}
+
+/* first pass: open file I, find its records within TINT, prefetch them */
+static int load_open(load_job *job, int i)
+{
+	load_file *lf = job->files[i];
+	cdf_file *f = &lf->f;
+	char *err = job->err[i];
+	long long end;
+	cdf_var *v;
+	int k;
+
+	if ( cdf_open(f, lf->path, err) )
+		return -1;
+	for ( k = 0; k <= job->nvars; k++ ) {
+		const char *name = k ? job->varnames[k - 1] : job->timevar;
+
+		if ( !(v = cdf_find(f, name)) )
+			return fail(err, "%s: no variable %s", f->path, name);
+		if ( v->bad )
+			return fail(err, "%s: %s: %s is not supported", f->path,
+				v->name, v->bad);
+		if ( !v->recvary )
+			return fail(err, "%s: %s is not record varying", f->path,
+				v->name);
+		lf->vars[k] = v;
+	}
+	v = lf->vars[0];
+	if ( v->type != T_TT2000 || v->nvalues != 1 )
+		return fail(err, "%s: %s is not a TT2000 time line", f->path,
+			v->name);
+	if ( lower_bound(f, v, 0, job->tt[0], &job->first[i], err) ||
+		lower_bound(f, v, 0, job->tt[1], &end, err) )
+		return -1;
+	job->count[i] = end > job->first[i] ? end - job->first[i] : 0;
+	if ( !job->count[i] )
+		return 0;
+	if ( cdf_read(f, v, job->first[i], 1, 1, (unsigned char *)&job->t0[i],
+		err) )
+		return -1;
+	for ( k = 1; k <= job->nvars; k++ )
+		prefetch(f, lf->vars[k], job->first[i], job->count[i]);
+	return 0;
+}
+
+/* second pass: read the records of file I into its rows of the outputs */
+static int load_read(load_job *job, int i)
+{
+	load_file *lf = job->files[i];
+	cdf_var *v;
+	int k;
+
+	for ( k = 1; k <= job->nvars; k++ ) {
+		v = lf->vars[k];
+		if ( cdf_read(&lf->f, v, job->first[i], job->count[i], job->rows,
+			job->out[k - 1] + job->row[i] * v->size, job->err[i]) )
+			return -1;
+	}
+	cdf_close(&lf->f);
+	return 0;
+}
+
+static void *load_worker(void *arg)
+{
+	load_job *job = arg;
+	int i;
+
+	for (;;) {
+		pthread_mutex_lock(&job->mtx);
+		if ( job->failed || job->next >= job->ntodo ) {
+			pthread_mutex_unlock(&job->mtx);
+			break;
+		}
+		i = job->todo[job->next++];
+		pthread_mutex_unlock(&job->mtx);
+
+		if ( job->fn(job, i) ) {
+			pthread_mutex_lock(&job->mtx);
+			job->failed = 1;
+			pthread_mutex_unlock(&job->mtx);
+		}
+	}
+	return NULL;
+}
+
+/* FN for the files in job->todo on up to NTHREADS threads */
+static int load_run(load_job *job, load_fn fn, int nthreads)
+{
+	pthread_t tid[MAX_THREADS];
+	int i, nstarted = 0;
+
+	job->fn = fn;
+	job->next = 0;
+	if ( nthreads > job->ntodo )
+		nthreads = job->ntodo;
+	for ( i = 0; i < nthreads; i++ )
+		if ( pthread_create(tid + nstarted, NULL, load_worker, job) == 0 )
+			nstarted++;
+	if ( nstarted == 0 )
+		load_worker(job);
+	for ( i = 0; i < nstarted; i++ )
+		pthread_join(tid[i], NULL);
+	return job->failed ? -1 : 0;
+}
+
+/* the message of the first file that failed */
+static const char *load_error(const load_job *job)
+{
+	int i;
+
+	for ( i = 0; i < job->nfiles; i++ )
+		if ( job->err[i][0] )
+			return job->err[i];
+	return "out of memory";
+}
+
+/* order of the files with records within TINT */
+static const load_job *sort_job;
+
+static int cmp_file(const void *a, const void *b)
+{
+	int i = *(const int *)a, j = *(const int *)b;
+
+	if ( sort_job->t0[i] != sort_job->t0[j] )
+		return sort_job->t0[i] < sort_job->t0[j] ? -1 : 1;
+	return i - j;
+}
+
+/* the variables of file I must have the type and dimensions of file J */
+static int same_vars(load_job *job, int i, int j)
+{
+	const cdf_var *v, *w;
+	int k, d;
+
+	for ( k = 1; k <= job->nvars; k++ ) {
+		v = job->files[i]->vars[k];
+		w = job->files[j]->vars[k];
+		if ( v->type != w->type || v->ndims != w->ndims )
+			break;
+		for ( d = 0; d < v->ndims && v->dims[d] == w->dims[d]; d++ )
+			;
+		if ( d < v->ndims )
+			break;
+	}
+	if ( k > job->nvars )
+		return 0;
+	return fail(job->err[i], "%s: %s differs from the one in %s",
+		job->files[i]->f.path, v->name, job->files[j]->f.path);
+}
+
+/* the job of 'load', allocated on the MATLAB thread */
+static void load_init(load_job *job, const mxArray *filenames,
+	const mxArray *timevar, const mxArray *varnames)
+{
+	int i, k;
+
+	memset(job, 0, sizeof(*job));
+	job->nfiles = (int)mxGetNumberOfElements(filenames);
+	job->nvars = mxIsCell(varnames) ?
+		(int)mxGetNumberOfElements(varnames) : 1;
+	if ( !(job->timevar = mxArrayToString(timevar)) )
+		mexErrMsgTxt("TIMEVAR must be a string.");
+	job->varnames = mxCalloc(job->nvars, sizeof(char *));
+	for ( k = 0; k < job->nvars; k++ ) {
+		job->varnames[k] = mxArrayToString(mxIsCell(varnames) ?
+			mxGetCell(varnames, k) : varnames);
+		if ( !job->varnames[k] )
+			mexErrMsgTxt("VARNAMES must be a string or a cell array of strings.");
+	}
+	job->files = mxCalloc(job->nfiles, sizeof(load_file *));
+	for ( i = 0; i < job->nfiles; i++ ) {
+		job->files[i] = mxCalloc(1, sizeof(load_file) +
+			job->nvars * sizeof(cdf_var *));
+		job->files[i]->path = mxArrayToString(mxGetCell(filenames, i));
+		if ( !job->files[i]->path )
+			mexErrMsgTxt("FILENAMES must be a cell array of strings.");
+	}
+	job->first = mxCalloc(job->nfiles, sizeof(long long));
+	job->count = mxCalloc(job->nfiles, sizeof(long long));
+	job->t0 = mxCalloc(job->nfiles, sizeof(long long));
+	job->row = mxCalloc(job->nfiles, sizeof(long long));
+	job->err = mxCalloc(job->nfiles, ERR_LEN);
+	job->out = mxCalloc(job->nvars, sizeof(unsigned char *));
+	job->todo = mxCalloc(job->nfiles, sizeof(int));
+	pthread_mutex_init(&job->mtx, NULL);
+}
+
+static void load_free(load_job *job)
+{
+	int i;
+
+	for ( i = 0; i < job->nfiles; i++ ) {
+		cdf_close(&job->files[i]->f);
+		mxFree(job->files[i]->path);
+		mxFree(job->files[i]);
+	}
+	for ( i = 0; i < job->nvars; i++ )
+		mxFree(job->varnames[i]);
+	mxFree(job->varnames);
+	mxFree((char *)job->timevar);
+	mxFree(job->files);
+	mxFree(job->first);
+	mxFree(job->count);
+	mxFree(job->t0);
+	mxFree(job->row);
+	mxFree(job->err);
+	mxFree(job->out);
+	mxFree(job->todo);
+	pthread_mutex_destroy(&job->mtx);
+}
+
+/* load_free() and the error of the first file that failed */
+static void load_fail(load_job *job)
+{
+	char err[ERR_LEN];
+
+	snprintf(err, sizeof(err), "%s", load_error(job));
+	load_free(job);
+	mexErrMsgIdAndTxt("irf_cdfread_mx:unsupported", "%s", err);
+}
+
+/* open FILENAME as cur, unless it is open already and unchanged */
+static void use_file(const mxArray *arg)
+{
+	char path[PATH_MAX], err[ERR_LEN];
+	struct stat st;
+
+	if ( !mxIsChar(arg) || mxGetString(arg, path, sizeof(path)) )
+		mexErrMsgTxt("FILENAME must be a string.");
+	if ( cur.map && !strcmp(cur.path, path) && !stat(path, &st) &&
+		st.st_dev == cur.dev && st.st_ino == cur.ino &&
+		st.st_mtime == cur.mtime && st.st_size == cur.size )
+		return;
+	cdf_close(&cur);
+	if ( cdf_open(&cur, path, err) )
+		mexErrMsgIdAndTxt("irf_cdfread_mx:unsupported", "%s", err);
+}
+
+static cdf_var *use_var(const mxArray *arg)
+{
+	char name[257];
+	cdf_var *v;
+
+	if ( !mxIsChar(arg) || mxGetString(arg, name, sizeof(name)) )
+		mexErrMsgTxt("VARNAME must be a string.");
+	if ( !(v = cdf_find(&cur, name)) )
+		mexErrMsgIdAndTxt("irf_cdfread_mx:variableNotFound",
+			"%s: no variable %s", cur.path, name);
+	return v;
+}
+
+static long long get_record(const mxArray *arg, const char *what)
+{
+	double x;
+
+	if ( !mxIsDouble(arg) || mxGetNumberOfElements(arg) != 1 )
+		mexErrMsgIdAndTxt("irf_cdfread_mx:input", "%s must be a scalar.",
+			what);
+	x = mxGetScalar(arg);
+	if ( x < 0 || x != (long long)x )
+		mexErrMsgIdAndTxt("irf_cdfread_mx:input",
+			"%s must be a nonnegative integer.", what);
+	return (long long)x;
+}
+
+/* TINT as TT2000 ns (or EPOCH ms) and as double */
+static void get_tint(const mxArray *arg, double t[2], long long tt[2])
+{
+	int i;
+
+	if ( mxGetNumberOfElements(arg) != 2 ||
+		!(mxIsDouble(arg) || mxIsInt64(arg)) )
+		mexErrMsgTxt("TINT must be a double or int64 [START STOP].");
+	for ( i = 0; i < 2; i++ ) {
+		if ( mxIsInt64(arg) ) {
+			tt[i] = ((const long long *)mxGetData(arg))[i];
+			t[i] = (double)tt[i];
+		} else {
+			t[i] = mxGetPr(arg)[i];
+			tt[i] = t[i] >= 9.2e18 ? LLONG_MAX :
+				t[i] <= -9.2e18 ? LLONG_MIN : (long long)t[i];
+		}
+	}
+}
+
+/* COUNT x DIMS array for records of V */
+static mxArray *create_records(const cdf_var *v, long long count)
+{
+	mwSize dims[CDF_MAX_DIMS + 1];
+	int i;
+
+	dims[0] = (mwSize)count;
+	dims[1] = 1;
+	for ( i = 0; i < v->ndims; i++ )
+		dims[i + 1] = v->dims[mat_dim(v, i)];
+	return mxCreateNumericArray(v->ndims > 1 ? v->ndims + 1 : 2, dims,
+		value_class(v->type), mxREAL);
+}
+
+static void close_at_exit(void)
+{
+	cdf_close(&cur);
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	char cmd[16], err[ERR_LEN];
+	long long first, count, tt[2];
+	double t[2];
+	cdf_var *v;
+	int i;
+
+	mexAtExit(close_at_exit);
+	if ( nrhs < 1 || !mxIsChar(prhs[0]) || mxGetString(prhs[0], cmd, sizeof(cmd)) )
+		mexErrMsgTxt("Usage: irf_cdfread_mx('range'|'read'|'load'|'close', ...)");
+
+	if ( !strcmp(cmd, "close") ) {
+		cdf_close(&cur);
+		return;
+	}
+
+	if ( !strcmp(cmd, "range") ) {
+		if ( nrhs != 4 || nlhs > 2 )
+			mexErrMsgTxt("Usage: [FIRST, COUNT] = irf_cdfread_mx('range', FILENAME, TIMEVAR, TINT)");
+		get_tint(prhs[3], t, tt);
+		use_file(prhs[1]);
+		v = use_var(prhs[2]);
+		if ( (v->type != T_TT2000 && v->type != T_EPOCH) || v->nvalues != 1 )
+			mexErrMsgIdAndTxt("irf_cdfread_mx:unsupported",
+				"%s: %s is not a TT2000 or EPOCH time line", cur.path,
+				v->name);
+		if ( lower_bound(&cur, v, t[0], tt[0], &first, err) ||
+			lower_bound(&cur, v, t[1], tt[1], &count, err) )
+			mexErrMsgIdAndTxt("irf_cdfread_mx:unsupported", "%s", err);
+		count = count > first ? count - first : 0;
+		plhs[0] = mxCreateDoubleScalar((double)first);
+		if ( nlhs > 1 )
+			plhs[1] = mxCreateDoubleScalar((double)count);
+		return;
+	}
+
+	if ( !strcmp(cmd, "read") ) {
+		if ( nrhs != 5 || nlhs > 1 )
+			mexErrMsgTxt("Usage: DATA = irf_cdfread_mx('read', FILENAME, VARNAME, FIRST, COUNT)");
+		first = get_record(prhs[3], "FIRST");
+		count = get_record(prhs[4], "COUNT");
+		use_file(prhs[1]);
+		v = use_var(prhs[2]);
+		plhs[0] = create_records(v, count);
+		if ( cdf_read(&cur, v, first, count, count,
+			(unsigned char *)mxGetData(plhs[0]), err) ) {
+			mxDestroyArray(plhs[0]);
+			mexErrMsgIdAndTxt("irf_cdfread_mx:unsupported", "%s", err);
+		}
+		return;
+	}
+
+	if ( !strcmp(cmd, "load") ) {
+		load_job job;
+		mxArray *data;
+		int nthreads, ref;
+
+		if ( nrhs < 5 || nrhs > 6 || nlhs > 1 )
+			mexErrMsgTxt("Usage: DATA = irf_cdfread_mx('load', FILENAMES, TIMEVAR, TINT, VARNAMES, NTHREADS)");
+		if ( !mxIsCell(prhs[1]) )
+			mexErrMsgTxt("FILENAMES must be a cell array of strings.");
+		get_tint(prhs[3], t, tt);
+		nthreads = nrhs > 5 ? (int)get_record(prhs[5], "NTHREADS") : 0;
+		if ( nthreads == 0 )
+			nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+		if ( nthreads < 1 )
+			nthreads = 1;
+		if ( nthreads > MAX_THREADS )
+			nthreads = MAX_THREADS;
+		load_init(&job, prhs[1], prhs[2], prhs[4]);
+		job.tt[0] = tt[0];
+		job.tt[1] = tt[1];
+
+		for ( i = 0; i < job.nfiles; i++ )
+			job.todo[i] = i;
+		job.ntodo = job.nfiles;
+		if ( load_run(&job, load_open, nthreads) )
+			load_fail(&job);
+
+		/* the files with records within TINT, in time order */
+		job.ntodo = 0;
+		for ( i = 0; i < job.nfiles; i++ )
+			if ( job.count[i] )
+				job.todo[job.ntodo++] = i;
+		sort_job = &job;
+		qsort(job.todo, job.ntodo, sizeof(int), cmp_file);
+		ref = job.ntodo ? job.todo[0] : 0;
+		for ( i = 0; i < job.ntodo; i++ ) {
+			if ( same_vars(&job, job.todo[i], ref) )
+				load_fail(&job);
+			job.row[job.todo[i]] = job.rows;
+			job.rows += job.count[job.todo[i]];
+		}
+
+		plhs[0] = mxCreateCellMatrix(1, job.nvars);
+		for ( i = 0; i < job.nvars && job.nfiles; i++ ) {
+			data = create_records(job.files[ref]->vars[i + 1], job.rows);
+			job.out[i] = mxGetData(data);
+			mxSetCell(plhs[0], i, data);
+		}
+		if ( load_run(&job, load_read, nthreads) ) {
+			mxDestroyArray(plhs[0]);
+			load_fail(&job);
+		}
+		load_free(&job);
+		return;
+	}
+
+	mexErrMsgTxt("Command must be 'range', 'read', 'load' or 'close'.");
+}
@@ -0,0 +1,397 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <yuri@irfu.se> wrote this file.  As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a beer in return.   Yuri Khotyaintsev
+ * ----------------------------------------------------------------------------
+ *
+ * irf_isotime_mx.c  MEX function to convert times to ISO strings
+ *
+ * S = IRF_ISOTIME_MX(T, KIND, DIGITS, [LEAPS])
+ *
+ * Returns a char matrix with one row "yyyy-mm-ddThh:mm:ss.fffZ" for every
+ * element of T, with DIGITS (0..9) fractional digits. KIND gives the time
+ * scale of T:
+ *
+ *   'epoch' - double seconds since 1970-01-01 (ISDAT epoch), rounded to
+ *             DIGITS as in EPOCH2ISO
+ *   'ttns'  - int64 TT2000 nanoseconds, truncated to DIGITS as in
+ *             SPDFENCODETT2000. Leap seconds come out as hh:mm:60.
+ *   'cef'   - double milliseconds since 1958-01-01 (CEFLIB), whole
+ *             seconds truncated and fractions rounded as in CEFLIB
+ *
+ * LEAPS is an optional leap second table replacing the built-in one, rows
+ * of [YEAR MONTH DAY TAI-UTC MJD DRIFT] as returned by
+ * GenericTimeArray.leap_seconds(). Before 1972 TAI-UTC drifts by DRIFT
+ * seconds a day from MJD on, as in the CDF library, and before the first
+ * row it is 0.
+ *
+ * Date strings are reused while consecutive times fall on the same day,
+ * so only the time of day is formatted for most rows.
+ *
+ * Compile with:
+ *   mex -v irf_isotime_mx.c CFLAGS='$CFLAGS -O2'
+ *
+ * $Id$
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+
+/*
+ * This typedef is needed for MATLAB < 7.3
+ */
+#ifndef MWSIZE_MAX
+typedef int mwSize;
+#endif
+
+#define MAX_LEAPS 128
+#define NS 1000000000LL
+#define TT_OFFSET 32184000000LL		/* TT - TAI in ns */
+#define J2000_UNIX 946728000LL		/* 2000-01-01T12:00:00 in seconds since 1970 */
+#define DAYS_1958 (-4383LL)		/* 1958-01-01 in days since 1970 */
+#define DAYS_2000 10957LL		/* 2000-01-01 in days since 1970 */
+#define MJD_1970 40587LL		/* 1970-01-01 as modified Julian day */
+
+enum kind { K_EPOCH, K_TTNS, K_CEF };
+
+typedef struct {
+	long long tt;	/* TT2000 ns at the start of the day */
+	long long day;	/* the day, since 1970 */
+	double dat;	/* TAI-UTC from then on, at MJD */
+	double mjd;	/* before 1972 TAI-UTC drifts by DRIFT s/day from MJD */
+	double drift;
+} leap_t;
+
+static const double builtin_leaps[][6] = {
+	{1960, 1, 1, 1.4178180, 37300, 0.001296}, {1961, 1, 1, 1.4228180, 37300, 0.001296},
+	{1961, 8, 1, 1.3728180, 37300, 0.001296}, {1962, 1, 1, 1.8458580, 37665, 0.0011232},
+	{1963, 11, 1, 1.9458580, 37665, 0.0011232}, {1964, 1, 1, 3.2401300, 38761, 0.001296},
+	{1964, 4, 1, 3.3401300, 38761, 0.001296}, {1964, 9, 1, 3.4401300, 38761, 0.001296},
+	{1965, 1, 1, 3.5401300, 38761, 0.001296}, {1965, 3, 1, 3.6401300, 38761, 0.001296},
+	{1965, 7, 1, 3.7401300, 38761, 0.001296}, {1965, 9, 1, 3.8401300, 38761, 0.001296},
+	{1966, 1, 1, 4.3131700, 39126, 0.002592}, {1968, 2, 1, 4.2131700, 39126, 0.002592},
+	{1972, 1, 1, 10}, {1972, 7, 1, 11}, {1973, 1, 1, 12}, {1974, 1, 1, 13},
+	{1975, 1, 1, 14}, {1976, 1, 1, 15}, {1977, 1, 1, 16}, {1978, 1, 1, 17},
+	{1979, 1, 1, 18}, {1980, 1, 1, 19}, {1981, 7, 1, 20}, {1982, 7, 1, 21},
+	{1983, 7, 1, 22}, {1985, 7, 1, 23}, {1988, 1, 1, 24}, {1990, 1, 1, 25},
+	{1991, 1, 1, 26}, {1992, 7, 1, 27}, {1993, 7, 1, 28}, {1994, 7, 1, 29},
+	{1996, 1, 1, 30}, {1997, 7, 1, 31}, {1999, 1, 1, 32}, {2006, 1, 1, 33},
+	{2009, 1, 1, 34}, {2012, 7, 1, 35}, {2015, 7, 1, 36}, {2017, 1, 1, 37}
+};
+
+typedef struct {
+	long long day;	/* days since 1970 of DATE */
+	char date[11];
+} day_cache;
+
+static long long floor_div(long long a, long long b)
+{
+	long long q = a / b;
+	return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+/* Days since 1970-01-01 of a civil date */
+static long long days_from_civil(long long y, int m, int d)
+{
+	long long era;
+	unsigned yoe, doy, doe;
+
+	y -= m <= 2;
+	era = (y >= 0 ? y : y - 399) / 400;
+	yoe = (unsigned)(y - era * 400);
+	doy = (153*(m + (m > 2 ? -3 : 9)) + 2)/5 + d - 1;
+	doe = yoe * 365 + yoe/4 - yoe/100 + doy;
+	return era * 146097 + (long long)doe - 719468;
+}
+
+static void civil_from_days(long long z, long long *y, int *m, int *d)
+{
+	long long era;
+	unsigned doe, yoe, doy, mp;
+
+	z += 719468;
+	era = (z >= 0 ? z : z - 146096) / 146097;
+	doe = (unsigned)(z - era * 146097);
+	yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+	doy = doe - (365*yoe + yoe/4 - yoe/100);
+	mp = (5*doy + 2)/153;
+	*d = doy - (153*mp + 2)/5 + 1;
+	*m = mp < 10 ? mp + 3 : mp - 9;
+	*y = (long long)yoe + era * 400 + (*m <= 2);
+}
+
+static void put_digits(char *p, long long v, int n)
+{
+	while ( n-- > 0 ) {
+		p[n] = '0' + (char)(v % 10);
+		v /= 10;
+	}
+}
+
+/*
+ * Round X >= 0 to DIGITS decimals, as units of 10^-DIGITS. Near a tie
+ * the product may be off by an ulp, so printf decides those cases.
+ */
+static long long round_units(double x, int digits, long long scale)
+{
+	double y = x * (double)scale, f = y - floor(y);
+	char buf[48], *dot;
+
+	if ( fabs(f - 0.5) > y * 4e-16 + 1e-300 )
+		return (long long)floor(y + 0.5);
+	snprintf(buf, sizeof(buf), "%.*f", digits, x);
+	dot = strchr(buf, '.');
+	return strtoll(buf, NULL, 10) * scale + (dot ? strtoll(dot + 1, NULL, 10) : 0);
+}
+
+/* Row for DAY (since 1970), SOD seconds of day and FRAC fraction units */
+static void format_row(char *row, day_cache *dc, long long day, long long sod,
+		int leap, long long frac, int digits)
+{
+	if ( day != dc->day || !dc->date[0] ) {
+		long long y;
+		int m, d;
+		civil_from_days(day, &y, &m, &d);
+		put_digits(dc->date, y, 4);
+		dc->date[4] = '-';
+		put_digits(dc->date + 5, m, 2);
+		dc->date[7] = '-';
+		put_digits(dc->date + 8, d, 2);
+		dc->date[10] = '\0';
+		dc->day = day;
+	}
+	memcpy(row, dc->date, 10);
+	row[10] = 'T';
+	put_digits(row + 11, sod / 3600, 2);
+	row[13] = ':';
+	put_digits(row + 14, sod / 60 % 60, 2);
+	row[16] = ':';
+	put_digits(row + 17, leap ? 60 : sod % 60, 2);
+	if ( digits > 0 ) {
+		row[19] = '.';
+		put_digits(row + 20, frac, digits);
+		row[20 + digits] = 'Z';
+	} else
+		row[19] = 'Z';
+}
+
+static void fill_row(char *row, int width, const char *text)
+{
+	size_t n = strlen(text);
+	memset(row, ' ', width);
+	memcpy(row, text, n < (size_t)width ? n : (size_t)width);
+}
+
+/* TAI-UTC in ns on DAY (since 1970), truncated as in the CDF library */
+static long long leap_dat(const leap_t *l, long long day)
+{
+	return (long long)((l->dat + ((double)(day + MJD_1970) + 0.5 - l->mjd) * l->drift) * 1e9);
+}
+
+/*
+ * TAI-UTC in ns on DAY from the last of the first N entries starting at or
+ * before it, 0 before the table, as LeapSecondsfromYMD of the CDF library
+ */
+static long long date_dat(const leap_t *leaps, int n, long long day)
+{
+	while ( n > 0 && leaps[n - 1].day > day )
+		n--;
+	return n > 0 ? leap_dat(&leaps[n - 1], day) : 0;
+}
+
+static void set_leap(leap_t *l, long long y, int m, int d, double dat, double mjd,
+		double drift)
+{
+	long long day = days_from_civil(y, m, d);
+
+	l->day = day;
+	l->dat = dat;
+	l->mjd = mjd;
+	l->drift = drift;
+	l->tt = ((day - DAYS_2000)*86400 - 43200) * NS + leap_dat(l, day) + TT_OFFSET;
+}
+
+static int load_leaps(leap_t *leaps, const mxArray *tab)
+{
+	int n = 0, k, nrows;
+	const double *p;
+
+	if ( tab == NULL ) {
+		nrows = sizeof(builtin_leaps) / sizeof(builtin_leaps[0]);
+		for ( k = 0; k < nrows; k++ ) {
+			const double *b = builtin_leaps[k];
+			set_leap(&leaps[n++], (long long)b[0], (int)b[1], (int)b[2], b[3], b[4], b[5]);
+		}
+		return n;
+	}
+
+	if ( !mxIsDouble(tab) || mxGetN(tab) < 4 )
+		mexErrMsgTxt("LEAPS must be a double matrix [YEAR MONTH DAY TAI-UTC ...].");
+	nrows = (int)mxGetM(tab);
+	p = mxGetPr(tab);
+	for ( k = 0; k < nrows && n < MAX_LEAPS; k++ ) {
+		int drifts = mxGetN(tab) >= 6 && p[k + 5*nrows] != 0;
+		if ( p[k] < 1972 && !drifts )
+			continue;
+		set_leap(&leaps[n++], (long long)p[k], (int)p[k + nrows], (int)p[k + 2*nrows],
+				p[k + 3*nrows], drifts ? p[k + 4*nrows] : 0, drifts ? p[k + 5*nrows] : 0);
+	}
+	return n;
+}
+
+/* Last leap second entry at or before TT, -1 before the table */
+static int find_leap(const leap_t *leaps, int n, long long tt, int hint)
+{
+	int lo, hi;
+
+	if ( hint >= 0 && hint < n && leaps[hint].tt <= tt &&
+			(hint + 1 == n || tt < leaps[hint + 1].tt) )
+		return hint;
+	lo = -1;
+	hi = n;
+	while ( hi - lo > 1 ) {
+		int mid = (lo + hi) / 2;
+		if ( leaps[mid].tt <= tt )
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+	char kind_str[8], *rows;
+	enum kind kind = K_EPOCH;
+	int digits, width, nleaps = 0, hint = -1;
+	long long scale = 1;
+	mwSize n, i, dims[2];
+	const double *t = NULL;
+	const long long *tt = NULL;
+	mxChar *out;
+	leap_t leaps[MAX_LEAPS];
+	day_cache dc;
+
+	if ( nrhs < 3 || nrhs > 4 )
+		mexErrMsgTxt("Usage: S = irf_isotime_mx(T, KIND, DIGITS, [LEAPS])");
+	if ( nlhs > 1 )
+		mexErrMsgTxt("Too many output arguments.");
+	if ( !mxIsChar(prhs[1]) || mxGetString(prhs[1], kind_str, sizeof(kind_str)) )
+		mexErrMsgTxt("KIND must be 'epoch', 'ttns' or 'cef'.");
+	if ( strcmp(kind_str, "epoch") == 0 )
+		kind = K_EPOCH;
+	else if ( strcmp(kind_str, "ttns") == 0 )
+		kind = K_TTNS;
+	else if ( strcmp(kind_str, "cef") == 0 )
+		kind = K_CEF;
+	else
+		mexErrMsgTxt("KIND must be 'epoch', 'ttns' or 'cef'.");
+	if ( !mxIsNumeric(prhs[2]) || mxGetNumberOfElements(prhs[2]) != 1 )
+		mexErrMsgTxt("DIGITS must be a scalar.");
+	digits = (int)mxGetScalar(prhs[2]);
+	if ( digits < 0 || digits > 9 )
+		mexErrMsgTxt("DIGITS must be between 0 and 9.");
+
+	if ( kind == K_TTNS ) {
+		if ( !mxIsInt64(prhs[0]) )
+			mexErrMsgTxt("T must be int64 for KIND 'ttns'.");
+		tt = (const long long *)mxGetData(prhs[0]);
+		nleaps = load_leaps(leaps, nrhs > 3 ? prhs[3] : NULL);
+	} else {
+		if ( !mxIsDouble(prhs[0]) || mxIsComplex(prhs[0]) )
+			mexErrMsgTxt("T must be real double.");
+		t = mxGetPr(prhs[0]);
+	}
+
+	for ( i = 0; i < (mwSize)digits; i++ )
+		scale *= 10;
+	width = 20 + (digits > 0 ? digits + 1 : 0);
+	n = mxGetNumberOfElements(prhs[0]);
+	rows = (char *)mxMalloc(n * width + 1);
+	memset(&dc, 0, sizeof(dc));
+
+	for ( i = 0; i < n; i++ ) {
+		char *row = rows + i * width;
+		long long sec, frac, units;
+		int leap = 0;
+
+		if ( kind == K_TTNS ) {
+			long long ns, epoch = J2000_UNIX;
+			int k;
+			if ( tt[i] == (long long)(-9223372036854775807LL - 1) ) {
+				/* CDF fill value */
+				fill_row(row, width, "9999-12-31T23:59:59.999999999");
+				row[width - 1] = 'Z';
+				continue;
+			}
+			if ( tt[i] == -9223372036854775807LL ) {
+				/* CDF pad value */
+				fill_row(row, width, "0000-01-01T00:00:00.000000000");
+				row[width - 1] = 'Z';
+				continue;
+			}
+			k = hint = find_leap(leaps, nleaps, tt[i], hint);
+			if ( k < 0 || leaps[k].drift != 0 ) {
+				/*
+				 * Before 1972 TAI-UTC changes from day to day. Like the CDF
+				 * library take it for the date of TAI, then for the date
+				 * that gives. Count from 2000-01-01T00:00 not to overflow.
+				 */
+				int m = k + 2 < nleaps ? k + 2 : nleaps;
+				ns = tt[i] + 43200 * NS - TT_OFFSET;
+				ns -= date_dat(leaps, m, floor_div(ns - date_dat(leaps, m,
+						floor_div(ns, 86400 * NS) + DAYS_2000), 86400 * NS) + DAYS_2000);
+				epoch -= 43200;
+			} else {
+				ns = tt[i] - TT_OFFSET - leap_dat(&leaps[k], 0);
+				if ( k + 1 < nleaps && tt[i] >= leaps[k + 1].tt - NS ) {
+					ns -= NS;	/* inserted second, shown as 23:59:60 */
+					leap = 1;
+				}
+			}
+			sec = floor_div(ns, NS);
+			frac = (ns - sec * NS) / (NS / scale);
+			sec += epoch;
+		} else {
+			double x, minute;
+			if ( !mxIsFinite(t[i]) ) {
+				fill_row(row, width, "NaN");
+				continue;
+			}
+			if ( kind == K_EPOCH ) {
+				minute = floor(t[i] / 60.0);
+				x = t[i] - minute * 60.0;
+				units = digits ? round_units(x, digits, scale) : (long long)floor(x + 0.5);
+			} else {
+				double isec = floor(t[i] / 1000.0);
+				minute = floor(t[i] / 60000.0);
+				x = (isec - minute * 60.0) + (t[i] - isec * 1000.0) / 1000.0;
+				units = digits ? round_units(x, digits, scale) : (long long)floor(x);
+			}
+			units += (long long)minute * 60 * scale;
+			sec = floor_div(units, scale);
+			frac = units - sec * scale;
+			if ( kind == K_CEF )
+				sec += DAYS_1958 * 86400;
+		}
+		format_row(row, &dc, floor_div(sec, 86400), sec - floor_div(sec, 86400) * 86400,
+				leap, frac, digits);
+	}
+
+	/* MATLAB char matrices are stored by column */
+	dims[0] = n;
+	dims[1] = width;
+	plhs[0] = mxCreateCharArray(2, dims);
+	out = mxGetChars(plhs[0]);
+	for ( i = 0; i < n; i++ ) {
+		int j;
+		for ( j = 0; j < width; j++ )
+			out[i + j * n] = (mxChar)rows[i * width + j];
+	}
+	mxFree(rows);
+}
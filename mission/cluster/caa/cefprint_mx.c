@@ -14,62 +14,755 @@
  * 
  * Usage:
  *   STATUS = cefprint_mx(FILENAME,DATA,FORMAT_STRING)
+ *   STATUS = cefprint_mx(FILENAME,DATA,FORMAT_STRING,NTHREADS)
+ *
+ *   H = cefprint_mx('open',FILENAME[,NTHREADS])
+ *   STATUS = cefprint_mx('append',H,DATA[,FORMAT_STRING])
+ *   STATUS = cefprint_mx('close',H)
  *
  *   FORMAT_STRING is optional, and should be an n-column array, where n is the number of data columns in DATA
  *   FORMAT_STRING should be transposed from a n-row string array to account for the different row-column ordering in C
  *   e.g.: FORMAT_STRING=['%8.3f'; '%8.3f'; '%8.3f'; '%2.0f'; '%7.0f']';
+ *   FORMAT_STRING can be given as '' to use the default '%8.3f' for all columns
+ *
+ *   NTHREADS turns on the parallel mode, 0 means one thread per CPU.
+ *   Blocks of rows are formatted and deflated on worker threads, each block
+ *   as a separate gzip member (as pigz does), and the members are written
+ *   in order to FILENAME.gz. The header already in FILENAME goes into the
+ *   first member and FILENAME is removed afterwards, the same as gzip does.
+ *
+ *   The handle API writes the same compressed stream incrementally, so the
+ *   data can be exported chunk by chunk with bounded memory. 'open' starts
+ *   FILENAME.gz with the header already written to FILENAME and returns a
+ *   handle H (-1 on error), each 'append' adds the rows of DATA and
+ *   'close' writes END_OF_DATA. H is used with the NTHREADS set on 'open'
+ *   (default 1). After a failed 'append' the handle only takes 'close',
+ *   which returns the STATUS of that error and removes the .gz file.
+ *   Handles left open when the MEX file is cleared are closed and their
+ *   incomplete .gz files removed.
  *
  *   STATUS = 0 means everything went OK
  *   STATUS = 1 means error on the data writing stange
  *   STATUS = 2 means error on the compression stange
+ *
+ * Column formats are compiled once per call. Plain "%w.pf" specs are written
+ * digit by digit into the output buffer, giving the same text as sprintf;
+ * anything else (flags, other conversions, NaN/Inf) goes through sprintf.
+ * The calendar date is cached and gmtime() is only called on a new day.
+ *
+ * Compile with:
+ *   mex -v cefprint_mx.c CFLAGS='$CFLAGS -O2 -pthread' -lz
  */
 
 #include "mex.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <math.h>
+#include <ctype.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <zlib.h>
+
+#define ISO_LEN 27	/* YYYY-MM-DDThh:mm:ss.uuuuuuZ */
+#define MAX_PREC 9	/* largest precision handled by fmt_fixed() */
+#define BLOCK_BYTES (4<<20)	/* target size of a text block in parallel mode */
+#define MAX_THREADS 64
 
-/* converts ISDAT epoch to ISO time string */
-void epoch2iso(double *epoch, char *str)
+static const double pow10tab[MAX_PREC+1] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+
+/* compiled column format, parsed once from "%w.pf" */
+typedef struct {
+	int width;
+	int prec;
+	int fast;	/* 0 means fall back to snprintf with spec */
+	char spec[32];
+} col_fmt;
+
+/* calendar date of the last converted epoch */
+typedef struct {
+	time_t day0;	/* epoch of 00:00:00 of the cached day */
+	char date[11];	/* "YYYY-MM-DD" */
+} date_cache;
+
+/* write N decimal digits of V, zero padded */
+static char *put_digits(char *p, unsigned long v, int n)
+{
+	char *q = p + n;
+	while ( q > p ) {
+		*--q = '0' + (char)(v % 10);
+		v /= 10;
+	}
+	return p + n;
+}
+
+/* parse a printf spec; only plain "%w.pf" takes the fast path */
+static void compile_format(const char *s, int len, col_fmt *c)
+{
+	int i = 0;
+
+	if ( len > (int)sizeof(c->spec) - 1 )
+		len = sizeof(c->spec) - 1;
+	memcpy(c->spec, s, len);
+	c->spec[len] = '\0';
+	/* drop blank padding of the MATLAB char array */
+	while ( len > 0 && c->spec[len-1] == ' ' )
+		c->spec[--len] = '\0';
+
+	c->width = 0;
+	c->prec = 6;
+	c->fast = 0;
+
+	if ( c->spec[i++] != '%' || strchr("-+ #0", c->spec[i]) )
+		return;
+	while ( isdigit((unsigned char)c->spec[i]) )
+		c->width = c->width*10 + c->spec[i++] - '0';
+	if ( c->spec[i] == '.' ) {
+		i++;
+		c->prec = 0;
+		while ( isdigit((unsigned char)c->spec[i]) )
+			c->prec = c->prec*10 + c->spec[i++] - '0';
+	}
+	if ( c->spec[i] == 'f' && c->spec[i+1] == '\0' && c->prec <= MAX_PREC &&
+			c->width < 64 )
+		c->fast = 1;
+}
+
+/*
+ * Format X as sprintf(p, "%w.pf", x) would. Values which are not finite,
+ * too large for exact integer arithmetic, or too close to a rounding tie
+ * are handed to snprintf so that the output is always identical.
+ * Returns pointer past the last written character, NULL if the text does
+ * not fit before END.
+ */
+static char *fmt_fixed(char *p, char *end, double x, const col_fmt *c)
 {
-	time_t sec;
-	int ms;
-	struct tm *t;
+	char tmp[32], *q;
+	double s, r, frac;
+	unsigned long long u, ip;
+	int neg, n, pad;
 
-	sec = floor(*epoch);
-	ms = round((*epoch - (double)sec)*1000000);
+	if ( !c->fast || !isfinite(x) )
+		goto slow;
+	/* at most sizeof(tmp) characters padded to the width */
+	if ( end - p < (c->width > (int)sizeof(tmp) ? c->width : (int)sizeof(tmp)) )
+		return NULL;
+
+	s = fabs(x) * pow10tab[c->prec];
+	if ( s >= 4503599627370496.0 ) /* 2^52 */
+		goto slow;
+	r = floor(s);
+	frac = s - r;
+	if ( fabs(frac - 0.5) <= s*4e-16 + 1e-300 )
+		goto slow;
+	u = (unsigned long long)r + (frac > 0.5);
+	neg = signbit(x) ? 1 : 0;
+
+	/* build the number right to left in tmp */
+	q = tmp + sizeof(tmp);
+	if ( c->prec > 0 ) {
+		ip = u / (unsigned long long)pow10tab[c->prec];
+		q -= c->prec;
+		put_digits(q, (unsigned long)(u - ip*(unsigned long long)pow10tab[c->prec]),
+				c->prec);
+		*--q = '.';
+	} else
+		ip = u;
+	do {
+		*--q = '0' + (char)(ip % 10);
+		ip /= 10;
+	} while ( ip );
+	if ( neg )
+		*--q = '-';
+
+	n = (int)(tmp + sizeof(tmp) - q);
+	for ( pad = c->width - n; pad > 0; pad-- )
+		*p++ = ' ';
+	memcpy(p, q, n);
+	return p + n;
+
+slow:
+	n = snprintf(p, end - p, c->spec, x);
+	return n < 0 || n >= end - p ? NULL : p + n;
+}
+
+/*
+ * Converts ISDAT epoch to ISO time string. gmtime() is only called when
+ * the day changes, otherwise the time of day is written from the cache.
+ * Returns pointer past the last written character.
+ */
+static char *epoch2iso(double epoch, date_cache *dc, char *p)
+{
+	time_t sec, sod;
+	long us;
+	struct tm t;
+
+	sec = floor(epoch);
+	us = round((epoch - (double)sec)*1000000);
 
 	/* Check if we round up to a whole second */
-	if ( ms >= 1000000 )
-	{
-		ms = ms - 1000000;
+	if ( us >= 1000000 ) {
+		us = us - 1000000;
 		sec++;
 	}
-	
-	t = gmtime(&sec);
-	
-	sprintf(str, "%.4d-%.2d-%.2d%c%.2d:%.2d:%.2d.%.6d%c",
-		t->tm_year + 1900, t->tm_mon + 1, t->tm_mday, 'T',
-		t->tm_hour, t->tm_min, t->tm_sec, ms, 'Z');
+
+	if ( !dc->date[0] || sec < dc->day0 || sec >= dc->day0 + 86400 ) {
+		gmtime_r(&sec, &t);
+		put_digits(dc->date, t.tm_year + 1900, 4);
+		dc->date[4] = '-';
+		put_digits(dc->date + 5, t.tm_mon + 1, 2);
+		dc->date[7] = '-';
+		put_digits(dc->date + 8, t.tm_mday, 2);
+		dc->day0 = sec - (t.tm_hour*3600 + t.tm_min*60 + t.tm_sec);
+	}
+	sod = sec - dc->day0;
+
+	memcpy(p, dc->date, 10);
+	p[10] = 'T';
+	put_digits(p + 11, sod/3600, 2);
+	p[13] = ':';
+	put_digits(p + 14, (sod/60)%60, 2);
+	p[16] = ':';
+	put_digits(p + 17, sod%60, 2);
+	p[19] = '.';
+	put_digits(p + 20, us, 6);
+	p[26] = 'Z';
+	return p + ISO_LEN;
+}
+
+/*
+ * Usual length of a formatted row, to size the buffers. snprintf() may
+ * write more for wide specs or huge values, format_rows() checks.
+ */
+static size_t row_size_max(const col_fmt *cf, int ncols)
+{
+	size_t n = ISO_LEN + 8;
+	int j;
+
+	for ( j=0; j<ncols; j++ )
+		n += 2 + (cf[j].fast ? (cf[j].width > 32 ? cf[j].width : 32) : 360);
+	return n;
+}
+
+/*
+ * Format rows [*I,I1) of DATA into [P,END), returns pointer past the last
+ * complete row. *I is left at the first row that did not fit.
+ */
+static char *format_rows(char *p, char *end, const double *data, int d_mrows,
+		int d_ncols, const col_fmt *cf, date_cache *dc, int *i, int i1)
+{
+	char *q;
+	int j;
+
+	for ( ; *i<i1; (*i)++ ) {
+		if ( end - p < ISO_LEN )
+			return p;
+		q = epoch2iso(data[*i], dc, p);
+		for ( j=1; j<d_ncols && q; j++ ) {
+			if ( end - q < 2 )
+				return p;
+			*q++ = ',';
+			*q++ = ' ';
+			q = fmt_fixed(q, end, data[(size_t)d_mrows*j + *i], cf + j - 1);
+		}
+		if ( q == NULL || end - q < 3 )
+			return p;
+		memcpy(q, " $\n", 3);
+		p = q + 3;
+	}
+	return p;
+}
+
+/*
+ * Compress LEN bytes of IN into a complete gzip member.
+ * OUT is malloc()ed, returns 0 on success.
+ */
+static int gz_member(const char *in, size_t len, unsigned char **out, size_t *outlen)
+{
+	z_stream zs;
+
+	memset(&zs, 0, sizeof(zs));
+	/* windowBits 15+16 makes deflate write the gzip header and trailer */
+	if ( deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15+16, 8,
+			Z_DEFAULT_STRATEGY) != Z_OK )
+		return -1;
+	*out = malloc(deflateBound(&zs, len));
+	if ( *out == NULL ) {
+		deflateEnd(&zs);
+		return -1;
+	}
+	zs.next_in = (Bytef *)in;
+	zs.avail_in = len;
+	zs.next_out = *out;
+	zs.avail_out = deflateBound(&zs, len);
+	if ( deflate(&zs, Z_FINISH) != Z_STREAM_END ) {
+		deflateEnd(&zs);
+		free(*out);
+		*out = NULL;
+		return -1;
+	}
+	*outlen = zs.total_out;
+	deflateEnd(&zs);
+	return 0;
+}
+
+/* compressed block waiting to be written */
+typedef struct {
+	int ready;
+	unsigned char *gz;
+	size_t len;
+} gz_slot;
+
+/* state shared between the writer and the worker threads */
+typedef struct {
+	const double *data;
+	int d_mrows, d_ncols;
+	const col_fmt *cf;
+	size_t row_max;
+	int rows_per_block, nblocks;
+	int next;	/* next block to format */
+	int written;	/* blocks written to the file */
+	int error;
+	int nslots;	/* blocks in flight, bounds the memory use */
+	gz_slot *slots;
+	pthread_mutex_t mtx;
+	pthread_cond_t cv_ready, cv_space;
+} par_job;
+
+static void *par_worker(void *arg)
+{
+	par_job *job = arg;
+	date_cache dc;
+	char *text, *p, *tmp;
+	unsigned char *gz;
+	size_t len, text_size, used;
+	int b, i, i0, i1, err;
+
+	text_size = job->rows_per_block * job->row_max;
+	text = malloc(text_size);
+
+	for (;;) {
+		pthread_mutex_lock(&job->mtx);
+		while ( !job->error && job->next < job->nblocks &&
+				job->next - job->written >= job->nslots )
+			pthread_cond_wait(&job->cv_space, &job->mtx);
+		if ( text == NULL )
+			job->error = 1;
+		if ( job->error || job->next >= job->nblocks ) {
+			pthread_cond_broadcast(&job->cv_ready);
+			pthread_mutex_unlock(&job->mtx);
+			break;
+		}
+		b = job->next++;
+		pthread_mutex_unlock(&job->mtx);
+
+		i0 = b * job->rows_per_block;
+		i1 = i0 + job->rows_per_block;
+		if ( i1 > job->d_mrows )
+			i1 = job->d_mrows;
+		memset(&dc, 0, sizeof(dc));
+		/* the block buffer is doubled until the rows fit */
+		p = text;
+		err = 0;
+		for ( i=i0; i<i1; ) {
+			p = format_rows(p, text + text_size, job->data, job->d_mrows,
+					job->d_ncols, job->cf, &dc, &i, i1);
+			if ( i == i1 )
+				break;
+			used = p - text;
+			if ( (tmp = realloc(text, 2*text_size)) == NULL ) {
+				err = -1;
+				break;
+			}
+			p = tmp + used;
+			text = tmp;
+			text_size *= 2;
+		}
+		if ( !err )
+			err = gz_member(text, p - text, &gz, &len);
+
+		pthread_mutex_lock(&job->mtx);
+		if ( err )
+			job->error = 1;
+		else {
+			job->slots[b % job->nslots].gz = gz;
+			job->slots[b % job->nslots].len = len;
+			job->slots[b % job->nslots].ready = 1;
+		}
+		pthread_cond_broadcast(&job->cv_ready);
+		pthread_mutex_unlock(&job->mtx);
+	}
+
+	free(text);
+	return NULL;
+}
+
+/* compress and write a small piece of text on the calling thread */
+static int gz_write_text(FILE *fp, const char *text, size_t len)
+{
+	unsigned char *gz;
+	size_t gzlen;
+	int status = 0;
+
+	if ( gz_member(text, len, &gz, &gzlen) )
+		return 2;
+	if ( fwrite(gz, 1, gzlen, fp) != gzlen )
+		status = 1;
+	free(gz);
+	return status;
+}
+
+/* compressed output stream, also used for the handle API */
+typedef struct {
+	FILE *fp;
+	char *f_name;	/* plain file with the header, removed on close */
+	char *gz_name;
+	int nthreads;
+	int status;	/* first error of the stream, 0 if none */
+} cef_out;
+
+/*
+ * Start F_NAME.gz, the header already in F_NAME becomes the first member.
+ * Returns STATUS as described at the top of the file.
+ */
+static int out_open(cef_out *o, const char *f_name, int nthreads)
+{
+	char *header = NULL;
+	size_t hlen = 0;
+	int status = 0;
+	FILE *fp;
+
+	memset(o, 0, sizeof(cef_out));
+	o->nthreads = nthreads;
+
+	/* the header written by caa_export_cef.m */
+	if ( (fp = fopen(f_name, "rb")) != NULL ) {
+		fseek(fp, 0, SEEK_END);
+		hlen = ftell(fp);
+		fseek(fp, 0, SEEK_SET);
+		header = malloc(hlen + 1);
+		if ( header == NULL || fread(header, 1, hlen, fp) != hlen ) {
+			fclose(fp);
+			free(header);
+			return 1;
+		}
+		fclose(fp);
+	}
+
+	o->f_name = malloc(strlen(f_name) + 1);
+	o->gz_name = malloc(strlen(f_name) + 4);
+	strcpy(o->f_name, f_name);
+	strcpy(o->gz_name, f_name);
+	strcat(o->gz_name, ".gz");
+	if ( (o->fp = fopen(o->gz_name, "wb")) == NULL ) {
+		mexWarnMsgTxt("Cannot open output file");
+		free(header);
+		free(o->f_name);
+		free(o->gz_name);
+		return 1;
+	}
+
+	if ( hlen > 0 )
+		status = gz_write_text(o->fp, header, hlen);
+	free(header);
+	return status;
+}
+
+/*
+ * Format and compress DATA, blocks are written in order as gzip members.
+ * Returns STATUS as described at the top of the file.
+ */
+static int out_append(cef_out *o, const double *data, int d_mrows,
+		int d_ncols, const col_fmt *cf)
+{
+	par_job job;
+	pthread_t tid[MAX_THREADS];
+	int i, nthreads = o->nthreads, nstarted = 0, status = 0;
+
+	/* nothing more goes into a stream which is already broken */
+	if ( o->status )
+		return o->status;
+
+	memset(&job, 0, sizeof(job));
+	job.data = data;
+	job.d_mrows = d_mrows;
+	job.d_ncols = d_ncols;
+	job.cf = cf;
+	job.row_max = row_size_max(cf, d_ncols-1);
+	job.rows_per_block = BLOCK_BYTES / job.row_max + 1;
+	job.nblocks = (d_mrows + job.rows_per_block - 1) / job.rows_per_block;
+	if ( job.nblocks == 0 )
+		return 0;
+	job.nslots = 2*nthreads;
+	job.slots = calloc(job.nslots, sizeof(gz_slot));
+	if ( job.slots == NULL )
+		return o->status = 1;
+	pthread_mutex_init(&job.mtx, NULL);
+	pthread_cond_init(&job.cv_ready, NULL);
+	pthread_cond_init(&job.cv_space, NULL);
+
+	if ( nthreads > job.nblocks )
+		nthreads = job.nblocks;
+	for ( i=0; i<nthreads; i++ )
+		if ( pthread_create(tid + i, NULL, par_worker, &job) == 0 )
+			nstarted++;
+	if ( nstarted == 0 )
+		status = 1;
+
+	/* write the members in block order as they become ready */
+	for ( i=0; i<job.nblocks && status == 0; i++ ) {
+		gz_slot *sl = job.slots + i % job.nslots;
+
+		pthread_mutex_lock(&job.mtx);
+		while ( !sl->ready && !job.error )
+			pthread_cond_wait(&job.cv_ready, &job.mtx);
+		if ( !sl->ready ) {
+			pthread_mutex_unlock(&job.mtx);
+			status = 2;
+			break;
+		}
+		pthread_mutex_unlock(&job.mtx);
+
+		if ( fwrite(sl->gz, 1, sl->len, o->fp) != sl->len )
+			status = 1;
+		free(sl->gz);
+
+		pthread_mutex_lock(&job.mtx);
+		sl->gz = NULL;
+		sl->ready = 0;
+		job.written++;
+		pthread_cond_broadcast(&job.cv_space);
+		pthread_mutex_unlock(&job.mtx);
+	}
+
+	pthread_mutex_lock(&job.mtx);
+	if ( status )
+		job.error = 1;
+	pthread_cond_broadcast(&job.cv_space);
+	pthread_mutex_unlock(&job.mtx);
+	for ( i=0; i<nstarted; i++ )
+		pthread_join(tid[i], NULL);
+
+	for ( i=0; i<job.nslots; i++ )
+		free(job.slots[i].gz);
+	free(job.slots);
+	pthread_mutex_destroy(&job.mtx);
+	pthread_cond_destroy(&job.cv_ready);
+	pthread_cond_destroy(&job.cv_space);
+
+	if ( status ) {
+		mexWarnMsgTxt(status == 1 ? "Error writing to output file" :
+				"Error compressing output file");
+		o->status = status;
+	}
+	return status;
+}
+
+/*
+ * Finish the stream with END_OF_DATA unless STATUS, or an earlier append,
+ * is already an error. On success the plain header file is removed, on
+ * error the partial .gz file.
+ */
+static int out_close(cef_out *o, int status)
+{
+	if ( status == 0 )
+		status = o->status;
+	if ( status == 0 )
+		status = gz_write_text(o->fp, "END_OF_DATA\n", 12);
+	if ( fclose(o->fp) != 0 && status == 0 )
+		status = 1;
+
+	if ( status ) {
+		/* remove the corrupt .gz file */
+		unlink(o->gz_name);
+	} else
+		unlink(o->f_name);
+
+	free(o->f_name);
+	free(o->gz_name);
+	memset(o, 0, sizeof(cef_out));
+	return status;
+}
+
+/* NTHREADS argument, 0 or negative means one thread per CPU */
+static int get_nthreads(const mxArray *arg)
+{
+	int nthreads;
+
+	if ( !mxIsNumeric(arg) || mxGetNumberOfElements(arg) != 1 )
+		mexErrMsgTxt("NTHREADS must be a scalar.");
+	nthreads = (int)mxGetScalar(arg);
+	if ( nthreads <= 0 )
+		nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if ( nthreads < 1 )
+		nthreads = 1;
+	if ( nthreads > MAX_THREADS )
+		nthreads = MAX_THREADS;
+	return nthreads;
+}
+
+/* compile formatting string(s), once per column. FMT may be NULL or empty */
+static col_fmt *get_formats(const mxArray *fmt, int d_ncols)
+{
+	col_fmt *cf;
+	char *formats;
+	int j, formatlen;
+
+	cf = mxCalloc(d_ncols-1, sizeof(col_fmt));
+	if ( fmt != NULL && !mxIsEmpty(fmt) ) {
+		if ( mxIsChar(fmt) != 1 )
+			mexErrMsgTxt("FORMAT_STRING must be a string.");
+		if (mxGetN(fmt)!=d_ncols-1)
+			mexErrMsgTxt("FORMAT_STRING must have the same number of rows as the number of data columns.");
+		formatlen=mxGetM(fmt);
+		formats = mxArrayToString(fmt);
+		if(formats == NULL)
+			mexErrMsgTxt("Could not convert FORMAT_STRING to string.");
+		for ( j=0; j<d_ncols-1; j++ )
+			compile_format(formats+formatlen*j, formatlen, cf+j);
+		mxFree(formats);
+	} else
+		for ( j=0; j<d_ncols-1; j++ )
+			compile_format("%8.3f", 5, cf+j);
+	return cf;
+}
+
+/*
+ * Handle API, streams stay open between calls
+ */
+#define MAX_HANDLES 32
+
+static cef_out handles[MAX_HANDLES];
+
+/* called when the MEX file is cleared or MATLAB exits */
+static void close_all_handles(void)
+{
+	int i;
+
+	for ( i=0; i<MAX_HANDLES; i++ )
+		if ( handles[i].fp != NULL )
+			out_close(handles + i, 1);
+}
+
+static cef_out *get_handle(const mxArray *arg)
+{
+	int h;
+
+	if ( !mxIsNumeric(arg) || mxGetNumberOfElements(arg) != 1 )
+		mexErrMsgTxt("Handle must be a scalar.");
+	h = (int)mxGetScalar(arg);
+	if ( h < 1 || h > MAX_HANDLES || handles[h-1].fp == NULL )
+		mexErrMsgTxt("Invalid or closed handle.");
+	return handles + h - 1;
+}
+
+/* H = cefprint_mx('open',FILENAME[,NTHREADS]) */
+static void handle_open(int nrhs, const mxArray *prhs[], double *res)
+{
+	char *f_name;
+	int h, nthreads = 1;
+
+	if ( nrhs < 2 || nrhs > 3 )
+		mexErrMsgTxt("Usage: H = cefprint_mx('open',FILENAME[,NTHREADS])");
+	if ( mxIsChar(prhs[1]) != 1 || mxGetM(prhs[1]) != 1 )
+		mexErrMsgTxt("FILENAME must be a string.");
+	if ( nrhs == 3 )
+		nthreads = get_nthreads(prhs[2]);
+
+	for ( h=0; h<MAX_HANDLES && handles[h].fp != NULL; h++ );
+	if ( h == MAX_HANDLES )
+		mexErrMsgTxt("Too many open CEF files.");
+
+	f_name = mxArrayToString(prhs[1]);
+	if ( out_open(handles + h, f_name, nthreads) != 0 ) {
+		if ( handles[h].fp != NULL )
+			out_close(handles + h, 1);
+		*res = -1;
+	} else {
+		/* keep the open streams if the MEX file is cleared */
+		if ( !mexIsLocked() )
+			mexLock();
+		*res = h + 1;
+	}
+	mxFree(f_name);
+}
+
+/* STATUS = cefprint_mx('append',H,DATA[,FORMAT_STRING]) */
+static void handle_append(int nrhs, const mxArray *prhs[], double *res)
+{
+	cef_out *o;
+	col_fmt *cf;
+	int d_ncols;
+
+	if ( nrhs < 3 || nrhs > 4 )
+		mexErrMsgTxt("Usage: STATUS = cefprint_mx('append',H,DATA[,FORMAT_STRING])");
+	o = get_handle(prhs[1]);
+	if ( mxIsDouble(prhs[2]) != 1 )
+		mexErrMsgTxt("DATA must be a double.");
+	d_ncols = mxGetN(prhs[2]);
+	if ( mxIsEmpty(prhs[2]) )
+		return;
+	if ( d_ncols < 2 )
+		mexErrMsgTxt("DATA must have at least two columns.");
+
+	cf = get_formats(nrhs == 4 ? prhs[3] : NULL, d_ncols);
+	*res = out_append(o, mxGetPr(prhs[2]), mxGetM(prhs[2]), d_ncols, cf);
+	mxFree(cf);
+}
+
+/* STATUS = cefprint_mx('close',H) */
+static void handle_close(int nrhs, const mxArray *prhs[], double *res)
+{
+	int i;
+
+	if ( nrhs != 2 )
+		mexErrMsgTxt("Usage: STATUS = cefprint_mx('close',H)");
+	*res = out_close(get_handle(prhs[1]), 0);
+
+	for ( i=0; i<MAX_HANDLES && handles[i].fp == NULL; i++ );
+	if ( i == MAX_HANDLES && mexIsLocked() )
+		mexUnlock();
 }
 
 void mexFunction( int nlhs, mxArray *plhs[],
 		int nrhs, const mxArray *prhs[])
 {
-	char *f_name, *format, *formats=NULL;
-	char tmp_s[BUFSIZ], tmp_s1[128], buf[BUFSIZ*64], unix_c[BUFSIZ];
+	char *f_name, *obuf, *p, cmd[8];
+	char unix_c[BUFSIZ];
 	double *data, *res;
-	int   buflen,status,t_mrows,t_ncols,d_mrows,d_ncols,i,j,formatlen;
+	int   buflen,status,d_mrows,d_ncols,i,nthreads=-1;
+	size_t row_max, obuf_size;
+	col_fmt *cf;
+	cef_out out;
+	date_cache dc;
 	FILE *fp;
     
 	/* check for proper number of arguments */
 	if(nlhs!=1)
 		mexErrMsgTxt("One output required.");
+
+	/* handle API */
+	if ( nrhs >= 2 && mxIsChar(prhs[0]) && mxGetNumberOfElements(prhs[0]) < sizeof(cmd) ) {
+		mxGetString(prhs[0], cmd, sizeof(cmd));
+		if ( !strcmp(cmd, "open") || !strcmp(cmd, "append") || !strcmp(cmd, "close") ) {
+			mexAtExit(close_all_handles);
+			plhs[0] = mxCreateDoubleMatrix(1, 1, mxREAL);
+			res = mxGetPr(plhs[0]);
+			*res = 0;
+			if ( cmd[0] == 'o' )
+				handle_open(nrhs, prhs, res);
+			else if ( cmd[0] == 'a' )
+				handle_append(nrhs, prhs, res);
+			else
+				handle_close(nrhs, prhs, res);
+			return;
+		}
+	}
 	if(nrhs<2)
 		mexErrMsgTxt("At least two inputs required.");
-	else if(nrhs > 3)
+	else if(nrhs > 4)
 		mexErrMsgTxt("Too many input arguments.");
     
 	/* check input*/
@@ -79,8 +772,8 @@ void mexFunction( int nlhs, mxArray *plhs[],
 		mexErrMsgTxt("First input must be a row vector.");
 	if ( mxIsDouble(prhs[1])!= 1)
 		mexErrMsgTxt("Second input must be a double.");
-	if ( (nrhs == 3) && ( mxIsChar(prhs[2])!= 1) )
-		mexErrMsgTxt("Third input must be a string.");
+	if ( nrhs == 4 )
+		nthreads = get_nthreads(prhs[3]);
     
 	/* data */
 	d_mrows = mxGetM(prhs[1]);
@@ -90,19 +783,7 @@ void mexFunction( int nlhs, mxArray *plhs[],
 		mexErrMsgTxt("Input must have at least two columns.");
 	data = mxGetPr(prhs[1]);
     
-	/* set up formatting string(s) */
-	if ( nrhs == 3 ) {
-		if (mxGetN(prhs[2])!=d_ncols-1)
-			mexErrMsgTxt("Third input must have the same number of rows as the number of data columns.");
-		formatlen=mxGetM(prhs[2]);
-		format=mxCalloc(formatlen+8, sizeof(char));
-		formats = mxArrayToString(prhs[2]);
-		if(formats == NULL)
-			mexErrMsgTxt("Could not convert third input to string.");
-	} else {
-		format = mxCalloc(16, sizeof(char));
-		strcpy(format,"%s, %8.3f");
-	}
+	cf = get_formats(nrhs >= 3 ? prhs[2] : NULL, d_ncols);
     
 	/* filename */
 	buflen = (mxGetM(prhs[0]) * mxGetN(prhs[0])) + 1;
@@ -124,37 +805,49 @@ void mexFunction( int nlhs, mxArray *plhs[],
 	strcat(unix_c,f_name);
 	strcat(unix_c,".gz");
 	system(unix_c);
+
+	if ( nthreads > 0 ) {
+		status = out_open(&out, f_name, nthreads);
+		if ( status == 0 )
+			status = out_append(&out, data, d_mrows, d_ncols, cf);
+		if ( out.fp != NULL )
+			status = out_close(&out, status);
+		*res = status;
+		mxFree(cf);
+		mxFree(f_name);
+		return;
+	}
 	
 	if ( (fp = fopen(f_name,"a")) == NULL ) {
 		mexWarnMsgTxt("Cannot open output file");
 		*res = 1;
 	} else {
-/*		setbuf(fp,buf);*/
-		setbuffer(fp,buf,BUFSIZ*64-1);
+		/* rows are formatted straight into obuf, which is flushed
+		 * when full and grown when a single row does not fit */
+		row_max = row_size_max(cf, d_ncols-1);
+		obuf_size = BUFSIZ*64 > 4*row_max ? BUFSIZ*64 : 4*row_max;
+		obuf = mxMalloc(obuf_size);
+		memset(&dc, 0, sizeof(dc));
 		status = 0;
 
-		for (i=0; i<d_mrows; i++){
-			epoch2iso(data+i, tmp_s);
-			if ( nrhs == 3 ) {
-				strcpy(format,"%s, ");
-				strncat(format,formats,formatlen);                
+		p = obuf;
+		i = 0;
+		while ( i < d_mrows ) {
+			p = format_rows(p, obuf + obuf_size, data, d_mrows, d_ncols,
+					cf, &dc, &i, d_mrows);
+			if ( p == obuf ) {
+				obuf_size *= 2;
+				obuf = mxRealloc(obuf, obuf_size);
+				p = obuf;
+				continue;
 			}
-			sprintf(tmp_s,format,tmp_s,*(data +d_mrows +i));
-			
-			if ( d_ncols > 2)
-				for ( j=2; j<d_ncols; j++ ){
-					if ( nrhs == 3) {
-						strcpy(format,", ");
-						strncat(format,formats+formatlen*(j-1),formatlen);
-						sprintf(tmp_s1,format,*(data +d_mrows*j +i));
-					} else
-						sprintf(tmp_s1,", %8.3f",*(data +d_mrows*j +i));
-					strcat(tmp_s,tmp_s1);
-				}
-
-			if ( (status = fprintf(fp,"%s $\n",tmp_s)) < 0 )
+			if ( fwrite(obuf, 1, p - obuf, fp) != (size_t)(p - obuf) ) {
+				status = -1;
 				break;
+			}
+			p = obuf;
 		}
+		mxFree(obuf);
 		if ( status < 0 ){
 			mexWarnMsgTxt("Error writing to output file");
 			*res = 1;
@@ -170,8 +863,7 @@ void mexFunction( int nlhs, mxArray *plhs[],
 	}
 
 	/* Free allocated dynamic memory*/
-	mxFree(format);
-	mxFree(formats);
+	mxFree(cf);
     
 	if (*res) {
 		mxFree(f_name);
@@ -56,7 +56,9 @@ classdef mms_db < handle
      fileList = list_files(obj,filePrefix,tint,varName);
      if isempty(fileList), return, end
      
-		 loadedFiles = obj.load_list(fileList,varName);
+		 res = obj.load_concat(fileList,varName,tint);
+		 if ~isempty(res), return, end
+		 loadedFiles = obj.load_list(fileList,varName,tint);
 		 if numel(loadedFiles)==0, return, end
      
      flagDataobj = isa(loadedFiles{1},'dataobj');
@@ -194,10 +196,13 @@ classdef mms_db < handle
      end % APPEND_SCI_VAR
    end % GET_VARIABLE
    
-   function res = load_list(obj,fileList,mustHaveVar)
-     narginchk(2,3), res = {};
+   function res = load_list(obj,fileList,mustHaveVar,tint)
+     % With TINT only the records within TINT of MUSTHAVEVAR (and the
+     % variables it refers to) are loaded, the result is not cached
+     narginchk(2,4), res = {};
      if isempty(fileList), return, end
      if nargin==2, mustHaveVar = ''; end
+     if nargin<4, tint = []; end
      
      for iFile=1:length(fileList)
        fileToLoad = fileList(iFile);
@@ -206,7 +211,8 @@ classdef mms_db < handle
 			 else
 				 fileNameToLoad = fileToLoad.name;
 			 end
-       dobjLoaded = obj.cache.get_by_key(fileNameToLoad);
+       dobjLoaded = [];
+       if isempty(tint), dobjLoaded = obj.cache.get_by_key(fileNameToLoad); end
        if isempty(dobjLoaded)
 				 if mms.db_index
 					 db=obj.databases;
@@ -216,13 +222,82 @@ classdef mms_db < handle
          if isempty(db) || ~db.file_has_var(fileNameToLoad,mustHaveVar)
            continue
          end
-         dobjLoaded = db.load_file(fileNameToLoad);
-         obj.cache.add_entry(fileNameToLoad,dobjLoaded)
+         if isempty(tint)
+           dobjLoaded = db.load_file(fileNameToLoad);
+           obj.cache.add_entry(fileNameToLoad,dobjLoaded)
+         else
+           dobjLoaded = db.load_file(fileNameToLoad,tint,mustHaveVar);
+         end
        end
        res = [res {dobjLoaded}]; %#ok<AGROW>
      end
    end
    
+   function res = load_concat(obj,fileList,varName,tint)
+     % Load varName within tint from all the CDF files of fileList at once.
+     % The files are read concurrently and concatenated in time order by
+     % irf_cdfread_mx('load'), the first file is loaded as well for the
+     % attributes and the variables varName refers to.
+     % Returns [] if this cannot be done, the files are then to be loaded
+     % one by one with LOAD_LIST.
+     narginchk(4,4), res = [];
+     if numel(fileList)<2 || exist('irf_cdfread_mx','file')~=3, return, end
+     
+     fileNames = {}; fullPaths = {}; dbs = {};
+     for iFile=1:length(fileList)
+       fileToLoad = fileList(iFile);
+			 if mms.db_index
+				 fileNameToLoad = fileToLoad{1}; db = obj.databases;
+			 else
+				 fileNameToLoad = fileToLoad.name; db = obj.get_db(fileToLoad.dbId);
+			 end
+       if isempty(db) || ~db.file_has_var(fileNameToLoad,varName)
+         continue
+       end
+       fullPath = db.get_cdf_path(fileNameToLoad);
+       if isempty(fullPath), return, end % ancillary
+       fileNames = [fileNames {fileNameToLoad}]; %#ok<AGROW>
+       fullPaths = [fullPaths {fullPath}]; %#ok<AGROW>
+       dbs = [dbs {db}]; %#ok<AGROW>
+     end
+     if numel(fullPaths)<2, return, end
+     
+     dobj = dbs{1}.load_file(fileNames{1},tint,varName);
+     v = get_variable(dobj,varName);
+     if ~isstruct(v) || ~isfield(v,'DEPEND_0') || ~isstruct(v.DEPEND_0)
+       return
+     end
+     depend0 = dobj.VariableAttributes.DEPEND_0;
+     timeVarName = depend0{strcmp(depend0(:,1),varName),2};
+     if isa(tint,'GenericTimeArray'), tintTT2000 = tint.ttns;
+     else
+       tintTT2000 = [spdfparsett2000(epoch2iso(tint(1))) ...
+         spdfparsett2000(epoch2iso(tint(2)))];
+     end
+     try
+       data = irf_cdfread_mx('load',fullPaths,timeVarName,tintTT2000,...
+         {timeVarName,varName});
+     catch err
+       irf.log('notice',['Loading files one by one, irf_cdfread_mx: ' ...
+         err.message]);
+       return
+     end
+     
+     time = data{1}; data = data{2};
+     if any(diff(time)<=0) % overlapping files
+       [time,idxUnique] = unique(time);
+       idx = repmat({':'},1,ndims(data)); idx{1} = idxUnique;
+       nDuplicate = size(data,1) - length(time);
+       data = data(idx{:});
+       if nDuplicate
+         irf.log('warning',sprintf('Discarded %d data points',nDuplicate))
+       end
+     end
+     v.data = data; v.nrec = length(time);
+     v.DEPEND_0.data = time; v.DEPEND_0.nrec = v.nrec;
+     res = v;
+   end
+   
    function res = get_db(obj,id)
      idx = arrayfun(@(x) strcmp(x.id,id),obj.databases);
      res = obj.databases(idx);
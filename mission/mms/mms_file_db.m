@@ -21,7 +21,8 @@ classdef (Abstract) mms_file_db
       end
     end
     fileList = list_files(obj,filePrefix,tint)
-    dataObj = load_file(obj,fileName)
+    dataObj = load_file(obj,fileName,tint,varName)
+    fullPath = get_cdf_path(obj,fileName)
   end
   
 end
@@ -308,18 +308,18 @@ classdef mms_local_file_db < mms_file_db
       end % ADD2LIST
     end % LIST_FILES
     %% LOAD FILES
-    function res = load_file(obj,fileName)
-      narginchk(2,3)
+    function res = load_file(obj,fileName,tint,varName)
+      % With TINT only the records within TINT are read from CDF files,
+      % with VARNAME only this variable and the ones it refers to
+      narginchk(2,4)
       
       irf.log('notice',['loading ' fileName])
-			if mms.db_index
-				fileNameFullPath = fileName;
-			else
-				p = obj.get_path_to_file(fileName);
-				fileNameFullPath = [p filesep fileName];
-			end
+      fileNameFullPath = obj.get_full_path(fileName);
       if mms_local_file_db.is_cdf_file(fileName)
-        res = dataobj(fileNameFullPath);
+        args = {};
+        if nargin>2 && ~isempty(tint), args = [args {'tint',tint}]; end
+        if nargin>3 && ~isempty(varName), args = [args {'vars',varName}]; end
+        res = dataobj(fileNameFullPath,args{:});
         return
       end
       
@@ -328,6 +328,14 @@ classdef mms_local_file_db < mms_file_db
         mms_local_file_db.get_anc_type(fileName));
     end % LOAD_FILES
     
+    %% GET_CDF_PATH
+    function res = get_cdf_path(obj,fileName)
+      % full path to the CDF file fileName, empty for ancillary files
+      res = '';
+      if ~mms_local_file_db.is_cdf_file(fileName), return, end
+      res = obj.get_full_path(fileName);
+    end
+    
     %% FILE_HAS_VAR
     function res = file_has_var(obj,fileName,varName)
 			% checks if fileName includes variable name varName
@@ -381,6 +389,13 @@ classdef mms_local_file_db < mms_file_db
   end
   
   methods (Access=private)
+    function res = get_full_path(obj,fileName)
+			if mms.db_index
+				res = fileName;
+			else
+				res = [obj.get_path_to_file(fileName) filesep fileName];
+			end
+    end
     function p = get_path_to_file(obj,fileName)
       C = strsplit(lower(fileName),'_');
       if strcmpi(fileName(end-3:end),'.cdf')
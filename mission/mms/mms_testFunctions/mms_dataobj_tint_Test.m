@@ -0,0 +1,139 @@
+% MMS_DATAOBJ_TINT_TEST tests reading CDF files with dataobj(file,'tint',tint).
+%       With the MEX file irf_cdfread_mx only the records within tint are
+%       read. The result must equal the whole file read with dataobj(file)
+%       and trimmed to tint, for 1-D, 2-D and 3-D records, GZIP compressed
+%       blocks and sparse records. The test files are written with
+%       spdfcdfwrite, the tests are skipped without irf_cdfread_mx.
+%
+%       Example:
+%               results = run(mms_dataobj_tint_Test)
+%
+%       See also MATLAB.UNITTEST, DATAOBJ, IRF_CDFREAD_MX.
+
+
+function tests = mms_dataobj_tint_Test
+    % Verify Matlab R2013b or later.
+    if( verLessThan('matlab', '8.3') )
+        error('Require R2013b or later to run this test. Please upgrade.');
+    end
+    tests = functiontests(localfunctions);
+end
+
+function setupOnce(testCase)
+    testCase.assumeEqual(exist('irf_cdfread_mx','file'), 3, ...
+        'irf_cdfread_mx is not compiled');
+    nRec = 600; % one record per second
+    t0 = spdfparsett2000('2016-01-01T00:00:00.000000000');
+    epoch = t0 + int64(0:nRec-1)'*int64(1e9);
+    v1 = (1:nRec)' + 0.25;                            % 1-D, not compressed
+    v2 = [(1:nRec)' -(1:nRec)' sin((1:nRec)')];       % 2-D, GZIP
+    v3 = reshape(1:4*3*2*nRec, 4, 3, 2, nRec);        % 3-D, GZIP
+    sp = cell(nRec,1);                                % sparse, 2 values
+    for iRec = [1:7:nRec nRec]
+        sp{iRec} = [iRec -iRec];
+    end
+    vars = {'Epoch', epoch, 'v1', v1, 'v2', v2, 'v3', v3, ...
+        'spPrev', sp, 'spPad', sp};
+    VATTRIB.DEPEND_0 = {'v1', 'Epoch'; 'v2', 'Epoch'; 'v3', 'Epoch'; ...
+        'spPrev', 'Epoch'; 'spPad', 'Epoch'};
+    args = {'Vardatatypes', {'Epoch', 'tt2000'}, ...
+        'VariableAttributes', VATTRIB, ...
+        'RecordBound', {'Epoch', 'v1', 'v2', 'v3'}, ...
+        'VarCompress', {'v2', 'gzip.6', 'v3', 'gzip.6', 'spPrev', 'gzip.6'}, ...
+        'BlockingFactor', {'v2', 64, 'v3', 50}, ...
+        'VarSparse', {'spPrev', 'Sparse(previous)', 'spPad', 'Sparse(padded)'}, ...
+        'PadValues', {'spPad', -1}};
+    testCase.TestData.dir = tempname;
+    mkdir(testCase.TestData.dir);
+    % the same variables in a file with compressed blocks and in a file
+    % compressed as a whole
+    testCase.TestData.files = {[testCase.TestData.dir, filesep, 'blocks'], ...
+        [testCase.TestData.dir, filesep, 'whole']};
+    spdfcdfwrite(testCase.TestData.files{1}, vars, args{:});
+    spdfcdfwrite(testCase.TestData.files{2}, vars, args{:}, ...
+        'CDFCompress', 'gzip.6');
+    testCase.TestData.files = strcat(testCase.TestData.files, '.cdf');
+    testCase.TestData.t0 = t0;
+end
+
+function teardownOnce(testCase)
+    if isfield(testCase.TestData, 'dir')
+        rmdir(testCase.TestData.dir, 's');
+    end
+end
+
+function testInsideFile(testCase)
+    % Interval boundaries between records.
+    verify_tint(testCase, [100.5 250.5]);
+end
+
+function testRecordBoundaries(testCase)
+    % A record at the start of tint is read, one at its end is not.
+    verify_tint(testCase, [100 200]);
+end
+
+function testFileStart(testCase)
+    verify_tint(testCase, [-50 30]);
+end
+
+function testFileEnd(testCase)
+    verify_tint(testCase, [550 700]);
+end
+
+function testBetweenSparseRecords(testCase)
+    % Only virtual records of the sparse variables.
+    verify_tint(testCase, [8.5 13.5]);
+end
+
+function testNumericTint(testCase)
+    % tint as ISDAT epoch instead of GenericTimeArray.
+    tintTT = testCase.TestData.t0 + int64([120 180]*1e9);
+    tint = irf_time(tintTT, 'ttns>epoch');
+    for iFile = 1:length(testCase.TestData.files)
+        file = testCase.TestData.files{iFile};
+        verify_parity(testCase, file, dataobj(file, 'tint', tint), tintTT);
+    end
+end
+
+function testOutsideFile(testCase)
+    tint = EpochTT(testCase.TestData.t0 + int64([700 800]*1e9));
+    for iFile = 1:length(testCase.TestData.files)
+        dobj = dataobj(testCase.TestData.files{iFile}, 'tint', tint);
+        for varName = {'Epoch', 'v1', 'v2', 'v3', 'spPrev', 'spPad'}
+            verifyEqual(testCase, dobj.data.(varName{:}).nrec, 0, varName{:});
+            verifyEmpty(testCase, dobj.data.(varName{:}).data, varName{:});
+        end
+    end
+end
+
+
+function verify_tint(testCase, tintSec)
+    % Compare dataobj(file,'tint',tint) with the whole file trimmed to tint,
+    % tint in seconds from the first record.
+    tintTT = testCase.TestData.t0 + int64(tintSec*1e9);
+    for iFile = 1:length(testCase.TestData.files)
+        file = testCase.TestData.files{iFile};
+        verify_parity(testCase, file, dataobj(file, 'tint', EpochTT(tintTT)), ...
+            tintTT);
+    end
+end
+
+function verify_parity(testCase, file, dobjTint, tintTT)
+    dobjAll = dataobj(file);
+    epoch = dobjAll.data.Epoch.data;
+    isIn = epoch >= tintTT(1) & epoch < tintTT(2);
+    testCase.assertTrue(any(isIn), 'no records within tint');
+    for varName = {'Epoch', 'v1', 'v2', 'v3', 'spPrev', 'spPad'}
+        dataAll = dobjAll.data.(varName{:}).data;
+        idx = repmat({':'}, 1, ndims(dataAll));
+        idx{1} = isIn;
+        verifyEqual(testCase, dobjTint.data.(varName{:}).data, dataAll(idx{:}), ...
+            varName{:});
+        verifyEqual(testCase, dobjTint.data.(varName{:}).nrec, sum(isIn), ...
+            varName{:});
+    end
+    % irf_cdfread_mx finds the same records, so dataobj read them directly
+    [~, count] = irf_cdfread_mx('range', file, 'Epoch', tintTT);
+    irf_cdfread_mx('close');
+    verifyEqual(testCase, double(count), sum(isIn));
+end
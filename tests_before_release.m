@@ -20,10 +20,13 @@ testsToRun = {...
   'TestTimeArray', ...              % IRF generic
   'test_irf_time', ...
   'irf.test_geocentric_coordinate_transformation', ...
+  'test_onera_desp_lib', ...       % libirbem, skipped without its mex file
+  'test_cspice_str2et', ...        % mice
   'testC4', ...                     % Cluster specific
   'test_mms_defatt_phase', ...      % MMS specific
   'test_mms_spinfit', ...
   'test_mms_dsl2gse', ...
+  'mms_dataobj_tint_Test', ...     % skipped without irf_cdfread_mx
   'mms_phaseFromSunpulse_2_Test'};
 
 for ii = 1:length(testsToRun)